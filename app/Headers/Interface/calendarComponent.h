@@ -0,0 +1,53 @@
+#ifndef CALENDAR_COMPONENT_H
+#define CALENDAR_COMPONENT_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "../calendarIndex.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+/**
+ * @brief Rendered month grid with the index version it was built from.
+ */
+struct CalendarGrid {
+    Element grid;
+    uint64_t version = 0;
+};
+
+class CalendarComponent {
+public:
+    CalendarComponent() {};
+    /**
+     * @brief Moves the shown month by the number of months, negative values go back in time.
+     */
+    void page(int months);
+    /**
+     * @brief Moves the shown month back to the current month.
+     */
+    void pageToToday();
+    /**
+     * @brief Creates the calendar component.
+     *
+     * This function creates the calendar component, which displays a month grid with the days the app was opened,
+     * diary entries, todo due dates and progress points. Every month is built once and kept until its days change.
+     */
+    ftxui::Component renderCalendarComponent(CalendarIndex *index, FileData *data);
+
+private:
+    Element buildGrid(CalendarIndex& index, FileData *data, int year, int month);
+
+    // Months from the current month
+    int monthOffset = 0;
+    int cachedToday = 0;
+    // Month index -> built grid
+    std::unordered_map<int, CalendarGrid> grids;
+};
+
+#endif // CALENDAR_COMPONENT_H
@@ -0,0 +1,62 @@
+#ifndef DATE_TIME_INPUT_H
+#define DATE_TIME_INPUT_H
+
+#include <array>
+#include <string>
+
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/component/component_base.hpp"
+
+using namespace ftxui;
+
+/**
+ * @class DateTimeInput
+ * @brief Year, month, day, hour and minute fields that keep a validated Date next to their text.
+ *
+ * The fields are parsed when they change, never while rendering. A field only keeps digits, a value
+ * above its range is lowered to the maximum (the day to the length of the month, which follows the
+ * month and the year) and a value below it, e.g. a year still being typed, marks the field invalid
+ * without touching the text. date() is the last value that had every field valid.
+ */
+class DateTimeInput {
+public:
+    DateTimeInput();
+
+    /**
+     * @brief Replaces the text of every field with the date.
+     */
+    void setDate(const Date& date);
+    const Date& date() const {
+        return value;
+    }
+    /**
+     * @brief Checks if every field holds a value in its range, so date() matches the text.
+     */
+    bool valid() const {
+        return invalidFields == 0;
+    }
+    /**
+     * @brief Creates the component of the fields, rendered as "YYYY - MM - DD / HH : MM".
+     */
+    ftxui::Component component();
+
+private:
+    enum Field { Year, Month, Day, Hour, Minute, FieldCount };
+
+    /**
+     * @brief Parses the changed field, and the day again when the month or the year changed.
+     */
+    void onChange(int field);
+    void validate(int field);
+    int maximum(int field) const;
+
+    std::array<std::string, FieldCount> texts;
+    std::array<int, FieldCount> values{};
+    // Bit per field
+    unsigned int invalidFields = 0;
+    Date value = Date();
+};
+
+#endif // DATE_TIME_INPUT_H
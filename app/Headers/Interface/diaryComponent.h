@@ -7,6 +7,10 @@
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/screen_interactive.hpp"
 
+#include "./diaryReader.h"
+#include "../calendarIndex.h"
+#include "../documentChanges.h"
+#include "../memoryReport.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 
 using namespace ftxui;
@@ -16,7 +20,37 @@ public:
     DiaryComponent() {};
     Component diaryComponent(FileData *data);
     DiaryData addDiaryEntry(FileData *data);
+    /**
+     * @brief Reloads the diary entries and dates from the data.
+     * 
+     * This function rebuilds the diary entries and the list of dates after the data has been replaced (e.g. changes were discarded).
+     */
+    void refreshData(FileData *data);
+    /**
+     * @brief Sets the calendar index kept up to date by the entries added here.
+     */
+    void setCalendarIndex(CalendarIndex *index);
+    /**
+     * @brief Sets the changes of the data, marked with the records changed here for the history of the next save.
+     */
+    void setDocumentChanges(DocumentChanges *changes);
+    /**
+     * @brief Memory of the diary entries and dates copied from the data, for the Memory tab.
+     */
+    MemoryUsage memoryUsage() const;
+    /**
+     * @brief Shrinks the diary entries and dates to their size, returns the bytes reclaimed.
+     */
+    size_t compact();
 private:
+    void updateSelectedDiary();
+
+    int selectedIndex = 0;
+    int selectedDiary = -1;
+    int isValidDiary = 0;
+    DiaryReader diaryReader;
+    CalendarIndex *calendarIndex = nullptr;
+    DocumentChanges *documentChanges = nullptr;
     std::string newEntryName;
     std::string newEntryContent;
     std::vector<DiaryData> diaryEntries;
@@ -0,0 +1,55 @@
+#ifndef DIARY_READER_H
+#define DIARY_READER_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+#include "ftxui/screen/box.hpp"
+
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+using namespace ftxui;
+
+/**
+ * @class DiaryReader
+ * @brief Scrollable view of a single diary entry.
+ * 
+ * The entry text is wrapped into lines once per (entry id, width) and the result is cached,
+ * so every frame only builds the lines that are visible. Supports scrolling with the arrows
+ * and the mouse wheel, and page jumps with PageUp/PageDown/Home/End.
+ */
+class DiaryReader {
+public:
+    DiaryReader() {};
+    /**
+     * @brief Creates the reader component.
+     * 
+     * @param selectedEntry Returns the entry to show, or nullptr when there is none.
+     */
+    Component readerComponent(std::function<const DiaryData*()> selectedEntry);
+    /**
+     * @brief Wraps the text into lines no longer than the width (in characters).
+     */
+    static std::vector<std::string> wrapText(const std::string& text, int width);
+    /**
+     * @brief Drops all cached layouts.
+     * 
+     * Used when the diary entries have been replaced (e.g. changes were discarded).
+     */
+    void clear();
+private:
+    const std::vector<std::string>& layoutFor(const DiaryData& entry, int width);
+    bool scroll(int lines);
+
+    std::unordered_map<long long, std::vector<std::string>> layouts;
+    int shownEntryId = -1;
+    int firstLine = 0;
+    int lineCount = 0;
+    Box box;
+};
+
+#endif // DIARY_READER_H
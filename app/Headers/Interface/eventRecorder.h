@@ -0,0 +1,85 @@
+#ifndef EVENT_RECORDER_H
+#define EVENT_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ftxui/component/event.hpp"
+#include "ftxui/component/mouse.hpp"
+
+enum class RecordedEventKind : uint8_t {
+    // Special keys, e.g. the arrows, Return or Tab
+    Key,
+    Character,
+    Mouse,
+    // The size of the terminal changed, width and height are set
+    Resize
+};
+
+struct RecordedEvent {
+    RecordedEventKind kind = RecordedEventKind::Key;
+    // Milliseconds since the recording started
+    int64_t time = 0;
+    // Terminal input of keys and characters
+    std::string input;
+    ftxui::Mouse mouse;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief A recorded session, as read by EventRecorder::load.
+ */
+struct EventLog {
+    // Seconds since the epoch when the recording started, replays fix the clock at it
+    std::time_t start = 0;
+    std::vector<RecordedEvent> events;
+};
+
+/**
+ * @class EventRecorder
+ * @brief Records the events of a UI session (LOG4DAILY_RECORD=path) for l4d-replay to run again.
+ *
+ * The file is text, one event per line: the time, the kind and its data, with the terminal input of keys
+ * and characters in hex so escape sequences survive. Every line is flushed as it is written, so a session
+ * that crashed is recorded up to the event that crashed it. Events the UI posts to itself are not recorded.
+ */
+class EventRecorder {
+public:
+    static constexpr const char* header = "log4daily events 1";
+
+    /**
+     * @brief Starts recording if LOG4DAILY_RECORD is set.
+     *
+     * @return bool False if the file could not be created, the error says why.
+     */
+    bool startFromEnvironment(std::string *error);
+    bool start(const std::string& path, std::string *error);
+    bool active() const;
+    void record(ftxui::Event event);
+    /**
+     * @brief Records the size of the terminal when it differs from the last one recorded.
+     */
+    void resize(int width, int height);
+
+    static bool load(const std::string& path, EventLog *log, std::string *error);
+    static ftxui::Event toEvent(const RecordedEvent& event);
+    /**
+     * @brief Names the event for reports, e.g. "key ArrowDown", "char a" or "mouse 3 1 at 40,12".
+     */
+    static std::string describe(const RecordedEvent& event);
+
+private:
+    void write(const RecordedEvent& event);
+
+    std::ofstream file;
+    std::chrono::steady_clock::time_point started;
+    int width = 0;
+    int height = 0;
+};
+
+#endif // EVENT_RECORDER_H
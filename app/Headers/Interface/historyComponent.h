@@ -0,0 +1,43 @@
+#ifndef HISTORY_COMPONENT_H
+#define HISTORY_COMPONENT_H
+
+#include <string>
+#include <vector>
+
+#include "../historyLog.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+class HistoryComponent {
+public:
+    HistoryComponent() {};
+    /**
+     * @brief Lists the saves of the history again, and shows the newest one.
+     */
+    void refreshData(const std::string& historyPath);
+    /**
+     * @brief Creates the history component.
+     *
+     * This function creates the history component, which lists the saves of the opened file and shows the
+     * document as it was saved by the selected one. A save is read back from the history only when it is selected.
+     */
+    ftxui::Component renderHistoryComponent(const std::string& historyPath);
+
+private:
+    /**
+     * @brief Reads the selected save back from the history and builds its summary.
+     */
+    void showSelected();
+
+    std::string path;
+    std::vector<HistoryEntry> entries;
+    std::vector<std::string> labels;
+    int selectedSave = 0;
+    Element summary;
+};
+
+#endif // HISTORY_COMPONENT_H
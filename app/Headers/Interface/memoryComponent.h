@@ -0,0 +1,41 @@
+#ifndef MEMORY_COMPONENT_H
+#define MEMORY_COMPONENT_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../memoryReport.h"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+class MemoryComponent {
+public:
+    MemoryComponent() {};
+    /**
+     * @brief Measures again on the next render, after the data was replaced or saved.
+     */
+    void invalidate();
+    /**
+     * @brief Creates the memory component.
+     *
+     * This function creates the memory component, a debug view of the bytes used by every section of the
+     * document and by the copies the other tabs keep of it. Measuring walks every record, so it is done when
+     * the tab is first shown, after a refresh and after compacting, not on every frame.
+     *
+     * @param measure Returns the rows of the document and of the UI copies.
+     * @param compact Shrinks the document and the copies, returns the bytes reclaimed.
+     */
+    ftxui::Component renderMemoryComponent(std::function<std::vector<MemoryRow>()> measure, std::function<size_t()> compact);
+
+private:
+    std::function<std::vector<MemoryRow>()> measure;
+    std::vector<std::string> lines;
+    bool stale = true;
+    std::string compactResult;
+};
+
+#endif // MEMORY_COMPONENT_H
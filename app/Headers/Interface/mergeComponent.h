@@ -0,0 +1,49 @@
+#ifndef MERGE_COMPONENT_H
+#define MERGE_COMPONENT_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../documentMerge.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+class MergeComponent {
+public:
+    MergeComponent() {};
+    /**
+     * @brief Reads the conflicts left by the last --merge of the file again.
+     */
+    void refreshData(const std::string& conflictsPath);
+    /**
+     * @brief Creates the merge component.
+     *
+     * This function creates the merge component, which lists the records both copies changed since their last
+     * merge and shows both versions of the selected one. Keeping mine drops the conflict, taking theirs replaces
+     * the record in the data and calls onResolved, so the other tabs can refresh.
+     */
+    ftxui::Component renderMergeComponent(const std::string& conflictsPath, FileData *data, std::function<void()> onResolved);
+
+private:
+    void resolve(bool takeTheirs);
+    /**
+     * @brief Builds both versions of the selected conflict, rendering only shows them.
+     */
+    void showSelected();
+
+    std::string path;
+    FileData *data = nullptr;
+    MergeConflicts conflicts;
+    std::vector<std::string> labels;
+    int selectedConflict = 0;
+    std::string error;
+    Element preview;
+    std::function<void()> onResolved;
+};
+
+#endif // MERGE_COMPONENT_H
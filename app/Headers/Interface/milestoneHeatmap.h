@@ -0,0 +1,69 @@
+#ifndef MILESTONE_HEATMAP_H
+#define MILESTONE_HEATMAP_H
+
+#include <string>
+#include <unordered_map>
+
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+/**
+ * @brief Progress points of one milestone indexed by day number.
+ */
+struct MilestoneDayIndex {
+    std::unordered_map<int, bool> completedByDay;
+    size_t indexedPoints = 0;
+};
+
+/**
+ * @class MilestoneHeatmap
+ * @brief Scrollable calendar heatmap of milestone progress points.
+ * 
+ * The heatmap shows a year of months (weeks as columns, weekdays as rows) and can be panned back
+ * across years. Each rendered month is kept as a pre-built tile, so scrolling only builds the tiles
+ * that become visible for the first time. Tiles are dropped when progress points are added to their month.
+ */
+class MilestoneHeatmap {
+public:
+    static constexpr int monthsPerRow = 4;
+    static constexpr int visibleRows = 3;
+    static constexpr int visibleMonths = monthsPerRow * visibleRows;
+
+    MilestoneHeatmap() {};
+    /**
+     * @brief Renders the visible months for the milestone.
+     */
+    Element render(const MilestonesData& milestone);
+    /**
+     * @brief Moves the visible window by the number of months, positive values go back in time.
+     */
+    void scroll(int months);
+    /**
+     * @brief Moves the visible window back to the current month.
+     */
+    void scrollToToday();
+    /**
+     * @brief Returns the visible range as text, e.g. "Nov 2025 - Oct 2026".
+     */
+    std::string rangeLabel() const;
+    /**
+     * @brief Drops all cached tiles and indexes.
+     * 
+     * Used when the data has been replaced (e.g. changes were discarded) or a milestone was removed.
+     */
+    void clear();
+private:
+    Element buildTile(int milestoneId, int monthIndex);
+    void updateIndex(const MilestonesData& milestone);
+    int lastVisibleMonth() const;
+
+    int monthOffset = 0;
+    int cachedToday = 0;
+    std::unordered_map<long long, Element> tiles;
+    std::unordered_map<int, MilestoneDayIndex> indexes;
+};
+
+#endif // MILESTONE_HEATMAP_H
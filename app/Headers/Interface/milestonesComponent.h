@@ -5,8 +5,14 @@
 #include <string>
 #include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
 #include "../applicationManager.h"
+#include "./milestoneHeatmap.h"
+#include "../memoryReport.h"
+#include "../milestoneStats.h"
+#include "../calendarIndex.h"
+#include "../documentChanges.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 
 #include "ftxui/component/component.hpp"
@@ -57,6 +63,28 @@ public:
      * The progress points for the milestone with the specified ID are retrieved.
      */
     MilestonesProgressPoints getMilestonesPoints(FileData *data, int id);
+    /**
+     * @brief Reloads the milestones list from the data.
+     * 
+     * This function rebuilds the displayed milestones list after the data has been replaced (e.g. changes were discarded).
+     */
+    void refreshData(FileData *data);
+    /**
+     * @brief Memory of the rows of the milestones list copied from the data, for the Memory tab.
+     */
+    MemoryUsage memoryUsage() const;
+    /**
+     * @brief Shrinks the rows of the milestones list to their size, returns the bytes reclaimed.
+     */
+    size_t compact();
+    /**
+     * @brief Sets the calendar index kept up to date by the changes made here.
+     */
+    void setCalendarIndex(CalendarIndex *index);
+    /**
+     * @brief Sets the changes of the data, marked with the records changed here for the history of the next save.
+     */
+    void setDocumentChanges(DocumentChanges *changes);
     /**
      * @brief Creates the milestones component.
      * 
@@ -66,6 +94,11 @@ public:
     Component renderMilestonesComponent(FileData *data);
 
 private:
+    /**
+     * @brief Returns the stats of the milestone, building them on first use.
+     */
+    MilestoneStats& statsFor(const MilestonesData& milestone);
+
     MilestonesListData milestones;
     int selectedMilestones = 0;
     std::string newMilestoneName = "";
@@ -73,6 +106,10 @@ private:
     std::string notificationText = "";
 
     NewMilestoneProgressPoint newProgressPoint = {false};
+    MilestoneHeatmap heatmap;
+    std::unordered_map<int, MilestoneStats> stats;
+    CalendarIndex *calendarIndex = nullptr;
+    DocumentChanges *documentChanges = nullptr;
 };
 
 #endif // MILESTONES_COMPONENT_H
\ No newline at end of file
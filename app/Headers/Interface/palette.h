@@ -0,0 +1,52 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <array>
+#include <vector>
+
+#include "../theme.h"
+
+#include "ftxui/dom/elements.hpp"
+#include "ftxui/screen/color.hpp"
+
+using namespace ftxui;
+
+/**
+ * @brief Colors of the frame gradient, rasterized for one screen size.
+ */
+struct FrameRaster {
+    int width = 0;
+    int height = 0;
+    // Row by row
+    std::vector<Color> colors;
+};
+
+/**
+ * @class Palette
+ * @brief FTXUI colors of the theme in use, built once when the UI starts.
+ *
+ * FTXUI computes a gradient for every cell on every frame, so the frame gradient is rasterized once for the
+ * size of the box it decorates, which is the whole screen, and copied into the cells afterwards. It is only
+ * rasterized again when the terminal is resized.
+ */
+class Palette {
+public:
+    static void use(const Theme& theme);
+    static const Color& color(ThemeRole role) {
+        return colors[static_cast<size_t>(role)];
+    }
+    /**
+     * @brief Colors the element with the frame of the theme: a gradient, a plain color or nothing.
+     */
+    static Element frame(Element element);
+
+private:
+    static const std::vector<Color>& rasterFor(int width, int height);
+
+    static std::array<Color, themeRoleCount> colors;
+    static std::vector<Color> frameColors;
+    static int frameAngle;
+    static FrameRaster raster;
+};
+
+#endif // PALETTE_H
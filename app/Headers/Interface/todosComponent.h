@@ -5,8 +5,17 @@
 #include <string>
 #include <algorithm>
 #include <iostream>
+#include <climits>
 
 #include "../applicationManager.h"
+#include "../todoQuery.h"
+#include "../dueDateIndex.h"
+#include "../memoryReport.h"
+#include "../recurrence.h"
+#include "../upcomingIndex.h"
+#include "../calendarIndex.h"
+#include "../documentChanges.h"
+#include "./dateTimeInput.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 
 #include "ftxui/component/component.hpp"
@@ -16,8 +25,12 @@
 using namespace ftxui;
 
 struct TodosListData {
+    static constexpr int plainTodo = INT_MIN;
+
     std::vector<std::string> todos;
     std::vector<int> todosIds;
+    // Day number of the occurrence for rows of recurring todos, plainTodo for the others
+    std::vector<int> occurrenceDays;
 };
 
 class TodosComponent {
@@ -25,23 +38,25 @@ public:
     TodosComponent();
     
     /**
-     * @brief Creates a limited range input component.
+     * @brief Sets the upcoming index kept up to date by the changes made here.
      * 
-     * This function creates a limited range input component for an integer value.
+     * The index is owned by the caller, which also rebuilds it when the data is replaced.
      */
-    ftxui::Component limitedRangeInput(std::string* content, const std::string& placeholder, int minValue, int maxValue);
+    void setUpcomingIndex(UpcomingIndex *index);
     /**
-     * @brief Creates a limited range input component for the day of the month.
-     * 
-     * This function creates a limited range input component for the day of the month.
+     * @brief Sets the calendar index kept up to date by the changes made here.
+     */
+    void setCalendarIndex(CalendarIndex *index);
+    /**
+     * @brief Sets the changes of the data, marked with the records changed here for the history of the next save.
      */
-    ftxui::Component limitedRangeInputDay(std::string* content, const std::string& placeholder);
+    void setDocumentChanges(DocumentChanges *changes);
     /**
      * @brief Adds a new todo item to the list.
      * 
-     * This function adds a new todo item to the list of todos.
+     * This function adds a new todo item to the list of todos, recurring when a rule is given.
      */
-    int addTodo(FileData *data, Date dueDate);
+    int addTodo(FileData *data, Date dueDate, const RecurrenceRule& rule = RecurrenceRule());
     /**
      * @brief Removes a todo item from the list.
      * 
@@ -55,6 +70,24 @@ public:
      * and marked as undone if the done parameter is false.
      */
     void markTodoDone(FileData *data, int id, bool done);
+    /**
+     * @brief Marks the occurrence of a recurring todo on the day (a day number) as done or undone.
+     */
+    void markOccurrenceDone(FileData *data, int id, int day, bool done);
+    /**
+     * @brief Reloads the todos list from the data.
+     * 
+     * This function rebuilds the displayed todos list after the data has been replaced (e.g. changes were discarded).
+     */
+    void refreshData(FileData *data);
+    /**
+     * @brief Memory of the rows of the todos list copied from the data, for the Memory tab.
+     */
+    MemoryUsage memoryUsage() const;
+    /**
+     * @brief Shrinks the rows of the todos list to their size, returns the bytes reclaimed.
+     */
+    size_t compact();
     /**
      * @brief Creates the todos component.
      * 
@@ -63,16 +96,39 @@ public:
     ftxui::Component renderTodosComponent(FileData *data);
 
 private:
+    /**
+     * @brief Rebuilds the displayed list from the data, keeping only todos matching the filter.
+     */
+    void rebuildList(FileData *data);
+    /**
+     * @brief Compiles the filter text and applies it, invalid filters keep the previous one.
+     */
+    void applyFilter(FileData *data);
+    const TodoData* findTodo(FileData *data, int id);
+    /**
+     * @brief Adds a row for the occurrence of a recurring todo, labelled with its day.
+     */
+    void addOccurrenceRow(const TodoData& todo, int day, bool done);
+
     TodosListData todos;
     int selectedTodos = 0;
     std::string newTodoName = "";
     std::string newTodoDescription = "";
+    std::string newTodoRepeat = "";
+    std::string repeatError;
+
+    DateTimeInput dueDateInput;
 
-    std::string dueYear;
-    std::string dueMonth;
-    std::string dueDay;
-    std::string dueHour;
-    std::string dueMinute;
+    std::string filterText;
+    std::string filterError;
+    TodoQuery filter;
+    DueDateIndex dueDateIndex;
+    bool dueDateIndexDirty = true;
+    RecurrenceIndex recurrenceIndex;
+    UpcomingIndex *upcomingIndex = nullptr;
+    CalendarIndex *calendarIndex = nullptr;
+    DocumentChanges *documentChanges = nullptr;
+    size_t selectedTodoHint = 0;
     // Private member variables and methods
 };
 
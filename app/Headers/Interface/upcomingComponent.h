@@ -0,0 +1,50 @@
+#ifndef UPCOMING_COMPONENT_H
+#define UPCOMING_COMPONENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../upcomingIndex.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+/**
+ * @brief Rows of one bucket of the Upcoming tab.
+ */
+struct UpcomingBucketRows {
+    std::string title;
+    size_t count = 0;
+    std::vector<std::string> dates;
+    std::vector<std::string> names;
+};
+
+class UpcomingComponent {
+public:
+    // Rows shown per bucket, the rest is counted
+    static constexpr size_t maxRows = 10;
+
+    UpcomingComponent() {};
+    /**
+     * @brief Creates the upcoming component.
+     *
+     * This function creates the upcoming component, which displays the open todos by due date in overdue,
+     * today, this week and later buckets. The rows are only rebuilt when the index changed or the day rolled over.
+     */
+    ftxui::Component renderUpcomingComponent(UpcomingIndex *index, FileData *data);
+
+private:
+    /**
+     * @brief Rebuilds the rows of every bucket from the index.
+     */
+    void rebuildRows(const UpcomingIndex& index);
+
+    std::vector<UpcomingBucketRows> buckets;
+    uint64_t builtVersion = UINT64_MAX;
+};
+
+#endif // UPCOMING_COMPONENT_H
@@ -8,12 +8,22 @@
 #ifndef APPLICATION_MANAGER_H
 #define APPLICATION_MANAGER_H
 
+#include <array>
 #include <iostream>
 #include <string>
 #include <vector>
 
 // For handling user inputs
 #include "./inputHandlers.h"
+// For talking to a running daemon
+#include "./daemonClient.h"
+// For the change history of saved logs
+#include "./documentChanges.h"
+#include "./historyLog.h"
+// For logs stored as one shard per year
+#include "./shardedStore.h"
+// For the colors of the UI
+#include "./theme.h"
 
 #include "../../l4dFiles/out/l4dFiles.hpp"
 
@@ -21,6 +31,8 @@ enum class CommandType {
     New,
     Open,
     Delete,
+    Batch,
+    Query,
     Help,
     Unsupported,
     Failed,
@@ -45,9 +57,13 @@ public:
      * 
      * This function updates the data in the opened log4daily file with the specified data.
      * 
-     * @param data The updated data to be saved to the log4daily file.
+     * @param data The updated data to be saved to the log4daily file. Through the daemon, replaced by its document
+     * when another client changed it since it was opened.
+     * @param changes The records changed since the data was last saved, for its history and the daemon.
+     * @param replaced Set when data was replaced.
+     * @return bool False if the daemon refused the save, the error says why.
      */
-    void updateFileData(FileData data);
+    bool updateFileData(FileData *data, const DocumentChanges& changes, bool *replaced, std::string *error);
     /**
      * @brief Registers the current date in the opened log4daily file.
      * 
@@ -83,13 +99,180 @@ public:
      * @return FileData The data of the opened log4daily file.
      */
     FileData getOpenedFile();
+    /**
+     * @brief Gets the records of the opened log4daily file changed since it was read or saved.
+     *
+     * A file read without the daemon starts out whole, because another process may have written its history.
+     */
+    DocumentChanges getDocumentChanges();
+    /**
+     * @brief Gets the theme read from the config folder when the application started.
+     */
+    Theme getTheme();
+    /**
+     * @brief Gets the path of the history of the opened log4daily file.
+     */
+    std::string getHistoryPath();
+    /**
+     * @brief Gets the path of the conflicts left by the last --merge of the opened log4daily file.
+     */
+    std::string getConflictsPath();
 private:
     LocalStorage localStorage;
     std::string workingDirectory;
     std::string configName;
+    Theme theme;
     FileData openedFile;
+    // The records of openedFile changed since it was read or saved
+    DocumentChanges documentChanges;
     std::string respondMessage;
+    ShardedStore shardedStore;
+    HistoryLog history;
+    DaemonClient daemon;
+    bool daemonChecked = false;
+    // Set by "--open name verify", files are checked against their checksums as they are read
+    bool verifyOnOpen = false;
+    std::string readError;
+    // The commands of one run share openedFile as their document, which is saved once when the run ends
+    bool documentLoaded = false;
+    bool documentChanged = false;
+    ShardScope documentScope = ShardScope::Active;
+    // The widest scope any command of the run needs
+    ShardScope pipelineScope = ShardScope::Active;
+    bool pipelined = false;
+    bool commandsFollow = false;
+
+    using CommandHandler = CommandType (ApplicationManager::*)(const Command& command);
+    /**
+     * @brief The handler of every supported command, indexed by the CommandId of the CommandTable.
+     */
+    static const std::array<CommandHandler, supportedCommands.size()> commandHandlers;
     void showHelp();
+    /**
+     * @brief Connects to the daemon on first use.
+     * 
+     * @return bool True if a daemon is running, so documents should go through it instead of the files.
+     */
+    bool useDaemon();
+    /**
+     * @brief Opens the log4daily file, from the daemon when one is running.
+     * 
+     * @param scope The shards read when the file is sharded, the daemon always keeps all of them.
+     */
+    FileData openFile(const std::string& log4FileName, ShardScope scope = ShardScope::All);
+    /**
+     * @brief Saves the log4daily file, through the daemon when one is running.
+     *
+     * The daemon only gets the changed records. When another client changed the document since it was opened,
+     * data is replaced by the daemon's document, which has the changes of both.
+     *
+     * @param replaced Set when data was replaced.
+     * @return bool False if the daemon refused the save, the file is not written then.
+     */
+    bool saveFile(FileData *data, const DocumentChanges& changes, bool *replaced, std::string *error);
+    /**
+     * @brief Reads the log4daily file from its file or its shards, without the daemon.
+     */
+    FileData readFile(const std::string& log4FileName, ShardScope scope);
+    /**
+     * @brief Writes the log4daily file to its file, or only its changed shards, without the daemon.
+     */
+    void writeFile(const FileData& data, const DocumentChanges& changes);
+    /**
+     * @brief Returns why the log4daily file could not be opened, telling damaged files apart from missing ones.
+     */
+    std::string openFailure(const std::string& log4FileName) const;
+    /**
+     * @brief Converts a log4daily file into a sharded log.
+     */
+    CommandType runShard(const Command& command);
+    /**
+     * @brief Checks the log4daily file, or every shard of a sharded one, against its checksums.
+     */
+    CommandType runVerify(const Command& command);
+    /**
+     * @brief Copies every intact record of the log4daily file into "<name>-repaired".
+     */
+    CommandType runRepair(const Command& command);
+    /**
+     * @brief Lists the saves recorded in the history of the log4daily file, or prints the file as of one of them.
+     */
+    CommandType runHistory(const Command& command);
+    /**
+     * @brief Merges another copy of the log4daily file into it, and writes the result to both.
+     */
+    CommandType runMerge(const Command& command);
+    /**
+     * @brief Moves old done todos, inactive milestones and old diary entries into the archive segments.
+     */
+    CommandType runArchive(const Command& command);
+    /**
+     * @brief Prints the archived records that contain a text.
+     */
+    CommandType runArchiveSearch(const Command& command);
+    /**
+     * @brief Compresses the diary entries of the log4daily file, or with "off" stores them as plain text again.
+     */
+    CommandType runCompressDiary(const Command& command);
+    /**
+     * @brief Runs the daemon, or sends "stop" or "flush" to the running one.
+     */
+    CommandType runDaemon(const Command& command);
+    /**
+     * @brief Applies a headless batch command to the document of the run, or through the daemon when it runs alone.
+     */
+    CommandType runBatch(const Command& command);
+    /**
+     * @brief Prints the todos of the log4daily file matching the query.
+     */
+    CommandType runQuery(const Command& command);
+    /**
+     * @brief Prints streak and completion stats of every milestone in the log4daily file, with "memory" the memory it uses.
+     */
+    CommandType runStats(const Command& command);
+    CommandType runHelp(const Command& command);
+    CommandType runNew(const Command& command);
+    CommandType runOpen(const Command& command);
+    CommandType runDelete(const Command& command);
+    CommandType runList(const Command& command);
+    /**
+     * @brief Adds the todos of a CSV file to the document.
+     */
+    CommandType runImport(const Command& command);
+    /**
+     * @brief Writes the document as a JSON file.
+     */
+    CommandType runExport(const Command& command);
+    /**
+     * @brief Checks if an option follows the log4_file_name of the command.
+     */
+    static bool hasOption(const Command& command, const std::string& option);
+    /**
+     * @brief Loads the log4daily file as the document of the run, unless it already is.
+     *
+     * Another file saves the changes of the current document first, so does a scope wider than the loaded one.
+     */
+    bool loadDocument(const std::string& log4FileName, ShardScope scope);
+    /**
+     * @brief Loads the log4daily file named after the path of --import or --export, or checks that one is loaded.
+     */
+    bool documentFor(const Command& command);
+    /**
+     * @brief Saves the document if a command changed it.
+     */
+    void flushDocument();
+    /**
+     * @brief Saves the document and lets the next command load it again.
+     */
+    void releaseDocument();
+    /**
+     * @brief Compiles a language pack into the config folder, so the next start uses its language.
+     */
+    CommandType runSetLanguage(const Command& command);
+    /**
+     * @brief Checks a theme file and stores it in the config folder, so the next start uses its colors.
+     */
+    CommandType runSetTheme(const Command& command);
 };
 
 #endif // APPLICATION_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef ARCHIVE_STORE_H
+#define ARCHIVE_STORE_H
+
+#include <string>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief How old records have to be before they are moved to the archive.
+ */
+struct ArchivePolicy {
+    // Done todos due more than this many days ago
+    int todoDays = 90;
+    // Milestones without a progress point for this many days
+    int milestoneDays = 90;
+    // Diary entries older than this many days
+    int diaryDays = 365;
+};
+
+/**
+ * @brief One cold archive segment, holding the archived records of one year.
+ */
+struct ArchiveSegment {
+    int year = 0;
+    size_t todos = 0;
+    size_t milestones = 0;
+    size_t diaryEntries = 0;
+};
+
+/**
+ * @brief An archived record that matched a search.
+ */
+struct ArchiveMatch {
+    int year = 0;
+    // "todo", "milestone" or "diary"
+    std::string kind;
+    int id = 0;
+    Date date = {};
+    std::string title;
+};
+
+/**
+ * @class ArchiveStore
+ * @brief Moves old records out of a log4daily file into cold, per year archive segments.
+ *
+ * Every segment is a log4daily file of its own ("<name>-archive-<year>") written through LocalStorage,
+ * so the hot file that the UI opens only keeps recent records. A small manifest next to the files
+ * lists the segments and their record counts, so searches know which segments exist without opening them.
+ * Segments are only opened by archive() and search().
+ */
+class ArchiveStore {
+    public:
+        ArchiveStore(std::string workingDirectory, std::string configName);
+
+        /**
+         * @brief Moves the records the policy selects from the data into the archive segments.
+         *
+         * The segments are written before this returns, the caller then saves the smaller hot file.
+         * If that save fails the records are in both places, never in none.
+         *
+         * @param today Day number (DateUtils::dayNumber) the record ages are counted from.
+         * @return std::vector<ArchiveSegment> The records moved, per segment.
+         */
+        std::vector<ArchiveSegment> archive(FileData *data, const ArchivePolicy& policy, int today);
+        /**
+         * @brief Returns the archive segments of the log4daily file, from its manifest.
+         */
+        std::vector<ArchiveSegment> segments(const std::string& log4FileName) const;
+        /**
+         * @brief Finds archived records whose title or text contains the text, ignoring case.
+         *
+         * Segments are opened one at a time, newest first, and released before the next one.
+         */
+        std::vector<ArchiveMatch> search(const std::string& log4FileName, const std::string& text);
+
+        static std::string segmentName(const std::string& log4FileName, int year);
+    private:
+        std::string manifestPath(const std::string& log4FileName) const;
+        void writeManifest(const std::string& log4FileName, const std::vector<ArchiveSegment>& segments) const;
+
+        LocalStorage localStorage;
+        std::string workingDirectory;
+        std::string configName;
+};
+
+#endif // ARCHIVE_STORE_H
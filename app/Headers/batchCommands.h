@@ -0,0 +1,66 @@
+#ifndef BATCH_COMMANDS_H
+#define BATCH_COMMANDS_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "./documentChanges.h"
+#include "./inputHandlers.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Outcome of applying one batch command.
+ */
+struct BatchResult {
+    size_t applied = 0;
+    size_t skipped = 0;
+    std::vector<std::string> errors;
+};
+
+/**
+ * @class BatchCommands
+ * @brief Applies the headless console commands (--add-todo, --done, --add-diary, --progress).
+ * 
+ * The records of a command are taken from its arguments after the log4_file_name, or when there
+ * are none, from the input stream with one record per line. Fields of a record are separated by tabs:
+ * 
+ *   --add-todo    title [description [YYYY-MM-DD [HH:MM] [repeat]]]   (e.g. daily, weekly mon,thu, see Recurrence)
+ *   --done        todo_id [YYYY-MM-DD]   (the date marks one occurrence of a recurring todo)
+ *   --add-diary   title content   (\n in the content is a line break)
+ *   --progress    milestone_id [1|0]   (completed by default)
+ * 
+ * All records are applied to the data in memory, so the caller writes the file once per batch.
+ */
+class BatchCommands {
+    public:
+        /**
+         * @brief Checks if the command is one of the headless batch commands.
+         */
+        static bool isBatchCommand(const std::string& commandName);
+        /**
+         * @brief Applies all records of the command to the data.
+         * 
+         * @param command The batch command with its arguments.
+         * @param data The data of the opened log4daily file.
+         * @param changes Marked with the records the command changed.
+         * @param input Stream the records are read from when the command has no record arguments.
+         * @return BatchResult How many records were applied or skipped, with a message for each skipped one.
+         */
+        static BatchResult apply(const Command& command, FileData *data, DocumentChanges *changes, std::istream& input);
+        /**
+         * @brief Parses a date in the "YYYY-MM-DD" or "YYYY-MM-DD HH:MM" format.
+         * 
+         * @return bool False if the text is not a valid date.
+         */
+        static bool parseDate(const std::string& text, Date *date);
+        /**
+         * @brief Returns the records of the command, from its arguments or else from the input stream.
+         */
+        static std::vector<std::string> readRecords(const Command& command, std::istream& input);
+    private:
+        static std::vector<std::string> splitFields(const std::string& record);
+};
+
+#endif // BATCH_COMMANDS_H
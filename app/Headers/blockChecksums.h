@@ -0,0 +1,84 @@
+#ifndef BLOCK_CHECKSUMS_H
+#define BLOCK_CHECKSUMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Checksum of one block of consecutive records of a section.
+ */
+struct ChecksumBlock {
+    // "calendar", "todos", "milestones" or "diary"
+    std::string section;
+    size_t first = 0;
+    size_t count = 0;
+    uint32_t crc = 0;
+};
+
+/**
+ * @brief Result of checking a log4daily file (or one shard) against its checksums.
+ */
+struct VerifyReport {
+    std::string file;
+    bool readable = false;
+    bool hasChecksums = false;
+    size_t blocks = 0;
+    // Blocks whose records differ from what was saved, or are missing
+    std::vector<ChecksumBlock> damaged;
+    // Records after the last block, saved by something that did not write checksums
+    size_t uncheckedRecords = 0;
+
+    bool intact() const {
+        return readable && damaged.empty();
+    }
+};
+
+/**
+ * @class BlockChecksums
+ * @brief CRC-32C checksums of the records of a log4daily file, kept in a file next to it.
+ *
+ * l4dFiles owns the file format, so the checksums are written to "<name>.l4dsum" whenever the file is
+ * saved. Every section is split into blocks of recordsPerBlock records and each block is checksummed
+ * over the records as they are sent to the daemon (PayloadWriter). A damaged block is found after
+ * l4dFiles read the file, and repairing keeps every record outside the damaged blocks.
+ *
+ * Checksums are computed and checked in parallel, one block range per thread.
+ */
+class BlockChecksums {
+    public:
+        static constexpr size_t recordsPerBlock = 16;
+
+        static std::string path(const std::string& workingDirectory, const std::string& log4FileName);
+        static std::vector<ChecksumBlock> compute(const FileData& data);
+        static bool read(const std::string& path, std::vector<ChecksumBlock> *blocks);
+        static void write(const std::string& path, const std::vector<ChecksumBlock>& blocks);
+        /**
+         * @brief Saves the data through LocalStorage and writes its checksums next to it.
+         */
+        static void save(LocalStorage& storage, const std::string& workingDirectory, const std::string& log4FileName, const FileData& data);
+
+        /**
+         * @brief Checks the records of the data against the stored checksums.
+         */
+        static VerifyReport verify(const FileData& data, const std::vector<ChecksumBlock>& stored);
+        /**
+         * @brief Opens the file and checks it against its checksums.
+         *
+         * @param data Set to the data that was read, when not nullptr.
+         */
+        static VerifyReport verifyFile(LocalStorage& storage, const std::string& workingDirectory, const std::string& log4FileName, FileData *data = nullptr);
+        /**
+         * @brief Returns the data without the records of the damaged blocks.
+         */
+        static FileData salvage(const FileData& data, const VerifyReport& report);
+        /**
+         * @brief Returns the lines describing the report, for the console.
+         */
+        static std::vector<std::string> describe(const VerifyReport& report);
+};
+
+#endif // BLOCK_CHECKSUMS_H
@@ -0,0 +1,101 @@
+#ifndef CALENDAR_INDEX_H
+#define CALENDAR_INDEX_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "./dateUtils.h"
+#include "./recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief What happened on one day of the calendar.
+ */
+struct CalendarDay {
+    // The app was opened that day (calendarData)
+    bool opened = false;
+    uint16_t diaryEntries = 0;
+    uint16_t dueTodos = 0;
+    // Of the due todos
+    uint16_t doneTodos = 0;
+    uint16_t progressPoints = 0;
+    // Of the progress points
+    uint16_t completedPoints = 0;
+};
+
+/**
+ * @brief Grid layout of a month, weeks start on Monday.
+ */
+struct MonthLayout {
+    // Day number of the 1st
+    int firstDay;
+    // 0 is Monday
+    int firstWeekday;
+    int days;
+    int weeks;
+};
+
+struct CalendarMonth {
+    MonthLayout layout;
+    std::array<CalendarDay, 31> days;
+};
+
+/**
+ * @class CalendarIndex
+ * @brief Per-day aggregates of a log4daily file, grouped by month for the calendar.
+ *
+ * The aggregates are built once from FileData and then updated by the components as records are added,
+ * changed or removed, so paging through months reads one stored month instead of scanning every section.
+ * Recurring todos are not stored, their occurrences are expanded for the month that is asked for.
+ */
+class CalendarIndex {
+    public:
+        /**
+         * @brief Returns the layout of the month (1-12), usable at compile time.
+         */
+        static constexpr MonthLayout layout(int year, int month) {
+            int firstDay = DateUtils::dayNumber(year, month, 1);
+            int firstWeekday = DateUtils::weekday(firstDay);
+            int days = DateUtils::daysInMonth(year, month);
+            return MonthLayout({firstDay, firstWeekday, days, (firstWeekday + days + 6) / 7});
+        }
+        static constexpr int monthIndex(int year, int month) {
+            return year * 12 + month - 1;
+        }
+
+        CalendarIndex() {};
+        void rebuild(const FileData& data);
+
+        void addOpenedDay(const Date& date);
+        void addDiaryEntry(const DiaryData& entry);
+        void addTodo(const TodoData& todo);
+        void removeTodo(const TodoData& todo);
+        void addProgressPoint(const MilestoneProgressPoint& point);
+        void removeMilestone(const MilestonesData& milestone);
+
+        /**
+         * @brief Returns the month (1-12) with the occurrences of the recurring todos added to its due todos.
+         */
+        CalendarMonth month(int year, int month, const std::vector<TodoData>& todos);
+        /**
+         * @brief Returns a number that grows whenever the days of the month may have changed.
+         */
+        uint64_t version(int year, int month) const;
+    private:
+        CalendarDay& day(const Date& date);
+
+        // Month index -> days of the month, only months with records are stored
+        std::unordered_map<int, std::array<CalendarDay, 31>> months;
+        std::unordered_map<int, uint64_t> monthChanges;
+        uint64_t changes = 0;
+        uint64_t rebuiltAt = 0;
+
+        RecurrenceIndex recurrences;
+        bool recurrencesStale = true;
+        uint64_t recurrencesChangedAt = 0;
+};
+
+#endif // CALENDAR_INDEX_H
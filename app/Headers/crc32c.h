@@ -0,0 +1,24 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @class Crc32c
+ * @brief CRC-32C (Castagnoli) checksums.
+ *
+ * Uses the SSE4.2 crc32 instruction on x86-64 when the CPU has it (checked once at run time)
+ * and the ARMv8 CRC32 instructions when the build targets them, and a table driven version otherwise.
+ * All of them give the same checksums.
+ */
+class Crc32c {
+    public:
+        /**
+         * @brief Returns the checksum of the data, continuing from the checksum of the data before it.
+         */
+        static uint32_t compute(std::string_view data, uint32_t crc = 0);
+        static bool hardwareAccelerated();
+};
+
+#endif // CRC32C_H
@@ -0,0 +1,78 @@
+#ifndef DAEMON_CLIENT_H
+#define DAEMON_CLIENT_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./batchCommands.h"
+#include "./daemonProtocol.h"
+#include "./documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @class DaemonClient
+ * @brief Talks to a running log4daily daemon over its Unix domain socket.
+ *
+ * Every request is one frame and one response frame on a connection kept for the life of the client.
+ * When no daemon is running connect() fails fast and the caller goes to the files directly.
+ */
+class DaemonClient {
+    public:
+        DaemonClient() = default;
+        DaemonClient(const DaemonClient&) = delete;
+        DaemonClient& operator=(const DaemonClient&) = delete;
+        ~DaemonClient();
+
+        /**
+         * @brief Connects to the daemon of the working directory.
+         *
+         * @return bool False if no daemon is running (or the platform has no Unix domain sockets).
+         */
+        bool connect(const std::string& workingDirectory);
+        bool connected() const;
+        void disconnect();
+
+        bool ping();
+        /**
+         * @brief Gets the document from the daemon, which opens it on first use, and remembers its version.
+         */
+        bool open(const std::string& log4FileName, FileData *data, std::string *error);
+        /**
+         * @brief Sends the changed records of the document to the daemon. It is written to the file on the next flush.
+         *
+         * When another client changed the document since it was opened here, data is replaced by the daemon's
+         * document, which has the changes of both.
+         *
+         * @param replaced Set when data was replaced.
+         * @return bool False if the daemon could not be reached, or refused to replace a whole document another client changed.
+         */
+        bool store(FileData *data, const DocumentChanges& changes, bool *replaced, std::string *error);
+        bool batch(const std::string& commandName, const std::string& log4FileName, const std::vector<std::string>& records, BatchResult *result, std::string *error);
+        /**
+         * @brief Runs a todo query on the daemon and returns the lines of the --query output.
+         */
+        bool query(const std::string& log4FileName, const std::string& expression, std::string *output, size_t *matches, std::string *error);
+        /**
+         * @brief Makes the daemon drop the document without writing it, e.g. before the file is deleted.
+         */
+        bool close(const std::string& log4FileName, std::string *error);
+        bool flush(std::string *error);
+        bool shutdown(std::string *error);
+    private:
+        /**
+         * @brief Sends a request and reads the response, whose payload starts with the status message.
+         *
+         * @param reader Set to read the rest of the response payload.
+         * @return bool False if the daemon could not be reached or answered with a failure.
+         */
+        bool request(DaemonOpcode opcode, const std::string& payload, DaemonFrame *response, PayloadReader *reader, std::string *error);
+
+        int socket = -1;
+        // The version of every document as this client last got it from the daemon, sent back with its stores
+        std::unordered_map<std::string, uint64_t> versions;
+};
+
+#endif // DAEMON_CLIENT_H
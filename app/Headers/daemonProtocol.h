@@ -0,0 +1,135 @@
+#ifndef DAEMON_PROTOCOL_H
+#define DAEMON_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "./documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Requests understood by the log4daily daemon.
+ */
+enum class DaemonOpcode : uint8_t {
+    Ping = 1,
+    // file name -> version, FileData
+    Open = 2,
+    // file name, version, changes -> version, outdated, FileData when outdated
+    Store = 3,
+    // command name, file name, records -> applied, skipped, errors
+    Batch = 4,
+    // file name, expression -> output lines
+    Query = 5,
+    // file name -> nothing, drops the document without writing it
+    Close = 6,
+    // nothing -> nothing, writes every changed document
+    Flush = 7,
+    // nothing -> nothing, writes every changed document and stops the daemon
+    Shutdown = 8
+};
+
+/**
+ * @brief Status sent back in the opcode byte of a response frame.
+ */
+enum class DaemonStatus : uint8_t {
+    Ok = 0,
+    Failed = 1
+};
+
+/**
+ * @brief One message of the daemon protocol.
+ *
+ * On the wire a frame is a 4 byte little endian payload length, a 1 byte opcode (or status
+ * for responses) and the payload. Payload fields are little endian integers, and strings are
+ * a 4 byte length followed by the bytes.
+ */
+struct DaemonFrame {
+    uint8_t opcode = 0;
+    std::string payload;
+};
+
+/**
+ * @brief Appends protocol fields to a payload.
+ */
+class PayloadWriter {
+    public:
+        void u8(uint8_t value);
+        void u32(uint32_t value);
+        void u64(uint64_t value);
+        void string(std::string_view value);
+        void strings(const std::vector<std::string>& values);
+        void date(const Date& date);
+        void todo(const TodoData& todo);
+        void milestone(const MilestonesData& milestone);
+        void diaryEntry(const DiaryData& entry);
+        void fileData(const FileData& data);
+        /**
+         * @brief Appends the records of the data marked in the changes, or the whole data when they are whole.
+         *
+         * A flag says which follows. Per section come the changed records in the order of the document, each
+         * after a flag set for new records, then the removed keys.
+         */
+        void changes(const FileData& data, const DocumentChanges& changes);
+
+        std::string payload;
+};
+
+/**
+ * @brief Reads protocol fields from a payload.
+ *
+ * Reading past the end leaves default values and clears ok, so a whole message can be read
+ * and checked once at the end.
+ */
+class PayloadReader {
+    public:
+        explicit PayloadReader(std::string_view payload);
+
+        uint8_t u8();
+        uint32_t u32();
+        uint64_t u64();
+        std::string string();
+        std::vector<std::string> strings();
+        Date date();
+        TodoData todo();
+        MilestonesData milestone();
+        DiaryData diaryEntry();
+        FileData fileData();
+
+        bool ok = true;
+    private:
+        bool take(size_t size, const char **bytes);
+
+        std::string_view remaining;
+};
+
+/**
+ * @class DaemonProtocol
+ * @brief Frame I/O on the daemon socket, shared by the daemon and its clients.
+ */
+class DaemonProtocol {
+    public:
+        // Frames are refused above this size, so a broken peer cannot make the other side allocate gigabytes
+        static constexpr uint32_t maxPayloadSize = 1u << 30;
+
+        /**
+         * @brief Returns the path of the daemon socket in the log4daily working directory.
+         */
+        static std::string socketPath(const std::string& workingDirectory);
+        /**
+         * @brief Writes a whole frame to the socket.
+         *
+         * @return bool False if the peer went away.
+         */
+        static bool writeFrame(int socket, uint8_t opcode, std::string_view payload);
+        /**
+         * @brief Reads a whole frame from the socket.
+         *
+         * @return bool False if the peer went away or sent a frame that is too large.
+         */
+        static bool readFrame(int socket, DaemonFrame *frame);
+};
+
+#endif // DAEMON_PROTOCOL_H
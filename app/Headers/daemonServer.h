@@ -0,0 +1,94 @@
+#ifndef DAEMON_SERVER_H
+#define DAEMON_SERVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "./daemonProtocol.h"
+#include "./documentChanges.h"
+#include "./dueDateIndex.h"
+#include "./historyLog.h"
+#include "./recurrence.h"
+#include "./shardedStore.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @class DaemonServer
+ * @brief Keeps log4daily documents in memory and serves them over a Unix domain socket.
+ *
+ * A document is opened from its file on the first request for it and stays loaded. Changes are
+ * applied in memory and written back in batches: a changed document is written flushInterval after
+ * its first unwritten change, on a Flush request, and for every document when the daemon stops.
+ *
+ * Requests are served one at a time on a single thread, so documents need no locking.
+ *
+ * Several clients can edit the same document. Every change gives it a new version, which Open sends with it.
+ * A Store only applies the records the client changed on top of the document, and if another client changed
+ * it since that version the merged document is sent back. A Store of a whole document (after a merge, an
+ * archive...) would drop the other clients' changes, so it is refused unless it is built on the latest version.
+ */
+class DaemonServer {
+    public:
+        static constexpr std::chrono::milliseconds flushInterval = std::chrono::seconds(2);
+
+        DaemonServer(std::string workingDirectory, std::string configName);
+        /**
+         * @brief Serves clients until a Shutdown request, SIGINT or SIGTERM.
+         *
+         * @param error Set when the daemon could not start, e.g. because one is already running.
+         * @return bool False if the daemon could not start.
+         */
+        bool run(std::string *error);
+    private:
+        struct Document {
+            FileData data;
+            // The records changed since the last write, by batches and the stores of clients
+            DocumentChanges changes;
+            uint64_t version = 0;
+            DueDateIndex dueDateIndex;
+            RecurrenceIndex recurrenceIndex;
+            // Both indexes are rebuilt on the next query
+            bool dueDateIndexStale = true;
+            bool dirty = false;
+            std::chrono::steady_clock::time_point firstUnsavedChange;
+        };
+
+        /**
+         * @brief Returns the loaded document, opening it from its file on first use.
+         *
+         * @return Document* The document, or nullptr if the file does not exist.
+         */
+        Document* document(const std::string& log4FileName);
+        /**
+         * @brief Gives the document a new version and schedules it to be written.
+         */
+        void markChanged(Document *document);
+        /**
+         * @brief Writes the changed documents, only the ones whose flush interval passed unless force is set.
+         */
+        void flush(bool force);
+        /**
+         * @brief Returns how long the daemon can wait for requests before the next scheduled flush.
+         */
+        int pollTimeoutMs() const;
+        /**
+         * @brief Handles one request frame and writes its response.
+         *
+         * @return bool False if the response could not be sent.
+         */
+        bool handle(int client, const DaemonFrame& request, bool *stop);
+
+        LocalStorage localStorage;
+        ShardedStore shardedStore;
+        HistoryLog history;
+        std::string workingDirectory;
+        std::string configName;
+        std::unordered_map<std::string, Document> documents;
+        // Versions are never reused, not even by a document closed and opened again
+        uint64_t lastVersion = 0;
+};
+
+#endif // DAEMON_SERVER_H
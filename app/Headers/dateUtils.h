@@ -0,0 +1,102 @@
+#ifndef DATE_UTILS_H
+#define DATE_UTILS_H
+
+#include <ctime>
+#include <string>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @class DateUtils
+ * @brief Calendar arithmetic shared by the log4daily components.
+ * 
+ * Dates are converted to day numbers (days since 1970-01-01), which makes ranges, weekdays
+ * and month layouts plain integer arithmetic instead of round trips through mktime/localtime.
+ */
+class DateUtils {
+    public:
+        /**
+         * @brief Checks if the year is a leap year in the Gregorian calendar.
+         */
+        static constexpr bool isLeapYear(int year) {
+            return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        }
+        /**
+         * @brief Returns the number of days in the month (1-12) of the year.
+         */
+        static constexpr int daysInMonth(int year, int month) {
+            constexpr int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            if (month == 2 && isLeapYear(year)) {
+                return 29;
+            }
+            return days[month - 1];
+        }
+        /**
+         * @brief Converts a civil date into the number of days since 1970-01-01.
+         */
+        static constexpr int dayNumber(int year, int month, int day) {
+            year -= month <= 2;
+            const int era = (year >= 0 ? year : year - 399) / 400;
+            const int yearOfEra = year - era * 400;
+            const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+            const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return era * 146097 + dayOfEra - 719468;
+        }
+        static constexpr int dayNumber(const Date& date) {
+            return dayNumber(date.year, date.month, date.day);
+        }
+        /**
+         * @brief Converts a day number back into a date (hour and minute set to 0).
+         */
+        static constexpr Date fromDayNumber(int days) {
+            days += 719468;
+            const int era = (days >= 0 ? days : days - 146096) / 146097;
+            const int dayOfEra = days - era * 146097;
+            const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            const int monthPart = (5 * dayOfYear + 2) / 153;
+            const int day = dayOfYear - (153 * monthPart + 2) / 5 + 1;
+            const int month = monthPart < 10 ? monthPart + 3 : monthPart - 9;
+            const int year = yearOfEra + era * 400 + (month <= 2);
+            return Date({static_cast<short>(day), static_cast<short>(month), static_cast<short>(year), 0, 0});
+        }
+        /**
+         * @brief Converts a date into minutes since 1970-01-01 00:00, which sorts like the date.
+         */
+        static constexpr long long dateKey(const Date& date) {
+            return static_cast<long long>(dayNumber(date)) * 1440 + date.hour * 60 + date.minute;
+        }
+        /**
+         * @brief Returns the weekday of a day number, 0 is Monday and 6 is Sunday.
+         */
+        static constexpr int weekday(int days) {
+            // 1970-01-01 was a Thursday
+            return ((days % 7) + 7 + 3) % 7;
+        }
+        /**
+         * @brief Returns the current local date and time.
+         */
+        static Date now();
+        /**
+         * @brief Seconds since the epoch, the fixed time while the clock is fixed.
+         */
+        static std::time_t currentTime();
+        /**
+         * @brief Stops the clock of now() and today() at the time, so a replayed session sees the day it was recorded; 0 lets it run again.
+         */
+        static void fixClock(std::time_t time);
+        /**
+         * @brief Converts seconds since the epoch into the local date and time.
+         */
+        static Date fromTime(std::time_t time);
+        /**
+         * @brief Returns the current local date with hour and minute set to 0.
+         */
+        static Date today();
+        /**
+         * @brief Formats the date as "YYYY-MM-DD", or "YYYY-MM-DD HH:MM" with the time.
+         */
+        static std::string toString(const Date& date, bool withTime = false);
+};
+
+#endif // DATE_UTILS_H
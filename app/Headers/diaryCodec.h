@@ -0,0 +1,78 @@
+#ifndef DIARY_CODEC_H
+#define DIARY_CODEC_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @class DiaryCodec
+ * @brief Built-in compression of diary bodies, decoded one entry at a time.
+ *
+ * A compressed body is stored in the diaryEntry field as the marker followed by base64 text, so it
+ * goes through LocalStorage like any other string. Inside, the body is split into blocks of up to
+ * blockSize bytes, each compressed on its own with a small LZ77 codec (4 byte minimum matches,
+ * 16 bit offsets), so no block depends on another one.
+ *
+ * A file is in compressed mode while any of its diary entries is compressed; entries added since
+ * the last save are compressed by prepareForSave(). Everything that shows or searches diary text
+ * goes through text(), which passes plain bodies through unchanged.
+ */
+class DiaryCodec {
+    public:
+        static constexpr std::string_view marker = "~l4dz1~";
+        static constexpr size_t blockSize = 64 * 1024;
+        // Shorter bodies rarely get smaller once the marker and base64 are added
+        static constexpr size_t minCompressSize = 256;
+
+        static bool isCompressed(std::string_view stored);
+        /**
+         * @brief Compresses a diary body.
+         *
+         * @return std::string The compressed body, or the text itself when compressing does not make it smaller.
+         */
+        static std::string compress(std::string_view text);
+        /**
+         * @brief Decompresses a diary body, plain bodies are copied as they are.
+         *
+         * @return bool False if the body is marked as compressed but is damaged.
+         */
+        static bool decompress(std::string_view stored, std::string *text);
+        /**
+         * @brief Returns the text of a diary body, or the stored body when it cannot be decompressed.
+         */
+        static std::string text(std::string_view stored);
+
+        /**
+         * @brief Compresses every plain diary entry that is long enough.
+         *
+         * @return size_t The number of entries compressed.
+         */
+        static size_t compressEntries(FileData *data);
+        /**
+         * @brief Turns every compressed diary entry back into plain text.
+         *
+         * @return size_t The number of entries decompressed.
+         */
+        static size_t decompressEntries(FileData *data);
+        static bool hasCompressedEntries(const FileData& data);
+        /**
+         * @brief Compresses the new entries of a file in compressed mode, called right before the file is written.
+         */
+        static void prepareForSave(FileData *data);
+
+        /**
+         * @brief Compresses one block (at most blockSize bytes) with the LZ77 codec.
+         */
+        static std::string compressBlock(std::string_view input);
+        /**
+         * @brief Decompresses one block into exactly rawSize bytes, appended to the output.
+         *
+         * @return bool False if the block is damaged.
+         */
+        static bool decompressBlock(std::string_view input, size_t rawSize, std::string *output);
+};
+
+#endif // DIARY_CODEC_H
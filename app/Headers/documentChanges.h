@@ -0,0 +1,70 @@
+#ifndef DOCUMENT_CHANGES_H
+#define DOCUMENT_CHANGES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+enum class DocumentSection : uint8_t {
+    Calendar,
+    Todos,
+    Milestones,
+    Diary
+};
+
+/**
+ * @class DocumentChanges
+ * @brief The records of a document added, modified or removed since it was last saved, by section and key.
+ *
+ * Keys are the record ids, and DateUtils::dateKey for calendar days. FileDataOperations marks the records
+ * it changes, so HistoryLog only hashes those on the next save and the daemon only gets those from its
+ * clients. Edits that replace the document or many records at once (opening, merging, archiving) mark it
+ * whole instead, and then every record is compared. A new document is whole until its first save.
+ */
+class DocumentChanges {
+    public:
+        static constexpr size_t sectionCount = 4;
+
+        /**
+         * @brief Marks the record as added or modified.
+         *
+         * @param position Where the record is in its section, a hint that removals before it may outdate.
+         */
+        void changed(DocumentSection section, int64_t key, size_t position);
+        /**
+         * @brief Marks the record as new since the last save, so the daemon gives it another key if a client took its key first.
+         *
+         * A record added with the key of one removed before counts as a modification of it.
+         */
+        void added(DocumentSection section, int64_t key, size_t position);
+        /**
+         * @brief Marks the record as removed, a record added since the last save is forgotten instead.
+         */
+        void removed(DocumentSection section, int64_t key);
+        void markWhole();
+        /**
+         * @brief Forgets every change, once the document is saved or its last save restored.
+         */
+        void clear();
+        bool whole() const;
+        bool empty() const;
+        /**
+         * @brief The changed records of the section, by key with their position hint.
+         */
+        const std::unordered_map<int64_t, size_t>& changedIn(DocumentSection section) const;
+        const std::unordered_set<int64_t>& removedIn(DocumentSection section) const;
+        /**
+         * @brief The keys of the changed records that are new since the last save.
+         */
+        const std::unordered_set<int64_t>& addedIn(DocumentSection section) const;
+
+    private:
+        std::array<std::unordered_map<int64_t, size_t>, sectionCount> changedKeys;
+        std::array<std::unordered_set<int64_t>, sectionCount> removedKeys;
+        std::array<std::unordered_set<int64_t>, sectionCount> addedKeys;
+        bool wholeDocument = true;
+};
+
+#endif // DOCUMENT_CHANGES_H
@@ -0,0 +1,43 @@
+#ifndef DOCUMENT_EXCHANGE_H
+#define DOCUMENT_EXCHANGE_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "./batchCommands.h"
+#include "./documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @class DocumentExchange
+ * @brief Reads todos from CSV files (--import) and writes log4daily files as JSON (--export).
+ *
+ * A CSV file has one todo per row with the columns title, description, due date and repeat, like the
+ * fields of --add-todo: only the title is required, the due date is "YYYY-MM-DD [HH:MM]" and the repeat
+ * is a Recurrence rule. Fields may be quoted, with "" for a quote, and a first row starting with "title"
+ * is a header. Rows are checked like batch records, so a bad row is skipped with an error.
+ *
+ * The JSON export has every section of the file, with done todos and repeat rules as fields of their own
+ * and diary entries decompressed.
+ */
+class DocumentExchange {
+    public:
+        /**
+         * @brief Adds the todos of a CSV file to the data, marking them in the changes.
+         *
+         * @return BatchResult How many rows were added or skipped, with a message for each skipped one.
+         */
+        static BatchResult importTodos(std::istream& csv, FileData *data, DocumentChanges *changes);
+        static void exportJson(const FileData& data, std::ostream& json);
+        /**
+         * @brief Splits CSV text into rows of fields.
+         */
+        static std::vector<std::vector<std::string>> parseCsv(std::istream& csv);
+    private:
+        static std::string jsonString(const std::string& text);
+};
+
+#endif // DOCUMENT_EXCHANGE_H
@@ -0,0 +1,130 @@
+#ifndef DOCUMENT_MERGE_H
+#define DOCUMENT_MERGE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+enum class MergeSection : uint8_t {
+    Calendar,
+    Todos,
+    Milestones,
+    Diary
+};
+
+/**
+ * @class MerkleTree
+ * @brief Hash tree of a log4daily file: per section a root over a fixed number of buckets over the records.
+ *
+ * A record is a leaf with its key (the id, calendar days their date) and a hash of its fields, and goes
+ * to the bucket picked by its key, so the same record lands in the same bucket in every copy of a
+ * file. Bucket and root hashes are sums of mixed leaf hashes, so the order of the records does not matter
+ * and equal hashes mean equal records without looking at them.
+ */
+class MerkleTree {
+    public:
+        static constexpr size_t sectionCount = 4;
+        static constexpr size_t bucketCount = 256;
+
+        struct Leaf {
+            int64_t key = 0;
+            uint64_t hash = 0;
+            // Position of the record in its section of the file the tree was built from
+            uint32_t index = 0;
+        };
+        struct Section {
+            uint64_t root = 0;
+            std::array<uint64_t, bucketCount> buckets{};
+            std::array<std::vector<Leaf>, bucketCount> leaves;
+        };
+
+        static MerkleTree build(const FileData& data);
+        /**
+         * @brief Hash of the serialized bytes of a record, eight bytes at a time.
+         */
+        static uint64_t hashBytes(std::string_view bytes);
+        static size_t bucketOf(int64_t key);
+
+        void add(MergeSection section, int64_t key, uint64_t hash, uint32_t index);
+        /**
+         * @brief Writes only the keys and hashes of the leaves, the buckets and roots are summed again on load.
+         */
+        bool save(const std::string& path, std::string *error) const;
+        /**
+         * @brief Reads a tree written by save(), a missing file is an empty tree.
+         *
+         * @return bool False if the file is not a tree, the error says why.
+         */
+        static bool load(const std::string& path, MerkleTree *tree, bool *found, std::string *error);
+
+        std::array<Section, sectionCount> sections;
+};
+
+/**
+ * @brief A record both copies changed since their common ancestor, or one changed and the other removed.
+ */
+struct MergeConflict {
+    MergeSection section = MergeSection::Todos;
+    int64_t key = 0;
+    bool inOurs = false;
+    bool inTheirs = false;
+};
+
+/**
+ * @brief The conflicts of a merge, with their version of every conflicting record they still have.
+ */
+struct MergeConflicts {
+    std::vector<MergeConflict> conflicts;
+    FileData theirs;
+};
+
+struct MergeReport {
+    // Records added, changed or removed on their side only, applied to ours
+    size_t taken = 0;
+    size_t removed = 0;
+    // Records both sides added under the same id, theirs got a new one
+    size_t renumbered = 0;
+    // Buckets whose records were compared, the others were skipped by their hash
+    size_t bucketsCompared = 0;
+    MergeConflicts conflicts;
+};
+
+/**
+ * @class DocumentMerge
+ * @brief Three-way merge of two copies of a log4daily file (--merge) against the tree of their last merge.
+ *
+ * Sections and buckets whose hash is the same in both copies, or unchanged on their side since the ancestor,
+ * are skipped; only the records of the other buckets are compared. A record changed on one side only takes
+ * that side, records both sides added under the same id are both kept, and a record changed on both sides
+ * keeps our version while their version is stored as a conflict to resolve in the Merge tab. Without an
+ * ancestor every record is new, so changes are kept but removals are not merged.
+ */
+class DocumentMerge {
+    public:
+        static MergeReport merge(FileData *ours, const FileData& theirs, const MerkleTree& ancestor);
+
+        /**
+         * @brief Path of the tree of the last merge of a file, written next to both merged copies.
+         */
+        static std::string ancestorPath(const std::string& workingDirectory, const std::string& log4FileName);
+        static std::string conflictsPath(const std::string& workingDirectory, const std::string& log4FileName);
+        /**
+         * @brief Writes the conflicts, or removes the file once none are left.
+         */
+        static bool saveConflicts(const std::string& path, const MergeConflicts& conflicts, std::string *error);
+        static bool loadConflicts(const std::string& path, MergeConflicts *conflicts, std::string *error);
+        /**
+         * @brief Replaces our version of the record of a conflict with theirs, or removes it if they did.
+         */
+        static void takeTheirs(FileData *ours, const MergeConflicts& conflicts, size_t conflict);
+        /**
+         * @brief Names the record of a conflict with its section, key and title on both sides.
+         */
+        static std::string describe(const MergeConflict& conflict, const FileData& ours, const MergeConflicts& conflicts);
+};
+
+#endif // DOCUMENT_MERGE_H
@@ -0,0 +1,38 @@
+#ifndef DUE_DATE_INDEX_H
+#define DUE_DATE_INDEX_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Position of a todo in FileData::todosData with its due date key.
+ */
+struct DueDateEntry {
+    long long dueKey;
+    uint32_t position;
+};
+
+/**
+ * @class DueDateIndex
+ * @brief Todos sorted by due date, for answering due date ranges without scanning every todo.
+ */
+class DueDateIndex {
+    public:
+        DueDateIndex() {};
+        /**
+         * @brief Rebuilds the index from the todos.
+         */
+        void rebuild(const std::vector<TodoData>& todos);
+        /**
+         * @brief Returns the entries with a due date key in [minKey, maxKey], sorted by due date.
+         */
+        std::pair<const DueDateEntry*, const DueDateEntry*> range(long long minKey, long long maxKey) const;
+        size_t size() const;
+    private:
+        std::vector<DueDateEntry> entries;
+};
+
+#endif // DUE_DATE_INDEX_H
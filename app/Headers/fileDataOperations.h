@@ -0,0 +1,79 @@
+#ifndef FILE_DATA_OPERATIONS_H
+#define FILE_DATA_OPERATIONS_H
+
+#include <string>
+#include <vector>
+
+#include "./documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @class FileDataOperations
+ * @brief Edits the log4daily file data without any UI.
+ * 
+ * The UI components and the headless console commands both go through these functions,
+ * so a todo, milestone or diary entry added from a script is identical to one added in the UI.
+ * The records they change are marked in the DocumentChanges passed with the data, when there is one.
+ */
+class FileDataOperations {
+    public:
+        /**
+         * @brief Suffix appended to the name of a todo that is done.
+         */
+        static constexpr const char* doneSuffix = " (done)";
+
+        /**
+         * @brief Adds a new todo item and returns its ID.
+         */
+        static int addTodo(FileData *data, const std::string& name, const std::string& description, Date dueDate, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Removes the todo item with the specified ID.
+         */
+        static void removeTodo(FileData *data, int id, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Marks the todo item with the specified ID as done or undone.
+         * 
+         * @return bool True if the todo was found and its state changed.
+         */
+        static bool markTodoDone(FileData *data, int id, bool done, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Marks all todo items with the specified IDs as done.
+         * 
+         * Looks every todo up once, instead of scanning the list for each ID.
+         * 
+         * @return size_t The number of todos that changed.
+         */
+        static size_t markTodosDone(FileData *data, const std::vector<int>& ids, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Marks one occurrence of the recurring todo with the specified ID as done or undone.
+         * 
+         * @param day The day number of the occurrence.
+         * @return bool True if the todo has an occurrence on that day and its state changed.
+         */
+        static bool markOccurrenceDone(FileData *data, int id, int day, bool done, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Checks if the todo item is marked as done.
+         */
+        static bool isTodoDone(const TodoData& todo);
+        /**
+         * @brief Adds a new milestone starting now and returns its ID.
+         */
+        static int addMilestone(FileData *data, const std::string& name, const std::string& description, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Removes the milestone with the specified ID.
+         */
+        static void removeMilestone(FileData *data, int id, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Adds today's progress point to the milestone with the specified ID.
+         * 
+         * @return bool False if the milestone does not exist or already has a progress point for today.
+         */
+        static bool addMilestoneProgressPoint(FileData *data, int id, bool isCompleted, DocumentChanges *changes = nullptr);
+        /**
+         * @brief Adds a new diary entry for today.
+         */
+        static DiaryData addDiaryEntry(FileData *data, const std::string& name, const std::string& content, DocumentChanges *changes = nullptr);
+};
+
+#endif // FILE_DATA_OPERATIONS_H
@@ -0,0 +1,103 @@
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+enum class HistoryEntryKind : uint8_t {
+    // The whole document
+    Checkpoint,
+    // The records added, modified or removed since the save before
+    Diff
+};
+
+/**
+ * @brief One recorded save, as listed by HistoryLog::entries.
+ */
+struct HistoryEntry {
+    // Saves are numbered from 1
+    uint32_t number = 0;
+    HistoryEntryKind kind = HistoryEntryKind::Checkpoint;
+    // Seconds since the epoch
+    int64_t time = 0;
+    uint32_t added = 0;
+    uint32_t modified = 0;
+    uint32_t removed = 0;
+    uint64_t offset = 0;
+    uint32_t size = 0;
+};
+
+/**
+ * @class HistoryLog
+ * @brief Change history of log4daily files, one entry per save in "<name>.l4dhist".
+ *
+ * Every save appends the records added, modified or removed since the save before, by id (calendar days by
+ * their date), and every checkpointInterval saves the whole document. A past save is read back from the
+ * checkpoint before it plus the diffs up to it, so at most checkpointInterval entries are read.
+ *
+ * A hash of every record (its PayloadWriter bytes) is kept from the save before. Only the records marked
+ * in the DocumentChanges of the save are hashed, and written when their hash changed, so a diff costs the
+ * changed records and not the document. The document is compared record by record when its changes are
+ * whole, and on its first save in a process, when the hashes are rebuilt from its history and may be of
+ * another process's save. A checkpoint rehashes every record, so a change that was not marked is not
+ * missed past the next one. Entries are checksummed; a torn last entry is cut off on the next save.
+ * Sharded logs save only some of their shards, so they are not recorded.
+ */
+class HistoryLog {
+    public:
+        static constexpr uint32_t checkpointInterval = 32;
+
+        static std::string path(const std::string& workingDirectory, const std::string& log4FileName);
+        /**
+         * @brief Appends the save of the data to its history, nothing when no record changed.
+         *
+         * @param changes The records changed since the last save of the data.
+         * @return bool False if the history could not be read or written, the error says why.
+         */
+        bool record(const std::string& workingDirectory, const FileData& data, const DocumentChanges& changes, std::string *error);
+        /**
+         * @brief Lists the saves of a history, a missing file has none.
+         *
+         * @return bool False if the file is not a history, entries up to a damaged one are still listed.
+         */
+        static bool entries(const std::string& path, std::vector<HistoryEntry> *entries, std::string *error);
+        /**
+         * @brief Rebuilds the document as it was saved by the save with the number.
+         */
+        static bool at(const std::string& path, uint32_t number, FileData *data, std::string *error);
+        /**
+         * @brief Same as at(), with the entries already listed.
+         */
+        static bool at(const std::string& path, const std::vector<HistoryEntry>& entries, uint32_t number, FileData *data, std::string *error);
+
+    private:
+        /**
+         * @brief Hashes of the records of the last save of one file, by record key, per section.
+         */
+        struct RecordHash {
+            uint64_t hash = 0;
+            // The last save the record was in
+            uint32_t save = 0;
+        };
+        struct TrackedFile {
+            std::array<std::unordered_map<int64_t, RecordHash>, 4> hashes;
+            uint32_t saves = 0;
+            uint32_t sinceCheckpoint = 0;
+            // Where the next entry goes, 0 while the file has no header
+            uint64_t end = 0;
+        };
+
+        bool track(const std::string& path, TrackedFile *tracked, std::string *error);
+        static void hashAll(const FileData& data, TrackedFile *tracked);
+
+        std::unordered_map<std::string, TrackedFile> trackedFiles;
+};
+
+#endif // HISTORY_LOG_H
@@ -1,30 +1,157 @@
 #ifndef HANDLERS_H
 #define HANDLERS_H
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
-#include <algorithm>
+#include <string_view>
 
-struct Command {
-    std::string name;
-    std::string argument;
-
-    bool operator==(const Command& other) const {
-        return name == other.name && argument == other.argument;
-    }
+/**
+ * @brief The supported commands, in the order of supportedCommands.
+ */
+enum class CommandId : uint8_t {
+    Help,
+    New,
+    Open,
+    Delete,
+    AddTodo,
+    Done,
+    AddDiary,
+    Progress,
+    Query,
+    Stats,
+    Daemon,
+    Archive,
+    ArchiveSearch,
+    Shard,
+    CompressDiary,
+    Verify,
+    Repair,
+    History,
+    Merge,
+    SetLanguage,
+    SetTheme,
+    Import,
+    Export,
+    List,
+    // Not a supported command
+    Unknown
 };
 
-static const std::vector<std::string> supportedCommands = {
+inline constexpr std::array<std::string_view, static_cast<size_t>(CommandId::Unknown)> supportedCommands = {
     "--help",
     "--new",
     "--open",
     "--delete",
-    // Will be implemented in the future
-    "--list",
+    "--add-todo",
+    "--done",
+    "--add-diary",
+    "--progress",
+    "--query",
+    "--stats",
+    "--daemon",
+    "--archive",
+    "--archive-search",
+    "--shard",
+    "--compress-diary",
+    "--verify",
+    "--repair",
+    "--history",
+    "--merge",
+    "--set-language",
+    "--set-theme",
     "--import",
     "--export",
-    "--set-theme",
-    "--set-language"   
+    // Will be implemented in the future
+    "--list"
+};
+
+constexpr uint64_t commandHash(std::string_view name, uint64_t seed) {
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    for (char character : name) {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @class CommandTable
+ * @brief Perfect hash table of supportedCommands, built by the compiler.
+ *
+ * The seed is searched at compile time until every command gets a slot of its own, so a lookup is one
+ * hash, one slot and one string comparison. A command added to supportedCommands that no seed can place
+ * fails the build instead of slowing the lookup down.
+ */
+class CommandTable {
+    public:
+        static constexpr int slotBits = 6;
+        static constexpr size_t slotCount = size_t(1) << slotBits;
+
+        // The top bits, the low bits of FNV-1a hardly depend on the seed
+        static constexpr size_t slotOf(std::string_view name, uint64_t seed) {
+            return static_cast<size_t>(commandHash(name, seed) >> (64 - slotBits));
+        }
+
+        static constexpr CommandId find(std::string_view name);
+
+        static consteval bool placesAll(uint64_t seed) {
+            std::array<bool, slotCount> taken{};
+            for (std::string_view name : supportedCommands) {
+                size_t slot = slotOf(name, seed);
+                if (taken[slot]) {
+                    return false;
+                }
+                taken[slot] = true;
+            }
+            return true;
+        }
+
+        static consteval uint64_t findSeed() {
+            for (uint64_t seed = 0; seed < 10000; seed++) {
+                if (placesAll(seed)) {
+                    return seed;
+                }
+            }
+            throw "No seed places every supported command in its own slot";
+        }
+
+        static consteval std::array<uint8_t, slotCount> buildSlots(uint64_t seed) {
+            // The index of the command plus one, 0 is an empty slot
+            std::array<uint8_t, slotCount> slots{};
+            for (size_t i = 0; i < supportedCommands.size(); i++) {
+                slots[slotOf(supportedCommands[i], seed)] = static_cast<uint8_t>(i + 1);
+            }
+            return slots;
+        }
+};
+
+inline constexpr uint64_t commandTableSeed = CommandTable::findSeed();
+inline constexpr std::array<uint8_t, CommandTable::slotCount> commandTableSlots = CommandTable::buildSlots(commandTableSeed);
+
+constexpr CommandId CommandTable::find(std::string_view name) {
+    uint8_t slot = commandTableSlots[slotOf(name, commandTableSeed)];
+    if (slot == 0 || supportedCommands[slot - 1] != name) {
+        return CommandId::Unknown;
+    }
+    return static_cast<CommandId>(slot - 1);
+}
+
+static_assert(CommandTable::find("--open") == CommandId::Open && CommandTable::find("--set-theme") == CommandId::SetTheme);
+static_assert(CommandTable::find("--opem") == CommandId::Unknown && CommandTable::find("") == CommandId::Unknown);
+
+struct Command {
+    std::string name;
+    // First argument of the command, e.g. the log4_file_name
+    std::string argument;
+    // All arguments of the command, including the first one
+    std::vector<std::string> arguments;
+    // Set by filterForSupportedCommands
+    CommandId id = CommandId::Unknown;
+
+    bool operator==(const Command& other) const {
+        return name == other.name && argument == other.argument && arguments == other.arguments;
+    }
 };
 
 class InputHandlers {
@@ -44,7 +171,7 @@ class InputHandlers {
          * @brief Filters a vector of Command structures for supported commands.
          * 
          * This function takes a vector of Command structures and filters out any commands that are not supported.
-         * The supported commands are defined in the supportedCommands vector.
+         * The supported commands are looked up in the CommandTable, which also sets their id.
          * 
          * @param commands The vector of Command structures to filter.
          * @return std::vector<Command> A vector of Command structures containing only supported commands.
@@ -0,0 +1,347 @@
+#ifndef LANGUAGE_H
+#define LANGUAGE_H
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A translatable string, the key is how language packs refer to it.
+ */
+struct LanguageString {
+    std::string_view key;
+    // English text, used when the language pack does not translate the key
+    std::string_view text;
+};
+
+// Every string of the UI and the help. Values with {1}, {2}... are filled in by Language::format()
+inline constexpr LanguageString languageStrings[] = {
+    { "language.name", "English" },
+
+    { "ui.dataIsNull", "Error: Data is null" },
+    { "ui.minimalWidth", "Minimal width: " },
+    { "ui.minimalHeight", "Minimal height: " },
+    { "ui.tooSmall", "Move mouse over app or expand the window to see the content." },
+    { "ui.changesDiscarded", "Changes has been discarded." },
+    { "ui.changesSaved", "Changes has been saved." },
+    { "ui.changesNotSaved", "Changes are not saved: " },
+    { "ui.recordFailed", "The events are not recorded: " },
+
+    { "tab.todos", "Todos" },
+    { "tab.upcoming", "Upcoming" },
+    { "tab.calendar", "Calendar" },
+    { "tab.milestones", "Milestones" },
+    { "tab.diary", "Diary" },
+    { "tab.history", "History" },
+    { "tab.merge", "Merge" },
+    { "tab.memory", "Memory" },
+    { "tab.exit", "Exit" },
+
+    { "date.year", "Year" },
+    { "date.month", "Month" },
+    { "date.day", "Day" },
+    { "date.hour", "Hour" },
+    { "date.minute", "Minute" },
+    { "date.today", "Today" },
+    { "month.january", "January" },
+    { "month.february", "February" },
+    { "month.march", "March" },
+    { "month.april", "April" },
+    { "month.may", "May" },
+    { "month.june", "June" },
+    { "month.july", "July" },
+    { "month.august", "August" },
+    { "month.september", "September" },
+    { "month.october", "October" },
+    { "month.november", "November" },
+    { "month.december", "December" },
+    { "monthShort.january", "Jan" },
+    { "monthShort.february", "Feb" },
+    { "monthShort.march", "Mar" },
+    { "monthShort.april", "Apr" },
+    { "monthShort.may", "May" },
+    { "monthShort.june", "Jun" },
+    { "monthShort.july", "Jul" },
+    { "monthShort.august", "Aug" },
+    { "monthShort.september", "Sep" },
+    { "monthShort.october", "Oct" },
+    { "monthShort.november", "Nov" },
+    { "monthShort.december", "Dec" },
+    { "weekday.monday", "Mon" },
+    { "weekday.tuesday", "Tue" },
+    { "weekday.wednesday", "Wed" },
+    { "weekday.thursday", "Thu" },
+    { "weekday.friday", "Fri" },
+    { "weekday.saturday", "Sat" },
+    { "weekday.sunday", "Sun" },
+    { "weekdayLetter.monday", "M" },
+    { "weekdayLetter.tuesday", "T" },
+    { "weekdayLetter.wednesday", "W" },
+    { "weekdayLetter.thursday", "T" },
+    { "weekdayLetter.friday", "F" },
+    { "weekdayLetter.saturday", "S" },
+    { "weekdayLetter.sunday", "S" },
+
+    { "todos.list", "Todos list:" },
+    { "todos.filter", "Filter, e.g. due < 2026-11-01 and not done and name ~ deploy" },
+    { "todos.empty", "Todo list is empty" },
+    { "todos.noMatch", "No todos match the filter" },
+    { "todos.addHeader", "Add Todo:" },
+    { "todos.title", "Todo Title:" },
+    { "todos.newTodo", "New Todo" },
+    { "todos.description", "Description:" },
+    { "todos.descriptionPlaceholder", "Description" },
+    { "todos.dueDate", "Due Date:" },
+    { "todos.repeat", "Repeat:" },
+    { "todos.repeatPlaceholder", "Repeat, e.g. daily, every 3 days, weekly mon,thu, monthly 15" },
+    { "todos.add", "Add Todo" },
+    { "todos.remove", "Remove Todo" },
+    { "todos.markDone", "Mark Done" },
+    { "todos.selected", "Selected Todo: " },
+    { "todos.noneSelected", "Selected Todo: No todo is selected" },
+    { "todos.dueDateLabel", "Due Date: " },
+    { "todos.dueDateNoneSelected", "Due Date: No Todo selected" },
+    { "todos.descriptionLabel", "Description: " },
+    { "todos.descriptionNoneSelected", "Description: No Todo selected" },
+    { "todos.noDescription", "No description" },
+    { "todos.repeats", " (repeats {1})" },
+
+    { "upcoming.overdue", "Overdue" },
+    { "upcoming.today", "Today" },
+    { "upcoming.thisWeek", "This week" },
+    { "upcoming.later", "Later" },
+    { "upcoming.repeats", " (repeats)" },
+    { "upcoming.more", "... and {1} more" },
+    { "upcoming.nothingDue", "Nothing due" },
+
+    { "calendar.previous", "< Previous" },
+    { "calendar.next", "Next >" },
+    { "calendar.legendOpened", "o opened" },
+    { "calendar.legendDiary", "D diary" },
+    { "calendar.legendTodos", "T todos due (red: open)" },
+    { "calendar.legendPoints", "P completed/progress points" },
+
+    { "milestones.list", "Milestones list:" },
+    { "milestones.empty", "Milestones list is empty" },
+    { "milestones.progressPoints", "Progress Points:" },
+    { "milestones.addHeader", "Add Milestone:" },
+    { "milestones.title", "Milestone Title:" },
+    { "milestones.newMilestone", "New Milestone" },
+    { "milestones.description", "Description:" },
+    { "milestones.descriptionPlaceholder", "Description" },
+    { "milestones.add", "Add Milestone" },
+    { "milestones.remove", "Remove Milestone" },
+    { "milestones.selected", "Selected Milestone: " },
+    { "milestones.noneSelected", "Selected Milestone: No milestone is selected" },
+    { "milestones.descriptionLabel", "Description: " },
+    { "milestones.descriptionNoneSelected", "Description: No Milestone selected" },
+    { "milestones.noDescription", "No description" },
+    { "milestones.nothingSelected", "No milestones selected" },
+    { "milestones.addProgressPointHeader", "Add Progress Point:" },
+    { "milestones.completed", "Completed" },
+    { "milestones.addProgressPoint", "Add Progress Point" },
+    { "milestones.progressPointExists", "A progress point for today already exists" },
+    { "milestones.legend", "Progress Points Legend:" },
+    { "milestones.legendCompleted", "Green Box: Completed" },
+    { "milestones.legendNotCompleted", "Red Box: Not Completed" },
+    { "milestones.legendNotAdded", "Blue Box: Not Added" },
+    { "milestones.legendUpcoming", "Gray Box: Upcoming Day" },
+    { "milestones.stats", "Stats:" },
+    { "milestones.statsStreak", "Current streak: {1} day(s), longest: {2} day(s)" },
+    { "milestones.statsRecent", "Last 7 days: {1}  Last {2} days: {3}" },
+    { "milestones.statsAllTime", "All time: {1} of recorded days completed" },
+    { "milestones.statsWeekdays", "Completed by weekday:" },
+    { "milestones.previousYear", "<< Year" },
+    { "milestones.previousMonth", "< Month" },
+    { "milestones.nextMonth", "Month >" },
+    { "milestones.nextYear", "Year >>" },
+
+    { "diary.addHeader", "Add Today Entry:" },
+    { "diary.newEntryName", "New Entry Name: " },
+    { "diary.newEntryContent", "New Entry Content: " },
+    { "diary.add", "Add Entry" },
+    { "diary.label", "Diary: " },
+    { "diary.invalidDate", "Invalid Date" },
+    { "diary.position", "Lines {1}-{2} of {3} (PageUp/PageDown to scroll)" },
+
+    { "history.saves", "Saves:" },
+    { "history.empty", "No saves recorded yet" },
+    { "history.unreadable", "Could not read the history: " },
+    { "history.save", "Save #{1} ({2})" },
+    { "history.checkpoint", "Stored whole: {1} added, {2} modified, {3} removed since the save before" },
+    { "history.diff", "Stored as a diff: {1} added, {2} modified, {3} removed since the save before" },
+    { "history.days", "Days opened: {1}" },
+    { "history.todos", "Todos ({1}):" },
+    { "history.milestones", "Milestones ({1}):" },
+    { "history.diary", "Diary entries ({1}):" },
+
+    { "merge.conflicts", "Conflicts:" },
+    { "merge.empty", "No merge conflicts" },
+    { "merge.unreadable", "Could not read the merge conflicts: " },
+    { "merge.mine", "Mine:" },
+    { "merge.theirs", "Theirs:" },
+    { "merge.removed", "Removed" },
+    { "merge.due", "Due: " },
+    { "merge.points", "Progress points: {1} ({2} completed)" },
+    { "merge.keepMine", "Keep Mine" },
+    { "merge.takeTheirs", "Take Theirs" },
+    { "memory.header", "Memory used by the document and the copies the tabs keep of it" },
+    { "memory.note", "Strings: text too long for the small string buffer. Slack: capacity beyond the size." },
+    { "memory.refresh", "Refresh" },
+    { "memory.compact", "Compact" },
+    { "memory.reclaimed", "Reclaimed {1}." },
+    { "memory.section", "Section" },
+    { "memory.records", "Records" },
+    { "memory.used", "Used" },
+    { "memory.strings", "Strings" },
+    { "memory.slack", "Slack" },
+    { "memory.total", "Total" },
+    { "memory.calendar", "Calendar" },
+    { "memory.todos", "Todos" },
+    { "memory.milestones", "Milestones" },
+    { "memory.progressPoints", "Progress points" },
+    { "memory.diary", "Diary" },
+    { "memory.document", "Document" },
+    { "memory.copies", "UI copies" },
+    { "memory.savedCopy", "Saved copy" },
+    { "memory.todosList", "Todos list" },
+    { "memory.milestonesList", "Milestones list" },
+    { "memory.diaryEntries", "Diary entries" },
+    { "merge.saveNote", "Taken versions are saved with your other changes (Exit > Save Changes)" },
+
+    { "exit.selectAction", "Select action:" },
+    { "exit.save", "Save Changes" },
+    { "exit.discard", "Discard Changes" },
+    { "exit.exit", "Exit Log4Daily" },
+
+    { "help.usage", "Usage: log4daily [command] [log4_file_name]" },
+    { "help.commands", "Commands:" },
+    { "help.new", "Create a new log4daily file, [sharded] stores it as one shard per year" },
+    { "help.open", "Open an existing log4daily file, [all] opens every year of a sharded one, [verify] checks what it reads" },
+    { "help.delete", "Delete an existing log4daily file" },
+    { "help.addTodo", "Add todos: title<TAB>description<TAB>YYYY-MM-DD HH:MM<TAB>repeat" },
+    { "help.done", "Mark todos as done: todo_id[<TAB>YYYY-MM-DD]" },
+    { "help.addDiary", "Add today's diary entries: title<TAB>content" },
+    { "help.progress", "Add today's progress points: milestone_id<TAB>1|0" },
+    { "help.query", "Print todos matching a query, e.g. \"due < 2026-11-01 and not done and name ~ deploy\"" },
+    { "help.stats", "Print streak and completion stats of every milestone, with \"memory\" the memory of every section" },
+    { "help.archive", "Archive done todos and inactive milestones older than [days] (90) and diary entries older than [diary_days] (365)" },
+    { "help.archiveSearch", "Print archived todos, milestones and diary entries containing a text" },
+    { "help.shard", "Convert a log4daily file into a directory with one shard per year" },
+    { "help.verify", "Check the log4daily file against the checksums written when it was saved" },
+    { "help.repair", "Copy every intact record of a damaged log4daily file into <log4_file_name>-repaired" },
+    { "help.history", "List the saves of a log4daily file, or print it as JSON as of [save_number]" },
+    { "help.merge", "Merge another copy (.l4d) of [log4_file_name] or the opened file into it, and write the result to both" },
+    { "help.compressDiary", "Store the diary entries compressed, or as plain text again with [off]" },
+    { "help.daemon", "Keep log4daily files loaded in memory for other commands, or stop/flush it" },
+    { "help.list", "List out all existing log4daily files" },
+    { "help.import", "Add todos from a CSV file (title,description,due,repeat), to [log4_file_name] or the opened file" },
+    { "help.export", "Write [log4_file_name] or the opened file as JSON" },
+    { "help.setTheme", "Set the theme of the application from a theme file, or back to [default]" },
+    { "help.setLanguage", "Set the language of the application from a language pack, or back to [en]" },
+    { "help.help", "Show this help message" },
+    { "help.noteFileName", "Note: log4_file_name should not contain spaces." },
+    { "help.noteBatch", "Note: records of --add-todo, --done, --add-diary and --progress are read from stdin (one per line)," },
+    { "help.noteBatchSaved", "      or taken from the arguments after log4_file_name. The file is saved once per batch." },
+    { "help.notePipeline", "Note: commands run in order on one loaded file, which is saved once at the end, e.g." },
+    { "help.notePipelineExample", "      log4daily --open work --import todos.csv --export work.json" },
+    { "help.noteTrace", "Note: set LOG4DAILY_TRACE=path to write a Chrome trace of the run to the path at exit." },
+    { "help.noteRecord", "Note: set LOG4DAILY_RECORD=path to record the events of the UI session, l4d-replay replays them." },
+    { "help.noteNiy", "'NIY': Not implemented yet." },
+};
+
+inline constexpr size_t languageStringCount = std::size(languageStrings);
+
+/**
+ * @brief FNV-1a hash of a key, the compiled language packs store keys only as this hash.
+ */
+constexpr uint64_t languageKeyHash(std::string_view key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char character : key) {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Position of a key in languageStrings, resolved at compile time.
+ *
+ * Converts implicitly from a string literal, so Language::text("todos.add") compiles to an array access,
+ * and a key that is not in languageStrings fails to compile.
+ */
+class StringId {
+    public:
+        consteval StringId(const char* key) : index(find(key)) {}
+
+        uint16_t index;
+    private:
+        static consteval uint16_t find(std::string_view key) {
+            uint64_t hash = languageKeyHash(key);
+            for (size_t i = 0; i < languageStringCount; i++) {
+                if (languageKeyHash(languageStrings[i].key) == hash) {
+                    return static_cast<uint16_t>(i);
+                }
+            }
+            throw "Unknown language string key";
+        }
+};
+
+/**
+ * @brief What compiling a language pack found.
+ */
+struct LanguagePackReport {
+    // Keys of languageStrings the pack translates
+    size_t translated = 0;
+    // Unknown keys and repeated keys, with their line numbers
+    std::vector<std::string> warnings;
+};
+
+/**
+ * @class Language
+ * @brief Strings of the UI in the language set with --set-language.
+ *
+ * Language packs are text files with one "key = text" per line, a text in quotes keeps its leading and trailing
+ * spaces, lines starting with # are comments. --set-language compiles a pack into a binary
+ * table in the config folder: a header, entries of (key hash, offset, length) sorted by hash, then the texts.
+ * The table is memory-mapped once at startup (read into a buffer where there is no mmap) and resolved into one
+ * string per StringId, keys the pack does not translate keep their English text. After that a string is one
+ * array access, with no lookups or allocations per frame.
+ */
+class Language {
+    public:
+        static constexpr const char* compiledFileName = "language.l4dl";
+        static constexpr const char* packExtension = ".lang";
+
+        static const std::string& text(StringId id) {
+            return table[id.index];
+        }
+        /**
+         * @brief Returns the text with {1}, {2}... replaced by the values.
+         */
+        static std::string format(StringId id, std::initializer_list<std::string_view> values);
+
+        /**
+         * @brief Compiles a language pack into the binary table read by load().
+         *
+         * @return bool False if a line is not "key = text" or the table could not be written, the error says why.
+         */
+        static bool compile(std::istream& source, const std::string& outputPath, LanguagePackReport *report, std::string *error);
+        /**
+         * @brief Maps a compiled table and uses its texts, a missing file keeps English without an error.
+         *
+         * @return bool False if the table exists but is damaged, English is used then.
+         */
+        static bool load(const std::string& path, std::string *error);
+        /**
+         * @brief Goes back to the English texts.
+         */
+        static void useDefault();
+    private:
+        static std::array<std::string, languageStringCount> table;
+};
+
+#endif // LANGUAGE_H
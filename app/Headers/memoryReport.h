@@ -0,0 +1,100 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Bytes held by one part of the document, or by a copy of it the UI keeps.
+ */
+struct MemoryUsage {
+    size_t records = 0;
+    // The records themselves, sizeof of each
+    size_t used = 0;
+    // Text of strings too long for their small string buffer, kept on the heap
+    size_t strings = 0;
+    // Capacity of vectors and strings beyond their size
+    size_t slack = 0;
+
+    size_t total() const;
+    MemoryUsage& operator+=(const MemoryUsage& other);
+};
+
+struct MemoryRow {
+    std::string name;
+    MemoryUsage usage;
+    // Copies the UI keeps besides the document
+    bool shadow = false;
+};
+
+/**
+ * @class MemoryReport
+ * @brief Memory accounting of a log4daily document per section (--stats name memory and the Memory tab).
+ *
+ * Sizes are what the containers hold, not what the allocator adds to them. Compacting shrinks every vector
+ * and string to its size, which reclaims the slack left by growing them record by record.
+ */
+class MemoryReport {
+    public:
+        static MemoryUsage of(const std::string& text);
+        static MemoryUsage of(const TodoData& todo);
+        /**
+         * @brief The strings of a milestone, its progress points are counted as a section of their own.
+         */
+        static MemoryUsage of(const MilestonesData& milestone);
+        static MemoryUsage of(const DiaryData& entry);
+        template <typename T>
+        static MemoryUsage of(const std::vector<T>& records) {
+            MemoryUsage usage;
+            usage.records = records.size();
+            usage.used = records.size() * sizeof(T);
+            usage.slack = (records.capacity() - records.size()) * sizeof(T);
+            if constexpr (!std::is_trivially_copyable_v<T>) {
+                for (const auto& record : records) {
+                    usage += of(record);
+                }
+            }
+            return usage;
+        }
+
+        /**
+         * @brief One row per section: calendar, todos, milestones, their progress points and diary.
+         */
+        static std::vector<MemoryRow> document(const FileData& data);
+        static MemoryUsage total(const std::vector<MemoryRow>& rows);
+
+        /**
+         * @brief Shrinks every vector and string of the data to its size.
+         *
+         * @return size_t The bytes reclaimed.
+         */
+        static size_t compact(FileData *data);
+        static size_t compact(std::string *text);
+        static size_t compact(TodoData *todo);
+        static size_t compact(MilestonesData *milestone);
+        static size_t compact(DiaryData *entry);
+        template <typename T>
+        static size_t compact(std::vector<T> *records) {
+            size_t reclaimed = 0;
+            if constexpr (!std::is_trivially_copyable_v<T>) {
+                for (auto& record : *records) {
+                    reclaimed += compact(&record);
+                }
+            }
+            size_t capacity = records->capacity();
+            records->shrink_to_fit();
+            return reclaimed + (capacity - records->capacity()) * sizeof(T);
+        }
+
+        static std::string formatBytes(size_t bytes);
+        /**
+         * @brief Formats the rows as a table in the language of the UI, shared by the Memory tab and the --stats command.
+         */
+        static std::vector<std::string> describe(const std::vector<MemoryRow>& rows);
+};
+
+#endif // MEMORY_REPORT_H
@@ -0,0 +1,78 @@
+#ifndef MILESTONE_STATS_H
+#define MILESTONE_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Streak and completion figures of one milestone.
+ */
+struct MilestoneSummary {
+    int currentStreak = 0;
+    int longestStreak = 0;
+    int recordedDays = 0;
+    int completedDays = 0;
+    int completedLastWeek = 0;
+    int completedLastMonth = 0;
+    // Indexed by weekday, 0 is Monday
+    std::array<int, 7> completedByWeekday{};
+    std::array<int, 7> recordedByWeekday{};
+};
+
+/**
+ * @class MilestoneStats
+ * @brief Progress points of one milestone packed into per-day bitsets.
+ * 
+ * Bit i of the sets stands for the day firstDay + i. One set marks the days with a progress
+ * point and the other the completed ones, so streaks, window counts and weekday distributions
+ * are popcounts and bit scans over 64 days at a time. Adding a point updates the totals in place;
+ * the summary is only recomputed when it is read after a change or on a new day.
+ */
+class MilestoneStats {
+    public:
+        /**
+         * @brief Length of the "last month" window in days.
+         */
+        static constexpr int monthWindow = 30;
+
+        MilestoneStats() {};
+        /**
+         * @brief Rebuilds the bitsets from all progress points of the milestone.
+         */
+        void rebuild(const MilestonesData& milestone);
+        /**
+         * @brief Adds a single progress point, a later point for the same day replaces the earlier one.
+         */
+        void addPoint(const MilestoneProgressPoint& point);
+        /**
+         * @brief Returns the summary as of the given day (day number, see DateUtils::dayNumber).
+         */
+        const MilestoneSummary& summary(int today);
+        /**
+         * @brief Formats the summary as lines of text in the language of the UI, shared by the stats panel and the --stats command.
+         */
+        static std::vector<std::string> describe(const MilestoneSummary& summary);
+    private:
+        void ensureDay(int day);
+        bool testBit(const std::vector<uint64_t>& bits, int day) const;
+        int countRange(const std::vector<uint64_t>& bits, int firstDay, int lastDay) const;
+        int runEndingAt(int day) const;
+        int longestRun() const;
+        void countWeekdays();
+
+        int firstDay = 0;
+        std::vector<uint64_t> recorded;
+        std::vector<uint64_t> completed;
+
+        int longestStreak = 0;
+        bool longestStreakStale = false;
+        bool summaryStale = true;
+        int summaryDay = 0;
+        MilestoneSummary cachedSummary;
+};
+
+#endif // MILESTONE_STATS_H
@@ -0,0 +1,135 @@
+#ifndef RECURRENCE_H
+#define RECURRENCE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+enum class RecurrenceKind {
+    None,
+    // Every interval days
+    Days,
+    // On the weekdays of the mask
+    Weekly,
+    // On a day of the month
+    Monthly
+};
+
+/**
+ * @brief When a recurring todo comes back, counted from its due date (the first occurrence).
+ */
+struct RecurrenceRule {
+    RecurrenceKind kind = RecurrenceKind::None;
+    int interval = 1;
+    // Bit 0 is Monday, bit 6 is Sunday
+    uint8_t weekdays = 0;
+    // Moved to the last day of shorter months
+    int monthDay = 1;
+
+    bool operator==(const RecurrenceRule& other) const = default;
+};
+
+/**
+ * @brief One occurrence of a recurring todo, expanded on demand.
+ */
+struct Occurrence {
+    // Position of the recurring todo in FileData::todosData
+    uint32_t position;
+    int day;
+    bool done;
+};
+
+/**
+ * @class Recurrence
+ * @brief Recurrence rules stored on a todo, with its done occurrences.
+ *
+ * TodoData has no room for a rule, so like the done suffix on the name, the rule is kept in the
+ * description, on a last line "~repeat: <rule>". Done occurrences follow on a line "~done: <days>",
+ * stored sparsely as days and ranges of days, e.g. "2026-10-01..2026-10-05 2026-10-08".
+ * Occurrences themselves are never stored, they are expanded for the days that are looked at.
+ *
+ * Rules: "daily", "every N days", "weekly" or "weekly mon,wed,fri", "monthly" or "monthly 15".
+ * A recurring todo marked done (done suffix) has ended and has no more occurrences.
+ */
+class Recurrence {
+    public:
+        static constexpr const char* ruleTag = "\n~repeat: ";
+        static constexpr const char* doneTag = "\n~done: ";
+
+        /**
+         * @brief Parses a rule, for a series starting on startDay (whose weekday or day of the month is the default).
+         *
+         * @return bool False if the text is not a rule, with the problem in error.
+         */
+        static bool parseRule(std::string_view text, int startDay, RecurrenceRule *rule, std::string *error);
+        static std::string formatRule(const RecurrenceRule& rule);
+
+        static bool isRecurring(const TodoData& todo);
+        static RecurrenceRule rule(const TodoData& todo);
+        /**
+         * @brief Returns the description as the user wrote it, without the rule and the done occurrences.
+         */
+        static std::string description(const TodoData& todo);
+        /**
+         * @brief Makes the todo recurring with the rule, or a plain todo again with RecurrenceKind::None.
+         */
+        static void setRule(TodoData *todo, const RecurrenceRule& rule);
+
+        /**
+         * @brief Returns the done occurrences as sorted, separate ranges of day numbers.
+         */
+        static std::vector<std::pair<int, int>> doneDays(const TodoData& todo);
+        /**
+         * @brief Marks the occurrence on the day as done or not done.
+         *
+         * @return bool False if the todo has no occurrence on that day or it already was in that state.
+         */
+        static bool markOccurrenceDone(TodoData *todo, int day, bool done);
+        static bool isOccurrence(const RecurrenceRule& rule, int startDay, int day);
+        /**
+         * @brief Finds the first occurrence on or after fromDay that is not done, looking a year ahead.
+         *
+         * @return bool False if the todo has ended or has no open occurrence in that year.
+         */
+        static bool nextOpenOccurrence(const TodoData& todo, int fromDay, int *day);
+
+        /**
+         * @brief Returns the occurrence as a todo of its own, due on the day, for the query and the lists.
+         */
+        static TodoData occurrence(const TodoData& todo, int day, bool done);
+};
+
+/**
+ * @class RecurrenceIndex
+ * @brief The recurring todos of a list with their parsed rules, for expanding occurrences of a window.
+ *
+ * Rules and done days are parsed once by rebuild(), so expanding is plain day arithmetic.
+ */
+class RecurrenceIndex {
+    public:
+        void rebuild(const std::vector<TodoData>& todos);
+        bool isSeries(uint32_t position) const;
+        size_t size() const;
+        /**
+         * @brief Appends the occurrences on the days [firstDay, lastDay] of every recurring todo that has not ended.
+         *
+         * Occurrences are grouped by todo, in the order of the todos list, and sorted by day within a todo.
+         */
+        void expand(int firstDay, int lastDay, std::vector<Occurrence> *occurrences) const;
+    private:
+        struct Series {
+            uint32_t position;
+            int startDay;
+            RecurrenceRule rule;
+            std::vector<std::pair<int, int>> doneDays;
+        };
+
+        std::vector<Series> series;
+        std::vector<bool> seriesPositions;
+};
+
+#endif // RECURRENCE_H
@@ -0,0 +1,99 @@
+#ifndef SHARDED_STORE_H
+#define SHARDED_STORE_H
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "./blockChecksums.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Which shards of a sharded log are opened.
+ */
+enum class ShardScope {
+    // Todos and milestones, without their progress points
+    Active,
+    // The active shard plus the current and the previous year
+    Recent,
+    // Every shard
+    All
+};
+
+/**
+ * @class ShardedStore
+ * @brief Stores a log4daily file as a directory of shards, so a decade of daily use is not one monolithic file.
+ *
+ * The directory "<name>.shards" holds an active shard with the todos and milestones (without progress points)
+ * and one shard per year with that year's calendar days, diary entries and progress points. Every shard is a
+ * log4daily file of its own, written through LocalStorage with a config of the directory, and a small manifest
+ * lists the year shards.
+ *
+ * Opening reads only the shards of the scope. Saving splits the data again and rewrites only the shards whose
+ * content changed since they were read. Records that land in a year that was not opened are added to the
+ * records already stored in that year's shard.
+ *
+ * Every shard has its own checksums (BlockChecksums), so opening with verification only checks the shards it reads.
+ */
+class ShardedStore {
+    public:
+        ShardedStore(std::string workingDirectory, std::string configName);
+
+        static std::string directoryName(const std::string& log4FileName);
+        bool isSharded(const std::string& log4FileName) const;
+        /**
+         * @brief Creates an empty sharded log.
+         *
+         * @return bool False if the directory already exists or could not be created.
+         */
+        bool create(const std::string& log4FileName);
+        /**
+         * @brief Deletes the sharded log with all its shards.
+         */
+        bool remove(const std::string& log4FileName);
+        /**
+         * @brief Opens the shards of the scope and joins them into one FileData.
+         *
+         * @param reports When not nullptr, every shard read is checked against its checksums, its report added here
+         *                and the records of its damaged blocks left out. Unreadable shards are skipped.
+         * @return FileData The joined data, or an empty FileData if the log does not exist.
+         */
+        FileData open(const std::string& log4FileName, ShardScope scope, std::vector<VerifyReport> *reports = nullptr);
+        /**
+         * @brief Writes the shards whose content changed.
+         *
+         * Data that was not read with open() is taken as the whole log, e.g. when a file is converted.
+         *
+         * @return size_t The number of shards written.
+         */
+        size_t save(const FileData& data);
+        /**
+         * @brief Returns the years that have a shard, from the manifest.
+         */
+        std::vector<int> years(const std::string& log4FileName) const;
+    private:
+        /**
+         * @brief What was read of a sharded log, to tell changed shards apart on save.
+         */
+        struct OpenedLog {
+            bool allYears = false;
+            std::set<int> years;
+            // Shard name -> hash of the content last read or written
+            std::map<std::string, size_t> fingerprints;
+            // Stored records of years that were not opened, kept once records were added to them
+            std::map<int, FileData> storedRecords;
+        };
+
+        std::string shardDirectory(const std::string& log4FileName) const;
+        std::string manifestPath(const std::string& log4FileName) const;
+        void writeManifest(const std::string& log4FileName, const std::vector<int>& years) const;
+
+        std::string workingDirectory;
+        std::string configName;
+        std::map<std::string, OpenedLog> opened;
+};
+
+#endif // SHARDED_STORE_H
@@ -0,0 +1,115 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ThemeColorKind : uint8_t {
+    // The terminal's own color, no escape sequence at all
+    Default,
+    Palette16,
+    Palette256,
+    Rgb
+};
+
+/**
+ * @brief A color of a theme, kept without FTXUI so themes can be checked by the command line.
+ */
+struct ThemeColor {
+    ThemeColorKind kind = ThemeColorKind::Default;
+    // Palette index of Palette16 and Palette256 colors
+    uint8_t index = 0;
+    uint8_t red = 0;
+    uint8_t green = 0;
+    uint8_t blue = 0;
+
+    bool operator==(const ThemeColor& other) const = default;
+};
+
+/**
+ * @brief What a theme color is used for.
+ */
+enum class ThemeRole : uint8_t {
+    Error,
+    CalendarOpened,
+    CalendarDiary,
+    TodosOpen,
+    TodosDone,
+    CalendarPoints,
+    PointCompleted,
+    PointNotCompleted,
+    PointNotAdded,
+    PointUpcoming,
+    Save,
+    Discard,
+    Exit,
+    Count
+};
+
+inline constexpr size_t themeRoleCount = static_cast<size_t>(ThemeRole::Count);
+
+enum class ThemeProfile : uint8_t {
+    Full,
+    // For slow links: 16 colors only and a plain frame, so a frame needs few escape sequences
+    LowCost
+};
+
+/**
+ * @brief A parsed theme, turned into FTXUI colors once when the UI starts.
+ */
+struct Theme {
+    std::string name = "Default";
+    ThemeProfile profile = ThemeProfile::Full;
+    // Colors of the frame gradient, one color is a plain frame and none leaves the frame uncolored
+    std::vector<ThemeColor> frame;
+    int frameAngle = 45;
+    std::array<ThemeColor, themeRoleCount> colors;
+
+    const ThemeColor& color(ThemeRole role) const {
+        return colors[static_cast<size_t>(role)];
+    }
+};
+
+/**
+ * @class ThemeFile
+ * @brief Reads themes from theme files.
+ *
+ * A theme file has one "key = value" per line, lines starting with # are comments:
+ * "name", "profile" (full or low-cost), "frame" (up to 8 colors of the frame gradient, or none),
+ * "frame.angle" and "color.<role>" for every ThemeRole. Colors are FTXUI palette names such as
+ * "BlueLight" or "DeepSkyBlue1", a 256 color palette index, "#rrggbb" or "default". Keys left out
+ * keep the colors of the default theme.
+ *
+ * --set-theme checks a theme file and copies it into the config folder, it is parsed once per start.
+ */
+class ThemeFile {
+    public:
+        static constexpr const char* storedFileName = "theme.l4dtheme";
+        static constexpr const char* themeExtension = ".theme";
+
+        /**
+         * @brief Returns the theme the UI used before themes existed.
+         */
+        static Theme defaults();
+        /**
+         * @brief Parses a theme file over the default theme.
+         *
+         * @return bool False if a line or a color is invalid, the error says which.
+         */
+        static bool parse(std::istream& source, Theme *theme, std::vector<std::string> *warnings, std::string *error);
+        /**
+         * @brief Reads the stored theme, a missing file gives the default theme without an error.
+         */
+        static bool load(const std::string& path, Theme *theme, std::string *error);
+        static bool parseColor(std::string_view text, ThemeColor *color);
+        /**
+         * @brief Returns the closest of the 16 basic colors, which have the shortest escape sequences.
+         */
+        static ThemeColor toPalette16(const ThemeColor& color);
+};
+
+#endif // THEME_H
@@ -0,0 +1,125 @@
+#ifndef TODO_QUERY_H
+#define TODO_QUERY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "./dueDateIndex.h"
+#include "./recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+enum class QueryField {
+    DueDate,
+    CreateDate,
+    Done,
+    Name,
+    Description
+};
+
+enum class QueryOperator {
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+    Contains
+};
+
+enum class QueryNodeKind {
+    And,
+    Or,
+    Not,
+    DateRange,
+    Text,
+    IsDone
+};
+
+/**
+ * @brief Node of a compiled query, children are indexes into TodoQuery's node list.
+ * 
+ * Date comparisons are compiled into the range of date keys they accept, so evaluating
+ * them is two integer comparisons.
+ */
+struct QueryNode {
+    QueryNodeKind kind;
+    QueryField field = QueryField::Done;
+    QueryOperator op = QueryOperator::Equal;
+    bool negated = false;
+    long long minKey = 0;
+    long long maxKey = 0;
+    std::string text = "";
+    int left = -1;
+    int right = -1;
+};
+
+/**
+ * @class TodoQuery
+ * @brief Filter expression over todos, compiled once and evaluated per todo.
+ * 
+ * Syntax: comparisons joined with "and", "or", "not" and parentheses, e.g.
+ *   due < 2026-11-01 and not done and name ~ deploy
+ * 
+ * Fields: due, created (dates as YYYY-MM-DD [HH:MM]), name, description (text), done.
+ * Operators: < <= > >= = != on dates, = != ~ (contains, case insensitive) on text.
+ * A date without a time covers the whole day, so "due = 2026-11-01" matches any time that day.
+ */
+class TodoQuery {
+    public:
+        TodoQuery() {};
+        /**
+         * @brief Compiles the expression into a query.
+         * 
+         * @param expression The query text, an empty expression matches every todo.
+         * @param query The compiled query, only changed when the expression is valid.
+         * @param error Set to a description of the problem when the expression is invalid.
+         * @return bool True if the expression is valid.
+         */
+        static bool compile(const std::string& expression, TodoQuery *query, std::string *error);
+        /**
+         * @brief Checks if the todo matches the query.
+         */
+        bool matches(const TodoData& todo) const;
+        /**
+         * @brief Returns the positions of the matching todos, in the order of the todos list.
+         * 
+         * When the query limits the due date and an index is given, only the todos in that due date
+         * range are evaluated instead of the whole list.
+         */
+        std::vector<uint32_t> run(const std::vector<TodoData>& todos, const DueDateIndex *index = nullptr) const;
+        /**
+         * @brief Returns the matching occurrences of the recurring todos, each as a todo of its own.
+         * 
+         * Occurrences are only expanded for the due date range of the query, up to a year after today
+         * when the range has no end, and for the coming week when the query does not limit the due date.
+         * The recurring todos themselves are left to run() and should be skipped by the caller.
+         */
+        std::vector<TodoData> runOccurrences(const std::vector<TodoData>& todos, const RecurrenceIndex& recurrences, int today) const;
+        /**
+         * @brief Checks if the query has no conditions and matches every todo.
+         */
+        bool empty() const;
+        /**
+         * @brief Formats a todo as one line of the --query output: id, due, done|open, name and description, tab separated.
+         *
+         * Line breaks, tabs and backslashes in the name and the description are escaped as \n, \t and \\,
+         * the escapes --add-todo reads, so every todo stays on one line.
+         */
+        static std::string formatMatch(const TodoData& todo);
+    private:
+        friend class QueryParser;
+
+        bool evaluate(int node, const TodoData& todo) const;
+        int orderByCost(int node = -1);
+        void planDueRange();
+
+        std::vector<QueryNode> nodes;
+        int root = -1;
+        bool hasDueRange = false;
+        long long dueMinKey = 0;
+        long long dueMaxKey = 0;
+};
+
+#endif // TODO_QUERY_H
@@ -2,30 +2,143 @@
 #define UI_RENDERER_H
 
 #include <string>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // Log4daily components
 #include "./applicationManager.h"
+#include "./upcomingIndex.h"
+#include "./calendarIndex.h"
+#include "./documentChanges.h"
 
 #include "../../l4dFiles/out/l4dFiles.hpp"
 
 // FTXUI component
 #include "ftxui/component/component.hpp"
+#include "ftxui/component/screen_interactive.hpp"
+
+// UI components
+#include "./Interface/todosComponent.h"
+#include "./Interface/upcomingComponent.h"
+#include "./Interface/calendarComponent.h"
+#include "./Interface/milestonesComponent.h"
+#include "./Interface/diaryComponent.h"
+#include "./Interface/historyComponent.h"
+#include "./Interface/mergeComponent.h"
+#include "./Interface/memoryComponent.h"
+#include "./Interface/eventRecorder.h"
 
 using namespace ftxui;
 
+/**
+ * @brief Latency of one replayed event, in milliseconds.
+ */
+struct ReplayedEvent {
+    size_t index = 0;
+    // Whether a component handled the event
+    bool handled = false;
+    double handleMs = 0;
+    // The frame drawn after the event
+    double renderMs = 0;
+};
+
 class uiRenderer {
     public:
         uiRenderer(ApplicationManager *_applicationManager);
-        int renderUI(int isReload);
+        /**
+         * @brief Runs the UI loop until the user exits the application.
+         * 
+         * The screen and the component tree are built once and kept alive for the whole session.
+         * Saving and discarding changes happen inside the loop and refresh the components in place.
+         */
+        void renderUI();
+        /**
+         * @brief Runs recorded events through the components without a terminal, drawing a frame after each.
+         *
+         * Stops early when an event exits the application. The day tick is not started, so with the clock
+         * fixed (DateUtils::fixClock) every replay of the same events on the same file does the same work.
+         *
+         * @param width The size of the frames until the events resize it.
+         */
+        std::vector<ReplayedEvent> replay(const std::vector<RecordedEvent>& events, int width, int height);
+        /**
+         * @brief Gets the file data as the UI holds it, with the changes not saved yet.
+         */
+        FileData getInUseFileData();
         void discardFileData();
         void saveFileData();
         void exit();
     private:
+        /**
+         * @brief Builds the component tree of the session, shared by the UI loop and replays.
+         */
+        Component buildComponents();
+        /**
+         * @brief Rebuilds the components' list data from the in use file data.
+         * 
+         * Used after the in use file data has been replaced, so the already built components show the new document.
+         */
+        void refreshComponents();
+        /**
+         * @brief Shows a notification under the tabs for a few seconds.
+         */
+        void notify(const std::string& message);
+        /**
+         * @brief Starts the thread that wakes the loop up when the day changes, so the Upcoming buckets move on,
+         * and when a notification expires, so it disappears.
+         *
+         * It posts to the screen of this renderer and is stopped and joined as soon as the loop returns.
+         */
+        void startDayTick();
+        /**
+         * @brief Memory of every section of the in use file data, then of the copies the UI keeps of it.
+         */
+        std::vector<MemoryRow> measureMemory();
+        /**
+         * @brief Shrinks the in use file data and its copies to their size, returns the bytes reclaimed.
+         */
+        size_t compactMemory();
+
         ApplicationManager *applicationManager;
-        ScreenInteractive *screen_ptr;
+        ScreenInteractive screen;
         FileData inUseFileData;
         FileData inUseFileDataBeforeSave;
-        int reloadUI = 0;
+        // The records changed since the last save, marked by the Todos, Milestones and Diary tabs
+        DocumentChanges inUseChanges;
+
+        TodosComponent todosComponent;
+        UpcomingComponent upcomingComponent;
+        CalendarComponent calendarComponent;
+        MilestonesComponent milestonesComponent;
+        DiaryComponent diaryComponent;
+        HistoryComponent historyComponent;
+        MergeComponent mergeComponent;
+        MemoryComponent memoryComponent;
+
+        // Open todos by due date, shared by the Todos and the Upcoming tab
+        UpcomingIndex upcomingIndex;
+        // Per-day aggregates of every section, kept up to date by the Todos, Diary and Milestones tabs
+        CalendarIndex calendarIndex;
+        // Guards notificationWakeUp, shared by notify() and the day tick
+        std::mutex tickMutex;
+        std::condition_variable_any tickWakeUp;
+        std::chrono::steady_clock::time_point notificationWakeUp = std::chrono::steady_clock::time_point::max();
+        std::jthread dayTick;
+
+        std::vector<std::string> tabLabels;
+        int selectedTab = 0;
+        // Set by LOG4DAILY_RECORD, records the events of the session
+        EventRecorder recorder;
+        // Frames of a replay are drawn at this size instead of the terminal's
+        bool replaying = false;
+        int replayWidth = 0;
+        int replayHeight = 0;
+        bool exitRequested = false;
+        std::string notificationText = "";
+        std::chrono::steady_clock::time_point notificationExpiry;
 };
 
-#endif // UI_RENDERER_H
\ No newline at end of file
+#endif // UI_RENDERER_H
@@ -0,0 +1,82 @@
+#ifndef UPCOMING_INDEX_H
+#define UPCOMING_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+enum class UpcomingBucket {
+    // Due before today
+    Overdue,
+    Today,
+    // Due after today until Sunday
+    ThisWeek,
+    Later
+};
+
+/**
+ * @brief An open todo in the upcoming index.
+ */
+struct UpcomingEntry {
+    int id;
+    Date dueDate;
+    std::string name;
+    // Recurring todos are kept at their next open occurrence
+    bool recurring = false;
+};
+
+/**
+ * @class UpcomingIndex
+ * @brief The open todos ordered by due date, split into overdue, today, this week and later.
+ *
+ * The entries are kept in an ordered map, so adding, removing or completing a todo is one O(log n)
+ * update instead of sorting the list again. The buckets are ranges of the map, found with a lookup of
+ * the first entry of every day boundary, so moving to a new day moves every todo to its new bucket at once.
+ *
+ * Done todos are left out. A recurring todo is listed at its next open occurrence from today.
+ */
+class UpcomingIndex {
+    public:
+        using Entries = std::map<std::pair<long long, int>, UpcomingEntry>;
+        using Range = std::pair<Entries::const_iterator, Entries::const_iterator>;
+
+        UpcomingIndex() {};
+        /**
+         * @brief Rebuilds the index from the todos, for the day number today.
+         */
+        void rebuild(const std::vector<TodoData>& todos, int today);
+        /**
+         * @brief Adds, moves or drops the todo after it was added or changed.
+         */
+        void update(const TodoData& todo);
+        void remove(int id);
+        /**
+         * @brief Moves the index to the day number today, recurring todos to their next open occurrence.
+         *
+         * @return bool True if the day changed.
+         */
+        bool rollOver(const std::vector<TodoData>& todos, int today);
+        /**
+         * @brief Returns the entries of the bucket, sorted by due date.
+         */
+        Range bucket(UpcomingBucket bucket) const;
+        size_t size() const;
+        int day() const;
+        /**
+         * @brief Returns a number that changes with every change of the index, so views only rebuild on change.
+         */
+        uint64_t version() const;
+    private:
+        Entries entries;
+        // ID -> key of its entry
+        std::unordered_map<int, std::pair<long long, int>> keys;
+        int today = 0;
+        uint64_t changes = 0;
+};
+
+#endif // UPCOMING_INDEX_H
@@ -0,0 +1,150 @@
+#include "../../Headers/Interface/calendarComponent.h"
+#include "../../Headers/Interface/palette.h"
+
+#include <string>
+#include <vector>
+
+#include "../../Headers/calendarIndex.h"
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+namespace {
+    constexpr StringId monthNames[12] = {
+        "month.january", "month.february", "month.march", "month.april", "month.may", "month.june",
+        "month.july", "month.august", "month.september", "month.october", "month.november", "month.december",
+    };
+    constexpr StringId weekdayNames[7] = { "weekday.monday", "weekday.tuesday", "weekday.wednesday", "weekday.thursday", "weekday.friday", "weekday.saturday", "weekday.sunday" };
+
+    constexpr int cellWidth = 12;
+    // Twenty years of months, the cache is dropped once it grows past that
+    constexpr size_t maxCachedGrids = 240;
+
+    Element dayCell(int dayOfMonth, const CalendarDay& day, bool isToday) {
+        Element number = text(std::to_string(dayOfMonth));
+        if (isToday) {
+            number = number | inverted;
+        }
+
+        Elements marks;
+        if (day.opened) {
+            marks.push_back(text("o ") | color(Palette::color(ThemeRole::CalendarOpened)));
+        }
+        if (day.diaryEntries > 0) {
+            marks.push_back(text("D ") | color(Palette::color(ThemeRole::CalendarDiary)));
+        }
+        if (day.dueTodos > 0) {
+            bool allDone = day.doneTodos == day.dueTodos;
+            marks.push_back(text("T" + std::to_string(day.dueTodos) + " ") | color(Palette::color(allDone ? ThemeRole::TodosDone : ThemeRole::TodosOpen)));
+        }
+        if (day.progressPoints > 0) {
+            marks.push_back(text("P" + std::to_string(day.completedPoints) + "/" + std::to_string(day.progressPoints)) | color(Palette::color(ThemeRole::CalendarPoints)));
+        }
+
+        return vbox({ number, hbox(std::move(marks)) }) | size(WIDTH, EQUAL, cellWidth) | size(HEIGHT, EQUAL, 2);
+    }
+}
+
+void CalendarComponent::page(int months) {
+    monthOffset += months;
+}
+
+void CalendarComponent::pageToToday() {
+    monthOffset = 0;
+}
+
+Element CalendarComponent::buildGrid(CalendarIndex& index, FileData *data, int year, int month) {
+    CalendarMonth calendarMonth = index.month(year, month, data->todosData);
+    const MonthLayout& layout = calendarMonth.layout;
+
+    Elements header;
+    for (StringId name : weekdayNames) {
+        header.push_back(text(Language::text(name)) | bold | size(WIDTH, EQUAL, cellWidth));
+    }
+
+    Elements weeks = { hbox(std::move(header)) };
+    for (int week = 0; week < layout.weeks; week++) {
+        Elements cells;
+        for (int weekday = 0; weekday < 7; weekday++) {
+            int dayOfMonth = week * 7 + weekday - layout.firstWeekday + 1;
+            if (dayOfMonth < 1 || dayOfMonth > layout.days) {
+                cells.push_back(text("") | size(WIDTH, EQUAL, cellWidth));
+                continue;
+            }
+            int dayNumber = layout.firstDay + dayOfMonth - 1;
+            cells.push_back(dayCell(dayOfMonth, calendarMonth.days[dayOfMonth - 1], dayNumber == cachedToday));
+        }
+        weeks.push_back(hbox(std::move(cells)));
+        weeks.push_back(separatorEmpty());
+    }
+    return vbox(std::move(weeks));
+}
+
+ftxui::Component CalendarComponent::renderCalendarComponent(CalendarIndex *index, FileData *data) {
+    TraceSpan span("CalendarComponent::renderCalendarComponent");
+    if (!index || !data) return ftxui::Renderer([] { return ftxui::text(Language::text("ui.dataIsNull")); });
+
+    auto previousButton = ftxui::Button(Language::text("calendar.previous"), [this] { TraceSpan span("CalendarComponent::previous"); page(-1); });
+    auto todayButton = ftxui::Button(Language::text("date.today"), [this] { TraceSpan span("CalendarComponent::today"); pageToToday(); });
+    auto nextButton = ftxui::Button(Language::text("calendar.next"), [this] { TraceSpan span("CalendarComponent::next"); page(1); });
+
+    auto buttons = ftxui::Container::Horizontal({
+        previousButton,
+        todayButton,
+        nextButton,
+    });
+
+    return ftxui::Renderer(buttons, [buttons, index, data, this] {
+        Date today = DateUtils::today();
+        int todayNumber = DateUtils::dayNumber(today);
+        if (todayNumber != cachedToday) {
+            // Today is highlighted, so grids built yesterday are stale
+            grids.clear();
+            cachedToday = todayNumber;
+        }
+        if (grids.size() > maxCachedGrids) {
+            grids.clear();
+        }
+
+        int shown = CalendarIndex::monthIndex(today.year, today.month) + monthOffset;
+        int year = shown / 12;
+        int month = shown % 12 + 1;
+
+        // Only a month whose days changed since it was built is built again
+        CalendarGrid& grid = grids[shown];
+        uint64_t version = index->version(year, month);
+        if (!grid.grid || grid.version != version) {
+            grid.grid = buildGrid(*index, data, year, month);
+            grid.version = version;
+        }
+
+        return vbox({
+            hbox({
+                filler(),
+                text(Language::text(monthNames[month - 1]) + " " + std::to_string(year)) | bold,
+                filler(),
+            }),
+            separatorEmpty(),
+            hbox({ filler(), grid.grid, filler() }),
+            hbox({ filler(), buttons->Render(), filler() }),
+            separatorEmpty(),
+            hbox({
+                filler(),
+                text(Language::text("calendar.legendOpened")) | color(Palette::color(ThemeRole::CalendarOpened)),
+                text("  "),
+                text(Language::text("calendar.legendDiary")) | color(Palette::color(ThemeRole::CalendarDiary)),
+                text("  "),
+                text(Language::text("calendar.legendTodos")) | color(Palette::color(ThemeRole::TodosOpen)),
+                text("  "),
+                text(Language::text("calendar.legendPoints")) | color(Palette::color(ThemeRole::CalendarPoints)),
+                filler(),
+            }),
+        });
+    });
+}
@@ -0,0 +1,126 @@
+#include "../../Headers/Interface/dateTimeInput.h"
+#include "../../Headers/Interface/palette.h"
+
+#include <charconv>
+#include <string>
+
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/component/component_base.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+namespace {
+    struct FieldLayout {
+        StringId placeholder;
+        size_t digits;
+        int minimum;
+        int maximum;
+    };
+
+    // The maximum of the day is the length of the month, see DateTimeInput::maximum
+    constexpr FieldLayout fieldLayouts[] = {
+        { StringId("date.year"), 4, 1900, 2100 },
+        { StringId("date.month"), 2, 1, 12 },
+        { StringId("date.day"), 2, 1, 31 },
+        { StringId("date.hour"), 2, 0, 23 },
+        { StringId("date.minute"), 2, 0, 59 },
+    };
+}
+
+DateTimeInput::DateTimeInput() {
+    // Tomorrow at the current time, like todos added from the command line
+    Date dueDate = DateUtils::fromDayNumber(DateUtils::dayNumber(DateUtils::today()) + 1);
+    Date now = DateUtils::now();
+    dueDate.hour = now.hour;
+    dueDate.minute = now.minute;
+    setDate(dueDate);
+}
+
+void DateTimeInput::setDate(const Date& date) {
+    values = { date.year, date.month, date.day, date.hour, date.minute };
+    for (int field = 0; field < FieldCount; field++) {
+        std::string text = std::to_string(values[field]);
+        texts[field] = std::string(text.size() < fieldLayouts[field].digits && field != Year ? 1 : 0, '0') + text;
+    }
+    invalidFields = 0;
+    value = date;
+}
+
+int DateTimeInput::maximum(int field) const {
+    if (field == Day && !(invalidFields & (1u << Month)) && !(invalidFields & (1u << Year))) {
+        return DateUtils::daysInMonth(values[Year], values[Month]);
+    }
+    return fieldLayouts[field].maximum;
+}
+
+void DateTimeInput::validate(int field) {
+    std::string& text = texts[field];
+    invalidFields |= 1u << field;
+    if (text.empty()) {
+        return;
+    }
+
+    int parsed = 0;
+    std::from_chars(text.data(), text.data() + text.size(), parsed);
+    int highest = maximum(field);
+    if (parsed > highest) {
+        // Same number of digits, so the cursor stays where it was
+        parsed = highest;
+        text = std::to_string(highest);
+    }
+    if (parsed < fieldLayouts[field].minimum) {
+        return;
+    }
+    values[field] = parsed;
+    invalidFields &= ~(1u << field);
+}
+
+void DateTimeInput::onChange(int field) {
+    std::string& text = texts[field];
+    std::erase_if(text, [](char character) { return character < '0' || character > '9'; });
+    if (text.size() > fieldLayouts[field].digits) {
+        text.resize(fieldLayouts[field].digits);
+    }
+
+    validate(field);
+    if (field == Month || field == Year) {
+        validate(Day);
+    }
+
+    if (valid()) {
+        value = Date({ static_cast<short>(values[Day]), static_cast<short>(values[Month]), static_cast<short>(values[Year]), static_cast<short>(values[Hour]), static_cast<short>(values[Minute]) });
+    }
+}
+
+ftxui::Component DateTimeInput::component() {
+    TraceSpan span("DateTimeInput::component");
+    static constexpr const char* separators[] = { "- ", "- ", "/ ", ": " };
+
+    Components fields;
+    for (int field = 0; field < FieldCount; field++) {
+        ftxui::InputOption option;
+        option.multiline = false;
+        option.on_change = [this, field] { onChange(field); };
+        auto input = ftxui::Input(&texts[field], Language::text(fieldLayouts[field].placeholder), option);
+
+        // Only reads the flags set by onChange
+        auto rendered = ftxui::Renderer(input, [this, input, field] {
+            if (invalidFields & (1u << field)) {
+                return input->Render() | ftxui::color(Palette::color(ThemeRole::Error));
+            }
+            return input->Render();
+        }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, static_cast<int>(fieldLayouts[field].digits) + 1);
+
+        if (field > 0) {
+            fields.push_back(ftxui::Renderer([field] { return ftxui::text(separators[field - 1]); }));
+        }
+        fields.push_back(rendered);
+    }
+    return ftxui::Container::Horizontal(std::move(fields));
+}
@@ -5,43 +5,40 @@
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/screen_interactive.hpp"
 
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/fileDataOperations.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 
 using namespace ftxui;
 
 DiaryData DiaryComponent::addDiaryEntry(FileData *fileData) {
-    auto currentTime = std::time(nullptr);
-    auto localTime = *std::localtime(&currentTime);
-
-    Date today;
-    today.year = localTime.tm_year + 1900;
-    today.month = localTime.tm_mon + 1;
-    today.day = localTime.tm_mday;
-    today.hour = 0;
-    today.minute = 0;
-
-    DiaryData newDiaryEntry;
-    newDiaryEntry.id = fileData->diaryData.size() + 1;
-    newDiaryEntry.date = today;
-    newDiaryEntry.diaryEntryName = newEntryName;
-    newDiaryEntry.diaryEntry = newEntryContent;
-
-    fileData->diaryData.push_back(newDiaryEntry);
-    return newDiaryEntry;
+    DiaryData entry = FileDataOperations::addDiaryEntry(fileData, newEntryName, newEntryContent, documentChanges);
+    if (calendarIndex) {
+        calendarIndex->addDiaryEntry(entry);
+    }
+    return entry;
 }
 
-Component DiaryComponent::diaryComponent(FileData *fileData) {
+void DiaryComponent::setCalendarIndex(CalendarIndex *index) {
+    calendarIndex = index;
+}
+
+void DiaryComponent::setDocumentChanges(DocumentChanges *changes) {
+    documentChanges = changes;
+}
+
+void DiaryComponent::refreshData(FileData *fileData) {
     diaryEntries = fileData->diaryData;
+    combinedDiaryDates.clear();
 
     std::vector<Date> diaryDates;
     for (DiaryData entry : diaryEntries) {
         diaryDates.push_back(entry.date);
     }
 
-    time_t now = time(0);
-    tm *localTime = localtime(&now);
-
-    Date todayDate = Date(localTime->tm_mday, 1 + localTime->tm_mon, 1900 + localTime->tm_year, 0, 0);
+    Date todayDate = DateUtils::today();
 
     if (std::find(diaryDates.begin(), diaryDates.end(), todayDate) == diaryDates.end()) {
         combinedDiaryDates.push_back(todayDate);
@@ -58,11 +55,41 @@ Component DiaryComponent::diaryComponent(FileData *fileData) {
         return a.day > b.day;
     });
 
-    auto selectedIndex = std::make_shared<int>(0);
-    auto isValidDiary = std::make_shared<int>(0);
+    selectedIndex = std::max(0, std::min(selectedIndex, static_cast<int>(combinedDiaryDates.size()) - 1));
+    diaryReader.clear();
+    updateSelectedDiary();
+}
+
+MemoryUsage DiaryComponent::memoryUsage() const {
+    MemoryUsage usage = MemoryReport::of(diaryEntries);
+    usage += MemoryReport::of(combinedDiaryDates);
+    usage.records = diaryEntries.size();
+    return usage;
+}
 
-    auto newEntryNameInput = Input(&newEntryName, "New Entry Name: ");
-    auto newEntryContentInput = Input(&newEntryContent, "New Entry Content: ");
+size_t DiaryComponent::compact() {
+    return MemoryReport::compact(&diaryEntries) + MemoryReport::compact(&combinedDiaryDates);
+}
+
+void DiaryComponent::updateSelectedDiary() {
+    selectedDiary = -1;
+    if (selectedIndex >= 0 && selectedIndex < combinedDiaryDates.size()) {
+        for (size_t i = 0; i < diaryEntries.size(); i++) {
+            if (diaryEntries[i].date == combinedDiaryDates[selectedIndex]) {
+                selectedDiary = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+    isValidDiary = selectedDiary == -1 ? 0 : 1;
+}
+
+Component DiaryComponent::diaryComponent(FileData *fileData) {
+    TraceSpan span("DiaryComponent::diaryComponent");
+    refreshData(fileData);
+
+    auto newEntryNameInput = Input(&newEntryName, Language::text("diary.newEntryName"));
+    auto newEntryContentInput = Input(&newEntryContent, Language::text("diary.newEntryContent"));
 
     auto dateToString = [](Date date) {
         std::string dayStr = (date.day < 10 ? "0" : "") + std::to_string(date.day);
@@ -71,30 +98,20 @@ Component DiaryComponent::diaryComponent(FileData *fileData) {
         return dateString;
     };
 
-    auto getDiaryFromDate = [selectedIndex, this]() -> DiaryData {
-        if (*selectedIndex >= 0 && *selectedIndex < combinedDiaryDates.size()) {
-            for (const auto& entry : diaryEntries) {
-                if (entry.date == combinedDiaryDates[*selectedIndex]) {
-                    return entry;
-                }
-            }
-        }
-        return DiaryData({-1, Date({0,0,0,0,0}), "", ""});
-    };
-
-    auto addEntryButton = Button("Add Entry", [fileData, this, isValidDiary, getDiaryFromDate] {
+    auto addEntryButton = Button(Language::text("diary.add"), [fileData, this] {
+        TraceSpan span("DiaryComponent::add");
         if (!newEntryName.empty() && !newEntryContent.empty()) {
             DiaryData addedEntry = addDiaryEntry(fileData);
             diaryEntries.push_back(addedEntry);
             combinedDiaryDates.push_back(addedEntry.date);
             newEntryName.clear();
             newEntryContent.clear();
-            *isValidDiary = getDiaryFromDate() == DiaryData({-1, Date({0,0,0,0,0}), "", ""}) ? 0 : 1;
+            updateSelectedDiary();
         }
     });
 
     auto addEntryView = ftxui::Container::Vertical({
-        ftxui::Renderer([] { return text("Add Today Entry:"); }),
+        ftxui::Renderer([] { return text(Language::text("diary.addHeader")); }),
         newEntryNameInput,
         newEntryContentInput,
         Renderer([]{
@@ -104,50 +121,49 @@ Component DiaryComponent::diaryComponent(FileData *fileData) {
     });
 
     auto viewDiaryEntry = ftxui::Container::Vertical({
-        Renderer([getDiaryFromDate] {
-            auto diary = getDiaryFromDate();
+        Renderer([this] {
+            std::string name = selectedDiary == -1 ? "" : diaryEntries[selectedDiary].diaryEntryName;
             return hbox(
-                ftxui::text("Diary: "),
-                paragraph(diary.diaryEntryName)
+                ftxui::text(Language::text("diary.label")),
+                paragraph(name)
             ) | ftxui::bold;
         }),
         Renderer([]{
             return ftxui::separatorEmpty();
         }),
-        Renderer([getDiaryFromDate] {
-            auto diary = getDiaryFromDate();
-            return hbox(paragraph(diary.diaryEntry));
-        }),
+        diaryReader.readerComponent([this]() -> const DiaryData* {
+            return selectedDiary == -1 ? nullptr : &diaryEntries[selectedDiary];
+        }) | ftxui::size(ftxui::HEIGHT, ftxui::EQUAL, 26),
     });
 
-    *isValidDiary = getDiaryFromDate() == DiaryData({-1, Date({0,0,0,0,0}), "", ""}) ? 0 : 1;
-
     auto selectedDiaryView = ftxui::Container::Tab({
         addEntryView,
         viewDiaryEntry,
-    }, isValidDiary.get());
+    }, &isValidDiary);
 
-    auto upButton = Button(">>", [selectedIndex, this, isValidDiary, getDiaryFromDate] {
-        if (*selectedIndex > 0) {
-            (*selectedIndex)--;
-            *isValidDiary = getDiaryFromDate() == DiaryData({-1, Date({0,0,0,0,0}), "", ""}) ? 0 : 1;
+    auto upButton = Button(">>", [this] {
+        TraceSpan span("DiaryComponent::up");
+        if (selectedIndex > 0) {
+            selectedIndex--;
+            updateSelectedDiary();
         }
     });
 
-    auto downButton = Button("<<", [selectedIndex, this, isValidDiary, getDiaryFromDate] {
-        if (*selectedIndex < combinedDiaryDates.size() - 1) {
-            (*selectedIndex)++;
-            *isValidDiary = getDiaryFromDate() == DiaryData({-1, Date({0,0,0,0,0}), "", ""}) ? 0 : 1;
+    auto downButton = Button("<<", [this] {
+        TraceSpan span("DiaryComponent::down");
+        if (selectedIndex < combinedDiaryDates.size() - 1) {
+            selectedIndex++;
+            updateSelectedDiary();
         }
     });
 
     auto selectedDateView = ftxui::Container::Horizontal({
         downButton,
-        Renderer([dateToString, this, selectedIndex] {
-            if (*selectedIndex >= 0 && *selectedIndex < combinedDiaryDates.size()) {
-                return text("  " + dateToString(combinedDiaryDates[*selectedIndex]) + "  ");
+        Renderer([dateToString, this] {
+            if (selectedIndex >= 0 && selectedIndex < combinedDiaryDates.size()) {
+                return text("  " + dateToString(combinedDiaryDates[selectedIndex]) + "  ");
             }
-            return text("Invalid Date");
+            return text(Language::text("diary.invalidDate"));
         }) | ftxui::center,
         upButton,
     });
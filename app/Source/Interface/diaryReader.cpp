@@ -0,0 +1,200 @@
+#include "../../Headers/Interface/diaryReader.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/component/event.hpp"
+#include "ftxui/component/mouse.hpp"
+#include "ftxui/dom/elements.hpp"
+
+#include "../../Headers/diaryCodec.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
+
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+using namespace ftxui;
+
+namespace {
+    // Layouts of this many entries and widths are kept before the cache starts over
+    constexpr size_t maxCachedLayouts = 64;
+    // Used before the first frame reported the real size of the reader
+    constexpr int defaultWidth = 120;
+    constexpr int defaultHeight = 25;
+
+    size_t characterCount(const std::string& text, size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; i++) {
+            // Continuation bytes of UTF-8 sequences do not start a new character
+            if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    size_t byteOffsetOfCharacter(const std::string& text, size_t begin, size_t end, size_t characters) {
+        size_t i = begin;
+        while (i < end && characters > 0) {
+            i++;
+            while (i < end && (static_cast<unsigned char>(text[i]) & 0xC0) == 0x80) {
+                i++;
+            }
+            characters--;
+        }
+        return i;
+    }
+}
+
+std::vector<std::string> DiaryReader::wrapText(const std::string& text, int width) {
+    std::vector<std::string> lines;
+    size_t maxWidth = static_cast<size_t>(std::max(1, width));
+
+    size_t paragraphBegin = 0;
+    while (paragraphBegin <= text.size()) {
+        size_t paragraphEnd = text.find('\n', paragraphBegin);
+        if (paragraphEnd == std::string::npos) {
+            paragraphEnd = text.size();
+        }
+
+        std::string line;
+        size_t lineWidth = 0;
+        size_t wordBegin = paragraphBegin;
+
+        while (wordBegin < paragraphEnd) {
+            if (text[wordBegin] == ' ') {
+                wordBegin++;
+                continue;
+            }
+            size_t wordEnd = text.find(' ', wordBegin);
+            if (wordEnd == std::string::npos || wordEnd > paragraphEnd) {
+                wordEnd = paragraphEnd;
+            }
+            size_t wordWidth = characterCount(text, wordBegin, wordEnd);
+
+            if (lineWidth > 0 && lineWidth + 1 + wordWidth > maxWidth) {
+                lines.push_back(std::move(line));
+                line.clear();
+                lineWidth = 0;
+            }
+
+            // Words longer than a whole line are split
+            while (wordWidth > maxWidth) {
+                size_t splitAt = byteOffsetOfCharacter(text, wordBegin, wordEnd, maxWidth);
+                lines.push_back(text.substr(wordBegin, splitAt - wordBegin));
+                wordBegin = splitAt;
+                wordWidth -= maxWidth;
+            }
+
+            if (lineWidth > 0) {
+                line += ' ';
+                lineWidth++;
+            }
+            line.append(text, wordBegin, wordEnd - wordBegin);
+            lineWidth += wordWidth;
+            wordBegin = wordEnd;
+        }
+
+        lines.push_back(std::move(line));
+        paragraphBegin = paragraphEnd + 1;
+    }
+
+    return lines;
+}
+
+void DiaryReader::clear() {
+    layouts.clear();
+    shownEntryId = -1;
+    firstLine = 0;
+}
+
+const std::vector<std::string>& DiaryReader::layoutFor(const DiaryData& entry, int width) {
+    long long key = (static_cast<long long>(entry.id) << 32) | static_cast<unsigned int>(width);
+
+    auto it = layouts.find(key);
+    if (it != layouts.end()) {
+        return it->second;
+    }
+
+    if (layouts.size() >= maxCachedLayouts) {
+        layouts.clear();
+    }
+    // Compressed entries are decoded only here, when they are shown
+    return layouts.emplace(key, wrapText(DiaryCodec::text(entry.diaryEntry), width)).first->second;
+}
+
+bool DiaryReader::scroll(int lines) {
+    int height = box.y_max >= box.y_min ? box.y_max - box.y_min + 1 : defaultHeight;
+    int lastFirstLine = std::max(0, lineCount - height);
+
+    int previous = firstLine;
+    firstLine = std::clamp(firstLine + lines, 0, lastFirstLine);
+    return firstLine != previous;
+}
+
+Component DiaryReader::readerComponent(std::function<const DiaryData*()> selectedEntry) {
+    TraceSpan span("DiaryReader::readerComponent");
+    auto reader = Renderer([this, selectedEntry](bool focused) {
+        const DiaryData *entry = selectedEntry();
+        if (!entry) {
+            lineCount = 0;
+            return text("");
+        }
+
+        if (entry->id != shownEntryId) {
+            shownEntryId = entry->id;
+            firstLine = 0;
+        }
+
+        int width = box.x_max > box.x_min ? box.x_max - box.x_min + 1 : defaultWidth;
+        int height = box.y_max >= box.y_min ? box.y_max - box.y_min + 1 : defaultHeight;
+
+        const auto& lines = layoutFor(*entry, width);
+        lineCount = static_cast<int>(lines.size());
+        firstLine = std::clamp(firstLine, 0, std::max(0, lineCount - height));
+
+        Elements visible;
+        int lastLine = std::min(lineCount, firstLine + height);
+        for (int i = firstLine; i < lastLine; i++) {
+            visible.push_back(text(lines[i]));
+        }
+
+        std::string position = lineCount <= height ? "" : Language::format("diary.position", { std::to_string(firstLine + 1), std::to_string(lastLine), std::to_string(lineCount) });
+        auto footer = text(position) | ftxui::dim;
+
+        return vbox({
+            vbox(std::move(visible)) | flex | reflect(box),
+            focused ? footer | ftxui::bold : footer,
+        });
+    });
+
+    return CatchEvent(reader, [this](Event event) {
+        int page = std::max(1, box.y_max - box.y_min);
+
+        if (event == Event::ArrowDown) {
+            return scroll(1);
+        }
+        if (event == Event::ArrowUp) {
+            return scroll(-1);
+        }
+        if (event == Event::PageDown || (event.is_mouse() && event.mouse().button == Mouse::WheelDown)) {
+            scroll(event.is_mouse() ? 3 : page);
+            return true;
+        }
+        if (event == Event::PageUp || (event.is_mouse() && event.mouse().button == Mouse::WheelUp)) {
+            scroll(event.is_mouse() ? -3 : -page);
+            return true;
+        }
+        if (event == Event::Home) {
+            scroll(-lineCount);
+            return true;
+        }
+        if (event == Event::End) {
+            scroll(lineCount);
+            return true;
+        }
+        return false;
+    });
+}
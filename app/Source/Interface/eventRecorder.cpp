@@ -0,0 +1,225 @@
+#include "../../Headers/Interface/eventRecorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../Headers/dateUtils.h"
+
+#include "ftxui/component/event.hpp"
+#include "ftxui/component/mouse.hpp"
+
+using namespace ftxui;
+
+namespace {
+    const std::pair<const Event*, const char*> keyNames[] = {
+        { &Event::ArrowLeft, "ArrowLeft" }, { &Event::ArrowRight, "ArrowRight" }, { &Event::ArrowUp, "ArrowUp" },
+        { &Event::ArrowDown, "ArrowDown" }, { &Event::Backspace, "Backspace" }, { &Event::Delete, "Delete" },
+        { &Event::Return, "Return" }, { &Event::Escape, "Escape" }, { &Event::Tab, "Tab" },
+        { &Event::TabReverse, "TabReverse" }, { &Event::Home, "Home" }, { &Event::End, "End" },
+        { &Event::PageUp, "PageUp" }, { &Event::PageDown, "PageDown" },
+    };
+
+    std::string toHex(const std::string& input) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (unsigned char character : input) {
+            hex += digits[character >> 4];
+            hex += digits[character & 0xf];
+        }
+        return hex;
+    }
+
+    bool fromHex(const std::string& hex, std::string *input) {
+        if (hex.size() % 2 != 0) {
+            return false;
+        }
+        input->clear();
+        for (size_t i = 0; i < hex.size(); i += 2) {
+            char *end = nullptr;
+            std::string digits = hex.substr(i, 2);
+            long value = std::strtol(digits.c_str(), &end, 16);
+            if (end != digits.c_str() + 2) {
+                return false;
+            }
+            input->push_back(static_cast<char>(value));
+        }
+        return true;
+    }
+
+    bool parseEvent(const std::string& line, RecordedEvent *event) {
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> event->time >> kind)) {
+            return false;
+        }
+        if (kind == "key" || kind == "char") {
+            std::string hex;
+            event->kind = kind == "key" ? RecordedEventKind::Key : RecordedEventKind::Character;
+            return static_cast<bool>(fields >> hex) && fromHex(hex, &event->input);
+        }
+        if (kind == "mouse") {
+            int button, motion, shift, meta, control;
+            if (!(fields >> button >> motion >> event->mouse.x >> event->mouse.y >> shift >> meta >> control)) {
+                return false;
+            }
+            event->kind = RecordedEventKind::Mouse;
+            event->mouse.button = static_cast<Mouse::Button>(button);
+            event->mouse.motion = static_cast<Mouse::Motion>(motion);
+            event->mouse.shift = shift != 0;
+            event->mouse.meta = meta != 0;
+            event->mouse.control = control != 0;
+            return true;
+        }
+        if (kind == "resize") {
+            event->kind = RecordedEventKind::Resize;
+            return static_cast<bool>(fields >> event->width >> event->height) && event->width > 0 && event->height > 0;
+        }
+        return false;
+    }
+}
+
+bool EventRecorder::startFromEnvironment(std::string *error) {
+    const char* path = std::getenv("LOG4DAILY_RECORD");
+    if (path == nullptr || *path == '\0') {
+        return true;
+    }
+    return start(path, error);
+}
+
+bool EventRecorder::start(const std::string& path, std::string *error) {
+    file.open(path, std::ios::trunc);
+    if (!file) {
+        *error = "failed to create " + path;
+        return false;
+    }
+    started = std::chrono::steady_clock::now();
+    file << header << "\nstart " << DateUtils::currentTime() << std::endl;
+    return true;
+}
+
+bool EventRecorder::active() const {
+    return file.is_open();
+}
+
+void EventRecorder::record(Event event) {
+    if (!active() || event == Event::Custom) {
+        return;
+    }
+    RecordedEvent recorded;
+    if (event.is_mouse()) {
+        recorded.kind = RecordedEventKind::Mouse;
+        recorded.mouse = event.mouse();
+    } else {
+        recorded.kind = event.is_character() ? RecordedEventKind::Character : RecordedEventKind::Key;
+        recorded.input = event.input();
+    }
+    write(recorded);
+}
+
+void EventRecorder::resize(int _width, int _height) {
+    if (!active() || (_width == width && _height == height)) {
+        return;
+    }
+    width = _width;
+    height = _height;
+
+    RecordedEvent recorded;
+    recorded.kind = RecordedEventKind::Resize;
+    recorded.width = width;
+    recorded.height = height;
+    write(recorded);
+}
+
+void EventRecorder::write(const RecordedEvent& event) {
+    int64_t time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    file << time;
+    switch (event.kind) {
+        case RecordedEventKind::Key:
+        case RecordedEventKind::Character:
+            file << (event.kind == RecordedEventKind::Key ? "\tkey\t" : "\tchar\t") << toHex(event.input);
+            break;
+        case RecordedEventKind::Mouse:
+            file << "\tmouse\t" << static_cast<int>(event.mouse.button) << ' ' << static_cast<int>(event.mouse.motion) << ' '
+                << event.mouse.x << ' ' << event.mouse.y << ' ' << event.mouse.shift << ' ' << event.mouse.meta << ' ' << event.mouse.control;
+            break;
+        case RecordedEventKind::Resize:
+            file << "\tresize\t" << event.width << ' ' << event.height;
+            break;
+    }
+    // Flushed per event, a crash keeps everything up to it
+    file << std::endl;
+}
+
+bool EventRecorder::load(const std::string& path, EventLog *log, std::string *error) {
+    std::ifstream file(path);
+    if (!file) {
+        *error = "failed to open " + path;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != header) {
+        *error = path + " is not a log4daily event recording";
+        return false;
+    }
+    long long start = 0;
+    if (!std::getline(file, line) || std::sscanf(line.c_str(), "start %lld", &start) != 1) {
+        *error = path + ": missing the start time";
+        return false;
+    }
+    log->start = static_cast<std::time_t>(start);
+
+    log->events.clear();
+    int lineNumber = 2;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty()) {
+            continue;
+        }
+        RecordedEvent event;
+        if (!parseEvent(line, &event)) {
+            *error = path + ":" + std::to_string(lineNumber) + ": not an event";
+            return false;
+        }
+        log->events.push_back(std::move(event));
+    }
+    return true;
+}
+
+Event EventRecorder::toEvent(const RecordedEvent& event) {
+    switch (event.kind) {
+        case RecordedEventKind::Character:
+            return Event::Character(event.input);
+        case RecordedEventKind::Mouse:
+            return Event::Mouse("", event.mouse);
+        default:
+            return Event::Special(event.input);
+    }
+}
+
+std::string EventRecorder::describe(const RecordedEvent& event) {
+    switch (event.kind) {
+        case RecordedEventKind::Key:
+            for (const auto& [key, name] : keyNames) {
+                if (key->input() == event.input) {
+                    return std::string("key ") + name;
+                }
+            }
+            return "key " + toHex(event.input);
+        case RecordedEventKind::Character:
+            return "char " + event.input;
+        case RecordedEventKind::Mouse:
+            return "mouse " + std::to_string(static_cast<int>(event.mouse.button)) + " " + std::to_string(static_cast<int>(event.mouse.motion))
+                + " at " + std::to_string(event.mouse.x) + "," + std::to_string(event.mouse.y);
+        case RecordedEventKind::Resize:
+            return "resize " + std::to_string(event.width) + "x" + std::to_string(event.height);
+    }
+    return "";
+}
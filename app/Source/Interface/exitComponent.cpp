@@ -1,8 +1,11 @@
 #include "../../Headers/Interface/exitComponent.h"
 
 #include "../../Headers/applicationManager.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 #include "../../Headers/uiRenderer.h"
+#include "../../Headers/Interface/palette.h"
 
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/screen_interactive.hpp"
@@ -10,21 +13,25 @@
 using namespace ftxui;
 
 Component ExitComponent::exitComponent(uiRenderer& UI) {
+    TraceSpan span("ExitComponent::exitComponent");
     auto exitButtons = ftxui::Container::Horizontal({
-        Button("Save Changes", [&UI] {
+        Button(Language::text("exit.save"), [&UI] {
+            TraceSpan span("ExitComponent::save");
             UI.saveFileData();
-        }) | size(WIDTH, LESS_THAN, 20) | size(HEIGHT, LESS_THAN, 3) | color(Color::Green),
-        Button("Discard Changes", [&UI] {
+        }) | size(WIDTH, LESS_THAN, 20) | size(HEIGHT, LESS_THAN, 3) | color(Palette::color(ThemeRole::Save)),
+        Button(Language::text("exit.discard"), [&UI] {
+            TraceSpan span("ExitComponent::discard");
             UI.discardFileData();
-        }) | size(WIDTH, LESS_THAN, 20) | size(HEIGHT, LESS_THAN, 3) | color(Color::Yellow),
-        Button("Exit Log4Daily", [&UI] {
+        }) | size(WIDTH, LESS_THAN, 20) | size(HEIGHT, LESS_THAN, 3) | color(Palette::color(ThemeRole::Discard)),
+        Button(Language::text("exit.exit"), [&UI] {
+            TraceSpan span("ExitComponent::exit");
             UI.exit();
-        }) | size(WIDTH, LESS_THAN, 20) | size(HEIGHT, LESS_THAN, 3) | color(Color::Red),
+        }) | size(WIDTH, LESS_THAN, 20) | size(HEIGHT, LESS_THAN, 3) | color(Palette::color(ThemeRole::Exit)),
     });
 
 
     return ftxui::Container::Vertical({
-        ftxui::Renderer([] { return text("Select action:") | hcenter | bold; }),
+        ftxui::Renderer([] { return text(Language::text("exit.selectAction")) | hcenter | bold; }),
         exitButtons | hcenter
     });
 }
\ No newline at end of file
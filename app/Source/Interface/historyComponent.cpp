@@ -0,0 +1,119 @@
+#include "../../Headers/Interface/historyComponent.h"
+#include "../../Headers/Interface/palette.h"
+
+#include <string>
+#include <vector>
+
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/fileDataOperations.h"
+#include "../../Headers/historyLog.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+namespace {
+    // Rows shown per section, the rest is counted
+    constexpr size_t maxRows = 15;
+
+    Element section(StringId title, const std::vector<Element>& rows) {
+        Elements lines = { text(Language::format(title, { std::to_string(rows.size()) })) | bold };
+        for (size_t i = 0; i < rows.size() && i < maxRows; i++) {
+            lines.push_back(rows[i]);
+        }
+        if (rows.size() > maxRows) {
+            lines.push_back(text(Language::format("upcoming.more", { std::to_string(rows.size() - maxRows) })) | dim);
+        }
+        return vbox(std::move(lines)) | flex;
+    }
+}
+
+void HistoryComponent::refreshData(const std::string& historyPath) {
+    path = historyPath;
+    std::string error;
+    if (!HistoryLog::entries(path, &entries, &error)) {
+        summary = text(Language::text("history.unreadable") + error) | color(Palette::color(ThemeRole::Error));
+    }
+
+    // Newest save first
+    labels.clear();
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        labels.push_back("#" + std::to_string(it->number) + "  " + DateUtils::toString(DateUtils::fromTime(it->time), true)
+            + "  +" + std::to_string(it->added) + " ~" + std::to_string(it->modified) + " -" + std::to_string(it->removed));
+    }
+    selectedSave = 0;
+    if (!entries.empty()) {
+        showSelected();
+    } else if (error.empty()) {
+        summary = text(Language::text("history.empty"));
+    }
+}
+
+void HistoryComponent::showSelected() {
+    if (selectedSave < 0 || selectedSave >= static_cast<int>(entries.size())) {
+        return;
+    }
+    const HistoryEntry& entry = entries[entries.size() - 1 - selectedSave];
+
+    FileData data;
+    std::string error;
+    if (!HistoryLog::at(path, entries, entry.number, &data, &error)) {
+        summary = text(Language::text("history.unreadable") + error) | color(Palette::color(ThemeRole::Error));
+        return;
+    }
+
+    std::vector<Element> todos;
+    for (const auto& todo : data.todosData) {
+        bool done = FileDataOperations::isTodoDone(todo);
+        todos.push_back(text(DateUtils::toString(todo.dueDate) + "  " + todo.todoName)
+            | color(Palette::color(done ? ThemeRole::TodosDone : ThemeRole::TodosOpen)));
+    }
+    std::vector<Element> milestones;
+    for (const auto& milestone : data.milestonesData) {
+        milestones.push_back(text(milestone.milestoneName + " (" + std::to_string(milestone.progressPoints.size()) + ")"));
+    }
+    std::vector<Element> diary;
+    for (const auto& diaryEntry : data.diaryData) {
+        diary.push_back(text(DateUtils::toString(diaryEntry.date) + "  " + diaryEntry.diaryEntryName));
+    }
+
+    StringId kind = entry.kind == HistoryEntryKind::Checkpoint ? StringId("history.checkpoint") : StringId("history.diff");
+    summary = vbox({
+        text(Language::format("history.save", { std::to_string(entry.number), DateUtils::toString(DateUtils::fromTime(entry.time), true) })) | bold,
+        text(Language::format(kind, { std::to_string(entry.added), std::to_string(entry.modified), std::to_string(entry.removed) })) | dim,
+        text(Language::format("history.days", { std::to_string(data.calendarData.size()) })),
+        separatorEmpty(),
+        hbox({
+            section("history.todos", todos),
+            separatorEmpty(),
+            section("history.milestones", milestones),
+            separatorEmpty(),
+            section("history.diary", diary),
+        }),
+    });
+}
+
+ftxui::Component HistoryComponent::renderHistoryComponent(const std::string& historyPath) {
+    TraceSpan span("HistoryComponent::renderHistoryComponent");
+    refreshData(historyPath);
+
+    ftxui::MenuOption option = ftxui::MenuOption::Vertical();
+    option.on_change = [this] { showSelected(); };
+    auto savesList = ftxui::Menu(&labels, &selectedSave, option);
+
+    // The summary is built when a save is selected, rendering only shows it
+    return ftxui::Renderer(savesList, [savesList, this] {
+        return hbox({
+            vbox({
+                text(Language::text("history.saves")) | bold,
+                savesList->Render() | vscroll_indicator | frame | flex,
+            }) | size(WIDTH, EQUAL, 40),
+            separator(),
+            summary | flex,
+        });
+    });
+}
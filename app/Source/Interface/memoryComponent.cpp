@@ -0,0 +1,56 @@
+#include "../../Headers/Interface/memoryComponent.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../../Headers/language.h"
+#include "../../Headers/memoryReport.h"
+#include "../../Headers/trace.h"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+void MemoryComponent::invalidate() {
+    stale = true;
+}
+
+ftxui::Component MemoryComponent::renderMemoryComponent(std::function<std::vector<MemoryRow>()> _measure, std::function<size_t()> compact) {
+    TraceSpan span("MemoryComponent::renderMemoryComponent");
+    measure = std::move(_measure);
+
+    auto buttons = ftxui::Container::Horizontal({
+        ftxui::Button(Language::text("memory.refresh"), [this] {
+            TraceSpan span("MemoryComponent::refresh");
+            stale = true;
+            compactResult.clear();
+        }),
+        ftxui::Button(Language::text("memory.compact"), [compact, this] {
+            TraceSpan span("MemoryComponent::compact");
+            compactResult = Language::format("memory.reclaimed", { MemoryReport::formatBytes(compact()) });
+            stale = true;
+        }),
+    });
+
+    return ftxui::Renderer(buttons, [buttons, this] {
+        if (stale && measure) {
+            lines = MemoryReport::describe(measure());
+            stale = false;
+        }
+
+        Elements rows = { text(Language::text("memory.header")) | bold, separatorEmpty() };
+        for (const auto& line : lines) {
+            rows.push_back(text(line));
+        }
+        rows.push_back(separatorEmpty());
+        rows.push_back(text(Language::text("memory.note")) | dim);
+        rows.push_back(separatorEmpty());
+        rows.push_back(buttons->Render());
+        if (!compactResult.empty()) {
+            rows.push_back(text(compactResult));
+        }
+        return vbox(std::move(rows)) | hcenter;
+    });
+}
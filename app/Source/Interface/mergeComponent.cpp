@@ -0,0 +1,172 @@
+#include "../../Headers/Interface/mergeComponent.h"
+#include "../../Headers/Interface/palette.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/diaryCodec.h"
+#include "../../Headers/documentMerge.h"
+#include "../../Headers/language.h"
+#include "../../Headers/recurrence.h"
+#include "../../Headers/trace.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+namespace {
+    constexpr StringId sectionNames[] = { "tab.calendar", "tab.todos", "tab.milestones", "tab.diary" };
+
+    /**
+     * @brief Lines describing the record of the conflict in the data, or that it was removed.
+     */
+    Elements recordLines(const FileData& data, const MergeConflict& conflict, bool present) {
+        if (!present) {
+            return { text(Language::text("merge.removed")) | dim };
+        }
+        auto byId = [&](const auto& records) {
+            return std::find_if(records.begin(), records.end(), [&](const auto& record) { return record.id == conflict.key; });
+        };
+
+        switch (conflict.section) {
+            case MergeSection::Calendar:
+                for (const auto& date : data.calendarData) {
+                    if (DateUtils::dateKey(date) == conflict.key) {
+                        return { text(DateUtils::toString(date)) };
+                    }
+                }
+                break;
+            case MergeSection::Todos:
+                if (auto todo = byId(data.todosData); todo != data.todosData.end()) {
+                    return {
+                        text(todo->todoName) | bold,
+                        text(Language::text("merge.due") + DateUtils::toString(todo->dueDate, true)),
+                        paragraph(Recurrence::description(*todo)),
+                    };
+                }
+                break;
+            case MergeSection::Milestones:
+                if (auto milestone = byId(data.milestonesData); milestone != data.milestonesData.end()) {
+                    size_t completed = std::count_if(milestone->progressPoints.begin(), milestone->progressPoints.end(), [](const auto& point) { return point.isCompleted; });
+                    return {
+                        text(milestone->milestoneName) | bold,
+                        paragraph(milestone->milestoneDescription),
+                        text(Language::format("merge.points", { std::to_string(milestone->progressPoints.size()), std::to_string(completed) })),
+                    };
+                }
+                break;
+            case MergeSection::Diary:
+                if (auto entry = byId(data.diaryData); entry != data.diaryData.end()) {
+                    return {
+                        text(DateUtils::toString(entry->date) + "  " + entry->diaryEntryName) | bold,
+                        paragraph(DiaryCodec::text(entry->diaryEntry)),
+                    };
+                }
+                break;
+        }
+        return { text(Language::text("merge.removed")) | dim };
+    }
+}
+
+void MergeComponent::refreshData(const std::string& conflictsPath) {
+    path = conflictsPath;
+    error.clear();
+    if (!DocumentMerge::loadConflicts(path, &conflicts, &error)) {
+        error = Language::text("merge.unreadable") + error;
+    }
+
+    labels.clear();
+    for (const auto& conflict : conflicts.conflicts) {
+        std::string label = Language::text(sectionNames[static_cast<size_t>(conflict.section)]);
+        if (conflict.section != MergeSection::Calendar) {
+            label += " #" + std::to_string(conflict.key);
+        }
+        labels.push_back(label);
+    }
+    selectedConflict = std::min(selectedConflict, std::max(0, static_cast<int>(labels.size()) - 1));
+    showSelected();
+}
+
+void MergeComponent::showSelected() {
+    if (!error.empty()) {
+        preview = text(error) | color(Palette::color(ThemeRole::Error));
+        return;
+    }
+    if (conflicts.conflicts.empty() || !data) {
+        preview = text(Language::text("merge.empty"));
+        return;
+    }
+
+    const MergeConflict& conflict = conflicts.conflicts[selectedConflict];
+    Elements mine = { text(Language::text("merge.mine")) | bold };
+    Elements theirs = { text(Language::text("merge.theirs")) | bold };
+    for (auto& line : recordLines(*data, conflict, conflict.inOurs)) {
+        mine.push_back(std::move(line));
+    }
+    for (auto& line : recordLines(conflicts.theirs, conflict, conflict.inTheirs)) {
+        theirs.push_back(std::move(line));
+    }
+    preview = vbox({
+        hbox({ vbox(std::move(mine)) | flex, separator(), vbox(std::move(theirs)) | flex }),
+        separatorEmpty(),
+        text(Language::text("merge.saveNote")) | dim,
+    });
+}
+
+void MergeComponent::resolve(bool takeTheirs) {
+    if (selectedConflict >= static_cast<int>(conflicts.conflicts.size()) || !data) {
+        return;
+    }
+    if (takeTheirs) {
+        DocumentMerge::takeTheirs(data, conflicts, selectedConflict);
+    }
+    conflicts.conflicts.erase(conflicts.conflicts.begin() + selectedConflict);
+    labels.erase(labels.begin() + selectedConflict);
+    selectedConflict = std::min(selectedConflict, std::max(0, static_cast<int>(labels.size()) - 1));
+
+    std::string saveError;
+    if (!DocumentMerge::saveConflicts(path, conflicts, &saveError)) {
+        error = Language::text("merge.unreadable") + saveError;
+    }
+    showSelected();
+    if (takeTheirs && onResolved) {
+        onResolved();
+    }
+}
+
+ftxui::Component MergeComponent::renderMergeComponent(const std::string& conflictsPath, FileData *_data, std::function<void()> _onResolved) {
+    TraceSpan span("MergeComponent::renderMergeComponent");
+    if (!_data) return ftxui::Renderer([] { return ftxui::text(Language::text("ui.dataIsNull")); });
+    data = _data;
+    onResolved = std::move(_onResolved);
+    refreshData(conflictsPath);
+
+    ftxui::MenuOption option = ftxui::MenuOption::Vertical();
+    option.on_change = [this] { showSelected(); };
+    auto conflictsList = ftxui::Menu(&labels, &selectedConflict, option);
+
+    auto buttons = ftxui::Container::Horizontal({
+        ftxui::Button(Language::text("merge.keepMine"), [this] { TraceSpan span("MergeComponent::keepMine"); resolve(false); }),
+        ftxui::Button(Language::text("merge.takeTheirs"), [this] { TraceSpan span("MergeComponent::takeTheirs"); resolve(true); }),
+    });
+    auto container = ftxui::Container::Vertical({ conflictsList, buttons });
+
+    return ftxui::Renderer(container, [conflictsList, buttons, this] {
+        return hbox({
+            vbox({
+                text(Language::text("merge.conflicts")) | bold,
+                conflictsList->Render() | vscroll_indicator | frame | flex,
+            }) | size(WIDTH, EQUAL, 30),
+            separator(),
+            vbox({
+                preview | flex,
+                labels.empty() ? text("") : buttons->Render(),
+            }) | flex,
+        });
+    });
+}
@@ -0,0 +1,164 @@
+#include "../../Headers/Interface/milestoneHeatmap.h"
+#include "../../Headers/Interface/palette.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/language.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+namespace {
+    constexpr StringId monthNames[12] = {
+        "monthShort.january", "monthShort.february", "monthShort.march", "monthShort.april", "monthShort.may", "monthShort.june",
+        "monthShort.july", "monthShort.august", "monthShort.september", "monthShort.october", "monthShort.november", "monthShort.december",
+    };
+    constexpr StringId weekdayNames[7] = {
+        "weekdayLetter.monday", "weekdayLetter.tuesday", "weekdayLetter.wednesday", "weekdayLetter.thursday",
+        "weekdayLetter.friday", "weekdayLetter.saturday", "weekdayLetter.sunday",
+    };
+
+    // Width of a month tile: 6 week columns of 2 characters, plus the gap to the next tile
+    constexpr int tileWidth = 14;
+    // Twenty years of months, the cache is rebuilt from the visible window once it grows past that
+    constexpr size_t maxCachedTiles = 240;
+
+    long long tileKey(int milestoneId, int monthIndex) {
+        return (static_cast<long long>(milestoneId) << 32) | static_cast<unsigned int>(monthIndex);
+    }
+
+    int monthIndexOf(const Date& date) {
+        return date.year * 12 + (date.month - 1);
+    }
+
+    std::string monthLabel(int monthIndex) {
+        return Language::text(monthNames[monthIndex % 12]) + " " + std::to_string(monthIndex / 12);
+    }
+}
+
+void MilestoneHeatmap::scroll(int months) {
+    monthOffset = std::max(0, monthOffset + months);
+}
+
+void MilestoneHeatmap::scrollToToday() {
+    monthOffset = 0;
+}
+
+void MilestoneHeatmap::clear() {
+    tiles.clear();
+    indexes.clear();
+}
+
+int MilestoneHeatmap::lastVisibleMonth() const {
+    return monthIndexOf(DateUtils::today()) - monthOffset;
+}
+
+std::string MilestoneHeatmap::rangeLabel() const {
+    int last = lastVisibleMonth();
+    return monthLabel(last - visibleMonths + 1) + " - " + monthLabel(last);
+}
+
+void MilestoneHeatmap::updateIndex(const MilestonesData& milestone) {
+    MilestoneDayIndex& index = indexes[milestone.id];
+
+    if (milestone.progressPoints.size() < index.indexedPoints) {
+        // Points were removed, drop everything that was built for this milestone
+        index = MilestoneDayIndex();
+        std::erase_if(tiles, [&milestone](const auto& tile) {
+            return static_cast<int>(tile.first >> 32) == milestone.id;
+        });
+    }
+
+    // Progress points are only ever appended, so only the new ones have to be indexed
+    for (size_t i = index.indexedPoints; i < milestone.progressPoints.size(); i++) {
+        const auto& point = milestone.progressPoints[i];
+        index.completedByDay.insert_or_assign(DateUtils::dayNumber(point.date), point.isCompleted);
+        tiles.erase(tileKey(milestone.id, monthIndexOf(point.date)));
+    }
+    index.indexedPoints = milestone.progressPoints.size();
+}
+
+Element MilestoneHeatmap::buildTile(int milestoneId, int monthIndex) {
+    const auto& completedByDay = indexes[milestoneId].completedByDay;
+
+    int year = monthIndex / 12;
+    int month = monthIndex % 12 + 1;
+    int firstDay = DateUtils::dayNumber(year, month, 1);
+    int firstWeekday = DateUtils::weekday(firstDay);
+    int days = DateUtils::daysInMonth(year, month);
+    int weeks = (firstWeekday + days - 1) / 7 + 1;
+
+    Elements rows;
+    rows.push_back(text(monthLabel(monthIndex)) | bold);
+
+    for (int weekday = 0; weekday < 7; weekday++) {
+        Elements cells;
+        for (int week = 0; week < weeks; week++) {
+            int day = week * 7 + weekday - firstWeekday + 1;
+            if (day < 1 || day > days) {
+                cells.push_back(text("  "));
+                continue;
+            }
+
+            int dayNumber = firstDay + day - 1;
+            auto it = completedByDay.find(dayNumber);
+
+            ThemeRole cellRole = ThemeRole::PointNotAdded;
+            if (it != completedByDay.end()) {
+                cellRole = it->second ? ThemeRole::PointCompleted : ThemeRole::PointNotCompleted;
+            }
+            else if (dayNumber > cachedToday) {
+                cellRole = ThemeRole::PointUpcoming;
+            }
+            const Color& cellColor = Palette::color(cellRole);
+            cells.push_back(text("■ ") | color(cellColor));
+        }
+        rows.push_back(hbox(std::move(cells)));
+    }
+
+    return vbox(std::move(rows)) | size(WIDTH, EQUAL, tileWidth);
+}
+
+Element MilestoneHeatmap::render(const MilestonesData& milestone) {
+    int today = DateUtils::dayNumber(DateUtils::today());
+    if (today != cachedToday) {
+        // Future days are drawn differently, so tiles built yesterday are stale
+        tiles.clear();
+        cachedToday = today;
+    }
+
+    updateIndex(milestone);
+
+    if (tiles.size() > maxCachedTiles) {
+        tiles.clear();
+    }
+
+    int first = lastVisibleMonth() - visibleMonths + 1;
+
+    Elements tileRows;
+    for (int row = 0; row < visibleRows; row++) {
+        Elements weekdayLabels = { text(" ") };
+        for (StringId name : weekdayNames) {
+            weekdayLabels.push_back(text(Language::text(name)));
+        }
+
+        Elements rowTiles = { vbox(std::move(weekdayLabels)) | size(WIDTH, EQUAL, 2) };
+        for (int column = 0; column < monthsPerRow; column++) {
+            int monthIndex = first + row * monthsPerRow + column;
+
+            auto [it, inserted] = tiles.try_emplace(tileKey(milestone.id, monthIndex));
+            if (inserted) {
+                it->second = buildTile(milestone.id, monthIndex);
+            }
+            rowTiles.push_back(it->second);
+        }
+        tileRows.push_back(hbox(std::move(rowTiles)));
+    }
+
+    return vbox(std::move(tileRows));
+}
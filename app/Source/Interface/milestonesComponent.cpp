@@ -1,4 +1,5 @@
 #include "../../Headers/Interface/milestonesComponent.h"
+#include "../../Headers/Interface/palette.h"
 
 #include <vector>
 #include <string>
@@ -6,6 +7,10 @@
 #include <iostream>
 
 #include "../../Headers/applicationManager.h"
+#include "../../Headers/fileDataOperations.h"
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 
 #include "ftxui/component/component.hpp"
@@ -20,65 +25,58 @@ MilestonesComponent::MilestonesComponent() {
 int MilestonesComponent::addMilestone(FileData *data) {
     if (!data) return -1;
 
-    auto t = std::time(nullptr);
-    auto tm = *std::localtime(&t);
-
-    Date startDate;
-    startDate.year = tm.tm_year + 1900;
-    startDate.month = tm.tm_mon + 1;
-    startDate.day = tm.tm_mday;
-    startDate.hour = tm.tm_hour;
-    startDate.minute = tm.tm_min;
-
-    MilestonesData newMilestone;
-    newMilestone.id = data->milestonesData.size() + 1;
-    newMilestone.startDate = startDate;
-    newMilestone.milestoneName = newMilestoneName;
-    newMilestone.milestoneDescription = newMilestoneDescription;
-
-    data->milestonesData.push_back(newMilestone);
-    return newMilestone.id;
+    return FileDataOperations::addMilestone(data, newMilestoneName, newMilestoneDescription, documentChanges);
 }
 
 void MilestonesComponent::removeMilestone(FileData *data, int id) {
     if (!data) return;
 
-    auto it = std::remove_if(data->milestonesData.begin(), data->milestonesData.end(), [id](const MilestonesData& milestone) {
-        return milestone.id == id;
-    });
-    data->milestonesData.erase(it, data->milestonesData.end());
+    if (calendarIndex) {
+        for (const auto& milestone : data->milestonesData) {
+            if (milestone.id == id) {
+                calendarIndex->removeMilestone(milestone);
+            }
+        }
+    }
+    FileDataOperations::removeMilestone(data, id, documentChanges);
 }
 
 void MilestonesComponent::addMilestoneProgressPoint(FileData *data, int id) {
     if (!data) return;
 
-    auto t = std::time(nullptr);
-    auto tm = *std::localtime(&t);
+    if (!FileDataOperations::addMilestoneProgressPoint(data, id, newProgressPoint.isCompleted, documentChanges)) {
+        notificationText = Language::text("milestones.progressPointExists");
+        return;
+    }
 
-    Date today;
-    today.year = tm.tm_year + 1900;
-    today.month = tm.tm_mon + 1;
-    today.day = tm.tm_mday;
-    today.hour = tm.tm_hour;
-    today.minute = tm.tm_min;
+    auto it = stats.find(id);
+    for (const auto& milestone : data->milestonesData) {
+        if (milestone.id != id) {
+            continue;
+        }
+        if (it != stats.end()) {
+            it->second.addPoint(milestone.progressPoints.back());
+        }
+        if (calendarIndex) {
+            calendarIndex->addProgressPoint(milestone.progressPoints.back());
+        }
+    }
+}
 
-    for (auto& milestone : data->milestonesData) {
-        if (milestone.id == id) {
-            auto it = std::find_if(milestone.progressPoints.begin(), milestone.progressPoints.end(), [&today](const MilestoneProgressPoint& point) {
-                return point.date.year == today.year && point.date.month == today.month && point.date.day == today.day;
-            });
+void MilestonesComponent::setCalendarIndex(CalendarIndex *index) {
+    calendarIndex = index;
+}
 
-            if (it == milestone.progressPoints.end()) {
-                MilestoneProgressPoint newPoint;
-                newPoint.date = today;
-                newPoint.isCompleted = newProgressPoint.isCompleted;
-                milestone.progressPoints.push_back(newPoint);
-            }
-            else {
-                notificationText = "A progress point for today already exists";
-            }
-        }
+void MilestonesComponent::setDocumentChanges(DocumentChanges *changes) {
+    documentChanges = changes;
+}
+
+MilestoneStats& MilestonesComponent::statsFor(const MilestonesData& milestone) {
+    auto [it, inserted] = stats.try_emplace(milestone.id);
+    if (inserted) {
+        it->second.rebuild(milestone);
     }
+    return it->second;
 }
 
 MilestonesProgressPoints MilestonesComponent::getMilestonesPoints(FileData *data, int id) {
@@ -95,9 +93,7 @@ MilestonesProgressPoints MilestonesComponent::getMilestonesPoints(FileData *data
     return points;
 }
 
-Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
-    if (!data) return ftxui::Renderer([] { return ftxui::text("Error: Data is null"); });
-
+void MilestonesComponent::refreshData(FileData *data) {
     milestones.milestones.clear();
     milestones.milestonesIds.clear();
 
@@ -105,15 +101,39 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
         milestones.milestones.push_back(milestone.milestoneName);
         milestones.milestonesIds.push_back(milestone.id);
     }
+
+    selectedMilestones = std::max(0, std::min(selectedMilestones, static_cast<int>(milestones.milestones.size()) - 1));
+    notificationText.clear();
+    heatmap.clear();
+    stats.clear();
+}
+
+MemoryUsage MilestonesComponent::memoryUsage() const {
+    MemoryUsage usage = MemoryReport::of(milestones.milestones);
+    usage += MemoryReport::of(milestones.milestonesIds);
+    usage.records = milestones.milestones.size();
+    return usage;
+}
+
+size_t MilestonesComponent::compact() {
+    return MemoryReport::compact(&milestones.milestones) + MemoryReport::compact(&milestones.milestonesIds);
+}
+
+Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
+    TraceSpan span("MilestonesComponent::renderMilestonesComponent");
+    if (!data) return ftxui::Renderer([] { return ftxui::text(Language::text("ui.dataIsNull")); });
+
+    refreshData(data);
     
     auto milestonesList = ftxui::Menu(&milestones.milestones, &selectedMilestones) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 30);
 
-    auto newMilestoneInput = ftxui::Input(&newMilestoneName, "New Milestone");
-    auto descriptionInput = ftxui::Input(&newMilestoneDescription, "Description");
+    auto newMilestoneInput = ftxui::Input(&newMilestoneName, Language::text("milestones.newMilestone"));
+    auto descriptionInput = ftxui::Input(&newMilestoneDescription, Language::text("milestones.descriptionPlaceholder"));
 
-    auto newProgressPointInput = ftxui::Checkbox("Completed", &newProgressPoint.isCompleted);
+    auto newProgressPointInput = ftxui::Checkbox(Language::text("milestones.completed"), &newProgressPoint.isCompleted);
 
-    auto addMilestoneButton = ftxui::Button("Add Milestone", [data, this] {
+    auto addMilestoneButton = ftxui::Button(Language::text("milestones.add"), [data, this] {
+        TraceSpan span("MilestonesComponent::add");
         if (!newMilestoneName.empty()) {
             int newId = addMilestone(data);
 
@@ -127,10 +147,13 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
         }
     });
 
-    auto removeMilestoneButton = ftxui::Button("Remove Milestone", [data, this] {
+    auto removeMilestoneButton = ftxui::Button(Language::text("milestones.remove"), [data, this] {
+        TraceSpan span("MilestonesComponent::remove");
         if (!milestones.milestones.empty() && selectedMilestones < static_cast<int>(milestones.milestones.size())) {
             int idToRemove = milestones.milestonesIds[selectedMilestones];
             removeMilestone(data, idToRemove);
+            heatmap.clear();
+            stats.erase(idToRemove);
             milestones.milestones.erase(milestones.milestones.begin() + selectedMilestones);
             milestones.milestonesIds.erase(milestones.milestonesIds.begin() + selectedMilestones);
         }
@@ -141,7 +164,8 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
         notificationText.clear();
     };
 
-    auto addProgressPointButton = ftxui::Button("Add Progress Point", [data, clearNotification, this] {
+    auto addProgressPointButton = ftxui::Button(Language::text("milestones.addProgressPoint"), [data, clearNotification, this] {
+        TraceSpan span("MilestonesComponent::addProgressPoint");
         if (!milestones.milestones.empty() && selectedMilestones < static_cast<int>(milestones.milestones.size())) {
             addMilestoneProgressPoint(data, milestones.milestonesIds[selectedMilestones]);
         }
@@ -153,155 +177,99 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
 
     auto selectedMilestoneLabel = Renderer([this] {
         if (milestones.milestones.empty() || selectedMilestones >= static_cast<int>(milestones.milestones.size())) {
-            return ftxui::text("Selected Milestone: No milestone is selected");
+            return ftxui::text(Language::text("milestones.noneSelected"));
         }
         return hbox(
-            ftxui::text("Selected Milestone: "),
+            ftxui::text(Language::text("milestones.selected")),
             paragraph(milestones.milestones[selectedMilestones])
         );
     });
 
     auto selectedMilestoneDescription = Renderer([data, this] {
         if (milestones.milestones.empty() || selectedMilestones >= static_cast<int>(milestones.milestones.size())) {
-            return ftxui::text("Description: No Milestone selected");
+            return ftxui::text(Language::text("milestones.descriptionNoneSelected"));
         }
         const auto& milestone = data->milestonesData[selectedMilestones];
         std::string description = milestone.milestoneDescription;
         if (description.empty()) {
-            description = "Description: No description";
+            description = Language::text("milestones.noDescription");
         }
         return hbox(
-            ftxui::text("Description: "),
+            ftxui::text(Language::text("milestones.descriptionLabel")),
             paragraph(description)
         );
     });
 
     auto milestonesDisplay = ftxui::Renderer(milestonesList, [milestonesList, this] {
         if (milestones.milestones.empty()) {
-            return ftxui::text("Milestones list is empty");
+            return ftxui::text(Language::text("milestones.empty"));
         }
         return milestonesList->Render() | ftxui::vscroll_indicator | ftxui::frame;
     });
 
-    auto milestonesPointsDisplay = ftxui::Container::Vertical({
-        ftxui::Renderer([data, this] {
-            if (milestones.milestones.empty() || selectedMilestones >= static_cast<int>(milestones.milestones.size())) {
-                return ftxui::text("No milestones selected");
-            }
+    auto heatmapNavigation = ftxui::Container::Horizontal({
+        ftxui::Button(Language::text("milestones.previousYear"), [this] { TraceSpan span("MilestonesComponent::previousYear"); heatmap.scroll(12); }, ftxui::ButtonOption::Ascii()),
+        ftxui::Button(Language::text("milestones.previousMonth"), [this] { TraceSpan span("MilestonesComponent::previousMonth"); heatmap.scroll(1); }, ftxui::ButtonOption::Ascii()),
+        ftxui::Button(Language::text("date.today"), [this] { TraceSpan span("MilestonesComponent::today"); heatmap.scrollToToday(); }, ftxui::ButtonOption::Ascii()),
+        ftxui::Button(Language::text("milestones.nextMonth"), [this] { TraceSpan span("MilestonesComponent::nextMonth"); heatmap.scroll(-1); }, ftxui::ButtonOption::Ascii()),
+        ftxui::Button(Language::text("milestones.nextYear"), [this] { TraceSpan span("MilestonesComponent::nextYear"); heatmap.scroll(-12); }, ftxui::ButtonOption::Ascii()),
+    });
 
-            auto milestonePoints = getMilestonesPoints(data, milestones.milestonesIds[selectedMilestones]);
-
-            auto c = ftxui::Canvas(104, 78);
-
-
-            auto t = std::time(nullptr);
-            auto tm = *std::localtime(&t);
-
-            Date min_date;
-            min_date.year = tm.tm_year + 1900;
-            min_date.month = tm.tm_mon + 1;
-            min_date.day = tm.tm_mday;
-            min_date.hour = tm.tm_hour;
-            min_date.minute = tm.tm_min;
-
-            auto max_date = min_date;
-            tm = {};
-            tm.tm_year = min_date.year - 1900;
-            tm.tm_mon = min_date.month - 1;
-            tm.tm_mday = min_date.day;
-            std::time_t time = std::mktime(&tm);
-            time -= 104 * 24 * 60 * 60; 
-            std::tm *new_tm = std::localtime(&time);
-            max_date.year = new_tm->tm_year + 1900;
-            max_date.month = new_tm->tm_mon + 1;
-            max_date.day = new_tm->tm_mday;
-
-            // Draw the date range at the top of the canvas
-            std::string date_range = "From: " + std::to_string(max_date.year) + "-" + std::to_string(max_date.month) + "-" + std::to_string(max_date.day) +
-                                     "  To: " + std::to_string(min_date.year) + "-" + std::to_string(min_date.month) + "-" + std::to_string(min_date.day);
-            c.DrawText(0, 2, date_range, Color::White);
-
-            int x = 0;
-            int y = 6;
-
-            for (size_t i = 0; i < 13; i++) {
-                for (size_t j = 0; j < 8; j++) {
-                    c.DrawText(x, y, std::to_string(i), Color::White);
-
-                    auto point_date = max_date;
-                    auto days_to_add = std::chrono::days(-((i * 8) + j));
-                    auto new_date = std::chrono::system_clock::from_time_t(std::mktime(&tm)) + days_to_add;
-                    std::time_t new_time = std::chrono::system_clock::to_time_t(new_date);
-                    std::tm new_tm = *std::localtime(&new_time);
-                    point_date.year = new_tm.tm_year + 1900;
-                    point_date.month = new_tm.tm_mon + 1;
-                    point_date.day = new_tm.tm_mday;
-
-                    auto it = std::find_if(milestonePoints.progressPoints.begin(), milestonePoints.progressPoints.end(), [&point_date](const MilestoneProgressPoint& point) {
-                        return point.date.year == point_date.year && point.date.month == point_date.month && point.date.day == point_date.day;
-                    });
-
-                    if (it != milestonePoints.progressPoints.end()) {
-                        const auto& point = *it;
-
-                        auto color = point.isCompleted ? Color::GreenLight : Color::RedLight;
-
-                        c.DrawBlock(x, y, 1, color); 
-                        c.DrawBlock(x + 1, y, 1, color); 
-                        c.DrawBlock(x + 2, y, 1, color); 
-                        c.DrawBlock(x + 3, y, 1, color); 
-
-                        c.DrawBlock(x, y + 1, 1, color); 
-                        c.DrawBlock(x + 1, y + 1, 1, color); 
-                        c.DrawBlock(x + 2, y + 1, 1, color); 
-                        c.DrawBlock(x + 3, y + 1, 1, color); 
-                        
-                        c.DrawBlock(x, y + 2, 1, color); 
-                        c.DrawBlock(x + 1, y + 2, 1, color); 
-                        c.DrawBlock(x + 2, y + 2, 1, color); 
-                        c.DrawBlock(x + 3, y + 2, 1, color); 
-
-                        c.DrawBlock(x, y + 3, 1, color); 
-                        c.DrawBlock(x + 1, y + 3, 1, color); 
-                        c.DrawBlock(x + 2, y + 3, 1, color); 
-                        c.DrawBlock(x + 3, y + 3, 1, color); 
-                    }
-                    else {
-                        auto color = Color::Blue;
-
-                        c.DrawBlock(x, y, 1, color); 
-                        c.DrawBlock(x + 1, y, 1, color); 
-                        c.DrawBlock(x + 2, y, 1, color); 
-                        c.DrawBlock(x + 3, y, 1, color); 
-
-                        c.DrawBlock(x, y + 1, 1, color); 
-                        c.DrawBlock(x + 1, y + 1, 1, color); 
-                        c.DrawBlock(x + 2, y + 1, 1, color); 
-                        c.DrawBlock(x + 3, y + 1, 1, color); 
-                        
-                        c.DrawBlock(x, y + 2, 1, color); 
-                        c.DrawBlock(x + 1, y + 2, 1, color); 
-                        c.DrawBlock(x + 2, y + 2, 1, color); 
-                        c.DrawBlock(x + 3, y + 2, 1, color); 
-
-                        c.DrawBlock(x, y + 3, 1, color); 
-                        c.DrawBlock(x + 1, y + 3, 1, color); 
-                        c.DrawBlock(x + 2, y + 3, 1, color); 
-                        c.DrawBlock(x + 3, y + 3, 1, color); 
-                    }
-                    
-
-                    x += 8;
-                    if (x >= 104) {
-                        x = 0;
-                        y += 8;
-                    }
-                }
-            }
+    auto heatmapDisplay = ftxui::Renderer([data, this] {
+        if (milestones.milestones.empty() || selectedMilestones >= static_cast<int>(milestones.milestones.size())) {
+            return ftxui::text(Language::text("milestones.nothingSelected"));
+        }
+
+        int id = milestones.milestonesIds[selectedMilestones];
+        auto it = std::find_if(data->milestonesData.begin(), data->milestonesData.end(), [id](const MilestonesData& milestone) {
+            return milestone.id == id;
+        });
+        if (it == data->milestonesData.end()) {
+            return ftxui::text(Language::text("milestones.nothingSelected"));
+        }
+
+        return ftxui::vbox({
+            ftxui::text(heatmap.rangeLabel()),
+            heatmap.render(*it),
+        });
+    });
+
+    auto milestonesPointsDisplay = ftxui::CatchEvent(ftxui::Container::Vertical({
+        heatmapNavigation,
+        heatmapDisplay,
+    }), [this](ftxui::Event event) {
+        if (event == ftxui::Event::PageUp) {
+            heatmap.scroll(1);
+            return true;
+        }
+        if (event == ftxui::Event::PageDown) {
+            heatmap.scroll(-1);
+            return true;
+        }
+        return false;
+    });
+
+    auto statsDisplay = ftxui::Renderer([data, this] {
+        if (milestones.milestones.empty() || selectedMilestones >= static_cast<int>(milestones.milestones.size())) {
+            return ftxui::text(Language::text("milestones.nothingSelected"));
+        }
+
+        int id = milestones.milestonesIds[selectedMilestones];
+        auto it = std::find_if(data->milestonesData.begin(), data->milestonesData.end(), [id](const MilestonesData& milestone) {
+            return milestone.id == id;
+        });
+        if (it == data->milestonesData.end()) {
+            return ftxui::text(Language::text("milestones.nothingSelected"));
+        }
+
+        const MilestoneSummary& summary = statsFor(*it).summary(DateUtils::dayNumber(DateUtils::today()));
 
-            return canvas(std::move(c));
-        }) 
-    });     
+        ftxui::Elements lines;
+        for (const auto& line : MilestoneStats::describe(summary)) {
+            lines.push_back(ftxui::text(line));
+        }
+        return ftxui::vbox(std::move(lines));
+    });
 
     auto notification = ftxui::Renderer([this] {
         if (notificationText.empty()) {
@@ -313,12 +281,12 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
     return ftxui::Container::Horizontal({
         ftxui::Renderer([] { return filler(); }),
         ftxui::Container::Vertical({
-            Renderer([] { return text("Milestones list:"); }),
-            milestonesDisplay | ftxui::size(ftxui::HEIGHT, ftxui::EQUAL, 20),
+            Renderer([] { return text(Language::text("milestones.list")); }),
+            milestonesDisplay | ftxui::size(ftxui::HEIGHT, ftxui::EQUAL, 10),
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
             ftxui::Container::Vertical({
-                ftxui::Renderer([] { return ftxui::text("Progress Points:"); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.progressPoints")); }),
                 milestonesPointsDisplay,
             }),
         }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 60) | ftxui::size(ftxui::HEIGHT, ftxui::EQUAL, 50),
@@ -331,10 +299,10 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
         }),
         ftxui::Container::Vertical({
             ftxui::Container::Vertical({
-                Renderer([] { return text("Add Milestone:"); }),
-                ftxui::Renderer([] { return ftxui::text("Milestone Title:"); }),
+                Renderer([] { return text(Language::text("milestones.addHeader")); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.title")); }),
                 newMilestoneInput | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 30),
-                ftxui::Renderer([] { return ftxui::text("Description:"); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.description")); }),
                 descriptionInput | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 45),
                 addMilestoneButton | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 20),
             }),
@@ -348,7 +316,7 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
             ftxui::Container::Vertical({
-                ftxui::Renderer([] { return ftxui::text("Add Progress Point:"); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.addProgressPointHeader")); }),
                 newProgressPointInput,
                 addProgressPointButton | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 20),
                 ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
@@ -357,10 +325,16 @@ Component MilestonesComponent::renderMilestonesComponent(FileData *data) {
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
             ftxui::Container::Vertical({
-                ftxui::Renderer([] { return ftxui::text("Progess Points Legend:"); }),
-                ftxui::Renderer([] { return ftxui::text("Green Box: Completed") | ftxui::color(ftxui::Color::GreenLight); }),
-                ftxui::Renderer([] { return ftxui::text("Red Box: Not Completed") | ftxui::color(ftxui::Color::RedLight); }),
-                ftxui::Renderer([] { return ftxui::text("Blue Box: Not Added") | ftxui::color(ftxui::Color::Blue); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.legend")); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.legendCompleted")) | ftxui::color(Palette::color(ThemeRole::PointCompleted)); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.legendNotCompleted")) | ftxui::color(Palette::color(ThemeRole::PointNotCompleted)); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.legendNotAdded")) | ftxui::color(Palette::color(ThemeRole::PointNotAdded)); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.legendUpcoming")) | ftxui::color(Palette::color(ThemeRole::PointUpcoming)); }),
+            }),
+            ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
+            ftxui::Container::Vertical({
+                ftxui::Renderer([] { return ftxui::text(Language::text("milestones.stats")); }),
+                statsDisplay,
             })
         }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 60) | ftxui::size(ftxui::HEIGHT, ftxui::EQUAL, 50),
         ftxui::Renderer([] { return filler(); }),
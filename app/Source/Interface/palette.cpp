@@ -0,0 +1,120 @@
+#include "../../Headers/Interface/palette.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../../Headers/theme.h"
+
+#include "ftxui/dom/elements.hpp"
+#include "ftxui/dom/linear_gradient.hpp"
+#include "ftxui/dom/node.hpp"
+#include "ftxui/screen/color.hpp"
+#include "ftxui/screen/screen.hpp"
+
+using namespace ftxui;
+
+namespace {
+    Color toColor(const ThemeColor& color) {
+        switch (color.kind) {
+            case ThemeColorKind::Palette16:
+                return Color(static_cast<Color::Palette16>(color.index));
+            case ThemeColorKind::Palette256:
+                return Color(static_cast<Color::Palette256>(color.index));
+            case ThemeColorKind::Rgb:
+                return Color::RGB(color.red, color.green, color.blue);
+            default:
+                return Color::Default;
+        }
+    }
+
+    /**
+     * @brief Like color(LinearGradient), but copies the colors of a raster made once instead of computing them.
+     */
+    class RasterizedFrame : public Node {
+    public:
+        RasterizedFrame(Element child, const std::vector<Color>& (*rasterFor)(int, int)) : Node({ std::move(child) }), rasterFor(rasterFor) {}
+
+        void ComputeRequirement() override {
+            Node::ComputeRequirement();
+            requirement_ = children_[0]->requirement();
+        }
+
+        void SetBox(Box box) override {
+            Node::SetBox(box);
+            children_[0]->SetBox(box);
+        }
+
+        void Render(Screen& screen) override {
+            Node::Render(screen);
+
+            int width = box_.x_max - box_.x_min + 1;
+            int height = box_.y_max - box_.y_min + 1;
+            if (width <= 0 || height <= 0) {
+                return;
+            }
+            const std::vector<Color>& colors = rasterFor(width, height);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    screen.PixelAt(box_.x_min + x, box_.y_min + y).foreground_color = colors[static_cast<size_t>(y * width + x)];
+                }
+            }
+        }
+
+    private:
+        const std::vector<Color>& (*rasterFor)(int, int);
+    };
+}
+
+std::array<Color, themeRoleCount> Palette::colors;
+std::vector<Color> Palette::frameColors;
+int Palette::frameAngle = 45;
+FrameRaster Palette::raster;
+
+void Palette::use(const Theme& theme) {
+    for (size_t role = 0; role < themeRoleCount; role++) {
+        colors[role] = toColor(theme.colors[role]);
+    }
+    frameColors.clear();
+    for (const auto& color : theme.frame) {
+        frameColors.push_back(toColor(color));
+    }
+    frameAngle = theme.frameAngle;
+    raster = FrameRaster();
+}
+
+const std::vector<Color>& Palette::rasterFor(int width, int height) {
+    if (raster.width == width && raster.height == height) {
+        return raster.colors;
+    }
+
+    // Drawn once with FTXUI's own gradient, so the frame looks exactly as it did before
+    LinearGradient gradient;
+    gradient.Angle(static_cast<float>(frameAngle));
+    for (const auto& color : frameColors) {
+        gradient.Stop(color);
+    }
+    Screen canvas = Screen::Create(Dimension::Fixed(width), Dimension::Fixed(height));
+    ftxui::Render(canvas, text("") | size(WIDTH, EQUAL, width) | size(HEIGHT, EQUAL, height) | ftxui::color(gradient));
+
+    raster.width = width;
+    raster.height = height;
+    raster.colors.clear();
+    raster.colors.reserve(static_cast<size_t>(width * height));
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            raster.colors.push_back(canvas.PixelAt(x, y).foreground_color);
+        }
+    }
+    return raster.colors;
+}
+
+Element Palette::frame(Element element) {
+    if (frameColors.empty()) {
+        return element;
+    }
+    if (frameColors.size() == 1) {
+        return element | ftxui::color(frameColors[0]);
+    }
+    return std::make_shared<RasterizedFrame>(std::move(element), &Palette::rasterFor);
+}
@@ -1,4 +1,6 @@
 #include "../../Headers/Interface/todosComponent.h"
+#include "../../Headers/Interface/palette.h"
+#include "../../Headers/Interface/dateTimeInput.h"
 
 #include <vector>
 #include <string>
@@ -6,6 +8,13 @@
 #include <iostream>
 
 #include "../../Headers/applicationManager.h"
+#include "../../Headers/fileDataOperations.h"
+#include "../../Headers/todoQuery.h"
+#include "../../Headers/dueDateIndex.h"
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/recurrence.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
 #include "../../../l4dFiles/out/l4dFiles.hpp"
 
 #include "ftxui/component/component.hpp"
@@ -14,194 +23,297 @@
 
 using namespace ftxui;
 
+namespace {
+    // Occurrences of recurring todos shown around today when there is no filter
+    constexpr int occurrenceDaysBefore = 7;
+    constexpr int occurrenceDaysAfter = 7;
+}
+
 TodosComponent::TodosComponent() {
     selectedTodos = 0;
 }
 
-ftxui::Component TodosComponent::limitedRangeInput(std::string* content, const std::string& placeholder, int minValue, int maxValue) {
-    auto input = ftxui::Input(content, placeholder);
-    
-    return ftxui::Renderer(input, [content, input, minValue, maxValue]() {
-        if (!content->empty()) {
-            try {
-                int value = std::stoi(*content);
-                if (value < minValue) {
-                    *content = std::to_string(minValue);
-                }
-                else if (value > maxValue) {
-                    *content = std::to_string(maxValue);
-                } 
-            } catch (const std::invalid_argument&) {
-                *content = std::to_string(minValue);
-            }
-        }
-        return input->Render();
-    });
+void TodosComponent::setUpcomingIndex(UpcomingIndex *index) {
+    upcomingIndex = index;
 }
 
-ftxui::Component TodosComponent::limitedRangeInputDay(std::string* content, const std::string& placeholder) {
-    auto input = ftxui::Input(content, placeholder);
+void TodosComponent::setCalendarIndex(CalendarIndex *index) {
+    calendarIndex = index;
+}
 
-    return ftxui::Renderer(input, [content, input, this]() {
-        if (!content->empty()) {
-            int minValue = 1;
-            int maxValue = 31;
+void TodosComponent::setDocumentChanges(DocumentChanges *changes) {
+    documentChanges = changes;
+}
 
-            try {
-                int month = std::stoi(this->dueMonth);
-                if (month == 2) {
-                    int year = std::stoi(this->dueYear);
-                    if ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0) {
-                        maxValue = 29;
-                    } else {
-                        maxValue = 28;
-                    }
-                } else if (month == 4 || month == 6 || month == 9 || month == 11) {
-                    maxValue = 30;
-                }
-                int value = std::stoi(*content);
-                if (value < minValue) {
-                    *content = std::to_string(minValue);
-                }
-                else if (value > maxValue) {
-                    *content = std::to_string(maxValue);
-                } 
-            } catch (const std::invalid_argument&) {
-                *content = std::to_string(minValue);
-            }
-        }
-        return input->Render();
-    });
+int TodosComponent::addTodo(FileData *data, Date dueDate, const RecurrenceRule& rule) {
+    dueDateIndexDirty = true;
+    int id = FileDataOperations::addTodo(data, this->newTodoName, this->newTodoDescription, dueDate, documentChanges);
+    if (rule.kind != RecurrenceKind::None) {
+        Recurrence::setRule(&data->todosData.back(), rule);
+    }
+    if (upcomingIndex) {
+        upcomingIndex->update(data->todosData.back());
+    }
+    if (calendarIndex) {
+        calendarIndex->addTodo(data->todosData.back());
+    }
+    return id;
 }
 
-int TodosComponent::addTodo(FileData *data, Date dueDate) {
-    TodoData newTodo;
-    
-    newTodo.id = data->todosData.size() + 1;
+void TodosComponent::removeTodo(FileData *data, int id) {
+    dueDateIndexDirty = true;
+    const TodoData *todo = findTodo(data, id);
+    if (calendarIndex && todo) {
+        calendarIndex->removeTodo(*todo);
+    }
+    FileDataOperations::removeTodo(data, id, documentChanges);
+    if (upcomingIndex) {
+        upcomingIndex->remove(id);
+    }
+}
 
-    auto t = std::time(nullptr);
-    auto tm = *std::localtime(&t);
+void TodosComponent::markTodoDone(FileData *data, int id, bool done) {
+    const TodoData *todo = findTodo(data, id);
+    if (calendarIndex && todo) {
+        calendarIndex->removeTodo(*todo);
+    }
+    FileDataOperations::markTodoDone(data, id, done, documentChanges);
+    if (upcomingIndex && todo) {
+        upcomingIndex->update(*todo);
+    }
+    if (calendarIndex && todo) {
+        calendarIndex->addTodo(*todo);
+    }
+}
 
-    Date createDate;
-    createDate.day = tm.tm_mday;
-    createDate.month = tm.tm_mon + 1;
-    createDate.year = tm.tm_year + 1900;
-    createDate.hour = tm.tm_hour;
-    createDate.minute = tm.tm_min;
-    newTodo.createDate = createDate;
+void TodosComponent::markOccurrenceDone(FileData *data, int id, int day, bool done) {
+    const TodoData *todo = findTodo(data, id);
+    if (calendarIndex && todo) {
+        calendarIndex->removeTodo(*todo);
+    }
+    FileDataOperations::markOccurrenceDone(data, id, day, done, documentChanges);
+    // The next open occurrence may have moved
+    if (upcomingIndex && todo) {
+        upcomingIndex->update(*todo);
+    }
+    if (calendarIndex && todo) {
+        calendarIndex->addTodo(*todo);
+    }
+}
 
-    newTodo.dueDate = dueDate;
+void TodosComponent::refreshData(FileData *data) {
+    dueDateIndexDirty = true;
+    rebuildList(data);
+}
 
-    newTodo.todoName = this->newTodoName;
-    newTodo.todoDescription = this->newTodoDescription;
+MemoryUsage TodosComponent::memoryUsage() const {
+    MemoryUsage usage = MemoryReport::of(todos.todos);
+    usage += MemoryReport::of(todos.todosIds);
+    usage += MemoryReport::of(todos.occurrenceDays);
+    // One record per row, not per vector
+    usage.records = todos.todos.size();
+    return usage;
+}
 
-    data->todosData.push_back(newTodo);
-    return newTodo.id;
+size_t TodosComponent::compact() {
+    return MemoryReport::compact(&todos.todos) + MemoryReport::compact(&todos.todosIds) + MemoryReport::compact(&todos.occurrenceDays);
 }
 
-void TodosComponent::removeTodo(FileData *data, int id) {
-    auto it = std::remove_if(data->todosData.begin(), data->todosData.end(), [id](const TodoData& todo) {
-        return todo.id == id;
-    });
-    data->todosData.erase(it, data->todosData.end());
+void TodosComponent::addOccurrenceRow(const TodoData& todo, int day, bool done) {
+    std::string label = todo.todoName;
+    if (FileDataOperations::isTodoDone(todo)) {
+        label.resize(label.size() - std::char_traits<char>::length(FileDataOperations::doneSuffix));
+    }
+    label += " [" + DateUtils::toString(DateUtils::fromDayNumber(day)) + "]";
+    if (done) {
+        label += FileDataOperations::doneSuffix;
+    }
+
+    todos.todos.push_back(label);
+    todos.todosIds.push_back(todo.id);
+    todos.occurrenceDays.push_back(day);
 }
 
-void TodosComponent::markTodoDone(FileData *data, int id, bool done) {
-    for (auto& todo : data->todosData) {
-        if (todo.id == id) {
-            if (done) {
-                todo.todoName += " (done)";
+void TodosComponent::rebuildList(FileData *data) {
+    todos.todos.clear();
+    todos.todosIds.clear();
+    todos.occurrenceDays.clear();
+
+    // Recurring todos are listed as their occurrences, expanded only for the days shown
+    recurrenceIndex.rebuild(data->todosData);
+    int today = DateUtils::dayNumber(DateUtils::today());
+
+    if (filter.empty()) {
+        for (uint32_t i = 0; i < data->todosData.size(); i++) {
+            if (recurrenceIndex.isSeries(i)) {
+                continue;
             }
-            else {
-                todo.todoName.erase(todo.todoName.size() - 7);
+            todos.todos.push_back(data->todosData[i].todoName);
+            todos.todosIds.push_back(data->todosData[i].id);
+            todos.occurrenceDays.push_back(TodosListData::plainTodo);
+        }
+
+        std::vector<Occurrence> occurrences;
+        recurrenceIndex.expand(today - occurrenceDaysBefore, today + occurrenceDaysAfter, &occurrences);
+        for (const auto& occurrence : occurrences) {
+            addOccurrenceRow(data->todosData[occurrence.position], occurrence.day, occurrence.done);
+        }
+    }
+    else {
+        if (dueDateIndexDirty) {
+            dueDateIndex.rebuild(data->todosData);
+            dueDateIndexDirty = false;
+        }
+        for (uint32_t position : filter.run(data->todosData, &dueDateIndex)) {
+            if (recurrenceIndex.isSeries(position)) {
+                continue;
             }
+            todos.todos.push_back(data->todosData[position].todoName);
+            todos.todosIds.push_back(data->todosData[position].id);
+            todos.occurrenceDays.push_back(TodosListData::plainTodo);
+        }
+        for (const auto& occurrence : filter.runOccurrences(data->todosData, recurrenceIndex, today)) {
+            addOccurrenceRow(occurrence, DateUtils::dayNumber(occurrence.dueDate), FileDataOperations::isTodoDone(occurrence));
         }
     }
-}
 
-ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
-    if (!data) return ftxui::Renderer([] { return ftxui::text("Error: Data is null"); });
+    selectedTodos = std::max(0, std::min(selectedTodos, static_cast<int>(todos.todos.size()) - 1));
+}
 
-    todos.todos.clear();
-    todos.todosIds.clear();
+void TodosComponent::applyFilter(FileData *data) {
+    TodoQuery compiled;
+    if (!TodoQuery::compile(filterText, &compiled, &filterError)) {
+        return;
+    }
+    filterError.clear();
+    filter = std::move(compiled);
+    rebuildList(data);
+}
 
-    for (const auto& todo : data->todosData) {
-        todos.todos.push_back(todo.todoName);
-        todos.todosIds.push_back(todo.id);
+const TodoData* TodosComponent::findTodo(FileData *data, int id) {
+    // The list shows todos in their order in the data, so the last position found is a good first guess
+    if (selectedTodoHint < data->todosData.size() && data->todosData[selectedTodoHint].id == id) {
+        return &data->todosData[selectedTodoHint];
+    }
+    for (size_t i = 0; i < data->todosData.size(); i++) {
+        if (data->todosData[i].id == id) {
+            selectedTodoHint = i;
+            return &data->todosData[i];
+        }
     }
+    return nullptr;
+}
+
+ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
+    TraceSpan span("TodosComponent::renderTodosComponent");
+    if (!data) return ftxui::Renderer([] { return ftxui::text(Language::text("ui.dataIsNull")); });
+
+    refreshData(data);
 
     auto todosList = ftxui::Menu(&todos.todos, &selectedTodos) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 30);
 
-    auto newTodoInput = ftxui::Input(&newTodoName, "New Todo");
-    auto descriptionInput = ftxui::Input(&newTodoDescription, "Description");
-
-    auto t = std::time(nullptr);
-    auto tm = *std::localtime(&t);
-
-    this->dueYear = std::to_string(tm.tm_year + 1900);
-    this->dueMonth = std::to_string(tm.tm_mon + 1);
-    this->dueDay = std::to_string(tm.tm_mday + 1);
-    this->dueHour = std::to_string(tm.tm_hour);
-    this->dueMinute = std::to_string(tm.tm_min);
-
-    auto inputDueYear = limitedRangeInput(&dueYear, "Year", 1900, 2100) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 5);
-    auto inputDueMonth = limitedRangeInput(&dueMonth, "Month", 1, 12) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 3);
-    auto inputDueDay = limitedRangeInputDay(&dueDay, "Day") | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 3);
-    auto inputDueHour = limitedRangeInput(&dueHour, "Hour", 0, 23) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 3);
-    auto inputDueMinute = limitedRangeInput(&dueMinute, "Minute", 1, 60) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 3);
-
-    auto dueDateInputs = ftxui::Container::Horizontal({
-        inputDueYear,
-        ftxui::Renderer([] { return ftxui::text("- "); }),
-        inputDueMonth,
-        ftxui::Renderer([] { return ftxui::text("- "); }),
-        inputDueDay,
-        ftxui::Renderer([] { return ftxui::text("/ "); }),
-        inputDueHour,
-        ftxui::Renderer([] { return ftxui::text(": "); }),
-        inputDueMinute,
+    ftxui::InputOption filterOption;
+    filterOption.multiline = false;
+    filterOption.on_change = [data, this] {
+        applyFilter(data);
+    };
+    auto filterInput = ftxui::Input(&filterText, Language::text("todos.filter"), filterOption);
+
+    auto filterErrorLabel = ftxui::Renderer([this] {
+        if (filterError.empty()) {
+            return ftxui::text("");
+        }
+        return ftxui::text(filterError) | ftxui::color(Palette::color(ThemeRole::Error));
     });
 
-    auto addButton = ftxui::Button("Add Todo", [data, this] {
-        if (!newTodoName.empty()) {
+    auto newTodoInput = ftxui::Input(&newTodoName, Language::text("todos.newTodo"));
+    auto descriptionInput = ftxui::Input(&newTodoDescription, Language::text("todos.descriptionPlaceholder"));
+    auto repeatInput = ftxui::Input(&newTodoRepeat, Language::text("todos.repeatPlaceholder"));
+
+    auto repeatErrorLabel = ftxui::Renderer([this] {
+        if (repeatError.empty()) {
+            return ftxui::text("");
+        }
+        return ftxui::text(repeatError) | ftxui::color(Palette::color(ThemeRole::Error));
+    });
+
+    auto dueDateInputs = dueDateInput.component();
+
+    auto addButton = ftxui::Button(Language::text("todos.add"), [data, this] {
+        TraceSpan span("TodosComponent::add");
+        if (!newTodoName.empty() && dueDateInput.valid()) {
             try {
-                int newId = addTodo(data, {static_cast<short>(std::stoi(dueDay)), static_cast<short>(std::stoi(dueMonth)), static_cast<short>(std::stoi(dueYear)), static_cast<short>(std::stoi(dueHour)), static_cast<short>(std::stoi(dueMinute))});
-                todos.todos.push_back(newTodoName);
-                todos.todosIds.push_back(newId);
+                Date dueDate = dueDateInput.date();
+                RecurrenceRule rule;
+                if (!newTodoRepeat.empty() && !Recurrence::parseRule(newTodoRepeat, DateUtils::dayNumber(dueDate), &rule, &repeatError)) {
+                    return;
+                }
+                repeatError.clear();
+
+                int newId = addTodo(data, dueDate, rule);
+                if (rule.kind == RecurrenceKind::None) {
+                    todos.todos.push_back(newTodoName);
+                    todos.todosIds.push_back(newId);
+                    todos.occurrenceDays.push_back(TodosListData::plainTodo);
+                }
                 newTodoName.clear();
                 newTodoDescription.clear();
+                newTodoRepeat.clear();
+                if (!filter.empty() || rule.kind != RecurrenceKind::None) {
+                    rebuildList(data);
+                }
             } catch (const std::bad_alloc& e) {
                 std::cerr << "Memory allocation failed: " << e.what() << std::endl;
             }
         }
     }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 20);
 
-    auto removeButton = ftxui::Button("Remove Todo", [data, this] {
+    auto removeButton = ftxui::Button(Language::text("todos.remove"), [data, this] {
+        TraceSpan span("TodosComponent::remove");
         if (!todos.todos.empty() && selectedTodos < static_cast<int>(todos.todos.size())) {
             int idToRemove = todos.todosIds[selectedTodos];
+            // Removing an occurrence removes the recurring todo with all its other rows
+            bool recurring = todos.occurrenceDays[selectedTodos] != TodosListData::plainTodo;
             todos.todos.erase(todos.todos.begin() + selectedTodos);
             todos.todosIds.erase(todos.todosIds.begin() + selectedTodos);
+            todos.occurrenceDays.erase(todos.occurrenceDays.begin() + selectedTodos);
             this->selectedTodos = std::max(0, this->selectedTodos - 1);
             removeTodo(data, idToRemove);
+            if (!filter.empty() || recurring) {
+                rebuildList(data);
+            }
         }
     }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 20);
 
-    auto markDoneButton = ftxui::Button("Mark Done", [data, this] {
+    auto markDoneButton = ftxui::Button(Language::text("todos.markDone"), [data, this] {
+        TraceSpan span("TodosComponent::markDone");
         if (!todos.todos.empty() && selectedTodos < static_cast<int>(todos.todos.size())) {
+            int occurrenceDay = todos.occurrenceDays[selectedTodos];
             if (!todos.todos[selectedTodos].ends_with("(done)")) {
                 todos.todos[selectedTodos] += " (done)"; 
-                markTodoDone(data, todos.todosIds[selectedTodos], true);
+                if (occurrenceDay != TodosListData::plainTodo) {
+                    markOccurrenceDone(data, todos.todosIds[selectedTodos], occurrenceDay, true);
+                } else {
+                    markTodoDone(data, todos.todosIds[selectedTodos], true);
+                }
             }
             else {
                 todos.todos[selectedTodos].erase(todos.todos[selectedTodos].size() - 7);
-                markTodoDone(data, todos.todosIds[selectedTodos], false);
+                if (occurrenceDay != TodosListData::plainTodo) {
+                    markOccurrenceDone(data, todos.todosIds[selectedTodos], occurrenceDay, false);
+                } else {
+                    markTodoDone(data, todos.todosIds[selectedTodos], false);
+                }
+            }
+            if (!filter.empty()) {
+                rebuildList(data);
             }
         }
     }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 20);
 
     auto todosDisplay = ftxui::Renderer(todosList, [todosList, this] {
         if (todos.todos.empty()) {
-            return ftxui::text("Todo list is empty");
+            return ftxui::text(filter.empty() ? Language::text("todos.empty") : Language::text("todos.noMatch"));
         }
         return ftxui::vbox({
             todosList->Render() | ftxui::vscroll_indicator | ftxui::frame,
@@ -215,19 +327,27 @@ ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
 
     auto selectedTodoLabel = Renderer([this] {
         if (todos.todos.empty() || selectedTodos >= static_cast<int>(todos.todos.size())) {
-            return ftxui::text("Selected Todo: No todo is selected");
+            return ftxui::text(Language::text("todos.noneSelected"));
         }
         return hbox(
-            ftxui::text("Selected Todo: "),
+            ftxui::text(Language::text("todos.selected")),
             paragraph(todos.todos[selectedTodos])
         );
     });
 
     auto selectedTodoDate = ftxui::Renderer([data, this] {
         if (todos.todos.empty() || selectedTodos >= static_cast<int>(todos.todos.size())) {
-            return ftxui::text("Due Date: No Todo selected");
+            return ftxui::text(Language::text("todos.dueDateNoneSelected"));
+        }
+        const TodoData *selectedTodo = findTodo(data, todos.todosIds[selectedTodos]);
+        if (!selectedTodo) {
+            return ftxui::text(Language::text("todos.dueDateNoneSelected"));
+        }
+        TodoData todo = *selectedTodo;
+        // An occurrence is due on its own day, at the time of the recurring todo
+        if (todos.occurrenceDays[selectedTodos] != TodosListData::plainTodo) {
+            todo = Recurrence::occurrence(todo, todos.occurrenceDays[selectedTodos], false);
         }
-        const auto& todo = data->todosData[selectedTodos];
 
         int month = todo.dueDate.month;
         std::string monthText = std::to_string(month);
@@ -251,7 +371,7 @@ ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
             minuteText = "0" + minuteText;
         }
 
-        std::string dateText = "Due Date: " + std::to_string(todo.dueDate.year) + "-" +
+        std::string dateText = Language::text("todos.dueDateLabel") + std::to_string(todo.dueDate.year) + "-" +
                                 monthText + "-" + dayText + " " +
                                 hourText + ":" + minuteText;
         return ftxui::text(dateText);
@@ -259,16 +379,23 @@ ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
 
     auto selectedTodoDescription = ftxui::Renderer([data, this] {
         if (todos.todos.empty() || selectedTodos >= static_cast<int>(todos.todos.size())) {
-            return ftxui::text("Description: No Todo selected");
+            return ftxui::text(Language::text("todos.descriptionNoneSelected"));
         }
-        const auto& todo = data->todosData[selectedTodos];
-        std::string description = todo.todoDescription;
+        const TodoData *selectedTodo = findTodo(data, todos.todosIds[selectedTodos]);
+        if (!selectedTodo) {
+            return ftxui::text(Language::text("todos.descriptionNoneSelected"));
+        }
+        const auto& todo = *selectedTodo;
+        std::string description = Recurrence::description(todo);
         if (description.empty()) {
-            description = "No description";
+            description = Language::text("todos.noDescription");
+        }
+        if (Recurrence::isRecurring(todo)) {
+            description += Language::format("todos.repeats", { Recurrence::formatRule(Recurrence::rule(todo)) });
         }
 
         return hbox(
-            ftxui::text("Description: "),
+            ftxui::text(Language::text("todos.descriptionLabel")),
             paragraph(description)
         );
     });
@@ -276,7 +403,9 @@ ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
     return ftxui::Container::Horizontal({
         ftxui::Renderer([] { return filler(); }),
         ftxui::Container::Vertical({
-            Renderer([] { return text("Todos list:"); }),
+            Renderer([] { return text(Language::text("todos.list")); }),
+            filterInput | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 58),
+            filterErrorLabel,
             todosDisplay,
         }) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 60) | ftxui::size(ftxui::HEIGHT, ftxui::EQUAL, 50),
         Renderer([]() -> Element {
@@ -288,13 +417,16 @@ ftxui::Component TodosComponent::renderTodosComponent(FileData *data) {
         }),
         ftxui::Container::Vertical({
             ftxui::Container::Vertical({
-                Renderer([] { return text("Add Todo:"); }),
-                ftxui::Renderer([] { return ftxui::text("Todo Title:"); }),
+                Renderer([] { return text(Language::text("todos.addHeader")); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("todos.title")); }),
                 newTodoInput | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 30),
-                ftxui::Renderer([] { return ftxui::text("Description:"); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("todos.description")); }),
                 descriptionInput | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 45),
-                ftxui::Renderer([] { return ftxui::text("Due Date:"); }),
+                ftxui::Renderer([] { return ftxui::text(Language::text("todos.dueDate")); }),
                 dueDateInputs,
+                ftxui::Renderer([] { return ftxui::text(Language::text("todos.repeat")); }),
+                repeatInput | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, 45),
+                repeatErrorLabel,
                 addButton,
             }),
             ftxui::Renderer([] { return ftxui::separatorEmpty(); }),
@@ -0,0 +1,101 @@
+#include "../../Headers/Interface/upcomingComponent.h"
+
+#include <string>
+#include <vector>
+
+#include "../../Headers/dateUtils.h"
+#include "../../Headers/language.h"
+#include "../../Headers/trace.h"
+#include "../../Headers/upcomingIndex.h"
+#include "../../../l4dFiles/out/l4dFiles.hpp"
+
+#include "ftxui/component/component.hpp"
+#include "ftxui/dom/elements.hpp"
+
+using namespace ftxui;
+
+namespace {
+    constexpr StringId weekdayNames[7] = { "weekday.monday", "weekday.tuesday", "weekday.wednesday", "weekday.thursday", "weekday.friday", "weekday.saturday", "weekday.sunday" };
+
+    std::string timeText(const Date& date) {
+        return DateUtils::toString(date, true).substr(11);
+    }
+}
+
+void UpcomingComponent::rebuildRows(const UpcomingIndex& index) {
+    const std::pair<UpcomingBucket, StringId> titles[] = {
+        { UpcomingBucket::Overdue, StringId("upcoming.overdue") },
+        { UpcomingBucket::Today, StringId("upcoming.today") },
+        { UpcomingBucket::ThisWeek, StringId("upcoming.thisWeek") },
+        { UpcomingBucket::Later, StringId("upcoming.later") },
+    };
+
+    buckets.clear();
+    for (const auto& [bucket, title] : titles) {
+        UpcomingBucketRows rows;
+        rows.title = Language::text(title);
+
+        auto [first, last] = index.bucket(bucket);
+        for (auto it = first; it != last; ++it) {
+            rows.count++;
+            if (rows.names.size() >= maxRows) {
+                continue;
+            }
+            const UpcomingEntry& entry = it->second;
+            switch (bucket) {
+                case UpcomingBucket::Today:
+                    rows.dates.push_back(timeText(entry.dueDate));
+                    break;
+                case UpcomingBucket::ThisWeek:
+                    rows.dates.push_back(Language::text(weekdayNames[DateUtils::weekday(DateUtils::dayNumber(entry.dueDate))]) + " " + timeText(entry.dueDate));
+                    break;
+                default:
+                    rows.dates.push_back(DateUtils::toString(entry.dueDate, true));
+                    break;
+            }
+            rows.names.push_back(entry.recurring ? entry.name + Language::text("upcoming.repeats") : entry.name);
+        }
+        buckets.push_back(std::move(rows));
+    }
+    builtVersion = index.version();
+}
+
+ftxui::Component UpcomingComponent::renderUpcomingComponent(UpcomingIndex *index, FileData *data) {
+    TraceSpan span("UpcomingComponent::renderUpcomingComponent");
+    if (!index || !data) return ftxui::Renderer([] { return ftxui::text(Language::text("ui.dataIsNull")); });
+
+    return ftxui::Renderer([index, data, this] {
+        // The day tick wakes the loop up at midnight, the todos move to their new buckets here
+        index->rollOver(data->todosData, DateUtils::dayNumber(DateUtils::today()));
+        if (builtVersion != index->version()) {
+            rebuildRows(*index);
+        }
+
+        Elements sections;
+        for (const auto& rows : buckets) {
+            sections.push_back(text(rows.title + " (" + std::to_string(rows.count) + ")") | bold);
+
+            Elements lines;
+            for (size_t i = 0; i < rows.names.size(); i++) {
+                lines.push_back(hbox({
+                    text(rows.dates[i]) | size(WIDTH, EQUAL, 18),
+                    text(rows.names[i]),
+                }));
+            }
+            if (rows.count > rows.names.size()) {
+                lines.push_back(text(Language::format("upcoming.more", { std::to_string(rows.count - rows.names.size()) })) | dim);
+            }
+            if (rows.count == 0) {
+                lines.push_back(text(Language::text("upcoming.nothingDue")) | dim);
+            }
+            sections.push_back(vbox(std::move(lines)));
+            sections.push_back(separatorEmpty());
+        }
+
+        return hbox({
+            filler(),
+            vbox(std::move(sections)) | size(WIDTH, EQUAL, 100),
+            filler(),
+        });
+    });
+}
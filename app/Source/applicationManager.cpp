@@ -1,108 +1,1193 @@
 #include "../Headers/applicationManager.h"
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 // For handling user inputs
 #include "../Headers/inputHandlers.h"
+#include "../Headers/batchCommands.h"
+#include "../Headers/todoQuery.h"
+#include "../Headers/dueDateIndex.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/fileDataOperations.h"
+#include "../Headers/memoryReport.h"
+#include "../Headers/milestoneStats.h"
+#include "../Headers/trace.h"
+#include "../Headers/daemonClient.h"
+#include "../Headers/daemonServer.h"
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/archiveStore.h"
+#include "../Headers/diaryCodec.h"
+#include "../Headers/shardedStore.h"
+#include "../Headers/blockChecksums.h"
+#include "../Headers/crc32c.h"
+#include "../Headers/recurrence.h"
+#include "../Headers/language.h"
+#include "../Headers/theme.h"
+#include "../Headers/documentExchange.h"
+#include "../Headers/historyLog.h"
+#include "../Headers/documentMerge.h"
 
 #include "../../l4dFiles/out/l4dFiles.hpp"
 
-ApplicationManager::ApplicationManager(std::string workingDirectory, std::string configPath) : localStorage(workingDirectory + configPath) {
+ApplicationManager::ApplicationManager(std::string workingDirectory, std::string configPath) : localStorage(workingDirectory + configPath), shardedStore(workingDirectory, configPath) {
     this->workingDirectory = workingDirectory;
     this->configName = configPath;
+
+    // Before any message is shown, a damaged table only costs the translation
+    std::string error;
+    if (!Language::load(workingDirectory + Language::compiledFileName, &error)) {
+        std::cerr << "Using English, the language table could not be read: " << error << std::endl;
+    }
+    if (!ThemeFile::load(workingDirectory + ThemeFile::storedFileName, &theme, &error)) {
+        std::cerr << "Using the default theme, the stored theme could not be read: " << error << std::endl;
+    }
+}
+
+namespace {
+    /**
+     * @brief Commands that read or write the log4daily files themselves instead of the document of the run.
+     */
+    bool usesFilesDirectly(CommandId id) {
+        switch (id) {
+            case CommandId::Query:
+            case CommandId::Stats:
+            case CommandId::Daemon:
+            case CommandId::Archive:
+            case CommandId::ArchiveSearch:
+            case CommandId::Shard:
+            case CommandId::CompressDiary:
+            case CommandId::Verify:
+            case CommandId::Repair:
+            case CommandId::History:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief The shards of a sharded log the command needs in the document.
+     */
+    ShardScope documentScopeOf(const Command& command) {
+        switch (command.id) {
+            case CommandId::Open:
+                return std::find(command.arguments.begin() + std::min<size_t>(1, command.arguments.size()), command.arguments.end(), "all") != command.arguments.end() ? ShardScope::All : ShardScope::Recent;
+            case CommandId::New:
+            case CommandId::AddDiary:
+            case CommandId::Progress:
+                return ShardScope::Recent;
+            case CommandId::Export:
+                return ShardScope::All;
+            default:
+                return ShardScope::Active;
+        }
+    }
 }
 
+// Indexed by CommandId, in the order of supportedCommands
+const std::array<ApplicationManager::CommandHandler, supportedCommands.size()> ApplicationManager::commandHandlers = {
+    &ApplicationManager::runHelp,
+    &ApplicationManager::runNew,
+    &ApplicationManager::runOpen,
+    &ApplicationManager::runDelete,
+    &ApplicationManager::runBatch,
+    &ApplicationManager::runBatch,
+    &ApplicationManager::runBatch,
+    &ApplicationManager::runBatch,
+    &ApplicationManager::runQuery,
+    &ApplicationManager::runStats,
+    &ApplicationManager::runDaemon,
+    &ApplicationManager::runArchive,
+    &ApplicationManager::runArchiveSearch,
+    &ApplicationManager::runShard,
+    &ApplicationManager::runCompressDiary,
+    &ApplicationManager::runVerify,
+    &ApplicationManager::runRepair,
+    &ApplicationManager::runHistory,
+    &ApplicationManager::runMerge,
+    &ApplicationManager::runSetLanguage,
+    &ApplicationManager::runSetTheme,
+    &ApplicationManager::runImport,
+    &ApplicationManager::runExport,
+    &ApplicationManager::runList,
+};
+
 CommandType ApplicationManager::run(int argc, char* argv[]) {
     std::vector<Command> commands = InputHandlers::parseConsoleInputs(argc, argv);
     std::vector<Command> supportedCommands = InputHandlers::filterForSupportedCommands(commands);
-    
-    std::string commandName;
-    std::string commandArgument;
-
-    commandName = supportedCommands.empty() ? "" : supportedCommands[0].name;
-    commandArgument = supportedCommands.empty() ? "" : supportedCommands[0].argument;
 
     if (supportedCommands.empty()) {
         return CommandType::Unsupported;
     }
 
-    if (supportedCommands.size() > 1) {
-        std::cout << "Multiple supported commands found. Picking first one, ignoring others" << std::endl;
-    }
-
     if (supportedCommands[0].name != commands[0].name) {
         std::cout << "First supported command is different from first unfilted command." << std::endl;
-        commandName = commands[0].name;
-        commandArgument = commands[0].argument;
+        std::cout << "Unsupported command: " << commands[0].name << std::endl;
+        std::cout << "Showing help instead." << std::endl;
+        showHelp();
+        return CommandType::Help;
+    }
+
+    // The commands share one document, loaded with every shard any of them needs so it is read only once
+    pipelineScope = ShardScope::Active;
+    for (const auto& command : supportedCommands) {
+        pipelineScope = std::max(pipelineScope, documentScopeOf(command));
+    }
+    pipelined = supportedCommands.size() > 1;
+
+    CommandType respond = CommandType::Other;
+    for (size_t i = 0; i < supportedCommands.size(); i++) {
+        const Command& command = supportedCommands[i];
+        commandsFollow = i + 1 < supportedCommands.size();
+        if (i > 0) {
+            showMessage(respond, respondMessage);
+            respondMessage.clear();
+        }
+
+        // They would not see the changes of the commands before them, or would overwrite them
+        if (usesFilesDirectly(command.id)) {
+            releaseDocument();
+        }
+
+        respond = (this->*commandHandlers[static_cast<size_t>(command.id)])(command);
+        if (respond == CommandType::Failed) {
+            if (documentChanged) {
+                respondMessage += " The changes of the commands before it were not saved.";
+            }
+            documentLoaded = false;
+            documentChanged = false;
+            return respond;
+        }
     }
 
-    if (commandName == "--open") {
-        openedFile = localStorage.openLog4DailyFile(workingDirectory, commandArgument);
-        if (!(openedFile == FileData())) {
-            respondMessage = "Opening it now!";
-            return CommandType::Open;
+    flushDocument();
+    return respond;
+}
+
+CommandType ApplicationManager::runHelp(const Command&) {
+    showHelp();
+    return CommandType::Help;
+}
+
+CommandType ApplicationManager::runNew(const Command& command) {
+    const std::string& commandArgument = command.argument;
+    bool succeeded = false;
+    if (!shardedStore.isSharded(commandArgument)) {
+        if (hasOption(command, "sharded")) {
+            succeeded = localStorage.openLog4DailyFile(workingDirectory, commandArgument) == FileData() && shardedStore.create(commandArgument);
         } else {
-            respondMessage = "Failed to open log4daily file. (maybe it does not exist?)";
+            succeeded = localStorage.createLog4DailyFile(workingDirectory, commandArgument, configName);
+        }
+    }
+    if (succeeded && loadDocument(commandArgument, ShardScope::Recent)) {
+        respondMessage = commandsFollow ? "Created " + commandArgument + "." : "Opening it now!";
+        return CommandType::New;
+    } else {
+        respondMessage = "Failed to create log4daily file. (maybe it already exists?)";
+        return CommandType::Failed;
+    }
+}
+
+CommandType ApplicationManager::runOpen(const Command& command) {
+    // A sharded log opens with the recent years only, unless all of it was asked for
+    verifyOnOpen = hasOption(command, "verify");
+    if (!loadDocument(command.argument, hasOption(command, "all") ? ShardScope::All : ShardScope::Recent)) {
+        respondMessage = openFailure(command.argument);
+        return CommandType::Failed;
+    }
+
+    // Only the last command of the line opens the UI
+    if (commandsFollow) {
+        respondMessage = "Loaded " + command.argument + ".";
+        return CommandType::Other;
+    }
+    respondMessage = "Opening it now!";
+    return CommandType::Open;
+}
+
+CommandType ApplicationManager::runDelete(const Command& command) {
+    const std::string& commandArgument = command.argument;
+    std::cout << "Are you sure you want to delete the log4daily file? (y/n): ";
+    std::string confirmation = "";
+    std::cin >> confirmation;
+
+    if (confirmation != "y" && confirmation != "Y") {
+        respondMessage = "Operation canceled.";
+        return CommandType::Other;
+    }
+
+    // Otherwise the daemon would write the file back with its next flush, and so would the end of the run
+    std::string error;
+    if (useDaemon()) {
+        daemon.close(commandArgument, &error);
+    }
+    if (documentLoaded && openedFile.log4FileName == commandArgument) {
+        documentLoaded = false;
+        documentChanged = false;
+        openedFile = FileData();
+        documentChanges.markWhole();
+    }
+
+    bool succeeded = shardedStore.isSharded(commandArgument) ? shardedStore.remove(commandArgument) : localStorage.deleteLog4DailyFile(workingDirectory, commandArgument, configName);
+    if (succeeded) {
+        std::error_code removeError;
+        std::filesystem::remove(BlockChecksums::path(workingDirectory, commandArgument), removeError);
+        std::filesystem::remove(HistoryLog::path(workingDirectory, commandArgument), removeError);
+        return CommandType::Delete;
+    } else {
+        respondMessage = "Failed to delete log4daily file.";
+        return CommandType::Failed;
+    }
+}
+
+CommandType ApplicationManager::runList(const Command& command) {
+    std::cout << "Command not implemented yet: " << command.name << std::endl;
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runImport(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing path_to_file for --import.";
+        return CommandType::Failed;
+    }
+    if (!documentFor(command)) {
+        return CommandType::Failed;
+    }
+
+    std::ifstream csv(command.argument);
+    if (!csv) {
+        respondMessage = "Failed to read " + command.argument + ".";
+        return CommandType::Failed;
+    }
+
+    BatchResult result = DocumentExchange::importTodos(csv, &openedFile, &documentChanges);
+    for (const auto& error : result.errors) {
+        std::cerr << command.argument << ": " << error << std::endl;
+    }
+    if (result.applied > 0) {
+        documentChanged = true;
+    }
+
+    respondMessage = "Imported " + std::to_string(result.applied) + " todo(s) into " + openedFile.log4FileName + ", skipped " + std::to_string(result.skipped) + ".";
+    return result.applied == 0 && result.skipped > 0 ? CommandType::Failed : CommandType::Batch;
+}
+
+CommandType ApplicationManager::runExport(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing path_to_file for --export.";
+        return CommandType::Failed;
+    }
+    if (!documentFor(command)) {
+        return CommandType::Failed;
+    }
+
+    // Written next to the target and renamed, so a failed export never leaves half a file behind
+    std::string temporaryPath = command.argument + ".tmp";
+    {
+        std::ofstream json(temporaryPath, std::ios::trunc);
+        DocumentExchange::exportJson(openedFile, json);
+        if (!json) {
+            respondMessage = "Failed to write " + temporaryPath + ".";
             return CommandType::Failed;
         }
-    } else if (commandName == "--new") {
-        bool succeeded = localStorage.createLog4DailyFile(workingDirectory, commandArgument, configName);
-        if (succeeded) {
-            openedFile = localStorage.openLog4DailyFile(workingDirectory, commandArgument);
-            respondMessage = "Opening it now!";
-            return CommandType::New;
+    }
+    std::error_code renameError;
+    std::filesystem::rename(temporaryPath, command.argument, renameError);
+    if (renameError) {
+        respondMessage = "Failed to write " + command.argument + ": " + renameError.message() + ".";
+        return CommandType::Failed;
+    }
+
+    respondMessage = "Exported " + openedFile.log4FileName + " to " + command.argument + ".";
+    return CommandType::Other;
+}
+
+bool ApplicationManager::hasOption(const Command& command, const std::string& option) {
+    // Options come after the log4_file_name, "all", "verify" or "sharded" of --open and --new, "memory" of --stats
+    const std::vector<std::string>& arguments = command.arguments;
+    return arguments.size() > 1 && std::find(arguments.begin() + 1, arguments.end(), option) != arguments.end();
+}
+
+bool ApplicationManager::documentFor(const Command& command) {
+    // --import and --export name the log4daily file after the path, or use the one loaded before them
+    if (command.arguments.size() > 1) {
+        if (!loadDocument(command.arguments[1], documentScopeOf(command))) {
+            respondMessage = openFailure(command.arguments[1]);
+            return false;
+        }
+        return true;
+    }
+    if (!documentLoaded) {
+        respondMessage = "No log4daily file for " + command.name + ", name one after the path or --open one before it.";
+        return false;
+    }
+    return true;
+}
+
+bool ApplicationManager::loadDocument(const std::string& log4FileName, ShardScope scope) {
+    scope = std::max(scope, pipelineScope);
+    if (documentLoaded && openedFile.log4FileName == log4FileName && documentScope >= scope) {
+        return true;
+    }
+
+    flushDocument();
+    documentLoaded = false;
+    openedFile = openFile(log4FileName, scope);
+    // The daemon keeps the history of its documents. Without it the history of the file may have been
+    // written by another process since its last save here
+    if (daemon.connected()) {
+        documentChanges.clear();
+    } else {
+        documentChanges.markWhole();
+    }
+    if (openedFile == FileData()) {
+        return false;
+    }
+    documentLoaded = true;
+    documentScope = scope;
+    return true;
+}
+
+void ApplicationManager::flushDocument() {
+    if (documentLoaded && documentChanged) {
+        bool replaced = false;
+        std::string error;
+        if (saveFile(&openedFile, documentChanges, &replaced, &error)) {
+            documentChanges.clear();
         } else {
-            respondMessage = "Failed to create log4daily file. (maybe it already exists?)";
+            std::cerr << "The changes were not saved: " << error << std::endl;
+        }
+    }
+    documentChanged = false;
+}
+
+void ApplicationManager::releaseDocument() {
+    flushDocument();
+    documentLoaded = false;
+}
+
+CommandType ApplicationManager::runBatch(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for " + command.name + ".";
+        return CommandType::Failed;
+    }
+
+    BatchResult result;
+    std::ios::sync_with_stdio(false);
+
+    if (!pipelined && useDaemon()) {
+        // The daemon applies the records to the document it keeps and writes the file with its next flush
+        std::string error;
+        if (!daemon.batch(command.name, command.argument, BatchCommands::readRecords(command, std::cin), &result, &error)) {
+            respondMessage = error;
+            return CommandType::Failed;
+        }
+    } else {
+        // Todos need only the active shard of a sharded log, diary entries and progress points this year's one too
+        bool todosOnly = command.id == CommandId::AddTodo || command.id == CommandId::Done;
+        if (!loadDocument(command.argument, todosOnly ? ShardScope::Active : ShardScope::Recent)) {
+            respondMessage = openFailure(command.argument);
             return CommandType::Failed;
         }
-    } else if (commandName == "--delete") {
-        std::cout << "Are you sure you want to delete the log4daily file? (y/n): ";
-        std::string confirmation = "";
-        std::cin >> confirmation;
 
-        if (confirmation != "y" && confirmation != "Y") {
-            respondMessage = "Operation canceled.";
-            return CommandType::Other;
+        // Saved once when the run ends, after the commands that follow
+        result = BatchCommands::apply(command, &openedFile, &documentChanges, std::cin);
+        if (result.applied > 0) {
+            documentChanged = true;
         }
+    }
 
-        bool succeeded = localStorage.deleteLog4DailyFile(workingDirectory, commandArgument, configName);
-        if (succeeded) {
-            return CommandType::Delete;
-        } else {
-            respondMessage = "Failed to delete log4daily file.";
+    for (const auto& error : result.errors) {
+        std::cerr << error << std::endl;
+    }
+
+    respondMessage = "Applied " + std::to_string(result.applied) + " record(s), skipped " + std::to_string(result.skipped) + ".";
+    return result.applied == 0 && result.skipped > 0 ? CommandType::Failed : CommandType::Batch;
+}
+
+CommandType ApplicationManager::runQuery(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --query.";
+        return CommandType::Failed;
+    }
+
+    // An unquoted query arrives split into several arguments
+    std::string expression;
+    for (size_t i = 1; i < command.arguments.size(); i++) {
+        expression += (i > 1 ? " " : "") + command.arguments[i];
+    }
+
+    TodoQuery query;
+    std::string error;
+    if (!TodoQuery::compile(expression, &query, &error)) {
+        respondMessage = "Invalid query: " + error;
+        return CommandType::Failed;
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    if (useDaemon()) {
+        std::string output;
+        size_t matches = 0;
+        if (!daemon.query(command.argument, expression, &output, &matches, &error)) {
+            respondMessage = error;
             return CommandType::Failed;
         }
-    } else if (commandName == "--help") {
-        showHelp();
-        return CommandType::Help;
-    } else if (commandName == "--list" || commandName == "--import" || commandName == "--export" || commandName == "--set-theme" || commandName == "--set-language") {
-        std::cout << "Command not implemented yet: " << commandName << std::endl;
+        std::cout << output;
+
+        respondMessage = std::to_string(matches) + " todo(s) matched.";
+        return CommandType::Query;
+    }
+
+    openedFile = readFile(command.argument, ShardScope::Active);
+    documentChanges.markWhole();
+    if (openedFile == FileData()) {
+        respondMessage = openFailure(command.argument);
+        return CommandType::Failed;
+    }
+
+    DueDateIndex index;
+    index.rebuild(openedFile.todosData);
+    std::vector<uint32_t> matches = query.run(openedFile.todosData, &index);
+
+    // Recurring todos are listed as their occurrences instead
+    RecurrenceIndex recurrences;
+    recurrences.rebuild(openedFile.todosData);
+    std::vector<TodoData> occurrences = query.runOccurrences(openedFile.todosData, recurrences, DateUtils::dayNumber(DateUtils::today()));
+
+    size_t matched = occurrences.size();
+    for (uint32_t position : matches) {
+        if (!recurrences.isSeries(position)) {
+            std::cout << TodoQuery::formatMatch(openedFile.todosData[position]) << '\n';
+            matched++;
+        }
+    }
+    for (const auto& occurrence : occurrences) {
+        std::cout << TodoQuery::formatMatch(occurrence) << '\n';
+    }
+
+    respondMessage = std::to_string(matched) + " todo(s) matched.";
+    return CommandType::Query;
+}
+
+CommandType ApplicationManager::runStats(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --stats.";
+        return CommandType::Failed;
+    }
+
+    openedFile = openFile(command.argument);
+    documentChanges.markWhole();
+    if (openedFile == FileData()) {
+        respondMessage = openFailure(command.argument);
+        return CommandType::Failed;
+    }
+
+    if (hasOption(command, "memory")) {
+        std::vector<MemoryRow> rows = MemoryReport::document(openedFile);
+        for (const auto& line : MemoryReport::describe(rows)) {
+            std::cout << line << std::endl;
+        }
+        respondMessage = MemoryReport::formatBytes(MemoryReport::total(rows).total()) + " used by " + command.argument + ".";
         return CommandType::Other;
+    }
+
+    int today = DateUtils::dayNumber(DateUtils::today());
+    for (const auto& milestone : openedFile.milestonesData) {
+        MilestoneStats stats;
+        stats.rebuild(milestone);
+
+        std::cout << milestone.id << ": " << milestone.milestoneName << std::endl;
+        for (const auto& line : MilestoneStats::describe(stats.summary(today))) {
+            std::cout << "    " << line << std::endl;
+        }
+    }
+
+    respondMessage = std::to_string(openedFile.milestonesData.size()) + " milestone(s).";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runSetLanguage(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing language_name for --set-language.";
+        return CommandType::Failed;
+    }
+
+    std::string tablePath = workingDirectory + Language::compiledFileName;
+    if (command.argument == "en" || command.argument == "english") {
+        std::error_code removeError;
+        std::filesystem::remove(tablePath, removeError);
+        respondMessage = "Language set to English.";
+        return CommandType::Other;
+    }
+
+    // A path to a language pack, or the name of one in the languages_packs folder of the config folder
+    std::filesystem::path packPath = command.argument;
+    std::error_code fileError;
+    if (!std::filesystem::is_regular_file(packPath, fileError)) {
+        packPath = std::filesystem::path(workingDirectory) / "languages_packs" / (command.argument + Language::packExtension);
+    }
+    std::ifstream pack(packPath);
+    if (!pack) {
+        respondMessage = "No language pack " + command.argument + " (looked for " + packPath.string() + ").";
+        return CommandType::Failed;
+    }
+
+    LanguagePackReport report;
+    std::string error;
+    if (!Language::compile(pack, tablePath, &report, &error)) {
+        respondMessage = "Invalid language pack " + packPath.string() + ", " + error + ".";
+        return CommandType::Failed;
+    }
+    for (const auto& warning : report.warnings) {
+        std::cerr << packPath.string() << ": " << warning << std::endl;
+    }
+
+    // Read back right away, so a table that does not load is reported now instead of on every start
+    if (!Language::load(tablePath, &error)) {
+        std::error_code removeError;
+        std::filesystem::remove(tablePath, removeError);
+        respondMessage = "The compiled language table could not be read back: " + error + ".";
+        return CommandType::Failed;
+    }
+
+    respondMessage = "Language set to " + Language::text("language.name") + ", " + std::to_string(report.translated) + " of " + std::to_string(languageStringCount) + " text(s) translated.";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runSetTheme(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing theme_name for --set-theme.";
+        return CommandType::Failed;
+    }
+
+    std::string storedPath = workingDirectory + ThemeFile::storedFileName;
+    if (command.argument == "default") {
+        std::error_code removeError;
+        std::filesystem::remove(storedPath, removeError);
+        respondMessage = "Theme set to the default theme.";
+        return CommandType::Other;
+    }
+
+    // A path to a theme file, or the name of one in the themes folder of the config folder
+    std::filesystem::path themePath = command.argument;
+    std::error_code fileError;
+    if (!std::filesystem::is_regular_file(themePath, fileError)) {
+        themePath = std::filesystem::path(workingDirectory) / "themes" / (command.argument + ThemeFile::themeExtension);
+    }
+    std::ifstream themeFile(themePath);
+    if (!themeFile) {
+        respondMessage = "No theme " + command.argument + " (looked for " + themePath.string() + ").";
+        return CommandType::Failed;
+    }
+    std::stringstream content;
+    content << themeFile.rdbuf();
+
+    Theme parsed = ThemeFile::defaults();
+    std::vector<std::string> warnings;
+    std::string error;
+    if (!ThemeFile::parse(content, &parsed, &warnings, &error)) {
+        respondMessage = "Invalid theme " + themePath.string() + ", " + error + ".";
+        return CommandType::Failed;
+    }
+    for (const auto& warning : warnings) {
+        std::cerr << themePath.string() << ": " << warning << std::endl;
+    }
+
+    // Stored as written, it is parsed again on start, which costs less than a frame
+    std::string temporaryPath = storedPath + ".tmp";
+    {
+        std::ofstream stored(temporaryPath, std::ios::trunc);
+        stored << content.str();
+        if (!stored) {
+            respondMessage = "Failed to write " + temporaryPath + ".";
+            return CommandType::Failed;
+        }
+    }
+    std::error_code renameError;
+    std::filesystem::rename(temporaryPath, storedPath, renameError);
+    if (renameError) {
+        respondMessage = "Failed to store the theme: " + renameError.message() + ".";
+        return CommandType::Failed;
+    }
+
+    respondMessage = "Theme set to " + parsed.name + (parsed.profile == ThemeProfile::LowCost ? " (low-cost profile)." : ".");
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runArchive(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --archive.";
+        return CommandType::Failed;
+    }
+
+    // --archive log4_file_name [days [diary_days]]
+    ArchivePolicy policy;
+    int* limits[] = { &policy.todoDays, &policy.diaryDays };
+    for (size_t i = 1; i < command.arguments.size() && i <= 2; i++) {
+        const std::string& text = command.arguments[i];
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), *limits[i - 1]);
+        if (error != std::errc() || end != text.data() + text.size() || *limits[i - 1] < 0) {
+            respondMessage = "'" + text + "' is not a number of days.";
+            return CommandType::Failed;
+        }
+    }
+    policy.milestoneDays = policy.todoDays;
+
+    openedFile = openFile(command.argument);
+    documentChanges.markWhole();
+    if (openedFile == FileData()) {
+        respondMessage = openFailure(command.argument);
+        return CommandType::Failed;
+    }
+
+    ArchiveStore archiveStore(workingDirectory, configName);
+    std::vector<ArchiveSegment> archived = archiveStore.archive(&openedFile, policy, DateUtils::dayNumber(DateUtils::today()));
+    if (archived.empty()) {
+        respondMessage = "Nothing to archive.";
+        return CommandType::Other;
+    }
+    bool replaced = false;
+    std::string error;
+    if (!saveFile(&openedFile, documentChanges, &replaced, &error)) {
+        respondMessage = error;
+        return CommandType::Failed;
+    }
+    documentChanges.clear();
+
+    size_t records = 0;
+    for (const auto& segment : archived) {
+        std::cout << ArchiveStore::segmentName(command.argument, segment.year) << ": " << segment.todos << " todo(s), "
+                  << segment.milestones << " milestone(s), " << segment.diaryEntries << " diary entr(ies)" << std::endl;
+        records += segment.todos + segment.milestones + segment.diaryEntries;
+    }
+
+    respondMessage = "Archived " + std::to_string(records) + " record(s) into " + std::to_string(archived.size()) + " segment(s).";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runArchiveSearch(const Command& command) {
+    if (command.argument.empty() || command.arguments.size() < 2) {
+        respondMessage = "Usage: --archive-search log4_file_name text";
+        return CommandType::Failed;
+    }
+
+    std::string text;
+    for (size_t i = 1; i < command.arguments.size(); i++) {
+        text += (i > 1 ? " " : "") + command.arguments[i];
+    }
+
+    ArchiveStore archiveStore(workingDirectory, configName);
+    if (archiveStore.segments(command.argument).empty()) {
+        respondMessage = "The log4daily file has no archive.";
+        return CommandType::Other;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::vector<ArchiveMatch> matches = archiveStore.search(command.argument, text);
+    for (const auto& match : matches) {
+        std::cout << match.year << '\t' << match.kind << '\t' << match.id << '\t' << DateUtils::toString(match.date) << '\t' << match.title << '\n';
+    }
+
+    respondMessage = std::to_string(matches.size()) + " archived record(s) matched.";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runShard(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --shard.";
+        return CommandType::Failed;
+    }
+    if (shardedStore.isSharded(command.argument)) {
+        respondMessage = "The log4daily file is already sharded.";
+        return CommandType::Other;
+    }
+
+    // Written straight from the file, a running daemon would keep writing the unsharded file
+    if (useDaemon()) {
+        respondMessage = "Stop the daemon (--daemon stop) before sharding a log4daily file.";
+        return CommandType::Failed;
+    }
+
+    {
+        TraceSpan span("LocalStorage::openLog4DailyFile");
+        openedFile = localStorage.openLog4DailyFile(workingDirectory, command.argument);
+    }
+    documentChanges.markWhole();
+    if (openedFile == FileData()) {
+        respondMessage = openFailure(command.argument);
+        return CommandType::Failed;
+    }
+    openedFile.log4FileName = command.argument;
+
+    if (!shardedStore.create(command.argument)) {
+        respondMessage = "Failed to create the shard directory " + ShardedStore::directoryName(command.argument) + ".";
+        return CommandType::Failed;
+    }
+    size_t shards = shardedStore.save(openedFile);
+
+    // The old file is only deleted once the shards read back the same records
+    FileData sharded = shardedStore.open(command.argument, ShardScope::All);
+    if (sharded.todosData.size() != openedFile.todosData.size() || sharded.diaryData.size() != openedFile.diaryData.size()
+        || sharded.calendarData.size() != openedFile.calendarData.size() || sharded.milestonesData.size() != openedFile.milestonesData.size()) {
+        shardedStore.remove(command.argument);
+        respondMessage = "The shards did not read back the same records, the log4daily file was left as it is.";
+        return CommandType::Failed;
+    }
+    localStorage.deleteLog4DailyFile(workingDirectory, command.argument, configName);
+    std::error_code removeError;
+    std::filesystem::remove(BlockChecksums::path(workingDirectory, command.argument), removeError);
+
+    respondMessage = "Sharded into " + std::to_string(shards) + " shard(s) (" + std::to_string(shardedStore.years(command.argument).size()) + " year(s)).";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runVerify(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --verify.";
+        return CommandType::Failed;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<VerifyReport> reports;
+    if (shardedStore.isSharded(command.argument)) {
+        shardedStore.open(command.argument, ShardScope::All, &reports);
     } else {
-        std::cout << "Unsupported command: " << commands[0].name << std::endl;
-        std::cout << "Showing help instead." << std::endl;
-        showHelp();
-        return CommandType::Help;
+        reports.push_back(BlockChecksums::verifyFile(localStorage, workingDirectory, command.argument));
+        if (!reports[0].readable && !reports[0].hasChecksums) {
+            respondMessage = openFailure(command.argument);
+            return CommandType::Failed;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    size_t blocks = 0;
+    size_t damaged = 0;
+    for (const auto& report : reports) {
+        std::vector<std::string> lines = BlockChecksums::describe(report);
+        std::cout << report.file << ": " << lines[0] << std::endl;
+        for (size_t i = 1; i < lines.size(); i++) {
+            std::cout << "    " << lines[i] << std::endl;
+        }
+        blocks += report.blocks;
+        damaged += report.intact() ? 0 : 1;
+    }
+    std::cout << "Checked " << blocks << " block(s) in " << elapsed.count() << " ms (CRC-32C " << (Crc32c::hardwareAccelerated() ? "in hardware" : "in software") << ")" << std::endl;
+
+    if (damaged > 0) {
+        respondMessage = std::to_string(damaged) + " of " + std::to_string(reports.size()) + " file(s) damaged, salvage the intact records with --repair.";
+        return CommandType::Failed;
+    }
+    respondMessage = "No damage found in " + std::to_string(reports.size()) + " file(s).";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runRepair(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --repair.";
+        return CommandType::Failed;
+    }
+
+    std::string repairedName = command.argument + "-repaired";
+    if (shardedStore.isSharded(repairedName) || !(localStorage.openLog4DailyFile(workingDirectory, repairedName) == FileData())) {
+        respondMessage = repairedName + " already exists, delete or rename it first.";
+        return CommandType::Failed;
+    }
+
+    bool sharded = shardedStore.isSharded(command.argument);
+    std::vector<VerifyReport> reports;
+    FileData salvaged;
+    if (sharded) {
+        salvaged = shardedStore.open(command.argument, ShardScope::All, &reports);
+    } else {
+        FileData opened;
+        reports.push_back(BlockChecksums::verifyFile(localStorage, workingDirectory, command.argument, &opened));
+        if (reports[0].readable) {
+            salvaged = BlockChecksums::salvage(opened, reports[0]);
+        }
+    }
+    if (salvaged == FileData()) {
+        respondMessage = "Nothing can be salvaged, l4dFiles could not read the log4daily file.";
+        return CommandType::Failed;
+    }
+    salvaged.log4FileName = repairedName;
+
+    bool created = sharded ? shardedStore.create(repairedName) : localStorage.createLog4DailyFile(workingDirectory, repairedName, configName);
+    if (!created) {
+        respondMessage = "Failed to create " + repairedName + ".";
+        return CommandType::Failed;
+    }
+    // A new file, its history starts with the whole document
+    writeFile(salvaged, DocumentChanges());
+
+    size_t dropped = 0;
+    size_t unreadable = 0;
+    for (const auto& report : reports) {
+        for (const auto& block : report.damaged) {
+            dropped += block.count;
+        }
+        unreadable += report.readable ? 0 : 1;
+    }
+    size_t kept = salvaged.calendarData.size() + salvaged.todosData.size() + salvaged.milestonesData.size() + salvaged.diaryData.size();
+
+    std::cout << "Kept " << kept << " record(s), left out " << dropped << " record(s) of damaged blocks";
+    if (unreadable > 0) {
+        std::cout << " and " << unreadable << " unreadable shard(s)";
+    }
+    std::cout << "." << std::endl;
+
+    respondMessage = "Salvaged the intact records into " + repairedName + ".";
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runHistory(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --history.";
+        return CommandType::Failed;
+    }
+    if (shardedStore.isSharded(command.argument)) {
+        respondMessage = "Sharded logs have no history.";
+        return CommandType::Failed;
+    }
+
+    std::string historyPath = HistoryLog::path(workingDirectory, command.argument);
+    std::vector<HistoryEntry> entries;
+    std::string error;
+    if (!HistoryLog::entries(historyPath, &entries, &error)) {
+        respondMessage = error;
+        return CommandType::Failed;
+    }
+    if (entries.empty()) {
+        respondMessage = "No saves of " + command.argument + " were recorded yet.";
+        return CommandType::Failed;
+    }
+
+    // --history log4_file_name [save_number]
+    if (command.arguments.size() < 2) {
+        for (const auto& entry : entries) {
+            std::cout << "#" << entry.number << "  " << DateUtils::toString(DateUtils::fromTime(entry.time), true) << "  "
+                << (entry.kind == HistoryEntryKind::Checkpoint ? "checkpoint" : "diff") << "  +" << entry.added
+                << " ~" << entry.modified << " -" << entry.removed << std::endl;
+        }
+        respondMessage = std::to_string(entries.size()) + " save(s) recorded, print one with --history " + command.argument + " <save_number>.";
+        return CommandType::Other;
+    }
+
+    const std::string& text = command.arguments[1];
+    uint32_t number = 0;
+    auto [end, parseError] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (parseError != std::errc() || end != text.data() + text.size()) {
+        respondMessage = "'" + text + "' is not a save number.";
+        return CommandType::Failed;
+    }
+
+    FileData saved;
+    if (!HistoryLog::at(historyPath, entries, number, &saved, &error)) {
+        respondMessage = error;
+        return CommandType::Failed;
+    }
+    DocumentExchange::exportJson(saved, std::cout);
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runMerge(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing path_to_file for --merge.";
+        return CommandType::Failed;
+    }
+    std::filesystem::path otherPath(command.argument);
+    if (otherPath.extension() != ".l4d") {
+        respondMessage = command.argument + " is not a log4daily file (.l4d).";
+        return CommandType::Failed;
+    }
+    if (!documentFor(command)) {
+        return CommandType::Failed;
+    }
+    const std::string log4FileName = openedFile.log4FileName;
+    if (shardedStore.isSharded(log4FileName)) {
+        respondMessage = "Sharded logs can not be merged.";
+        return CommandType::Failed;
+    }
+
+    std::string otherDirectory = (otherPath.has_parent_path() ? otherPath.parent_path().string() : std::string(".")) + "/";
+    std::string otherName = otherPath.stem().string();
+    std::error_code pathError;
+    if (std::filesystem::equivalent(otherPath, workingDirectory + log4FileName + ".l4d", pathError)) {
+        respondMessage = "A log4daily file can not be merged with itself.";
+        return CommandType::Failed;
+    }
+    FileData theirs;
+    {
+        TraceSpan span("LocalStorage::openLog4DailyFile");
+        theirs = localStorage.openLog4DailyFile(otherDirectory, otherName);
+    }
+    if (theirs == FileData()) {
+        respondMessage = "Failed to read " + command.argument + ".";
+        return CommandType::Failed;
+    }
+
+    // The ancestor is written next to both copies, so either of them can be merged into the other next time
+    MerkleTree ancestor;
+    bool found = false;
+    std::string error;
+    if (!MerkleTree::load(DocumentMerge::ancestorPath(workingDirectory, log4FileName), &ancestor, &found, &error)
+        || (!found && !MerkleTree::load(DocumentMerge::ancestorPath(otherDirectory, otherName), &ancestor, &found, &error))) {
+        respondMessage = error;
+        return CommandType::Failed;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MergeReport report = DocumentMerge::merge(&openedFile, theirs, ancestor);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    if (report.taken + report.removed + report.renumbered > 0) {
+        documentChanged = true;
+        documentChanges.markWhole();
+    }
+
+    // Both copies and their ancestor have to match, so ours is saved now rather than when the run ends
+    flushDocument();
+    FileData merged = openedFile;
+    merged.log4FileName = otherName;
+    if (DiaryCodec::hasCompressedEntries(merged)) {
+        DiaryCodec::compressEntries(&merged);
+    }
+    BlockChecksums::save(localStorage, otherDirectory, otherName, merged);
+
+    MerkleTree mergedTree = MerkleTree::build(merged);
+    if (!mergedTree.save(DocumentMerge::ancestorPath(workingDirectory, log4FileName), &error)
+        || !mergedTree.save(DocumentMerge::ancestorPath(otherDirectory, otherName), &error)
+        || !DocumentMerge::saveConflicts(DocumentMerge::conflictsPath(workingDirectory, log4FileName), report.conflicts, &error)) {
+        respondMessage = "Merged, but " + error + ".";
+        return CommandType::Failed;
+    }
+
+    for (const auto& conflict : report.conflicts.conflicts) {
+        std::cout << DocumentMerge::describe(conflict, openedFile, report.conflicts) << std::endl;
+    }
+    respondMessage = "Merged " + command.argument + " into " + log4FileName + ": took " + std::to_string(report.taken) + ", removed "
+        + std::to_string(report.removed) + " and renumbered " + std::to_string(report.renumbered) + " record(s), compared "
+        + std::to_string(report.bucketsCompared) + " bucket(s) in " + std::to_string(elapsed.count()) + " ms.";
+    if (!report.conflicts.conflicts.empty()) {
+        respondMessage += " " + std::to_string(report.conflicts.conflicts.size()) + " conflict(s) kept your version, resolve them in the Merge tab.";
+    }
+    if (!found) {
+        respondMessage += " No earlier merge was recorded, so removed records were kept.";
+    }
+    return CommandType::Other;
+}
+
+CommandType ApplicationManager::runCompressDiary(const Command& command) {
+    if (command.argument.empty()) {
+        respondMessage = "Missing log4_file_name for --compress-diary.";
+        return CommandType::Failed;
+    }
+
+    bool compress = command.arguments.size() < 2;
+    if (!compress && command.arguments[1] != "off") {
+        respondMessage = "Unknown --compress-diary action: " + command.arguments[1] + " (expected off)";
+        return CommandType::Failed;
+    }
+
+    openedFile = openFile(command.argument);
+    documentChanges.markWhole();
+    if (openedFile == FileData()) {
+        respondMessage = openFailure(command.argument);
+        return CommandType::Failed;
+    }
+
+    size_t storedBefore = 0;
+    for (const auto& entry : openedFile.diaryData) {
+        storedBefore += entry.diaryEntry.size();
     }
 
-    respondMessage = "Failed to execute command.";
-    return CommandType::Failed;
+    auto start = std::chrono::steady_clock::now();
+    size_t changed = compress ? DiaryCodec::compressEntries(&openedFile) : DiaryCodec::decompressEntries(&openedFile);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    size_t raw = 0;
+    size_t stored = 0;
+    for (const auto& entry : openedFile.diaryData) {
+        raw += DiaryCodec::text(entry.diaryEntry).size();
+        stored += entry.diaryEntry.size();
+    }
+
+    if (changed > 0) {
+        // Not through saveFile(), which would compress the entries again right after "off"
+        std::string error;
+        bool replaced = false;
+        if (!useDaemon() || !daemon.store(&openedFile, documentChanges, &replaced, &error)) {
+            if (daemon.connected()) {
+                respondMessage = error;
+                return CommandType::Failed;
+            }
+            writeFile(openedFile, documentChanges);
+        }
+        documentChanges.clear();
+    }
+
+    std::cout << "Diary text: " << raw << " bytes, stored: " << storedBefore << " -> " << stored << " bytes";
+    if (stored > 0) {
+        std::cout << " (ratio " << static_cast<double>(raw) / static_cast<double>(stored) << ")";
+    }
+    std::cout << ", " << elapsed.count() << " ms" << std::endl;
+
+    respondMessage = std::string(compress ? "Compressed " : "Decompressed ") + std::to_string(changed) + " diary entr(ies).";
+    return CommandType::Other;
 }
 
-void ApplicationManager::updateFileData(FileData data) {
-    localStorage.updateDataToFile(workingDirectory, data.log4FileName, data);
+CommandType ApplicationManager::runDaemon(const Command& command) {
+    std::string error;
+
+    if (command.argument.empty()) {
+        DaemonServer server(workingDirectory, configName);
+        std::cout << "log4daily daemon listening on " << DaemonProtocol::socketPath(workingDirectory) << " (Ctrl+C or --daemon stop to stop it)" << std::endl;
+        if (!server.run(&error)) {
+            respondMessage = error;
+            return CommandType::Failed;
+        }
+        respondMessage = "Daemon stopped, all changes are saved.";
+        return CommandType::Other;
+    }
+
+    if (command.argument != "stop" && command.argument != "flush") {
+        respondMessage = "Unknown --daemon action: " + command.argument + " (expected stop or flush)";
+        return CommandType::Failed;
+    }
+    if (!useDaemon()) {
+        respondMessage = "No log4daily daemon is running.";
+        return CommandType::Failed;
+    }
+
+    bool succeeded = command.argument == "stop" ? daemon.shutdown(&error) : daemon.flush(&error);
+    if (!succeeded) {
+        respondMessage = error;
+        return CommandType::Failed;
+    }
+    respondMessage = command.argument == "stop" ? "Daemon stopped, all changes are saved." : "All changes are saved.";
+    return CommandType::Other;
+}
+
+bool ApplicationManager::useDaemon() {
+    if (!daemonChecked) {
+        daemonChecked = true;
+        daemon.connect(workingDirectory);
+    }
+    return daemon.connected();
+}
+
+FileData ApplicationManager::openFile(const std::string& log4FileName, ShardScope scope) {
+    if (useDaemon()) {
+        FileData data;
+        std::string error;
+        if (daemon.open(log4FileName, &data, &error)) {
+            return data;
+        }
+        if (daemon.connected()) {
+            return FileData();
+        }
+    }
+    return readFile(log4FileName, scope);
+}
+
+bool ApplicationManager::saveFile(FileData *data, const DocumentChanges& changes, bool *replaced, std::string *error) {
+    *replaced = false;
+    if (useDaemon()) {
+        if (daemon.store(data, changes, replaced, error)) {
+            return true;
+        }
+        // Refused, the daemon would write its own document over the file on its next flush anyway
+        if (daemon.connected()) {
+            return false;
+        }
+    }
+
+    // The opened file keeps new diary entries as plain text, only the written copy is compressed
+    if (DiaryCodec::hasCompressedEntries(*data)) {
+        FileData compressed = *data;
+        DiaryCodec::compressEntries(&compressed);
+        writeFile(compressed, changes);
+        return true;
+    }
+    writeFile(*data, changes);
+    return true;
+}
+
+FileData ApplicationManager::readFile(const std::string& log4FileName, ShardScope scope) {
+    readError.clear();
+    bool sharded = shardedStore.isSharded(log4FileName);
+    if (!verifyOnOpen) {
+        if (sharded) {
+            return shardedStore.open(log4FileName, scope);
+        }
+        TraceSpan span("LocalStorage::openLog4DailyFile");
+        return localStorage.openLog4DailyFile(workingDirectory, log4FileName);
+    }
+
+    // Only the shards of the scope are read, so only they are checked
+    FileData data;
+    std::vector<VerifyReport> reports;
+    if (sharded) {
+        data = shardedStore.open(log4FileName, scope, &reports);
+    } else {
+        reports.push_back(BlockChecksums::verifyFile(localStorage, workingDirectory, log4FileName, &data));
+        if (data == FileData()) {
+            return data;
+        }
+    }
+
+    for (const auto& report : reports) {
+        if (!report.intact()) {
+            std::string damage = BlockChecksums::describe(report)[0];
+            if (damage.ends_with(':')) {
+                damage.pop_back();
+            }
+            readError = report.file + " is damaged, " + damage + ". (salvage it with --repair)";
+            return FileData();
+        }
+    }
+    return data;
+}
+
+void ApplicationManager::writeFile(const FileData& data, const DocumentChanges& changes) {
+    if (shardedStore.isSharded(data.log4FileName)) {
+        shardedStore.save(data);
+        return;
+    }
+    BlockChecksums::save(localStorage, workingDirectory, data.log4FileName, data);
+
+    std::string error;
+    if (!history.record(workingDirectory, data, changes, &error)) {
+        std::cerr << "The save was not added to the history: " << error << std::endl;
+    }
+}
+
+std::string ApplicationManager::openFailure(const std::string& log4FileName) const {
+    if (!readError.empty()) {
+        return readError;
+    }
+    // Checksums are only written for saved files, so a file without them may just not exist
+    std::error_code error;
+    if (shardedStore.isSharded(log4FileName) || std::filesystem::exists(BlockChecksums::path(workingDirectory, log4FileName), error)) {
+        return "Failed to read log4daily file, it may be damaged. (check it with --verify, salvage it with --repair)";
+    }
+    return "Failed to open log4daily file. (maybe it does not exist?)";
+}
+
+bool ApplicationManager::updateFileData(FileData *data, const DocumentChanges& changes, bool *replaced, std::string *error) {
+    return saveFile(data, changes, replaced, error);
 }
 
 void ApplicationManager::registerToday() {
-    time_t t = time(0);
-    struct tm * now = localtime(&t);
-    int year = now->tm_year + 1900;
-    int month = now->tm_mon + 1;
-    int day = now->tm_mday;
-    
-    Date today = Date({static_cast<short>(day), static_cast<short>(month), static_cast<short>(year), 0, 0});
+    TraceSpan span("ApplicationManager::registerToday");
+    Date today = DateUtils::today();
 
 
     bool exists = false;
@@ -114,7 +1199,14 @@ void ApplicationManager::registerToday() {
     }
     if (!exists) {
         openedFile.calendarData.push_back(today);
-        localStorage.updateDataToFile(workingDirectory, openedFile.log4FileName, openedFile);
+        documentChanges.changed(DocumentSection::Calendar, DateUtils::dateKey(today), openedFile.calendarData.size() - 1);
+        bool replaced = false;
+        std::string error;
+        if (saveFile(&openedFile, documentChanges, &replaced, &error)) {
+            documentChanges.clear();
+        } else {
+            std::cerr << "Today was not registered: " << error << std::endl;
+        }
     }
 }
 
@@ -130,6 +1222,12 @@ void ApplicationManager::showMessage(CommandType respond, std::string message) {
         case CommandType::Delete:
             std::cout << "Log4daily file deleted successfully. ";
             break;
+        case CommandType::Batch:
+            std::cout << "Batch command executed. ";
+            break;
+        case CommandType::Query:
+            std::cout << "Query executed. ";
+            break;
         case CommandType::Help:
             std::cout << "Help command executed. ";
             break;
@@ -155,19 +1253,56 @@ FileData ApplicationManager::getOpenedFile() {
     return openedFile;
 }
 
+DocumentChanges ApplicationManager::getDocumentChanges() {
+    return documentChanges;
+}
+
+Theme ApplicationManager::getTheme() {
+    return theme;
+}
+
+std::string ApplicationManager::getHistoryPath() {
+    return HistoryLog::path(workingDirectory, openedFile.log4FileName);
+}
+
+std::string ApplicationManager::getConflictsPath() {
+    return DocumentMerge::conflictsPath(workingDirectory, openedFile.log4FileName);
+}
+
 void ApplicationManager::showHelp() {
-    std::cout << "Usage: log4daily [command] [log4_file_name]" << std::endl;
-    std::cout << "Commands:" << std::endl;
-    std::cout << "  --new                   [log4_file_name]    Create a new log4daily file" << std::endl;
-    std::cout << "  --open                  [log4_file_name]    Open an existing log4daily file" << std::endl;
-    std::cout << "  --delete                [log4_file_name]    Delete an existing log4daily file" << std::endl;
-    std::cout << "  --list (NIY)            [None]              List out all existing log4daily files" << std::endl;
-    std::cout << "  --import (NIY)          [path_to_file]      Import data from provided log4daily file" << std::endl;
-    std::cout << "  --export (NIY)          [log4_file_name]    Export log4daily file to documents" << std::endl;
-    std::cout << "  --set-theme (NIY)       [theme_name]        Set the theme of the application" << std::endl;
-    std::cout << "  --set-language (NIY)    [language_name]     Set the language of the application" << std::endl;
-    std::cout << "  --help                                      Show this help message" << std::endl;
-
-    std::cout << "Note: log4_file_name should not contain spaces." << std::endl;
-    std::cout << std::endl << "'NIY': Not implemented yet." << std::endl;
+    std::cout << Language::text("help.usage") << std::endl;
+    std::cout << Language::text("help.commands") << std::endl;
+    std::cout << "  --new                   [log4_file_name]    " << Language::text("help.new") << std::endl;
+    std::cout << "  --open                  [log4_file_name]    " << Language::text("help.open") << std::endl;
+    std::cout << "  --delete                [log4_file_name]    " << Language::text("help.delete") << std::endl;
+    std::cout << "  --add-todo              [log4_file_name]    " << Language::text("help.addTodo") << std::endl;
+    std::cout << "  --done                  [log4_file_name]    " << Language::text("help.done") << std::endl;
+    std::cout << "  --add-diary             [log4_file_name]    " << Language::text("help.addDiary") << std::endl;
+    std::cout << "  --progress              [log4_file_name]    " << Language::text("help.progress") << std::endl;
+    std::cout << "  --query                 [log4_file_name]    " << Language::text("help.query") << std::endl;
+    std::cout << "  --stats                 [log4_file_name]    " << Language::text("help.stats") << std::endl;
+    std::cout << "  --archive               [log4_file_name]    " << Language::text("help.archive") << std::endl;
+    std::cout << "  --archive-search        [log4_file_name]    " << Language::text("help.archiveSearch") << std::endl;
+    std::cout << "  --shard                 [log4_file_name]    " << Language::text("help.shard") << std::endl;
+    std::cout << "  --verify                [log4_file_name]    " << Language::text("help.verify") << std::endl;
+    std::cout << "  --repair                [log4_file_name]    " << Language::text("help.repair") << std::endl;
+    std::cout << "  --history               [log4_file_name]    " << Language::text("help.history") << std::endl;
+    std::cout << "  --merge                 [path_to_file]      " << Language::text("help.merge") << std::endl;
+    std::cout << "  --compress-diary        [log4_file_name]    " << Language::text("help.compressDiary") << std::endl;
+    std::cout << "  --daemon                [stop|flush]        " << Language::text("help.daemon") << std::endl;
+    std::cout << "  --set-language          [language_name]     " << Language::text("help.setLanguage") << std::endl;
+    std::cout << "  --set-theme             [theme_name]        " << Language::text("help.setTheme") << std::endl;
+    std::cout << "  --import                [path_to_file]      " << Language::text("help.import") << std::endl;
+    std::cout << "  --export                [path_to_file]      " << Language::text("help.export") << std::endl;
+    std::cout << "  --list (NIY)            [None]              " << Language::text("help.list") << std::endl;
+    std::cout << "  --help                                      " << Language::text("help.help") << std::endl;
+
+    std::cout << Language::text("help.noteFileName") << std::endl;
+    std::cout << Language::text("help.noteBatch") << std::endl;
+    std::cout << Language::text("help.noteBatchSaved") << std::endl;
+    std::cout << Language::text("help.notePipeline") << std::endl;
+    std::cout << Language::text("help.notePipelineExample") << std::endl;
+    std::cout << Language::text("help.noteTrace") << std::endl;
+    std::cout << Language::text("help.noteRecord") << std::endl;
+    std::cout << std::endl << Language::text("help.noteNiy") << std::endl;
 }
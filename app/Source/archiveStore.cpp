@@ -0,0 +1,209 @@
+#include "../Headers/archiveStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Headers/blockChecksums.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/diaryCodec.h"
+#include "../Headers/fileDataOperations.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr const char* manifestHeader = "log4daily archive manifest 1";
+
+    std::string lowercase(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char character) {
+            return static_cast<char>(std::tolower(character));
+        });
+        return text;
+    }
+
+    bool contains(const std::string& text, const std::string& lowercaseNeedle) {
+        return lowercase(text).find(lowercaseNeedle) != std::string::npos;
+    }
+
+    /**
+     * @brief Returns the last day anything happened on the milestone.
+     */
+    int lastActivityDay(const MilestonesData& milestone) {
+        int day = DateUtils::dayNumber(milestone.startDate);
+        for (const auto& point : milestone.progressPoints) {
+            day = std::max(day, DateUtils::dayNumber(point.date));
+        }
+        return day;
+    }
+
+    /**
+     * @brief Moves the records the predicate selects into the archive list of their year, keeping the order of the rest.
+     */
+    template <typename Record, typename Select, typename Year, typename Target>
+    void moveRecords(std::vector<Record>& records, Select select, Year year, Target target) {
+        auto kept = records.begin();
+        for (auto it = records.begin(); it != records.end(); ++it) {
+            if (select(*it)) {
+                target(year(*it)).push_back(std::move(*it));
+            } else {
+                if (kept != it) {
+                    *kept = std::move(*it);
+                }
+                ++kept;
+            }
+        }
+        records.erase(kept, records.end());
+    }
+}
+
+ArchiveStore::ArchiveStore(std::string workingDirectory, std::string configName) : localStorage(workingDirectory + configName) {
+    this->workingDirectory = workingDirectory;
+    this->configName = configName;
+}
+
+std::string ArchiveStore::segmentName(const std::string& log4FileName, int year) {
+    return log4FileName + "-archive-" + std::to_string(year);
+}
+
+std::string ArchiveStore::manifestPath(const std::string& log4FileName) const {
+    return workingDirectory + log4FileName + ".archive-manifest";
+}
+
+std::vector<ArchiveSegment> ArchiveStore::segments(const std::string& log4FileName) const {
+    std::vector<ArchiveSegment> segments;
+
+    std::ifstream manifest(manifestPath(log4FileName));
+    std::string line;
+    if (!std::getline(manifest, line) || line != manifestHeader) {
+        return segments;
+    }
+
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        ArchiveSegment segment;
+        if (fields >> segment.year >> segment.todos >> segment.milestones >> segment.diaryEntries) {
+            segments.push_back(segment);
+        }
+    }
+    return segments;
+}
+
+void ArchiveStore::writeManifest(const std::string& log4FileName, const std::vector<ArchiveSegment>& segments) const {
+    std::ofstream manifest(manifestPath(log4FileName), std::ios::trunc);
+    manifest << manifestHeader << '\n';
+    for (const auto& segment : segments) {
+        manifest << segment.year << '\t' << segment.todos << '\t' << segment.milestones << '\t' << segment.diaryEntries << '\n';
+    }
+}
+
+std::vector<ArchiveSegment> ArchiveStore::archive(FileData *data, const ArchivePolicy& policy, int today) {
+    std::map<int, FileData> moved;
+    auto target = [&moved](int year) -> FileData& {
+        return moved[year];
+    };
+
+    moveRecords(data->todosData, [&](const TodoData& todo) {
+        return FileDataOperations::isTodoDone(todo) && DateUtils::dayNumber(todo.dueDate) < today - policy.todoDays;
+    }, [](const TodoData& todo) {
+        return static_cast<int>(todo.dueDate.year);
+    }, [&](int year) -> std::vector<TodoData>& {
+        return target(year).todosData;
+    });
+
+    moveRecords(data->milestonesData, [&](const MilestonesData& milestone) {
+        return lastActivityDay(milestone) < today - policy.milestoneDays;
+    }, [](const MilestonesData& milestone) {
+        return static_cast<int>(DateUtils::fromDayNumber(lastActivityDay(milestone)).year);
+    }, [&](int year) -> std::vector<MilestonesData>& {
+        return target(year).milestonesData;
+    });
+
+    moveRecords(data->diaryData, [&](const DiaryData& entry) {
+        return DateUtils::dayNumber(entry.date) < today - policy.diaryDays;
+    }, [](const DiaryData& entry) {
+        return static_cast<int>(entry.date.year);
+    }, [&](int year) -> std::vector<DiaryData>& {
+        return target(year).diaryData;
+    });
+
+    std::vector<ArchiveSegment> archived;
+    if (moved.empty()) {
+        return archived;
+    }
+
+    std::vector<ArchiveSegment> manifest = segments(data->log4FileName);
+
+    for (auto& [year, records] : moved) {
+        std::string name = segmentName(data->log4FileName, year);
+
+        FileData segment = localStorage.openLog4DailyFile(workingDirectory, name);
+        if (segment == FileData()) {
+            localStorage.createLog4DailyFile(workingDirectory, name, configName);
+            segment = localStorage.openLog4DailyFile(workingDirectory, name);
+            segment.log4FileName = name;
+        }
+
+        for (auto& todo : records.todosData) {
+            segment.todosData.push_back(std::move(todo));
+        }
+        for (auto& milestone : records.milestonesData) {
+            segment.milestonesData.push_back(std::move(milestone));
+        }
+        for (auto& entry : records.diaryData) {
+            segment.diaryData.push_back(std::move(entry));
+        }
+        BlockChecksums::save(localStorage, workingDirectory, name, segment);
+
+        ArchiveSegment counts = { year, records.todosData.size(), records.milestonesData.size(), records.diaryData.size() };
+        archived.push_back(counts);
+
+        auto it = std::find_if(manifest.begin(), manifest.end(), [year](const ArchiveSegment& existing) {
+            return existing.year == year;
+        });
+        if (it == manifest.end()) {
+            manifest.push_back(ArchiveSegment({year, 0, 0, 0}));
+            it = manifest.end() - 1;
+        }
+        it->todos += counts.todos;
+        it->milestones += counts.milestones;
+        it->diaryEntries += counts.diaryEntries;
+    }
+
+    std::sort(manifest.begin(), manifest.end(), [](const ArchiveSegment& left, const ArchiveSegment& right) {
+        return left.year < right.year;
+    });
+    writeManifest(data->log4FileName, manifest);
+    return archived;
+}
+
+std::vector<ArchiveMatch> ArchiveStore::search(const std::string& log4FileName, const std::string& text) {
+    std::vector<ArchiveMatch> matches;
+    std::string needle = lowercase(text);
+
+    std::vector<ArchiveSegment> manifest = segments(log4FileName);
+    for (auto it = manifest.rbegin(); it != manifest.rend(); ++it) {
+        int year = it->year;
+        FileData segment = localStorage.openLog4DailyFile(workingDirectory, segmentName(log4FileName, year));
+
+        for (const auto& todo : segment.todosData) {
+            if (contains(todo.todoName, needle) || contains(todo.todoDescription, needle)) {
+                matches.push_back(ArchiveMatch({year, "todo", todo.id, todo.dueDate, todo.todoName}));
+            }
+        }
+        for (const auto& milestone : segment.milestonesData) {
+            if (contains(milestone.milestoneName, needle) || contains(milestone.milestoneDescription, needle)) {
+                matches.push_back(ArchiveMatch({year, "milestone", milestone.id, milestone.startDate, milestone.milestoneName}));
+            }
+        }
+        for (const auto& entry : segment.diaryData) {
+            if (contains(entry.diaryEntryName, needle) || contains(DiaryCodec::text(entry.diaryEntry), needle)) {
+                matches.push_back(ArchiveMatch({year, "diary", entry.id, entry.date, entry.diaryEntryName}));
+            }
+        }
+    }
+    return matches;
+}
@@ -0,0 +1,215 @@
+#include "../Headers/batchCommands.h"
+
+#include <charconv>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "../Headers/dateUtils.h"
+#include "../Headers/fileDataOperations.h"
+#include "../Headers/inputHandlers.h"
+#include "../Headers/recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    bool parseNumber(const std::string& text, size_t begin, size_t length, int *value) {
+        if (begin + length > text.size()) {
+            return false;
+        }
+        const char *first = text.data() + begin;
+        auto [end, error] = std::from_chars(first, first + length, *value);
+        return error == std::errc() && end == first + length;
+    }
+
+    bool parseId(const std::string& text, int *id) {
+        return parseNumber(text, 0, text.size(), id);
+    }
+
+    std::string unescape(const std::string& text) {
+        std::string result;
+        result.reserve(text.size());
+
+        for (size_t i = 0; i < text.size(); i++) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                char next = text[i + 1];
+                if (next == 'n' || next == 't' || next == '\\') {
+                    result += next == 'n' ? '\n' : next == 't' ? '\t' : '\\';
+                    i++;
+                    continue;
+                }
+            }
+            result += text[i];
+        }
+        return result;
+    }
+
+    std::string recordError(size_t record, const std::string& message) {
+        return "Record " + std::to_string(record + 1) + ": " + message;
+    }
+}
+
+bool BatchCommands::isBatchCommand(const std::string& commandName) {
+    return commandName == "--add-todo" || commandName == "--done" || commandName == "--add-diary" || commandName == "--progress";
+}
+
+bool BatchCommands::parseDate(const std::string& text, Date *date) {
+    int year, month, day;
+    int hour = 0;
+    int minute = 0;
+
+    if (text.size() != 10 && text.size() != 16) {
+        return false;
+    }
+    if (text[4] != '-' || text[7] != '-') {
+        return false;
+    }
+    if (!parseNumber(text, 0, 4, &year) || !parseNumber(text, 5, 2, &month) || !parseNumber(text, 8, 2, &day)) {
+        return false;
+    }
+    if (text.size() == 16) {
+        if (text[10] != ' ' || text[13] != ':' || !parseNumber(text, 11, 2, &hour) || !parseNumber(text, 14, 2, &minute)) {
+            return false;
+        }
+    }
+
+    if (month < 1 || month > 12 || day < 1 || day > DateUtils::daysInMonth(year, month) || hour > 23 || minute > 59) {
+        return false;
+    }
+
+    *date = Date({static_cast<short>(day), static_cast<short>(month), static_cast<short>(year), static_cast<short>(hour), static_cast<short>(minute)});
+    return true;
+}
+
+std::vector<std::string> BatchCommands::readRecords(const Command& command, std::istream& input) {
+    if (command.arguments.size() > 1) {
+        return std::vector<std::string>(command.arguments.begin() + 1, command.arguments.end());
+    }
+
+    std::vector<std::string> records;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            records.push_back(std::move(line));
+        }
+    }
+    return records;
+}
+
+std::vector<std::string> BatchCommands::splitFields(const std::string& record) {
+    std::vector<std::string> fields;
+
+    size_t begin = 0;
+    while (true) {
+        size_t end = record.find('\t', begin);
+        if (end == std::string::npos) {
+            fields.push_back(record.substr(begin));
+            break;
+        }
+        fields.push_back(record.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return fields;
+}
+
+BatchResult BatchCommands::apply(const Command& command, FileData *data, DocumentChanges *changes, std::istream& input) {
+    BatchResult result;
+    std::vector<std::string> records = readRecords(command, input);
+
+    if (command.name == "--done") {
+        std::vector<int> ids;
+        ids.reserve(records.size());
+        size_t occurrencesDone = 0;
+
+        for (size_t i = 0; i < records.size(); i++) {
+            std::vector<std::string> fields = splitFields(records[i]);
+            int id;
+            if (!parseId(fields[0], &id)) {
+                result.errors.push_back(recordError(i, "'" + fields[0] + "' is not a todo ID"));
+                continue;
+            }
+            if (fields.size() < 2) {
+                ids.push_back(id);
+                continue;
+            }
+
+            // A date marks one occurrence of a recurring todo
+            Date day;
+            if (!parseDate(fields[1], &day)) {
+                result.errors.push_back(recordError(i, "'" + fields[1] + "' is not a valid date (YYYY-MM-DD)"));
+                continue;
+            }
+            if (!FileDataOperations::markOccurrenceDone(data, id, DateUtils::dayNumber(day), true, changes)) {
+                result.errors.push_back(recordError(i, "todo " + fields[0] + " has no open occurrence on " + fields[1]));
+                continue;
+            }
+            occurrencesDone++;
+        }
+
+        size_t todosDone = FileDataOperations::markTodosDone(data, ids, changes);
+        result.applied = todosDone + occurrencesDone;
+        result.skipped = records.size() - result.applied;
+        if (todosDone < ids.size()) {
+            result.errors.push_back(std::to_string(ids.size() - todosDone) + " todo(s) were not found or already done");
+        }
+        return result;
+    }
+
+    // Todos added without a due date are due tomorrow at the current time, like in the UI
+    Date defaultDueDate = DateUtils::fromDayNumber(DateUtils::dayNumber(DateUtils::today()) + 1);
+    Date now = DateUtils::now();
+    defaultDueDate.hour = now.hour;
+    defaultDueDate.minute = now.minute;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        std::vector<std::string> fields = splitFields(records[i]);
+
+        if (command.name == "--add-todo") {
+            if (fields[0].empty()) {
+                result.errors.push_back(recordError(i, "todo needs a title"));
+                continue;
+            }
+            Date dueDate = defaultDueDate;
+            if (fields.size() > 2 && !parseDate(fields[2], &dueDate)) {
+                result.errors.push_back(recordError(i, "'" + fields[2] + "' is not a valid due date (YYYY-MM-DD [HH:MM])"));
+                continue;
+            }
+            RecurrenceRule rule;
+            std::string error;
+            if (fields.size() > 3 && !Recurrence::parseRule(fields[3], DateUtils::dayNumber(dueDate), &rule, &error)) {
+                result.errors.push_back(recordError(i, error));
+                continue;
+            }
+            FileDataOperations::addTodo(data, unescape(fields[0]), fields.size() > 1 ? unescape(fields[1]) : "", dueDate, changes);
+            if (rule.kind != RecurrenceKind::None) {
+                Recurrence::setRule(&data->todosData.back(), rule);
+            }
+        }
+        else if (command.name == "--add-diary") {
+            if (fields.size() < 2 || fields[1].empty()) {
+                result.errors.push_back(recordError(i, "diary entry needs a title and a content"));
+                continue;
+            }
+            FileDataOperations::addDiaryEntry(data, unescape(fields[0]), unescape(fields[1]), changes);
+        }
+        else if (command.name == "--progress") {
+            int id;
+            if (!parseId(fields[0], &id)) {
+                result.errors.push_back(recordError(i, "'" + fields[0] + "' is not a milestone ID"));
+                continue;
+            }
+            bool isCompleted = fields.size() < 2 || fields[1] != "0";
+            if (!FileDataOperations::addMilestoneProgressPoint(data, id, isCompleted, changes)) {
+                result.errors.push_back(recordError(i, "milestone " + fields[0] + " does not exist or already has a progress point for today"));
+                continue;
+            }
+        }
+        result.applied++;
+    }
+
+    result.skipped = records.size() - result.applied;
+    return result;
+}
@@ -0,0 +1,274 @@
+#include "../Headers/blockChecksums.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Headers/crc32c.h"
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/trace.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr const char* checksumsHeader = "log4daily checksums 1";
+
+    enum Section {
+        Calendar,
+        Todos,
+        Milestones,
+        Diary,
+        SectionCount
+    };
+
+    constexpr const char* sectionNames[SectionCount] = { "calendar", "todos", "milestones", "diary" };
+
+    int sectionIndex(const std::string& name) {
+        for (int section = 0; section < SectionCount; section++) {
+            if (name == sectionNames[section]) {
+                return section;
+            }
+        }
+        return -1;
+    }
+
+    size_t sectionSize(const FileData& data, int section) {
+        switch (section) {
+            case Calendar: return data.calendarData.size();
+            case Todos: return data.todosData.size();
+            case Milestones: return data.milestonesData.size();
+            case Diary: return data.diaryData.size();
+            default: return 0;
+        }
+    }
+
+    uint32_t blockCrc(const FileData& data, int section, size_t first, size_t count, PayloadWriter& writer) {
+        writer.payload.clear();
+        for (size_t i = first; i < first + count; i++) {
+            switch (section) {
+                case Calendar: writer.date(data.calendarData[i]); break;
+                case Todos: writer.todo(data.todosData[i]); break;
+                case Milestones: writer.milestone(data.milestonesData[i]); break;
+                case Diary: writer.diaryEntry(data.diaryData[i]); break;
+                default: break;
+            }
+        }
+        return Crc32c::compute(writer.payload);
+    }
+
+    /**
+     * @brief Calls the function for every block index, spread over the cores when there are enough blocks.
+     */
+    template <typename Function>
+    void forEachBlock(size_t count, Function checkBlock) {
+        // Below this many blocks per thread, starting the threads costs more than it saves
+        constexpr size_t blocksPerThread = 256;
+        size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), (count + blocksPerThread - 1) / blocksPerThread);
+
+        std::atomic<size_t> nextBlock = 0;
+        auto worker = [&] {
+            PayloadWriter writer;
+            for (size_t block = nextBlock++; block < count; block = nextBlock++) {
+                checkBlock(block, writer);
+            }
+        };
+
+        if (threadCount <= 1) {
+            worker();
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.emplace_back(worker);
+        }
+    }
+
+    template <typename Record>
+    std::vector<Record> keepRecords(const std::vector<Record>& records, const std::vector<bool>& dropped) {
+        std::vector<Record> kept;
+        kept.reserve(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            if (!dropped[i]) {
+                kept.push_back(records[i]);
+            }
+        }
+        return kept;
+    }
+}
+
+std::string BlockChecksums::path(const std::string& workingDirectory, const std::string& log4FileName) {
+    return workingDirectory + log4FileName + ".l4dsum";
+}
+
+std::vector<ChecksumBlock> BlockChecksums::compute(const FileData& data) {
+    std::vector<ChecksumBlock> blocks;
+    for (int section = 0; section < SectionCount; section++) {
+        size_t size = sectionSize(data, section);
+        for (size_t first = 0; first < size; first += recordsPerBlock) {
+            blocks.push_back(ChecksumBlock({sectionNames[section], first, std::min(recordsPerBlock, size - first), 0}));
+        }
+    }
+
+    forEachBlock(blocks.size(), [&](size_t i, PayloadWriter& writer) {
+        ChecksumBlock& block = blocks[i];
+        block.crc = blockCrc(data, sectionIndex(block.section), block.first, block.count, writer);
+    });
+    return blocks;
+}
+
+bool BlockChecksums::read(const std::string& path, std::vector<ChecksumBlock> *blocks) {
+    blocks->clear();
+
+    std::ifstream file(path);
+    std::string line;
+    if (!std::getline(file, line) || line != checksumsHeader) {
+        return false;
+    }
+
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        ChecksumBlock block;
+        if (fields >> block.section >> block.first >> block.count >> std::hex >> block.crc) {
+            blocks->push_back(block);
+        }
+    }
+    return true;
+}
+
+void BlockChecksums::write(const std::string& path, const std::vector<ChecksumBlock>& blocks) {
+    // Written next to the old checksums and renamed over them, so a crash never leaves half a list
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << checksumsHeader << '\n';
+
+        char crc[9];
+        for (const auto& block : blocks) {
+            std::snprintf(crc, sizeof(crc), "%08x", block.crc);
+            file << block.section << ' ' << block.first << ' ' << block.count << ' ' << crc << '\n';
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
+
+void BlockChecksums::save(LocalStorage& storage, const std::string& workingDirectory, const std::string& log4FileName, const FileData& data) {
+    {
+        TraceSpan span("LocalStorage::updateDataToFile");
+        storage.updateDataToFile(workingDirectory, log4FileName, data);
+    }
+    write(path(workingDirectory, log4FileName), compute(data));
+}
+
+VerifyReport BlockChecksums::verify(const FileData& data, const std::vector<ChecksumBlock>& stored) {
+    VerifyReport report;
+    report.readable = true;
+    report.hasChecksums = !stored.empty();
+    report.blocks = stored.size();
+
+    std::vector<char> damaged(stored.size(), 0);
+    forEachBlock(stored.size(), [&](size_t i, PayloadWriter& writer) {
+        const ChecksumBlock& block = stored[i];
+        int section = sectionIndex(block.section);
+        if (section < 0 || block.first + block.count > sectionSize(data, section)) {
+            damaged[i] = 1;
+            return;
+        }
+        damaged[i] = blockCrc(data, section, block.first, block.count, writer) != block.crc;
+    });
+
+    size_t checkedUntil[SectionCount] = {};
+    for (size_t i = 0; i < stored.size(); i++) {
+        if (damaged[i]) {
+            report.damaged.push_back(stored[i]);
+        }
+        int section = sectionIndex(stored[i].section);
+        if (section >= 0) {
+            checkedUntil[section] = std::max(checkedUntil[section], stored[i].first + stored[i].count);
+        }
+    }
+    for (int section = 0; section < SectionCount; section++) {
+        size_t size = sectionSize(data, section);
+        report.uncheckedRecords += size > checkedUntil[section] ? size - checkedUntil[section] : 0;
+    }
+    return report;
+}
+
+VerifyReport BlockChecksums::verifyFile(LocalStorage& storage, const std::string& workingDirectory, const std::string& log4FileName, FileData *data) {
+    FileData opened;
+    {
+        TraceSpan span("LocalStorage::openLog4DailyFile");
+        opened = storage.openLog4DailyFile(workingDirectory, log4FileName);
+    }
+    std::vector<ChecksumBlock> stored;
+    bool hasChecksums = read(path(workingDirectory, log4FileName), &stored);
+
+    VerifyReport report;
+    if (!(opened == FileData())) {
+        report = verify(opened, stored);
+    }
+    report.file = log4FileName;
+    report.hasChecksums = hasChecksums;
+
+    if (data != nullptr) {
+        *data = std::move(opened);
+    }
+    return report;
+}
+
+FileData BlockChecksums::salvage(const FileData& data, const VerifyReport& report) {
+    std::vector<bool> dropped[SectionCount];
+    for (int section = 0; section < SectionCount; section++) {
+        dropped[section].assign(sectionSize(data, section), false);
+    }
+    for (const auto& block : report.damaged) {
+        int section = sectionIndex(block.section);
+        if (section < 0) {
+            continue;
+        }
+        for (size_t i = block.first; i < block.first + block.count && i < dropped[section].size(); i++) {
+            dropped[section][i] = true;
+        }
+    }
+
+    FileData salvaged;
+    salvaged.log4FileName = data.log4FileName;
+    salvaged.calendarData = keepRecords(data.calendarData, dropped[Calendar]);
+    salvaged.todosData = keepRecords(data.todosData, dropped[Todos]);
+    salvaged.milestonesData = keepRecords(data.milestonesData, dropped[Milestones]);
+    salvaged.diaryData = keepRecords(data.diaryData, dropped[Diary]);
+    return salvaged;
+}
+
+std::vector<std::string> BlockChecksums::describe(const VerifyReport& report) {
+    std::vector<std::string> lines;
+    if (!report.readable) {
+        lines.push_back("unreadable, l4dFiles could not read it");
+        return lines;
+    }
+    if (!report.hasChecksums) {
+        lines.push_back("no checksums yet, they are written with the next save");
+        return lines;
+    }
+
+    if (report.damaged.empty()) {
+        lines.push_back("ok, " + std::to_string(report.blocks) + " block(s)");
+    } else {
+        lines.push_back(std::to_string(report.damaged.size()) + " of " + std::to_string(report.blocks) + " block(s) damaged:");
+        for (const auto& block : report.damaged) {
+            lines.push_back("    " + block.section + " " + std::to_string(block.first) + "-" + std::to_string(block.first + block.count - 1));
+        }
+    }
+    if (report.uncheckedRecords > 0) {
+        lines.push_back(std::to_string(report.uncheckedRecords) + " record(s) after the last block have no checksum");
+    }
+    return lines;
+}
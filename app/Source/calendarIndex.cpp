@@ -0,0 +1,119 @@
+#include "../Headers/calendarIndex.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "../Headers/dateUtils.h"
+#include "../Headers/fileDataOperations.h"
+#include "../Headers/recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+// 2024 is a leap year starting on a Monday
+static_assert(CalendarIndex::layout(2024, 2).days == 29 && CalendarIndex::layout(2024, 1).firstWeekday == 0);
+static_assert(CalendarIndex::layout(2027, 2).weeks == 4 && CalendarIndex::layout(2026, 3).weeks == 6);
+
+CalendarDay& CalendarIndex::day(const Date& date) {
+    int index = monthIndex(date.year, date.month);
+    monthChanges[index] = ++changes;
+    return months[index][std::clamp(date.day - 1, 0, 30)];
+}
+
+void CalendarIndex::rebuild(const FileData& data) {
+    months.clear();
+    monthChanges.clear();
+
+    for (const auto& date : data.calendarData) {
+        addOpenedDay(date);
+    }
+    for (const auto& entry : data.diaryData) {
+        addDiaryEntry(entry);
+    }
+    for (const auto& todo : data.todosData) {
+        addTodo(todo);
+    }
+    for (const auto& milestone : data.milestonesData) {
+        for (const auto& point : milestone.progressPoints) {
+            addProgressPoint(point);
+        }
+    }
+
+    recurrencesStale = true;
+    rebuiltAt = ++changes;
+}
+
+void CalendarIndex::addOpenedDay(const Date& date) {
+    day(date).opened = true;
+}
+
+void CalendarIndex::addDiaryEntry(const DiaryData& entry) {
+    day(entry.date).diaryEntries++;
+}
+
+void CalendarIndex::addTodo(const TodoData& todo) {
+    // Recurring todos are expanded per month instead
+    recurrencesStale = true;
+    if (Recurrence::isRecurring(todo)) {
+        recurrencesChangedAt = ++changes;
+        return;
+    }
+    CalendarDay& due = day(todo.dueDate);
+    due.dueTodos++;
+    due.doneTodos += FileDataOperations::isTodoDone(todo);
+}
+
+void CalendarIndex::removeTodo(const TodoData& todo) {
+    // The recurrence index holds positions in the todos list, which move when a todo is removed
+    recurrencesStale = true;
+    if (Recurrence::isRecurring(todo)) {
+        recurrencesChangedAt = ++changes;
+        return;
+    }
+    CalendarDay& due = day(todo.dueDate);
+    due.dueTodos -= due.dueTodos > 0;
+    due.doneTodos -= FileDataOperations::isTodoDone(todo) && due.doneTodos > 0;
+}
+
+void CalendarIndex::addProgressPoint(const MilestoneProgressPoint& point) {
+    CalendarDay& pointDay = day(point.date);
+    pointDay.progressPoints++;
+    pointDay.completedPoints += point.isCompleted;
+}
+
+void CalendarIndex::removeMilestone(const MilestonesData& milestone) {
+    for (const auto& point : milestone.progressPoints) {
+        CalendarDay& pointDay = day(point.date);
+        pointDay.progressPoints -= pointDay.progressPoints > 0;
+        pointDay.completedPoints -= point.isCompleted && pointDay.completedPoints > 0;
+    }
+}
+
+CalendarMonth CalendarIndex::month(int year, int month, const std::vector<TodoData>& todos) {
+    CalendarMonth calendarMonth;
+    calendarMonth.layout = layout(year, month);
+
+    auto stored = months.find(monthIndex(year, month));
+    if (stored != months.end()) {
+        calendarMonth.days = stored->second;
+    }
+
+    if (recurrencesStale) {
+        recurrences.rebuild(todos);
+        recurrencesStale = false;
+    }
+    std::vector<Occurrence> occurrences;
+    const MonthLayout& monthLayout = calendarMonth.layout;
+    recurrences.expand(monthLayout.firstDay, monthLayout.firstDay + monthLayout.days - 1, &occurrences);
+    for (const auto& occurrence : occurrences) {
+        CalendarDay& due = calendarMonth.days[occurrence.day - monthLayout.firstDay];
+        due.dueTodos++;
+        due.doneTodos += occurrence.done;
+    }
+    return calendarMonth;
+}
+
+uint64_t CalendarIndex::version(int year, int month) const {
+    auto changed = monthChanges.find(monthIndex(year, month));
+    uint64_t monthChangedAt = changed == monthChanges.end() ? 0 : changed->second;
+    return std::max({ monthChangedAt, rebuiltAt, recurrencesChangedAt });
+}
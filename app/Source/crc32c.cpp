@@ -0,0 +1,121 @@
+#include "../Headers/crc32c.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define LOG4DAILY_CRC32C_SSE42
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define LOG4DAILY_CRC32C_ARM
+#endif
+
+namespace {
+    // Reversed Castagnoli polynomial
+    constexpr uint32_t polynomial = 0x82F63B78u;
+
+    // Slicing by 8: tables[k][byte] is the checksum of the byte followed by k zero bytes
+    constexpr std::array<std::array<uint32_t, 256>, 8> tables = [] {
+        std::array<std::array<uint32_t, 256>, 8> tables = {};
+        for (uint32_t byte = 0; byte < 256; byte++) {
+            uint32_t crc = byte;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1)));
+            }
+            tables[0][byte] = crc;
+        }
+        for (size_t byte = 0; byte < 256; byte++) {
+            for (size_t k = 1; k < 8; k++) {
+                tables[k][byte] = (tables[k - 1][byte] >> 8) ^ tables[0][tables[k - 1][byte] & 0xff];
+            }
+        }
+        return tables;
+    }();
+
+    uint32_t softwareCrc(const unsigned char *bytes, size_t size, uint32_t crc) {
+        while (size >= 8) {
+            uint32_t low;
+            uint32_t high;
+            std::memcpy(&low, bytes, 4);
+            std::memcpy(&high, bytes + 4, 4);
+            if constexpr (std::endian::native == std::endian::big) {
+                low = __builtin_bswap32(low);
+                high = __builtin_bswap32(high);
+            }
+            low ^= crc;
+            crc = tables[7][low & 0xff] ^ tables[6][(low >> 8) & 0xff] ^ tables[5][(low >> 16) & 0xff] ^ tables[4][low >> 24]
+                ^ tables[3][high & 0xff] ^ tables[2][(high >> 8) & 0xff] ^ tables[1][(high >> 16) & 0xff] ^ tables[0][high >> 24];
+            bytes += 8;
+            size -= 8;
+        }
+        while (size-- > 0) {
+            crc = (crc >> 8) ^ tables[0][(crc ^ *bytes++) & 0xff];
+        }
+        return crc;
+    }
+
+#if defined(LOG4DAILY_CRC32C_SSE42)
+    __attribute__((target("sse4.2")))
+    uint32_t hardwareCrc(const unsigned char *bytes, size_t size, uint32_t crc) {
+        uint64_t crc64 = crc;
+        while (size >= 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+            bytes += 8;
+            size -= 8;
+        }
+        crc = static_cast<uint32_t>(crc64);
+        while (size-- > 0) {
+            crc = _mm_crc32_u8(crc, *bytes++);
+        }
+        return crc;
+    }
+
+    bool detectHardware() {
+        return __builtin_cpu_supports("sse4.2");
+    }
+#elif defined(LOG4DAILY_CRC32C_ARM)
+    uint32_t hardwareCrc(const unsigned char *bytes, size_t size, uint32_t crc) {
+        while (size >= 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            crc = __crc32cd(crc, word);
+            bytes += 8;
+            size -= 8;
+        }
+        while (size-- > 0) {
+            crc = __crc32cb(crc, *bytes++);
+        }
+        return crc;
+    }
+
+    bool detectHardware() {
+        return true;
+    }
+#else
+    uint32_t hardwareCrc(const unsigned char *bytes, size_t size, uint32_t crc) {
+        return softwareCrc(bytes, size, crc);
+    }
+
+    bool detectHardware() {
+        return false;
+    }
+#endif
+}
+
+bool Crc32c::hardwareAccelerated() {
+    static const bool available = detectHardware();
+    return available;
+}
+
+uint32_t Crc32c::compute(std::string_view data, uint32_t crc) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data.data());
+    crc = ~crc;
+    crc = hardwareAccelerated() ? hardwareCrc(bytes, data.size(), crc) : softwareCrc(bytes, data.size(), crc);
+    return ~crc;
+}
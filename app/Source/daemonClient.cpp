@@ -0,0 +1,196 @@
+#include "../Headers/daemonClient.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "../Headers/batchCommands.h"
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    bool checkResponse(const PayloadReader& reader, std::string *error) {
+        if (!reader.ok) {
+            *error = "Malformed response from the log4daily daemon.";
+        }
+        return reader.ok;
+    }
+}
+
+DaemonClient::~DaemonClient() {
+    disconnect();
+}
+
+bool DaemonClient::connect(const std::string& workingDirectory) {
+#if defined(__unix__) || defined(__APPLE__)
+    disconnect();
+
+    std::string path = DaemonProtocol::socketPath(workingDirectory);
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+
+    socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket < 0) {
+        return false;
+    }
+    if (::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        disconnect();
+        return false;
+    }
+    return true;
+#else
+    (void)workingDirectory;
+    return false;
+#endif
+}
+
+bool DaemonClient::connected() const {
+    return socket >= 0;
+}
+
+void DaemonClient::disconnect() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (socket >= 0) {
+        ::close(socket);
+    }
+#endif
+    socket = -1;
+}
+
+bool DaemonClient::request(DaemonOpcode opcode, const std::string& payload, DaemonFrame *response, PayloadReader *reader, std::string *error) {
+    if (!connected() || !DaemonProtocol::writeFrame(socket, static_cast<uint8_t>(opcode), payload) || !DaemonProtocol::readFrame(socket, response)) {
+        // The daemon went away, later requests go to the files directly
+        disconnect();
+        *error = "Lost connection to the log4daily daemon.";
+        return false;
+    }
+
+    *reader = PayloadReader(response->payload);
+    std::string message = reader->string();
+    if (static_cast<DaemonStatus>(response->opcode) != DaemonStatus::Ok) {
+        *error = message.empty() ? "The log4daily daemon failed to execute the request." : message;
+        return false;
+    }
+    return checkResponse(*reader, error);
+}
+
+bool DaemonClient::ping() {
+    DaemonFrame response;
+    PayloadReader reader("");
+    std::string error;
+    return request(DaemonOpcode::Ping, "", &response, &reader, &error);
+}
+
+bool DaemonClient::open(const std::string& log4FileName, FileData *data, std::string *error) {
+    PayloadWriter writer;
+    writer.string(log4FileName);
+
+    DaemonFrame response;
+    PayloadReader reader("");
+    if (!request(DaemonOpcode::Open, writer.payload, &response, &reader, error)) {
+        return false;
+    }
+    uint64_t version = reader.u64();
+    *data = reader.fileData();
+    if (!checkResponse(reader, error)) {
+        return false;
+    }
+    versions[log4FileName] = version;
+    return true;
+}
+
+bool DaemonClient::store(FileData *data, const DocumentChanges& changes, bool *replaced, std::string *error) {
+    auto known = versions.find(data->log4FileName);
+    PayloadWriter writer;
+    writer.string(data->log4FileName);
+    writer.u64(known != versions.end() ? known->second : 0);
+    writer.changes(*data, changes);
+
+    DaemonFrame response;
+    PayloadReader reader("");
+    if (!request(DaemonOpcode::Store, writer.payload, &response, &reader, error)) {
+        return false;
+    }
+    uint64_t version = reader.u64();
+    bool outdated = reader.u8() != 0;
+    FileData latest;
+    if (outdated) {
+        latest = reader.fileData();
+    }
+    if (!checkResponse(reader, error)) {
+        return false;
+    }
+
+    versions[data->log4FileName] = version;
+    *replaced = outdated;
+    if (outdated) {
+        *data = std::move(latest);
+    }
+    return true;
+}
+
+bool DaemonClient::batch(const std::string& commandName, const std::string& log4FileName, const std::vector<std::string>& records, BatchResult *result, std::string *error) {
+    PayloadWriter writer;
+    writer.string(commandName);
+    writer.string(log4FileName);
+    writer.strings(records);
+
+    DaemonFrame response;
+    PayloadReader reader("");
+    if (!request(DaemonOpcode::Batch, writer.payload, &response, &reader, error)) {
+        return false;
+    }
+    result->applied = reader.u64();
+    result->skipped = reader.u64();
+    result->errors = reader.strings();
+    return checkResponse(reader, error);
+}
+
+bool DaemonClient::query(const std::string& log4FileName, const std::string& expression, std::string *output, size_t *matches, std::string *error) {
+    PayloadWriter writer;
+    writer.string(log4FileName);
+    writer.string(expression);
+
+    DaemonFrame response;
+    PayloadReader reader("");
+    if (!request(DaemonOpcode::Query, writer.payload, &response, &reader, error)) {
+        return false;
+    }
+    *matches = reader.u64();
+    *output = reader.string();
+    return checkResponse(reader, error);
+}
+
+bool DaemonClient::close(const std::string& log4FileName, std::string *error) {
+    PayloadWriter writer;
+    writer.string(log4FileName);
+
+    DaemonFrame response;
+    PayloadReader reader("");
+    return request(DaemonOpcode::Close, writer.payload, &response, &reader, error);
+}
+
+bool DaemonClient::flush(std::string *error) {
+    DaemonFrame response;
+    PayloadReader reader("");
+    return request(DaemonOpcode::Flush, "", &response, &reader, error);
+}
+
+bool DaemonClient::shutdown(std::string *error) {
+    DaemonFrame response;
+    PayloadReader reader("");
+    return request(DaemonOpcode::Shutdown, "", &response, &reader, error);
+}
@@ -0,0 +1,369 @@
+#include "../Headers/daemonProtocol.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+#include "../Headers/dateUtils.h"
+#include "../Headers/documentChanges.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    // The changed records of one section in the order of the document, then the removed keys
+    template <typename Record, typename Key, typename Write>
+    void writeSection(PayloadWriter& writer, const std::vector<Record>& records, const DocumentChanges& changes, DocumentSection section, Key key, Write write) {
+        std::vector<size_t> positions;
+        std::unordered_map<int64_t, size_t> moved;
+        for (const auto& [changedKey, hint] : changes.changedIn(section)) {
+            size_t position = hint;
+            if (position >= records.size() || key(records[position]) != changedKey) {
+                // Records removed before it moved it, the positions of the section are looked up once
+                if (moved.empty()) {
+                    moved.reserve(records.size());
+                    for (size_t i = 0; i < records.size(); i++) {
+                        moved.emplace(key(records[i]), i);
+                    }
+                }
+                auto it = moved.find(changedKey);
+                if (it == moved.end()) {
+                    continue;
+                }
+                position = it->second;
+            }
+            positions.push_back(position);
+        }
+        std::sort(positions.begin(), positions.end());
+
+        const std::unordered_set<int64_t>& added = changes.addedIn(section);
+        writer.u32(static_cast<uint32_t>(positions.size()));
+        for (size_t position : positions) {
+            writer.u8(added.contains(key(records[position])) ? 1 : 0);
+            write(writer, records[position]);
+        }
+
+        const std::unordered_set<int64_t>& removed = changes.removedIn(section);
+        writer.u32(static_cast<uint32_t>(removed.size()));
+        for (int64_t removedKey : removed) {
+            writer.u64(static_cast<uint64_t>(removedKey));
+        }
+    }
+}
+
+void PayloadWriter::u8(uint8_t value) {
+    payload += static_cast<char>(value);
+}
+
+void PayloadWriter::u32(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        payload += static_cast<char>((value >> shift) & 0xff);
+    }
+}
+
+void PayloadWriter::u64(uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        payload += static_cast<char>((value >> shift) & 0xff);
+    }
+}
+
+void PayloadWriter::string(std::string_view value) {
+    u32(static_cast<uint32_t>(value.size()));
+    payload.append(value);
+}
+
+void PayloadWriter::strings(const std::vector<std::string>& values) {
+    u32(static_cast<uint32_t>(values.size()));
+    for (const auto& value : values) {
+        string(value);
+    }
+}
+
+void PayloadWriter::date(const Date& date) {
+    for (short field : { date.day, date.month, date.year, date.hour, date.minute }) {
+        payload += static_cast<char>(static_cast<uint16_t>(field) & 0xff);
+        payload += static_cast<char>(static_cast<uint16_t>(field) >> 8);
+    }
+}
+
+void PayloadWriter::todo(const TodoData& todo) {
+    u32(static_cast<uint32_t>(todo.id));
+    date(todo.createDate);
+    date(todo.dueDate);
+    string(todo.todoName);
+    string(todo.todoDescription);
+}
+
+void PayloadWriter::milestone(const MilestonesData& milestone) {
+    u32(static_cast<uint32_t>(milestone.id));
+    date(milestone.startDate);
+    string(milestone.milestoneName);
+    string(milestone.milestoneDescription);
+    u32(static_cast<uint32_t>(milestone.progressPoints.size()));
+    for (const auto& point : milestone.progressPoints) {
+        date(point.date);
+        u8(point.isCompleted ? 1 : 0);
+    }
+}
+
+void PayloadWriter::diaryEntry(const DiaryData& entry) {
+    u32(static_cast<uint32_t>(entry.id));
+    date(entry.date);
+    string(entry.diaryEntryName);
+    string(entry.diaryEntry);
+}
+
+void PayloadWriter::fileData(const FileData& data) {
+    string(data.log4FileName);
+
+    u32(static_cast<uint32_t>(data.calendarData.size()));
+    for (const auto& day : data.calendarData) {
+        date(day);
+    }
+
+    u32(static_cast<uint32_t>(data.todosData.size()));
+    for (const auto& todo : data.todosData) {
+        this->todo(todo);
+    }
+
+    u32(static_cast<uint32_t>(data.milestonesData.size()));
+    for (const auto& milestone : data.milestonesData) {
+        this->milestone(milestone);
+    }
+
+    u32(static_cast<uint32_t>(data.diaryData.size()));
+    for (const auto& entry : data.diaryData) {
+        diaryEntry(entry);
+    }
+}
+
+void PayloadWriter::changes(const FileData& data, const DocumentChanges& changes) {
+    u8(changes.whole() ? 1 : 0);
+    if (changes.whole()) {
+        fileData(data);
+        return;
+    }
+    writeSection(*this, data.calendarData, changes, DocumentSection::Calendar, [](const Date& date) { return static_cast<int64_t>(DateUtils::dateKey(date)); }, [](PayloadWriter& writer, const Date& date) { writer.date(date); });
+    writeSection(*this, data.todosData, changes, DocumentSection::Todos, [](const TodoData& todo) { return static_cast<int64_t>(todo.id); }, [](PayloadWriter& writer, const TodoData& todo) { writer.todo(todo); });
+    writeSection(*this, data.milestonesData, changes, DocumentSection::Milestones, [](const MilestonesData& milestone) { return static_cast<int64_t>(milestone.id); }, [](PayloadWriter& writer, const MilestonesData& milestone) { writer.milestone(milestone); });
+    writeSection(*this, data.diaryData, changes, DocumentSection::Diary, [](const DiaryData& entry) { return static_cast<int64_t>(entry.id); }, [](PayloadWriter& writer, const DiaryData& entry) { writer.diaryEntry(entry); });
+}
+
+PayloadReader::PayloadReader(std::string_view payload) : remaining(payload) {}
+
+bool PayloadReader::take(size_t size, const char **bytes) {
+    if (!ok || remaining.size() < size) {
+        ok = false;
+        return false;
+    }
+    *bytes = remaining.data();
+    remaining.remove_prefix(size);
+    return true;
+}
+
+uint8_t PayloadReader::u8() {
+    const char *bytes;
+    return take(1, &bytes) ? static_cast<uint8_t>(bytes[0]) : 0;
+}
+
+uint32_t PayloadReader::u32() {
+    const char *bytes;
+    uint32_t value = 0;
+    if (take(4, &bytes)) {
+        for (int i = 3; i >= 0; i--) {
+            value = (value << 8) | static_cast<uint8_t>(bytes[i]);
+        }
+    }
+    return value;
+}
+
+uint64_t PayloadReader::u64() {
+    const char *bytes;
+    uint64_t value = 0;
+    if (take(8, &bytes)) {
+        for (int i = 7; i >= 0; i--) {
+            value = (value << 8) | static_cast<uint8_t>(bytes[i]);
+        }
+    }
+    return value;
+}
+
+std::string PayloadReader::string() {
+    uint32_t size = u32();
+    const char *bytes;
+    return take(size, &bytes) ? std::string(bytes, size) : std::string();
+}
+
+std::vector<std::string> PayloadReader::strings() {
+    uint32_t count = u32();
+    std::vector<std::string> values;
+    // Every string takes at least its length field, which bounds the count by the payload
+    values.reserve(std::min<size_t>(count, remaining.size() / 4));
+    for (uint32_t i = 0; i < count && ok; i++) {
+        values.push_back(string());
+    }
+    return values;
+}
+
+Date PayloadReader::date() {
+    const char *bytes;
+    short fields[5] = {};
+    if (take(10, &bytes)) {
+        for (int i = 0; i < 5; i++) {
+            fields[i] = static_cast<short>(static_cast<uint8_t>(bytes[i * 2]) | (static_cast<uint8_t>(bytes[i * 2 + 1]) << 8));
+        }
+    }
+    return Date({fields[0], fields[1], fields[2], fields[3], fields[4]});
+}
+
+FileData PayloadReader::fileData() {
+    FileData data;
+    data.log4FileName = string();
+
+    uint32_t count = u32();
+    for (uint32_t i = 0; i < count && ok; i++) {
+        data.calendarData.push_back(date());
+    }
+
+    count = u32();
+    for (uint32_t i = 0; i < count && ok; i++) {
+        data.todosData.push_back(todo());
+    }
+
+    count = u32();
+    for (uint32_t i = 0; i < count && ok; i++) {
+        data.milestonesData.push_back(milestone());
+    }
+
+    count = u32();
+    for (uint32_t i = 0; i < count && ok; i++) {
+        data.diaryData.push_back(diaryEntry());
+    }
+    return data;
+}
+
+TodoData PayloadReader::todo() {
+    TodoData todo;
+    todo.id = static_cast<int>(u32());
+    todo.createDate = date();
+    todo.dueDate = date();
+    todo.todoName = string();
+    todo.todoDescription = string();
+    return todo;
+}
+
+MilestonesData PayloadReader::milestone() {
+    MilestonesData milestone;
+    milestone.id = static_cast<int>(u32());
+    milestone.startDate = date();
+    milestone.milestoneName = string();
+    milestone.milestoneDescription = string();
+    uint32_t points = u32();
+    for (uint32_t point = 0; point < points && ok; point++) {
+        Date pointDate = date();
+        milestone.progressPoints.push_back(MilestoneProgressPoint({pointDate, u8() != 0}));
+    }
+    return milestone;
+}
+
+DiaryData PayloadReader::diaryEntry() {
+    DiaryData entry;
+    entry.id = static_cast<int>(u32());
+    entry.date = date();
+    entry.diaryEntryName = string();
+    entry.diaryEntry = string();
+    return entry;
+}
+
+std::string DaemonProtocol::socketPath(const std::string& workingDirectory) {
+    return workingDirectory + "log4daily.sock";
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace {
+    bool writeAll(int socket, const char *bytes, size_t size) {
+        while (size > 0) {
+            ssize_t written = send(socket, bytes, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool readAll(int socket, char *bytes, size_t size) {
+        while (size > 0) {
+            ssize_t received = recv(socket, bytes, size, 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            bytes += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+}
+
+bool DaemonProtocol::writeFrame(int socket, uint8_t opcode, std::string_view payload) {
+    if (payload.size() > maxPayloadSize) {
+        return false;
+    }
+
+    PayloadWriter header;
+    header.u32(static_cast<uint32_t>(payload.size()));
+    header.u8(opcode);
+
+    // Small frames go out in a single send, so a request is one packet on the socket
+    if (payload.size() <= 4096) {
+        header.payload.append(payload);
+        return writeAll(socket, header.payload.data(), header.payload.size());
+    }
+    return writeAll(socket, header.payload.data(), header.payload.size()) && writeAll(socket, payload.data(), payload.size());
+}
+
+bool DaemonProtocol::readFrame(int socket, DaemonFrame *frame) {
+    char header[5];
+    if (!readAll(socket, header, sizeof(header))) {
+        return false;
+    }
+
+    PayloadReader reader(std::string_view(header, sizeof(header)));
+    uint32_t size = reader.u32();
+    frame->opcode = reader.u8();
+    if (size > maxPayloadSize) {
+        return false;
+    }
+
+    frame->payload.resize(size);
+    return readAll(socket, frame->payload.data(), size);
+}
+#else
+bool DaemonProtocol::writeFrame(int, uint8_t, std::string_view) {
+    return false;
+}
+
+bool DaemonProtocol::readFrame(int, DaemonFrame *) {
+    return false;
+}
+#endif
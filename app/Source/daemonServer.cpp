@@ -0,0 +1,456 @@
+#include "../Headers/daemonServer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "../Headers/batchCommands.h"
+#include "../Headers/blockChecksums.h"
+#include "../Headers/daemonClient.h"
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/diaryCodec.h"
+#include "../Headers/dueDateIndex.h"
+#include "../Headers/inputHandlers.h"
+#include "../Headers/recurrence.h"
+#include "../Headers/todoQuery.h"
+#include "../Headers/trace.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int) {
+        stopRequested = 1;
+    }
+
+    // Upper bound of a poll, so a signal that arrives right before it is noticed soon
+    constexpr int idlePollTimeoutMs = 1000;
+
+    template <typename Record>
+    struct SectionChanges {
+        // Changed records, each with whether it is new
+        std::vector<std::pair<bool, Record>> upserts;
+        std::vector<int64_t> removed;
+    };
+
+    template <typename Record, typename Read>
+    SectionChanges<Record> readSection(PayloadReader& reader, Read read) {
+        SectionChanges<Record> section;
+        uint32_t count = reader.u32();
+        for (uint32_t i = 0; i < count && reader.ok; i++) {
+            bool added = reader.u8() != 0;
+            section.upserts.emplace_back(added, read(reader));
+        }
+        count = reader.u32();
+        for (uint32_t i = 0; i < count && reader.ok; i++) {
+            section.removed.push_back(static_cast<int64_t>(reader.u64()));
+        }
+        return section;
+    }
+
+    /**
+     * @brief Applies the records a client changed to the section of the daemon's document.
+     *
+     * Removed records are dropped and changed ones replace the record with their key, or are appended. A new record
+     * whose key another client took first is appended with the next free ID instead.
+     */
+    template <typename Record, typename Key>
+    void applySection(SectionChanges<Record>& section, std::vector<Record>& records, DocumentChanges *changes, DocumentSection changedSection, Key key) {
+        if (!section.removed.empty()) {
+            std::unordered_set<int64_t> removed(section.removed.begin(), section.removed.end());
+            std::erase_if(records, [&removed, &key](const Record& record) {
+                return removed.contains(key(record));
+            });
+            for (int64_t removedKey : removed) {
+                changes->removed(changedSection, removedKey);
+            }
+        }
+
+        std::unordered_map<int64_t, size_t> positions;
+        positions.reserve(records.size() + section.upserts.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            positions.emplace(key(records[i]), i);
+        }
+
+        int64_t highestId = -1;
+        for (auto& [added, record] : section.upserts) {
+            auto it = positions.find(key(record));
+            if constexpr (requires { record.id; }) {
+                if (added && it != positions.end()) {
+                    // Both the document and the records still to come may hold the highest ID
+                    if (highestId < 0) {
+                        for (const auto& stored : records) highestId = std::max<int64_t>(highestId, stored.id);
+                        for (const auto& [_, upsert] : section.upserts) highestId = std::max<int64_t>(highestId, upsert.id);
+                    }
+                    record.id = static_cast<decltype(record.id)>(++highestId);
+                    it = positions.end();
+                }
+            }
+
+            if (it != positions.end()) {
+                records[it->second] = std::move(record);
+                changes->changed(changedSection, it->first, it->second);
+                continue;
+            }
+            records.push_back(std::move(record));
+            int64_t recordKey = key(records.back());
+            positions.emplace(recordKey, records.size() - 1);
+            changes->added(changedSection, recordKey, records.size() - 1);
+        }
+    }
+
+    /**
+     * @brief Reads the changes of a Store and applies them to the document, nothing is applied if they can not be read.
+     */
+    bool applyChanges(PayloadReader& reader, FileData *data, DocumentChanges *changes) {
+        auto calendar = readSection<Date>(reader, [](PayloadReader& reader) { return reader.date(); });
+        auto todos = readSection<TodoData>(reader, [](PayloadReader& reader) { return reader.todo(); });
+        auto milestones = readSection<MilestonesData>(reader, [](PayloadReader& reader) { return reader.milestone(); });
+        auto diary = readSection<DiaryData>(reader, [](PayloadReader& reader) { return reader.diaryEntry(); });
+        if (!reader.ok) {
+            return false;
+        }
+
+        applySection(calendar, data->calendarData, changes, DocumentSection::Calendar, [](const Date& date) { return static_cast<int64_t>(DateUtils::dateKey(date)); });
+        applySection(todos, data->todosData, changes, DocumentSection::Todos, [](const TodoData& todo) { return static_cast<int64_t>(todo.id); });
+        applySection(milestones, data->milestonesData, changes, DocumentSection::Milestones, [](const MilestonesData& milestone) { return static_cast<int64_t>(milestone.id); });
+        applySection(diary, data->diaryData, changes, DocumentSection::Diary, [](const DiaryData& entry) { return static_cast<int64_t>(entry.id); });
+        return true;
+    }
+}
+
+DaemonServer::DaemonServer(std::string workingDirectory, std::string configName) : localStorage(workingDirectory + configName), shardedStore(workingDirectory, configName) {
+    this->workingDirectory = workingDirectory;
+    this->configName = configName;
+}
+
+DaemonServer::Document* DaemonServer::document(const std::string& log4FileName) {
+    auto it = documents.find(log4FileName);
+    if (it != documents.end()) {
+        return &it->second;
+    }
+
+    FileData data;
+    if (shardedStore.isSharded(log4FileName)) {
+        data = shardedStore.open(log4FileName, ShardScope::All);
+    } else {
+        TraceSpan span("LocalStorage::openLog4DailyFile");
+        data = localStorage.openLog4DailyFile(workingDirectory, log4FileName);
+    }
+    if (data == FileData()) {
+        return nullptr;
+    }
+
+    Document& document = documents[log4FileName];
+    document.data = std::move(data);
+    document.version = ++lastVersion;
+    return &document;
+}
+
+void DaemonServer::markChanged(Document *document) {
+    document->version = ++lastVersion;
+    if (!document->dirty) {
+        document->dirty = true;
+        document->firstUnsavedChange = std::chrono::steady_clock::now();
+    }
+}
+
+void DaemonServer::flush(bool force) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& [log4FileName, document] : documents) {
+        if (document.dirty && (force || now - document.firstUnsavedChange >= flushInterval)) {
+            DiaryCodec::prepareForSave(&document.data);
+            if (shardedStore.isSharded(log4FileName)) {
+                shardedStore.save(document.data);
+            } else {
+                BlockChecksums::save(localStorage, workingDirectory, log4FileName, document.data);
+                std::string error;
+                if (!history.record(workingDirectory, document.data, document.changes, &error)) {
+                    std::cerr << "The save was not added to the history: " << error << std::endl;
+                }
+            }
+            document.changes.clear();
+            document.dirty = false;
+        }
+    }
+}
+
+int DaemonServer::pollTimeoutMs() const {
+    auto now = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::milliseconds(idlePollTimeoutMs);
+
+    for (const auto& [log4FileName, document] : documents) {
+        if (document.dirty) {
+            auto untilFlush = std::chrono::duration_cast<std::chrono::milliseconds>(document.firstUnsavedChange + flushInterval - now);
+            timeout = std::min(timeout, std::max(untilFlush, std::chrono::milliseconds(0)));
+        }
+    }
+    return static_cast<int>(timeout.count());
+}
+
+bool DaemonServer::handle(int client, const DaemonFrame& request, bool *stop) {
+    PayloadReader reader(request.payload);
+    PayloadWriter body;
+
+    auto respond = [client](DaemonStatus status, const std::string& message, const std::string& rest = "") {
+        PayloadWriter response;
+        response.string(message);
+        response.payload += rest;
+        return DaemonProtocol::writeFrame(client, static_cast<uint8_t>(status), response.payload);
+    };
+    auto notFound = [&respond] {
+        return respond(DaemonStatus::Failed, "Failed to open log4daily file. (maybe it does not exist?)");
+    };
+
+    switch (static_cast<DaemonOpcode>(request.opcode)) {
+        case DaemonOpcode::Ping:
+            break;
+        case DaemonOpcode::Open: {
+            std::string log4FileName = reader.string();
+            Document *document = reader.ok ? this->document(log4FileName) : nullptr;
+            if (document == nullptr) {
+                return notFound();
+            }
+            body.u64(document->version);
+            body.fileData(document->data);
+            break;
+        }
+        case DaemonOpcode::Store: {
+            std::string log4FileName = reader.string();
+            uint64_t version = reader.u64();
+            Document *document = reader.ok ? this->document(log4FileName) : nullptr;
+            if (document == nullptr) {
+                return notFound();
+            }
+            // Another client changed the document since this one got it
+            bool outdated = version != document->version;
+
+            if (reader.u8() != 0) {
+                FileData data = reader.fileData();
+                if (!reader.ok || data.log4FileName != log4FileName) {
+                    return respond(DaemonStatus::Failed, "Invalid store request.");
+                }
+                if (outdated) {
+                    return respond(DaemonStatus::Failed, "The log4daily file was changed by another client since it was opened, open it again to save it.");
+                }
+                document->data = std::move(data);
+                document->changes.markWhole();
+            } else if (!applyChanges(reader, &document->data, &document->changes)) {
+                return respond(DaemonStatus::Failed, "Invalid store request.");
+            }
+            document->dueDateIndexStale = true;
+            markChanged(document);
+
+            body.u64(document->version);
+            body.u8(outdated ? 1 : 0);
+            if (outdated) {
+                body.fileData(document->data);
+            }
+            break;
+        }
+        case DaemonOpcode::Batch: {
+            std::string commandName = reader.string();
+            std::string log4FileName = reader.string();
+            std::vector<std::string> records = reader.strings();
+            if (!reader.ok || !BatchCommands::isBatchCommand(commandName)) {
+                return respond(DaemonStatus::Failed, "Invalid batch request.");
+            }
+            Document *document = this->document(log4FileName);
+            if (document == nullptr) {
+                return notFound();
+            }
+
+            Command command;
+            command.name = commandName;
+            command.argument = log4FileName;
+            command.arguments.reserve(records.size() + 1);
+            command.arguments.push_back(log4FileName);
+            command.arguments.insert(command.arguments.end(), std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
+
+            std::istringstream noInput;
+            BatchResult result = BatchCommands::apply(command, &document->data, &document->changes, noInput);
+            if (result.applied > 0) {
+                document->dueDateIndexStale = true;
+                markChanged(document);
+            }
+
+            body.u64(result.applied);
+            body.u64(result.skipped);
+            body.strings(result.errors);
+            break;
+        }
+        case DaemonOpcode::Query: {
+            std::string log4FileName = reader.string();
+            std::string expression = reader.string();
+
+            TodoQuery query;
+            std::string error;
+            if (!reader.ok || !TodoQuery::compile(expression, &query, &error)) {
+                return respond(DaemonStatus::Failed, "Invalid query: " + error);
+            }
+            Document *document = this->document(log4FileName);
+            if (document == nullptr) {
+                return notFound();
+            }
+
+            // The indexes survive between queries and are only rebuilt after a change
+            if (document->dueDateIndexStale) {
+                document->dueDateIndex.rebuild(document->data.todosData);
+                document->recurrenceIndex.rebuild(document->data.todosData);
+                document->dueDateIndexStale = false;
+            }
+            std::vector<uint32_t> matches = query.run(document->data.todosData, &document->dueDateIndex);
+            std::vector<TodoData> occurrences = query.runOccurrences(document->data.todosData, document->recurrenceIndex, DateUtils::dayNumber(DateUtils::today()));
+
+            std::string output;
+            size_t matched = occurrences.size();
+            for (uint32_t position : matches) {
+                if (document->recurrenceIndex.isSeries(position)) {
+                    continue;
+                }
+                output += TodoQuery::formatMatch(document->data.todosData[position]);
+                output += '\n';
+                matched++;
+            }
+            for (const auto& occurrence : occurrences) {
+                output += TodoQuery::formatMatch(occurrence);
+                output += '\n';
+            }
+            body.u64(matched);
+            body.string(output);
+            break;
+        }
+        case DaemonOpcode::Close:
+            documents.erase(reader.string());
+            break;
+        case DaemonOpcode::Flush:
+            flush(true);
+            break;
+        case DaemonOpcode::Shutdown:
+            // Written before the response, so the client knows the files are up to date when it returns
+            flush(true);
+            *stop = true;
+            break;
+        default:
+            return respond(DaemonStatus::Failed, "Unknown request.");
+    }
+
+    return respond(DaemonStatus::Ok, "", body.payload);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+bool DaemonServer::run(std::string *error) {
+    std::string path = DaemonProtocol::socketPath(workingDirectory);
+
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) {
+        *error = "Socket path is too long: " + path;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+
+    DaemonClient running;
+    if (running.connect(workingDirectory)) {
+        *error = "A log4daily daemon is already running.";
+        return false;
+    }
+    // Left behind by a daemon that did not stop cleanly
+    unlink(path.c_str());
+
+    // The socket is created owner only, no other user can connect before it is listened on
+    mode_t previousMask = umask(S_IRWXG | S_IRWXO);
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    bool bound = listener >= 0 && bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    umask(previousMask);
+
+    // Checked again, a umask can not widen the mode but a filesystem may ignore it
+    struct stat socketStat = {};
+    bool ownerOnly = bound && chmod(path.c_str(), S_IRUSR | S_IWUSR) == 0 && stat(path.c_str(), &socketStat) == 0
+        && (socketStat.st_mode & (S_IRWXG | S_IRWXO)) == 0;
+    if (!ownerOnly || listen(listener, 16) != 0) {
+        *error = bound && !ownerOnly ? "Failed to make " + path + " accessible to its owner only" : "Failed to listen on " + path;
+        if (listener >= 0) {
+            close(listener);
+        }
+        if (bound) {
+            unlink(path.c_str());
+        }
+        return false;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<pollfd> sockets = { pollfd({listener, POLLIN, 0}) };
+    bool stop = false;
+
+    while (!stop && !stopRequested) {
+        int ready = poll(sockets.data(), sockets.size(), pollTimeoutMs());
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        flush(false);
+        if (ready <= 0) {
+            continue;
+        }
+
+        for (size_t i = 1; i < sockets.size() && !stop;) {
+            if ((sockets[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+                i++;
+                continue;
+            }
+            DaemonFrame request;
+            if (!DaemonProtocol::readFrame(sockets[i].fd, &request) || !handle(sockets[i].fd, request, &stop)) {
+                close(sockets[i].fd);
+                sockets.erase(sockets.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            i++;
+        }
+
+        if (sockets[0].revents & POLLIN) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                // A client that stops halfway through a frame cannot hold the daemon for long
+                timeval timeout = { 5, 0 };
+                setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                sockets.push_back(pollfd({client, POLLIN, 0}));
+            }
+        }
+    }
+
+    flush(true);
+    for (const auto& socket : sockets) {
+        close(socket.fd);
+    }
+    unlink(path.c_str());
+    return true;
+}
+#else
+bool DaemonServer::run(std::string *error) {
+    *error = "The daemon needs Unix domain sockets, which this platform does not have.";
+    return false;
+}
+#endif
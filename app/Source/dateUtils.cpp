@@ -0,0 +1,51 @@
+#include "../Headers/dateUtils.h"
+
+#include <atomic>
+#include <ctime>
+#include <string>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    // Read by the day tick thread as well
+    std::atomic<std::time_t> fixedTime = 0;
+}
+
+Date DateUtils::now() {
+    return fromTime(currentTime());
+}
+
+std::time_t DateUtils::currentTime() {
+    std::time_t fixed = fixedTime.load(std::memory_order_relaxed);
+    return fixed != 0 ? fixed : std::time(nullptr);
+}
+
+void DateUtils::fixClock(std::time_t time) {
+    fixedTime.store(time, std::memory_order_relaxed);
+}
+
+Date DateUtils::fromTime(std::time_t time) {
+    std::tm tm = *std::localtime(&time);
+
+    return Date({static_cast<short>(tm.tm_mday), static_cast<short>(tm.tm_mon + 1), static_cast<short>(tm.tm_year + 1900), static_cast<short>(tm.tm_hour), static_cast<short>(tm.tm_min)});
+}
+
+Date DateUtils::today() {
+    Date date = now();
+    date.hour = 0;
+    date.minute = 0;
+    return date;
+}
+
+std::string DateUtils::toString(const Date& date, bool withTime) {
+    std::string monthText = (date.month <= 9 ? "0" : "") + std::to_string(date.month);
+    std::string dayText = (date.day <= 9 ? "0" : "") + std::to_string(date.day);
+    std::string dateText = std::to_string(date.year) + "-" + monthText + "-" + dayText;
+
+    if (withTime) {
+        std::string hourText = (date.hour <= 9 ? "0" : "") + std::to_string(date.hour);
+        std::string minuteText = (date.minute <= 9 ? "0" : "") + std::to_string(date.minute);
+        dateText += " " + hourText + ":" + minuteText;
+    }
+    return dateText;
+}
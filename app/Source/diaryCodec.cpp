@@ -0,0 +1,381 @@
+#include "../Headers/diaryCodec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr int hashBits = 13;
+    constexpr size_t minMatch = 4;
+    constexpr size_t maxOffset = 65535;
+
+    enum BlockKind : uint8_t {
+        Stored = 0,
+        Compressed = 1
+    };
+
+    uint32_t read32(const unsigned char *bytes) {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    uint32_t hashSequence(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - hashBits);
+    }
+
+    void writeLength(std::string& output, size_t length) {
+        while (length >= 255) {
+            output += static_cast<char>(255);
+            length -= 255;
+        }
+        output += static_cast<char>(length);
+    }
+
+    bool readLength(std::string_view input, size_t *position, size_t *length) {
+        while (true) {
+            if (*position >= input.size()) {
+                return false;
+            }
+            uint8_t byte = static_cast<uint8_t>(input[(*position)++]);
+            *length += byte;
+            if (byte != 255) {
+                return true;
+            }
+        }
+    }
+
+    void writeVarint(std::string& output, uint64_t value) {
+        while (value >= 0x80) {
+            output += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        output += static_cast<char>(value);
+    }
+
+    bool readVarint(std::string_view input, size_t *position, uint64_t *value) {
+        *value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (*position >= input.size()) {
+                return false;
+            }
+            uint8_t byte = static_cast<uint8_t>(input[(*position)++]);
+            *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    constexpr std::array<int8_t, 256> base64Values = [] {
+        std::array<int8_t, 256> values = {};
+        values.fill(-1);
+        for (int i = 0; i < 64; i++) {
+            values[static_cast<unsigned char>(base64Alphabet[i])] = static_cast<int8_t>(i);
+        }
+        return values;
+    }();
+
+    void appendBase64(std::string& output, std::string_view input) {
+        output.reserve(output.size() + (input.size() + 2) / 3 * 4);
+
+        size_t i = 0;
+        for (; i + 3 <= input.size(); i += 3) {
+            uint32_t group = (static_cast<uint8_t>(input[i]) << 16) | (static_cast<uint8_t>(input[i + 1]) << 8) | static_cast<uint8_t>(input[i + 2]);
+            output += base64Alphabet[group >> 18];
+            output += base64Alphabet[(group >> 12) & 63];
+            output += base64Alphabet[(group >> 6) & 63];
+            output += base64Alphabet[group & 63];
+        }
+        if (i < input.size()) {
+            uint32_t group = static_cast<uint8_t>(input[i]) << 16;
+            if (i + 1 < input.size()) {
+                group |= static_cast<uint8_t>(input[i + 1]) << 8;
+            }
+            output += base64Alphabet[group >> 18];
+            output += base64Alphabet[(group >> 12) & 63];
+            output += i + 1 < input.size() ? base64Alphabet[(group >> 6) & 63] : '=';
+            output += '=';
+        }
+    }
+
+    bool decodeBase64(std::string_view input, std::string *output) {
+        if (input.size() % 4 != 0) {
+            return false;
+        }
+        output->clear();
+        output->reserve(input.size() / 4 * 3);
+
+        for (size_t i = 0; i < input.size(); i += 4) {
+            int values[4];
+            int padding = 0;
+            for (int j = 0; j < 4; j++) {
+                char character = input[i + j];
+                if (character == '=' && i + 4 == input.size() && j >= 2) {
+                    values[j] = 0;
+                    padding++;
+                    continue;
+                }
+                values[j] = base64Values[static_cast<unsigned char>(character)];
+                if (values[j] < 0 || padding > 0) {
+                    return false;
+                }
+            }
+
+            uint32_t group = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+            *output += static_cast<char>(group >> 16);
+            if (padding < 2) {
+                *output += static_cast<char>((group >> 8) & 0xff);
+            }
+            if (padding < 1) {
+                *output += static_cast<char>(group & 0xff);
+            }
+        }
+        return true;
+    }
+
+    void emitSequence(std::string& output, const unsigned char *literals, size_t literalLength, size_t offset, size_t matchLength) {
+        size_t extraMatch = matchLength - minMatch;
+        output += static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(extraMatch, 15));
+        if (literalLength >= 15) {
+            writeLength(output, literalLength - 15);
+        }
+        output.append(reinterpret_cast<const char*>(literals), literalLength);
+        output += static_cast<char>(offset & 0xff);
+        output += static_cast<char>(offset >> 8);
+        if (extraMatch >= 15) {
+            writeLength(output, extraMatch - 15);
+        }
+    }
+}
+
+std::string DiaryCodec::compressBlock(std::string_view input) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(input.data());
+    size_t size = input.size();
+
+    std::string output;
+    output.reserve(size + size / 255 + 16);
+
+    // Position + 1 of the last occurrence of each hashed 4 byte sequence, 0 when there was none
+    std::array<uint32_t, 1 << hashBits> lastSeen = {};
+
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + minMatch <= size) {
+        uint32_t sequence = read32(bytes + position);
+        uint32_t hash = hashSequence(sequence);
+        size_t candidate = lastSeen[hash];
+        lastSeen[hash] = static_cast<uint32_t>(position + 1);
+
+        if (candidate == 0 || position - (candidate - 1) > maxOffset || read32(bytes + candidate - 1) != sequence) {
+            position++;
+            continue;
+        }
+
+        size_t reference = candidate - 1;
+        size_t length = minMatch;
+        while (position + length < size && bytes[reference + length] == bytes[position + length]) {
+            length++;
+        }
+
+        emitSequence(output, bytes + anchor, position - anchor, position - reference, length);
+        position += length;
+        anchor = position;
+    }
+
+    // The last sequence only has literals
+    size_t literalLength = size - anchor;
+    output += static_cast<char>(std::min<size_t>(literalLength, 15) << 4);
+    if (literalLength >= 15) {
+        writeLength(output, literalLength - 15);
+    }
+    output.append(reinterpret_cast<const char*>(bytes + anchor), literalLength);
+    return output;
+}
+
+bool DiaryCodec::decompressBlock(std::string_view input, size_t rawSize, std::string *output) {
+    size_t start = output->size();
+    output->resize(start + rawSize);
+    char *destination = output->data() + start;
+
+    size_t written = 0;
+    size_t position = 0;
+    while (position < input.size()) {
+        uint8_t token = static_cast<uint8_t>(input[position++]);
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(input, &position, &literalLength)) {
+            return false;
+        }
+        if (literalLength > input.size() - position || literalLength > rawSize - written) {
+            return false;
+        }
+        std::memcpy(destination + written, input.data() + position, literalLength);
+        position += literalLength;
+        written += literalLength;
+
+        if (position == input.size()) {
+            break;
+        }
+
+        if (input.size() - position < 2) {
+            return false;
+        }
+        size_t offset = static_cast<uint8_t>(input[position]) | (static_cast<uint8_t>(input[position + 1]) << 8);
+        position += 2;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(input, &position, &matchLength)) {
+            return false;
+        }
+        matchLength += minMatch;
+
+        if (offset == 0 || offset > written || matchLength > rawSize - written) {
+            return false;
+        }
+
+        const char *source = destination + written - offset;
+        if (offset >= matchLength) {
+            std::memcpy(destination + written, source, matchLength);
+        } else {
+            // Overlapping match, e.g. a run of one repeated character
+            for (size_t i = 0; i < matchLength; i++) {
+                destination[written + i] = source[i];
+            }
+        }
+        written += matchLength;
+    }
+
+    if (written != rawSize) {
+        output->resize(start);
+        return false;
+    }
+    return true;
+}
+
+bool DiaryCodec::isCompressed(std::string_view stored) {
+    return stored.starts_with(marker);
+}
+
+std::string DiaryCodec::compress(std::string_view text) {
+    if (text.size() < minCompressSize || isCompressed(text)) {
+        return std::string(text);
+    }
+
+    std::string payload;
+    writeVarint(payload, text.size());
+
+    for (size_t offset = 0; offset < text.size(); offset += blockSize) {
+        std::string_view block = text.substr(offset, blockSize);
+        std::string compressed = compressBlock(block);
+        bool stored = compressed.size() >= block.size();
+
+        payload += static_cast<char>(stored ? Stored : Compressed);
+        writeVarint(payload, block.size());
+        writeVarint(payload, stored ? block.size() : compressed.size());
+        payload.append(stored ? block : std::string_view(compressed));
+    }
+
+    std::string result(marker);
+    appendBase64(result, payload);
+    if (result.size() >= text.size()) {
+        return std::string(text);
+    }
+    return result;
+}
+
+bool DiaryCodec::decompress(std::string_view stored, std::string *text) {
+    if (!isCompressed(stored)) {
+        text->assign(stored);
+        return true;
+    }
+
+    std::string payload;
+    if (!decodeBase64(stored.substr(marker.size()), &payload)) {
+        return false;
+    }
+
+    size_t position = 0;
+    uint64_t totalSize;
+    if (!readVarint(payload, &position, &totalSize) || totalSize > payload.size() * 255 + blockSize) {
+        return false;
+    }
+
+    text->clear();
+    text->reserve(totalSize);
+    while (position < payload.size()) {
+        uint8_t kind = static_cast<uint8_t>(payload[position++]);
+        uint64_t rawSize, storedSize;
+        if (!readVarint(payload, &position, &rawSize) || !readVarint(payload, &position, &storedSize)) {
+            return false;
+        }
+        if (rawSize > blockSize || storedSize > payload.size() - position || text->size() + rawSize > totalSize) {
+            return false;
+        }
+
+        std::string_view block(payload.data() + position, storedSize);
+        position += storedSize;
+
+        if (kind == Stored && storedSize == rawSize) {
+            text->append(block);
+        } else if (kind != Compressed || !decompressBlock(block, rawSize, text)) {
+            return false;
+        }
+    }
+    return text->size() == totalSize;
+}
+
+std::string DiaryCodec::text(std::string_view stored) {
+    std::string text;
+    if (!decompress(stored, &text)) {
+        return std::string(stored);
+    }
+    return text;
+}
+
+size_t DiaryCodec::compressEntries(FileData *data) {
+    size_t compressed = 0;
+    for (auto& entry : data->diaryData) {
+        if (isCompressed(entry.diaryEntry) || entry.diaryEntry.size() < minCompressSize) {
+            continue;
+        }
+        std::string stored = compress(entry.diaryEntry);
+        if (isCompressed(stored)) {
+            entry.diaryEntry = std::move(stored);
+            compressed++;
+        }
+    }
+    return compressed;
+}
+
+size_t DiaryCodec::decompressEntries(FileData *data) {
+    size_t decompressed = 0;
+    for (auto& entry : data->diaryData) {
+        std::string text;
+        if (isCompressed(entry.diaryEntry) && decompress(entry.diaryEntry, &text)) {
+            entry.diaryEntry = std::move(text);
+            decompressed++;
+        }
+    }
+    return decompressed;
+}
+
+bool DiaryCodec::hasCompressedEntries(const FileData& data) {
+    return std::any_of(data.diaryData.begin(), data.diaryData.end(), [](const DiaryData& entry) {
+        return isCompressed(entry.diaryEntry);
+    });
+}
+
+void DiaryCodec::prepareForSave(FileData *data) {
+    if (hasCompressedEntries(*data)) {
+        compressEntries(data);
+    }
+}
@@ -0,0 +1,82 @@
+#include "../Headers/documentChanges.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+void DocumentChanges::changed(DocumentSection section, int64_t key, size_t position) {
+    if (wholeDocument) {
+        return;
+    }
+    size_t index = static_cast<size_t>(section);
+    // A removed id can be given to the next record added
+    removedKeys[index].erase(key);
+    changedKeys[index][key] = position;
+}
+
+void DocumentChanges::added(DocumentSection section, int64_t key, size_t position) {
+    if (wholeDocument) {
+        return;
+    }
+    size_t index = static_cast<size_t>(section);
+    if (!removedKeys[index].contains(key)) {
+        addedKeys[index].insert(key);
+    }
+    changed(section, key, position);
+}
+
+void DocumentChanges::removed(DocumentSection section, int64_t key) {
+    if (wholeDocument) {
+        return;
+    }
+    size_t index = static_cast<size_t>(section);
+    changedKeys[index].erase(key);
+    // Nothing saved has the key yet, and another client may have given it to a record of its own
+    if (addedKeys[index].erase(key) > 0) {
+        return;
+    }
+    removedKeys[index].insert(key);
+}
+
+void DocumentChanges::markWhole() {
+    clear();
+    wholeDocument = true;
+}
+
+void DocumentChanges::clear() {
+    for (size_t section = 0; section < sectionCount; section++) {
+        changedKeys[section].clear();
+        removedKeys[section].clear();
+        addedKeys[section].clear();
+    }
+    wholeDocument = false;
+}
+
+bool DocumentChanges::whole() const {
+    return wholeDocument;
+}
+
+bool DocumentChanges::empty() const {
+    if (wholeDocument) {
+        return false;
+    }
+    for (size_t section = 0; section < sectionCount; section++) {
+        if (!changedKeys[section].empty() || !removedKeys[section].empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const std::unordered_map<int64_t, size_t>& DocumentChanges::changedIn(DocumentSection section) const {
+    return changedKeys[static_cast<size_t>(section)];
+}
+
+const std::unordered_set<int64_t>& DocumentChanges::removedIn(DocumentSection section) const {
+    return removedKeys[static_cast<size_t>(section)];
+}
+
+const std::unordered_set<int64_t>& DocumentChanges::addedIn(DocumentSection section) const {
+    return addedKeys[static_cast<size_t>(section)];
+}
@@ -0,0 +1,192 @@
+#include "../Headers/documentExchange.h"
+
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../Headers/batchCommands.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/diaryCodec.h"
+#include "../Headers/fileDataOperations.h"
+#include "../Headers/recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    std::string rowError(size_t row, const std::string& message) {
+        return "Row " + std::to_string(row + 1) + ": " + message;
+    }
+
+    std::string dateJson(const Date& date) {
+        return "\"" + DateUtils::toString(date, true) + "\"";
+    }
+}
+
+std::vector<std::vector<std::string>> DocumentExchange::parseCsv(std::istream& csv) {
+    std::string text((std::istreambuf_iterator<char>(csv)), std::istreambuf_iterator<char>());
+
+    std::vector<std::vector<std::string>> rows;
+    std::vector<std::string> row;
+    std::string field;
+    bool quoted = false;
+    bool rowStarted = false;
+
+    for (size_t i = 0; i < text.size(); i++) {
+        char character = text[i];
+        if (quoted) {
+            if (character != '"') {
+                field += character;
+            } else if (i + 1 < text.size() && text[i + 1] == '"') {
+                field += '"';
+                i++;
+            } else {
+                quoted = false;
+            }
+            continue;
+        }
+
+        if (character == '"') {
+            quoted = true;
+            rowStarted = true;
+        } else if (character == ',') {
+            row.push_back(std::move(field));
+            field.clear();
+            rowStarted = true;
+        } else if (character == '\n') {
+            if (rowStarted || !field.empty()) {
+                row.push_back(std::move(field));
+                rows.push_back(std::move(row));
+            }
+            field.clear();
+            row.clear();
+            rowStarted = false;
+        } else if (character != '\r') {
+            field += character;
+            rowStarted = true;
+        }
+    }
+    if (rowStarted || !field.empty()) {
+        row.push_back(std::move(field));
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+BatchResult DocumentExchange::importTodos(std::istream& csv, FileData *data, DocumentChanges *changes) {
+    BatchResult result;
+    std::vector<std::vector<std::string>> rows = parseCsv(csv);
+
+    size_t first = !rows.empty() && rows[0][0] == "title" ? 1 : 0;
+
+    // Todos without a due date are due tomorrow at the current time, like with --add-todo
+    Date defaultDueDate = DateUtils::fromDayNumber(DateUtils::dayNumber(DateUtils::today()) + 1);
+    Date now = DateUtils::now();
+    defaultDueDate.hour = now.hour;
+    defaultDueDate.minute = now.minute;
+
+    for (size_t i = first; i < rows.size(); i++) {
+        const std::vector<std::string>& fields = rows[i];
+        if (fields[0].empty()) {
+            result.errors.push_back(rowError(i, "todo needs a title"));
+            continue;
+        }
+        Date dueDate = defaultDueDate;
+        if (fields.size() > 2 && !fields[2].empty() && !BatchCommands::parseDate(fields[2], &dueDate)) {
+            result.errors.push_back(rowError(i, "'" + fields[2] + "' is not a valid due date (YYYY-MM-DD [HH:MM])"));
+            continue;
+        }
+        RecurrenceRule rule;
+        std::string error;
+        if (fields.size() > 3 && !fields[3].empty() && !Recurrence::parseRule(fields[3], DateUtils::dayNumber(dueDate), &rule, &error)) {
+            result.errors.push_back(rowError(i, error));
+            continue;
+        }
+
+        FileDataOperations::addTodo(data, fields[0], fields.size() > 1 ? fields[1] : "", dueDate, changes);
+        if (rule.kind != RecurrenceKind::None) {
+            Recurrence::setRule(&data->todosData.back(), rule);
+        }
+        result.applied++;
+    }
+
+    result.skipped = rows.size() - first - result.applied;
+    return result;
+}
+
+std::string DocumentExchange::jsonString(const std::string& text) {
+    static constexpr char hex[] = "0123456789abcdef";
+
+    std::string quoted = "\"";
+    quoted.reserve(text.size() + 2);
+    for (char character : text) {
+        switch (character) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    quoted += "\\u00";
+                    quoted += hex[character >> 4];
+                    quoted += hex[character & 0xF];
+                } else {
+                    quoted += character;
+                }
+        }
+    }
+    return quoted + "\"";
+}
+
+void DocumentExchange::exportJson(const FileData& data, std::ostream& json) {
+    json << "{\n  \"name\": " << jsonString(data.log4FileName) << ",\n";
+
+    json << "  \"calendar\": [";
+    for (size_t i = 0; i < data.calendarData.size(); i++) {
+        json << (i > 0 ? ", " : "") << "\"" << DateUtils::toString(data.calendarData[i]) << "\"";
+    }
+    json << "],\n";
+
+    json << "  \"todos\": [";
+    for (size_t i = 0; i < data.todosData.size(); i++) {
+        const TodoData& todo = data.todosData[i];
+        bool done = FileDataOperations::isTodoDone(todo);
+        std::string name = todo.todoName;
+        if (done) {
+            name.resize(name.size() - std::char_traits<char>::length(FileDataOperations::doneSuffix));
+        }
+
+        json << (i > 0 ? "," : "") << "\n    { \"id\": " << todo.id << ", \"name\": " << jsonString(name)
+            << ", \"description\": " << jsonString(Recurrence::description(todo)) << ", \"created\": " << dateJson(todo.createDate)
+            << ", \"due\": " << dateJson(todo.dueDate) << ", \"done\": " << (done ? "true" : "false");
+        if (Recurrence::isRecurring(todo)) {
+            json << ", \"repeat\": " << jsonString(Recurrence::formatRule(Recurrence::rule(todo)));
+        }
+        json << " }";
+    }
+    json << (data.todosData.empty() ? "],\n" : "\n  ],\n");
+
+    json << "  \"milestones\": [";
+    for (size_t i = 0; i < data.milestonesData.size(); i++) {
+        const MilestonesData& milestone = data.milestonesData[i];
+        json << (i > 0 ? "," : "") << "\n    { \"id\": " << milestone.id << ", \"name\": " << jsonString(milestone.milestoneName)
+            << ", \"description\": " << jsonString(milestone.milestoneDescription) << ", \"start\": " << dateJson(milestone.startDate)
+            << ", \"progress\": [";
+        for (size_t j = 0; j < milestone.progressPoints.size(); j++) {
+            const MilestoneProgressPoint& point = milestone.progressPoints[j];
+            json << (j > 0 ? ", " : "") << "{ \"date\": \"" << DateUtils::toString(point.date) << "\", \"completed\": " << (point.isCompleted ? "true" : "false") << " }";
+        }
+        json << "] }";
+    }
+    json << (data.milestonesData.empty() ? "],\n" : "\n  ],\n");
+
+    json << "  \"diary\": [";
+    for (size_t i = 0; i < data.diaryData.size(); i++) {
+        const DiaryData& entry = data.diaryData[i];
+        json << (i > 0 ? "," : "") << "\n    { \"id\": " << entry.id << ", \"date\": " << dateJson(entry.date)
+            << ", \"title\": " << jsonString(entry.diaryEntryName) << ", \"entry\": " << jsonString(DiaryCodec::text(entry.diaryEntry)) << " }";
+    }
+    json << (data.diaryData.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
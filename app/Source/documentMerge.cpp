@@ -0,0 +1,459 @@
+#include "../Headers/documentMerge.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/dateUtils.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr std::string_view treeMagic = "L4DB";
+    constexpr std::string_view conflictsMagic = "L4DC";
+    constexpr uint32_t version = 1;
+
+    uint64_t mix(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Hashes the fields of a record eight bytes at a time, without serializing it first.
+     */
+    class RecordHasher {
+        public:
+            void value(uint64_t word) {
+                state = std::rotl(state ^ (word * 0x9e3779b97f4a7c15ULL), 29) * 0xbf58476d1ce4e5b9ULL;
+            }
+            void bytes(std::string_view text) {
+                value(text.size());
+                size_t i = 0;
+                for (; i + 8 <= text.size(); i += 8) {
+                    uint64_t word;
+                    std::memcpy(&word, text.data() + i, 8);
+                    value(word);
+                }
+                if (i < text.size()) {
+                    uint64_t word = 0;
+                    std::memcpy(&word, text.data() + i, text.size() - i);
+                    value(word);
+                }
+            }
+            void date(const Date& date) {
+                value(static_cast<uint64_t>(static_cast<uint16_t>(date.day)) | static_cast<uint64_t>(static_cast<uint16_t>(date.month)) << 16
+                    | static_cast<uint64_t>(static_cast<uint16_t>(date.year)) << 32 | static_cast<uint64_t>(static_cast<uint16_t>(date.hour)) << 48);
+                value(static_cast<uint16_t>(date.minute));
+            }
+            uint64_t finish() const {
+                return mix(state);
+            }
+        private:
+            uint64_t state = 0x6c34646d65726765ULL;
+    };
+
+    uint64_t hashOf(const Date& date) {
+        RecordHasher hasher;
+        hasher.date(date);
+        return hasher.finish();
+    }
+    uint64_t hashOf(const TodoData& todo) {
+        RecordHasher hasher;
+        hasher.value(static_cast<uint64_t>(todo.id));
+        hasher.date(todo.createDate);
+        hasher.date(todo.dueDate);
+        hasher.bytes(todo.todoName);
+        hasher.bytes(todo.todoDescription);
+        return hasher.finish();
+    }
+    uint64_t hashOf(const MilestonesData& milestone) {
+        RecordHasher hasher;
+        hasher.value(static_cast<uint64_t>(milestone.id));
+        hasher.date(milestone.startDate);
+        hasher.bytes(milestone.milestoneName);
+        hasher.bytes(milestone.milestoneDescription);
+        hasher.value(milestone.progressPoints.size());
+        for (const auto& point : milestone.progressPoints) {
+            hasher.date(point.date);
+            hasher.value(point.isCompleted ? 1 : 0);
+        }
+        return hasher.finish();
+    }
+    uint64_t hashOf(const DiaryData& entry) {
+        RecordHasher hasher;
+        hasher.value(static_cast<uint64_t>(entry.id));
+        hasher.date(entry.date);
+        hasher.bytes(entry.diaryEntryName);
+        hasher.bytes(entry.diaryEntry);
+        return hasher.finish();
+    }
+
+    int64_t keyOf(const Date& date) { return DateUtils::dateKey(date); }
+    int64_t keyOf(const TodoData& todo) { return todo.id; }
+    int64_t keyOf(const MilestonesData& milestone) { return milestone.id; }
+    int64_t keyOf(const DiaryData& entry) { return entry.id; }
+
+    std::string titleOf(const Date& date) { return DateUtils::toString(date); }
+    std::string titleOf(const TodoData& todo) { return todo.todoName; }
+    std::string titleOf(const MilestonesData& milestone) { return milestone.milestoneName; }
+    std::string titleOf(const DiaryData& entry) { return DateUtils::toString(entry.date) + " " + entry.diaryEntryName; }
+
+    /**
+     * @brief Calls the visitor with every section of the data and its MergeSection.
+     */
+    template <typename Data, typename Visit>
+    void forEachSection(Data& data, Visit&& visit) {
+        visit(MergeSection::Calendar, data.calendarData);
+        visit(MergeSection::Todos, data.todosData);
+        visit(MergeSection::Milestones, data.milestonesData);
+        visit(MergeSection::Diary, data.diaryData);
+    }
+
+    bool writeAtomically(const std::string& path, const std::string& bytes, std::string *error) {
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            if (!file) {
+                *error = "failed to write " + temporary;
+                return false;
+            }
+        }
+        std::error_code renameError;
+        std::filesystem::rename(temporary, path, renameError);
+        if (renameError) {
+            *error = "failed to write " + path + ": " + renameError.message();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads a whole file, found is false if it does not exist.
+     */
+    bool readAll(const std::string& path, std::string *bytes, bool *found) {
+        std::ifstream file(path, std::ios::binary);
+        *found = static_cast<bool>(file);
+        if (!file) {
+            return true;
+        }
+        bytes->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !file.bad();
+    }
+
+    template <typename Record>
+    void mergeSection(MergeSection section, std::vector<Record>& ours, const std::vector<Record>& theirs, std::vector<Record>& conflictRecords,
+        const MerkleTree& oursTree, const MerkleTree& theirsTree, const MerkleTree& ancestor, MergeReport *report) {
+        const auto& oursSection = oursTree.sections[static_cast<size_t>(section)];
+        const auto& theirsSection = theirsTree.sections[static_cast<size_t>(section)];
+        const auto& ancestorSection = ancestor.sections[static_cast<size_t>(section)];
+        // Same on both sides, or nothing changed on theirs
+        if (oursSection.root == theirsSection.root || theirsSection.root == ancestorSection.root) {
+            return;
+        }
+
+        std::vector<Record> added;
+        std::vector<bool> removed;
+        int64_t nextId = -1;
+
+        for (size_t bucket = 0; bucket < MerkleTree::bucketCount; bucket++) {
+            if (oursSection.buckets[bucket] == theirsSection.buckets[bucket] || theirsSection.buckets[bucket] == ancestorSection.buckets[bucket]) {
+                continue;
+            }
+            report->bucketsCompared++;
+
+            // Key -> leaf of ours, theirs and the ancestor
+            std::map<int64_t, std::array<const MerkleTree::Leaf*, 3>> keys;
+            for (const auto& leaf : oursSection.leaves[bucket]) keys[leaf.key][0] = &leaf;
+            for (const auto& leaf : theirsSection.leaves[bucket]) keys[leaf.key][1] = &leaf;
+            for (const auto& leaf : ancestorSection.leaves[bucket]) keys[leaf.key][2] = &leaf;
+
+            auto same = [](const MerkleTree::Leaf *first, const MerkleTree::Leaf *second) {
+                return first == second || (first && second && first->hash == second->hash);
+            };
+            for (const auto& [key, leaves] : keys) {
+                const auto [our, their, base] = leaves;
+                if (same(our, their) || same(their, base)) {
+                    continue;
+                }
+
+                if (same(our, base)) {
+                    if (!their) {
+                        if (removed.empty()) {
+                            removed.resize(ours.size());
+                        }
+                        removed[our->index] = true;
+                        report->removed++;
+                    } else if (our) {
+                        ours[our->index] = theirs[their->index];
+                        report->taken++;
+                    } else {
+                        added.push_back(theirs[their->index]);
+                        report->taken++;
+                    }
+                    continue;
+                }
+
+                // Added on both sides under the same id, usually two unrelated records
+                if constexpr (requires(Record record) { record.id; }) {
+                    if (our && their && !base) {
+                        if (nextId < 0) {
+                            for (const auto& record : ours) nextId = std::max<int64_t>(nextId, record.id);
+                            for (const auto& record : theirs) nextId = std::max<int64_t>(nextId, record.id);
+                        }
+                        Record renumbered = theirs[their->index];
+                        renumbered.id = static_cast<decltype(renumbered.id)>(++nextId);
+                        added.push_back(std::move(renumbered));
+                        report->renumbered++;
+                        continue;
+                    }
+                }
+
+                report->conflicts.conflicts.push_back(MergeConflict({ section, key, our != nullptr, their != nullptr }));
+                if (their) {
+                    conflictRecords.push_back(theirs[their->index]);
+                }
+            }
+        }
+
+        if (!removed.empty()) {
+            size_t kept = 0;
+            for (size_t i = 0; i < ours.size(); i++) {
+                if (!removed[i]) {
+                    if (kept != i) {
+                        ours[kept] = std::move(ours[i]);
+                    }
+                    kept++;
+                }
+            }
+            ours.resize(kept);
+        }
+        std::move(added.begin(), added.end(), std::back_inserter(ours));
+    }
+}
+
+uint64_t MerkleTree::hashBytes(std::string_view bytes) {
+    RecordHasher hasher;
+    hasher.bytes(bytes);
+    return hasher.finish();
+}
+
+size_t MerkleTree::bucketOf(int64_t key) {
+    return static_cast<size_t>(mix(static_cast<uint64_t>(key)) >> 56);
+}
+
+void MerkleTree::add(MergeSection section, int64_t key, uint64_t hash, uint32_t index) {
+    Section& tree = sections[static_cast<size_t>(section)];
+    size_t bucket = bucketOf(key);
+    uint64_t leafHash = mix(hash ^ mix(static_cast<uint64_t>(key)));
+    tree.leaves[bucket].push_back(Leaf({ key, hash, index }));
+    tree.buckets[bucket] += leafHash;
+    tree.root += leafHash;
+}
+
+MerkleTree MerkleTree::build(const FileData& data) {
+    MerkleTree tree;
+    forEachSection(data, [&](MergeSection section, const auto& records) {
+        for (auto& leaves : tree.sections[static_cast<size_t>(section)].leaves) {
+            leaves.reserve(records.size() / bucketCount + records.size() / (bucketCount * 8) + 4);
+        }
+        for (size_t i = 0; i < records.size(); i++) {
+            tree.add(section, keyOf(records[i]), hashOf(records[i]), static_cast<uint32_t>(i));
+        }
+    });
+    return tree;
+}
+
+bool MerkleTree::save(const std::string& path, std::string *error) const {
+    PayloadWriter writer;
+    writer.payload += treeMagic;
+    writer.u32(version);
+    for (const auto& section : sections) {
+        uint32_t count = 0;
+        for (const auto& leaves : section.leaves) {
+            count += static_cast<uint32_t>(leaves.size());
+        }
+        writer.u32(count);
+        for (const auto& leaves : section.leaves) {
+            for (const auto& leaf : leaves) {
+                writer.u64(static_cast<uint64_t>(leaf.key));
+                writer.u64(leaf.hash);
+            }
+        }
+    }
+    return writeAtomically(path, writer.payload, error);
+}
+
+bool MerkleTree::load(const std::string& path, MerkleTree *tree, bool *found, std::string *error) {
+    *tree = MerkleTree();
+    std::string bytes;
+    if (!readAll(path, &bytes, found)) {
+        *error = "failed to read " + path;
+        return false;
+    }
+    if (!*found) {
+        return true;
+    }
+
+    PayloadReader reader(std::string_view(bytes).substr(std::min(bytes.size(), treeMagic.size())));
+    if (!bytes.starts_with(treeMagic) || reader.u32() != version) {
+        *error = path + " is not a log4daily merge ancestor";
+        return false;
+    }
+    for (size_t section = 0; section < sectionCount && reader.ok; section++) {
+        uint32_t count = reader.u32();
+        for (uint32_t i = 0; i < count && reader.ok; i++) {
+            int64_t key = static_cast<int64_t>(reader.u64());
+            uint64_t hash = reader.u64();
+            tree->add(static_cast<MergeSection>(section), key, hash, 0);
+        }
+    }
+    if (!reader.ok) {
+        *error = path + " is cut short";
+        return false;
+    }
+    return true;
+}
+
+MergeReport DocumentMerge::merge(FileData *ours, const FileData& theirs, const MerkleTree& ancestor) {
+    MergeReport report;
+    // Building the trees is the only pass over every record, both are built at once
+    MerkleTree theirsTree;
+    std::jthread theirsBuild([&theirsTree, &theirs] { theirsTree = MerkleTree::build(theirs); });
+    MerkleTree oursTree = MerkleTree::build(*ours);
+    theirsBuild.join();
+    FileData& conflictRecords = report.conflicts.theirs;
+    conflictRecords.log4FileName = theirs.log4FileName;
+
+    mergeSection(MergeSection::Calendar, ours->calendarData, theirs.calendarData, conflictRecords.calendarData, oursTree, theirsTree, ancestor, &report);
+    mergeSection(MergeSection::Todos, ours->todosData, theirs.todosData, conflictRecords.todosData, oursTree, theirsTree, ancestor, &report);
+    mergeSection(MergeSection::Milestones, ours->milestonesData, theirs.milestonesData, conflictRecords.milestonesData, oursTree, theirsTree, ancestor, &report);
+    mergeSection(MergeSection::Diary, ours->diaryData, theirs.diaryData, conflictRecords.diaryData, oursTree, theirsTree, ancestor, &report);
+    return report;
+}
+
+std::string DocumentMerge::ancestorPath(const std::string& workingDirectory, const std::string& log4FileName) {
+    return workingDirectory + log4FileName + ".l4dbase";
+}
+
+std::string DocumentMerge::conflictsPath(const std::string& workingDirectory, const std::string& log4FileName) {
+    return workingDirectory + log4FileName + ".l4dconflicts";
+}
+
+bool DocumentMerge::saveConflicts(const std::string& path, const MergeConflicts& conflicts, std::string *error) {
+    if (conflicts.conflicts.empty()) {
+        std::error_code removeError;
+        std::filesystem::remove(path, removeError);
+        return true;
+    }
+
+    PayloadWriter writer;
+    writer.payload += conflictsMagic;
+    writer.u32(version);
+    writer.fileData(conflicts.theirs);
+    writer.u32(static_cast<uint32_t>(conflicts.conflicts.size()));
+    for (const auto& conflict : conflicts.conflicts) {
+        writer.u8(static_cast<uint8_t>(conflict.section));
+        writer.u64(static_cast<uint64_t>(conflict.key));
+        writer.u8(conflict.inOurs ? 1 : 0);
+        writer.u8(conflict.inTheirs ? 1 : 0);
+    }
+    return writeAtomically(path, writer.payload, error);
+}
+
+bool DocumentMerge::loadConflicts(const std::string& path, MergeConflicts *conflicts, std::string *error) {
+    *conflicts = MergeConflicts();
+    std::string bytes;
+    bool found = false;
+    if (!readAll(path, &bytes, &found)) {
+        *error = "failed to read " + path;
+        return false;
+    }
+    if (!found) {
+        return true;
+    }
+
+    PayloadReader reader(std::string_view(bytes).substr(std::min(bytes.size(), conflictsMagic.size())));
+    if (!bytes.starts_with(conflictsMagic) || reader.u32() != version) {
+        *error = path + " is not a list of log4daily merge conflicts";
+        return false;
+    }
+    conflicts->theirs = reader.fileData();
+    uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count && reader.ok; i++) {
+        MergeConflict conflict;
+        conflict.section = static_cast<MergeSection>(reader.u8());
+        conflict.key = static_cast<int64_t>(reader.u64());
+        conflict.inOurs = reader.u8() != 0;
+        conflict.inTheirs = reader.u8() != 0;
+        conflicts->conflicts.push_back(conflict);
+    }
+    if (!reader.ok) {
+        *conflicts = MergeConflicts();
+        *error = path + " is cut short";
+        return false;
+    }
+    return true;
+}
+
+void DocumentMerge::takeTheirs(FileData *ours, const MergeConflicts& conflicts, size_t conflict) {
+    const MergeConflict& taken = conflicts.conflicts[conflict];
+    auto replace = [&](auto& records, const auto& theirRecords) {
+        auto sameKey = [&](const auto& record) { return keyOf(record) == taken.key; };
+        auto our = std::find_if(records.begin(), records.end(), sameKey);
+        auto their = std::find_if(theirRecords.begin(), theirRecords.end(), sameKey);
+        if (!taken.inTheirs || their == theirRecords.end()) {
+            if (our != records.end()) {
+                records.erase(our);
+            }
+        } else if (our != records.end()) {
+            *our = *their;
+        } else {
+            records.push_back(*their);
+        }
+    };
+
+    switch (taken.section) {
+        case MergeSection::Calendar: replace(ours->calendarData, conflicts.theirs.calendarData); break;
+        case MergeSection::Todos: replace(ours->todosData, conflicts.theirs.todosData); break;
+        case MergeSection::Milestones: replace(ours->milestonesData, conflicts.theirs.milestonesData); break;
+        case MergeSection::Diary: replace(ours->diaryData, conflicts.theirs.diaryData); break;
+    }
+}
+
+std::string DocumentMerge::describe(const MergeConflict& conflict, const FileData& ours, const MergeConflicts& conflicts) {
+    auto titleIn = [&](const FileData& data, bool present) -> std::string {
+        std::string title = "(removed)";
+        if (!present) {
+            return title;
+        }
+        forEachSection(data, [&](MergeSection section, const auto& records) {
+            if (section != conflict.section) {
+                return;
+            }
+            auto record = std::find_if(records.begin(), records.end(), [&](const auto& record) { return keyOf(record) == conflict.key; });
+            if (record != records.end()) {
+                title = titleOf(*record);
+            }
+        });
+        return title;
+    };
+
+    static constexpr const char* sectionNames[] = { "Calendar day", "Todo", "Milestone", "Diary entry" };
+    std::string name = sectionNames[static_cast<size_t>(conflict.section)];
+    if (conflict.section != MergeSection::Calendar) {
+        name += " " + std::to_string(conflict.key);
+    }
+    return name + ": " + titleIn(ours, conflict.inOurs) + " | " + titleIn(conflicts.theirs, conflict.inTheirs);
+}
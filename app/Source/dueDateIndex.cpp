@@ -0,0 +1,33 @@
+#include "../Headers/dueDateIndex.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "../Headers/dateUtils.h"
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+void DueDateIndex::rebuild(const std::vector<TodoData>& todos) {
+    entries.resize(todos.size());
+
+    for (size_t i = 0; i < todos.size(); i++) {
+        entries[i] = { DateUtils::dateKey(todos[i].dueDate), static_cast<uint32_t>(i) };
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const DueDateEntry& a, const DueDateEntry& b) {
+        return a.dueKey < b.dueKey || (a.dueKey == b.dueKey && a.position < b.position);
+    });
+}
+
+std::pair<const DueDateEntry*, const DueDateEntry*> DueDateIndex::range(long long minKey, long long maxKey) const {
+    auto first = std::lower_bound(entries.begin(), entries.end(), minKey, [](const DueDateEntry& entry, long long key) {
+        return entry.dueKey < key;
+    });
+    auto last = std::upper_bound(first, entries.end(), maxKey, [](long long key, const DueDateEntry& entry) {
+        return key < entry.dueKey;
+    });
+    return { entries.data() + (first - entries.begin()), entries.data() + (last - entries.begin()) };
+}
+
+size_t DueDateIndex::size() const {
+    return entries.size();
+}
@@ -0,0 +1,179 @@
+#include "../Headers/fileDataOperations.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+
+#include "../Headers/dateUtils.h"
+#include "../Headers/documentChanges.h"
+#include "../Headers/recurrence.h"
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    /**
+     * @brief Returns the ID for a record appended to the list.
+     * 
+     * IDs follow the highest ID in the list instead of its size or last record, so they stay unique
+     * after records are removed, and after a merge appends records out of ID order.
+     */
+    template <typename Record>
+    int nextId(const std::vector<Record>& records) {
+        int highestId = 0;
+        for (const Record& record : records) {
+            highestId = std::max(highestId, record.id);
+        }
+        return highestId + 1;
+    }
+
+    void markChanged(DocumentChanges *changes, DocumentSection section, int id, size_t position) {
+        if (changes) {
+            changes->changed(section, id, position);
+        }
+    }
+
+    void markAdded(DocumentChanges *changes, DocumentSection section, int id, size_t position) {
+        if (changes) {
+            changes->added(section, id, position);
+        }
+    }
+
+    void markRemoved(DocumentChanges *changes, DocumentSection section, int id) {
+        if (changes) {
+            changes->removed(section, id);
+        }
+    }
+}
+
+int FileDataOperations::addTodo(FileData *data, const std::string& name, const std::string& description, Date dueDate, DocumentChanges *changes) {
+    TodoData newTodo;
+
+    newTodo.id = nextId(data->todosData);
+    newTodo.createDate = DateUtils::now();
+    newTodo.dueDate = dueDate;
+    newTodo.todoName = name;
+    newTodo.todoDescription = description;
+
+    data->todosData.push_back(newTodo);
+    markAdded(changes, DocumentSection::Todos, newTodo.id, data->todosData.size() - 1);
+    return newTodo.id;
+}
+
+void FileDataOperations::removeTodo(FileData *data, int id, DocumentChanges *changes) {
+    auto it = std::remove_if(data->todosData.begin(), data->todosData.end(), [id](const TodoData& todo) {
+        return todo.id == id;
+    });
+    data->todosData.erase(it, data->todosData.end());
+    markRemoved(changes, DocumentSection::Todos, id);
+}
+
+bool FileDataOperations::isTodoDone(const TodoData& todo) {
+    return todo.todoName.ends_with(doneSuffix);
+}
+
+bool FileDataOperations::markTodoDone(FileData *data, int id, bool done, DocumentChanges *changes) {
+    bool changed = false;
+
+    for (size_t position = 0; position < data->todosData.size(); position++) {
+        TodoData& todo = data->todosData[position];
+        if (todo.id != id || isTodoDone(todo) == done) {
+            continue;
+        }
+        if (done) {
+            todo.todoName += doneSuffix;
+        }
+        else {
+            todo.todoName.erase(todo.todoName.size() - std::char_traits<char>::length(doneSuffix));
+        }
+        markChanged(changes, DocumentSection::Todos, id, position);
+        changed = true;
+    }
+    return changed;
+}
+
+size_t FileDataOperations::markTodosDone(FileData *data, const std::vector<int>& ids, DocumentChanges *changes) {
+    std::unordered_set<int> pending(ids.begin(), ids.end());
+    size_t changed = 0;
+
+    for (size_t position = 0; position < data->todosData.size(); position++) {
+        TodoData& todo = data->todosData[position];
+        if (pending.contains(todo.id) && !isTodoDone(todo)) {
+            todo.todoName += doneSuffix;
+            markChanged(changes, DocumentSection::Todos, todo.id, position);
+            changed++;
+        }
+    }
+    return changed;
+}
+
+bool FileDataOperations::markOccurrenceDone(FileData *data, int id, int day, bool done, DocumentChanges *changes) {
+    for (size_t position = 0; position < data->todosData.size(); position++) {
+        if (data->todosData[position].id != id) {
+            continue;
+        }
+        if (!Recurrence::markOccurrenceDone(&data->todosData[position], day, done)) {
+            return false;
+        }
+        markChanged(changes, DocumentSection::Todos, id, position);
+        return true;
+    }
+    return false;
+}
+
+int FileDataOperations::addMilestone(FileData *data, const std::string& name, const std::string& description, DocumentChanges *changes) {
+    MilestonesData newMilestone;
+    newMilestone.id = nextId(data->milestonesData);
+    newMilestone.startDate = DateUtils::now();
+    newMilestone.milestoneName = name;
+    newMilestone.milestoneDescription = description;
+
+    data->milestonesData.push_back(newMilestone);
+    markAdded(changes, DocumentSection::Milestones, newMilestone.id, data->milestonesData.size() - 1);
+    return newMilestone.id;
+}
+
+void FileDataOperations::removeMilestone(FileData *data, int id, DocumentChanges *changes) {
+    auto it = std::remove_if(data->milestonesData.begin(), data->milestonesData.end(), [id](const MilestonesData& milestone) {
+        return milestone.id == id;
+    });
+    data->milestonesData.erase(it, data->milestonesData.end());
+    markRemoved(changes, DocumentSection::Milestones, id);
+}
+
+bool FileDataOperations::addMilestoneProgressPoint(FileData *data, int id, bool isCompleted, DocumentChanges *changes) {
+    Date today = DateUtils::now();
+
+    for (size_t position = 0; position < data->milestonesData.size(); position++) {
+        MilestonesData& milestone = data->milestonesData[position];
+        if (milestone.id != id) {
+            continue;
+        }
+
+        auto it = std::find_if(milestone.progressPoints.begin(), milestone.progressPoints.end(), [&today](const MilestoneProgressPoint& point) {
+            return point.date.year == today.year && point.date.month == today.month && point.date.day == today.day;
+        });
+        if (it != milestone.progressPoints.end()) {
+            return false;
+        }
+
+        MilestoneProgressPoint newPoint;
+        newPoint.date = today;
+        newPoint.isCompleted = isCompleted;
+        milestone.progressPoints.push_back(newPoint);
+        markChanged(changes, DocumentSection::Milestones, id, position);
+        return true;
+    }
+    return false;
+}
+
+DiaryData FileDataOperations::addDiaryEntry(FileData *data, const std::string& name, const std::string& content, DocumentChanges *changes) {
+    DiaryData newDiaryEntry;
+    newDiaryEntry.id = nextId(data->diaryData);
+    newDiaryEntry.date = DateUtils::today();
+    newDiaryEntry.diaryEntryName = name;
+    newDiaryEntry.diaryEntry = content;
+
+    data->diaryData.push_back(newDiaryEntry);
+    markAdded(changes, DocumentSection::Diary, newDiaryEntry.id, data->diaryData.size() - 1);
+    return newDiaryEntry;
+}
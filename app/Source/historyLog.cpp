@@ -0,0 +1,421 @@
+#include "../Headers/historyLog.h"
+
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../Headers/crc32c.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/documentMerge.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr std::string_view magic = "L4DH";
+    constexpr uint32_t version = 1;
+    constexpr size_t fileHeaderSize = 8;
+    // Size and checksum of the payload
+    constexpr size_t entryHeaderSize = 8;
+    // Kind, time, number and the added, modified and removed counts
+    constexpr size_t payloadHeaderSize = 1 + 8 + 4 * 4;
+
+    enum Section { Calendar, Todos, Milestones, Diary };
+
+    int64_t calendarKey(const Date& date) {
+        return DateUtils::dateKey(date);
+    }
+
+    bool readBytes(std::ifstream& file, uint64_t offset, size_t size, std::string *bytes) {
+        bytes->resize(size);
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(bytes->data(), static_cast<std::streamsize>(size));
+        return file.gcount() == static_cast<std::streamsize>(size);
+    }
+
+    /**
+     * @brief Applies the removed keys and the upserted records of one section of a diff.
+     */
+    template <typename Record, typename Key, typename Read>
+    void applySection(PayloadReader& reader, std::vector<Record>& records, Key key, Read read) {
+        uint32_t upserts = reader.u32();
+        std::vector<Record> changed;
+        changed.reserve(upserts);
+        for (uint32_t i = 0; i < upserts && reader.ok; i++) {
+            changed.push_back(read(reader));
+        }
+        uint32_t removals = reader.u32();
+        std::unordered_set<int64_t> removed;
+        for (uint32_t i = 0; i < removals && reader.ok; i++) {
+            removed.insert(static_cast<int64_t>(reader.u64()));
+        }
+        if (changed.empty() && removed.empty()) {
+            return;
+        }
+
+        std::erase_if(records, [&](const Record& record) {
+            return removed.contains(key(record));
+        });
+        std::unordered_map<int64_t, size_t> positions;
+        positions.reserve(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            positions.emplace(key(records[i]), i);
+        }
+        // Modified records keep their place, added ones go last like in the document
+        for (auto& record : changed) {
+            auto [it, inserted] = positions.emplace(key(record), records.size());
+            if (inserted) {
+                records.push_back(std::move(record));
+            } else {
+                records[it->second] = std::move(record);
+            }
+        }
+    }
+}
+
+std::string HistoryLog::path(const std::string& workingDirectory, const std::string& log4FileName) {
+    return workingDirectory + log4FileName + ".l4dhist";
+}
+
+bool HistoryLog::entries(const std::string& path, std::vector<HistoryEntry> *entries, std::string *error) {
+    entries->clear();
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return true;
+    }
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+
+    std::string bytes;
+    if (!readBytes(file, 0, fileHeaderSize, &bytes) || std::string_view(bytes).substr(0, 4) != magic) {
+        *error = path + " is not a log4daily history";
+        return false;
+    }
+    PayloadReader header(std::string_view(bytes).substr(4));
+    if (header.u32() != version) {
+        *error = path + " has an unknown history version";
+        return false;
+    }
+
+    // Only the headers are read, the checksums are checked when the entries are read back
+    uint64_t offset = fileHeaderSize;
+    while (offset + entryHeaderSize + payloadHeaderSize <= fileSize) {
+        if (!readBytes(file, offset, entryHeaderSize + payloadHeaderSize, &bytes)) {
+            break;
+        }
+        PayloadReader reader(bytes);
+        HistoryEntry entry;
+        entry.offset = offset;
+        entry.size = reader.u32();
+        reader.u32();
+        // A save that was cut off halfway, the next save writes over it
+        if (entry.size < payloadHeaderSize || offset + entryHeaderSize + entry.size > fileSize) {
+            break;
+        }
+        entry.kind = static_cast<HistoryEntryKind>(reader.u8());
+        entry.time = static_cast<int64_t>(reader.u64());
+        entry.number = reader.u32();
+        entry.added = reader.u32();
+        entry.modified = reader.u32();
+        entry.removed = reader.u32();
+        entries->push_back(entry);
+        offset += entryHeaderSize + entry.size;
+    }
+    return true;
+}
+
+bool HistoryLog::at(const std::string& path, uint32_t number, FileData *data, std::string *error) {
+    std::vector<HistoryEntry> list;
+    if (!entries(path, &list, error)) {
+        return false;
+    }
+    return at(path, list, number, data, error);
+}
+
+bool HistoryLog::at(const std::string& path, const std::vector<HistoryEntry>& entries, uint32_t number, FileData *data, std::string *error) {
+    auto target = std::find_if(entries.begin(), entries.end(), [number](const HistoryEntry& entry) {
+        return entry.number == number;
+    });
+    if (target == entries.end()) {
+        *error = "no save #" + std::to_string(number) + " in the history";
+        return false;
+    }
+    auto checkpoint = target;
+    while (checkpoint != entries.begin() && checkpoint->kind != HistoryEntryKind::Checkpoint) {
+        --checkpoint;
+    }
+    if (checkpoint->kind != HistoryEntryKind::Checkpoint) {
+        *error = "the history has no checkpoint before save #" + std::to_string(number);
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::string bytes;
+    uint64_t first = checkpoint->offset;
+    uint64_t last = target->offset + entryHeaderSize + target->size;
+    if (!file || !readBytes(file, first, static_cast<size_t>(last - first), &bytes)) {
+        *error = "failed to read " + path;
+        return false;
+    }
+
+    for (auto it = checkpoint; it != target + 1; ++it) {
+        std::string_view entry = std::string_view(bytes).substr(static_cast<size_t>(it->offset - first), entryHeaderSize + it->size);
+        PayloadReader entryHeader(entry);
+        entryHeader.u32();
+        uint32_t crc = entryHeader.u32();
+        std::string_view payload = entry.substr(entryHeaderSize);
+        if (Crc32c::compute(payload) != crc) {
+            *error = "save #" + std::to_string(it->number) + " of the history is damaged";
+            return false;
+        }
+
+        PayloadReader reader(payload.substr(payloadHeaderSize));
+        if (it->kind == HistoryEntryKind::Checkpoint) {
+            *data = reader.fileData();
+        } else {
+            applySection(reader, data->calendarData, calendarKey, [](PayloadReader& reader) { return reader.date(); });
+            applySection(reader, data->todosData, [](const TodoData& todo) { return static_cast<int64_t>(todo.id); }, [](PayloadReader& reader) { return reader.todo(); });
+            applySection(reader, data->milestonesData, [](const MilestonesData& milestone) { return static_cast<int64_t>(milestone.id); }, [](PayloadReader& reader) { return reader.milestone(); });
+            applySection(reader, data->diaryData, [](const DiaryData& entry) { return static_cast<int64_t>(entry.id); }, [](PayloadReader& reader) { return reader.diaryEntry(); });
+        }
+        if (!reader.ok) {
+            *error = "save #" + std::to_string(it->number) + " of the history could not be read";
+            return false;
+        }
+    }
+    return true;
+}
+
+void HistoryLog::hashAll(const FileData& data, TrackedFile *tracked) {
+    PayloadWriter writer;
+    auto hashSection = [&](const auto& records, auto key, auto write, std::unordered_map<int64_t, RecordHash>& hashes) {
+        hashes.clear();
+        hashes.reserve(records.size());
+        for (const auto& record : records) {
+            writer.payload.clear();
+            write(writer, record);
+            hashes[key(record)] = RecordHash({ MerkleTree::hashBytes(writer.payload), tracked->saves });
+        }
+    };
+    hashSection(data.calendarData, calendarKey, [](PayloadWriter& writer, const Date& date) { writer.date(date); }, tracked->hashes[Calendar]);
+    hashSection(data.todosData, [](const TodoData& todo) { return static_cast<int64_t>(todo.id); }, [](PayloadWriter& writer, const TodoData& todo) { writer.todo(todo); }, tracked->hashes[Todos]);
+    hashSection(data.milestonesData, [](const MilestonesData& milestone) { return static_cast<int64_t>(milestone.id); }, [](PayloadWriter& writer, const MilestonesData& milestone) { writer.milestone(milestone); }, tracked->hashes[Milestones]);
+    hashSection(data.diaryData, [](const DiaryData& entry) { return static_cast<int64_t>(entry.id); }, [](PayloadWriter& writer, const DiaryData& entry) { writer.diaryEntry(entry); }, tracked->hashes[Diary]);
+}
+
+bool HistoryLog::track(const std::string& path, TrackedFile *tracked, std::string *error) {
+    std::vector<HistoryEntry> list;
+    if (!entries(path, &list, error)) {
+        return false;
+    }
+
+    std::error_code fileError;
+    if (list.empty()) {
+        // The first save is a checkpoint
+        tracked->saves = 0;
+        tracked->sinceCheckpoint = checkpointInterval;
+        tracked->end = std::filesystem::exists(path, fileError) ? fileHeaderSize : 0;
+        return true;
+    }
+
+    FileData last;
+    if (!at(path, list, list.back().number, &last, error)) {
+        return false;
+    }
+    tracked->saves = list.back().number;
+    hashAll(last, tracked);
+
+    auto checkpoint = std::find_if(list.rbegin(), list.rend(), [](const HistoryEntry& entry) {
+        return entry.kind == HistoryEntryKind::Checkpoint;
+    });
+    tracked->sinceCheckpoint = list.back().number - checkpoint->number;
+    tracked->end = list.back().offset + entryHeaderSize + list.back().size;
+    return true;
+}
+
+bool HistoryLog::record(const std::string& workingDirectory, const FileData& data, const DocumentChanges& changes, std::string *error) {
+    std::string historyPath = path(workingDirectory, data.log4FileName);
+    auto found = trackedFiles.find(historyPath);
+
+    // Another process (the daemon or the app) saved the file since, or it was deleted
+    std::error_code fileError;
+    uint64_t fileSize = std::filesystem::file_size(historyPath, fileError);
+    if (found != trackedFiles.end() && (fileError ? 0 : fileSize) != found->second.end) {
+        trackedFiles.erase(found);
+        found = trackedFiles.end();
+    }
+    bool compareAll = changes.whole();
+    if (found == trackedFiles.end()) {
+        TrackedFile tracked;
+        if (!track(historyPath, &tracked, error)) {
+            return false;
+        }
+        found = trackedFiles.emplace(historyPath, std::move(tracked)).first;
+        // The rebuilt hashes are of the last save in the history, which the changes may not start from
+        compareAll = true;
+    }
+    TrackedFile& tracked = found->second;
+    if (!compareAll && changes.empty()) {
+        return true;
+    }
+
+    uint32_t save = tracked.saves + 1;
+    uint32_t added = 0;
+    uint32_t modified = 0;
+    uint32_t removed = 0;
+    // Records sharing a key can not be told apart by a diff, such saves are stored whole
+    bool duplicateKeys = false;
+    PayloadWriter body;
+    PayloadWriter scratch;
+
+    // Appends the record to the upserts unless its hash is the one of the save before
+    auto upsert = [&](const auto& record, int64_t recordKey, auto write, std::unordered_map<int64_t, RecordHash>& hashes, PayloadWriter& upserts) {
+        scratch.payload.clear();
+        write(scratch, record);
+        uint64_t hash = MerkleTree::hashBytes(scratch.payload);
+        auto [it, inserted] = hashes.try_emplace(recordKey, RecordHash({ hash, save }));
+        if (inserted) {
+            added++;
+        } else {
+            duplicateKeys |= it->second.save == save;
+            it->second.save = save;
+            if (it->second.hash == hash) {
+                return false;
+            }
+            it->second.hash = hash;
+            modified++;
+        }
+        upserts.payload += scratch.payload;
+        return true;
+    };
+
+    auto diffSection = [&](const auto& records, auto key, auto write, Section section, std::unordered_map<int64_t, RecordHash>& hashes) {
+        PayloadWriter upserts;
+        uint32_t upsertCount = 0;
+        std::vector<int64_t> removedKeys;
+
+        if (compareAll) {
+            // Every record is hashed and marked as seen, the ones not seen were removed
+            for (const auto& record : records) {
+                upsertCount += upsert(record, key(record), write, hashes, upserts);
+            }
+            for (auto it = hashes.begin(); it != hashes.end();) {
+                if (it->second.save != save) {
+                    removedKeys.push_back(it->first);
+                    it = hashes.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        } else {
+            DocumentSection changedSection = static_cast<DocumentSection>(section);
+            std::vector<size_t> positions;
+            std::unordered_map<int64_t, size_t> moved;
+            for (const auto& [changedKey, hint] : changes.changedIn(changedSection)) {
+                size_t position = hint;
+                if (position >= records.size() || key(records[position]) != changedKey) {
+                    // Records removed before it moved it, the positions of the section are looked up once
+                    if (moved.empty()) {
+                        moved.reserve(records.size());
+                        for (size_t i = 0; i < records.size(); i++) {
+                            moved.emplace(key(records[i]), i);
+                        }
+                    }
+                    auto it = moved.find(changedKey);
+                    if (it == moved.end()) {
+                        if (hashes.erase(changedKey) > 0) {
+                            removedKeys.push_back(changedKey);
+                        }
+                        continue;
+                    }
+                    position = it->second;
+                }
+                positions.push_back(position);
+            }
+            // In the order of the document, so added records are appended in it when the diff is applied
+            std::sort(positions.begin(), positions.end());
+            for (size_t position : positions) {
+                upsertCount += upsert(records[position], key(records[position]), write, hashes, upserts);
+            }
+            for (int64_t removedKey : changes.removedIn(changedSection)) {
+                if (hashes.erase(removedKey) > 0) {
+                    removedKeys.push_back(removedKey);
+                }
+            }
+        }
+        body.u32(upsertCount);
+        body.payload += upserts.payload;
+
+        removed += static_cast<uint32_t>(removedKeys.size());
+        body.u32(static_cast<uint32_t>(removedKeys.size()));
+        for (int64_t removedKey : removedKeys) {
+            body.u64(static_cast<uint64_t>(removedKey));
+        }
+    };
+    diffSection(data.calendarData, calendarKey, [](PayloadWriter& writer, const Date& date) { writer.date(date); }, Calendar, tracked.hashes[Calendar]);
+    diffSection(data.todosData, [](const TodoData& todo) { return static_cast<int64_t>(todo.id); }, [](PayloadWriter& writer, const TodoData& todo) { writer.todo(todo); }, Todos, tracked.hashes[Todos]);
+    diffSection(data.milestonesData, [](const MilestonesData& milestone) { return static_cast<int64_t>(milestone.id); }, [](PayloadWriter& writer, const MilestonesData& milestone) { writer.milestone(milestone); }, Milestones, tracked.hashes[Milestones]);
+    diffSection(data.diaryData, [](const DiaryData& entry) { return static_cast<int64_t>(entry.id); }, [](PayloadWriter& writer, const DiaryData& entry) { writer.diaryEntry(entry); }, Diary, tracked.hashes[Diary]);
+
+    if (added + modified + removed == 0 && tracked.saves > 0 && !duplicateKeys) {
+        return true;
+    }
+
+    HistoryEntryKind kind = HistoryEntryKind::Diff;
+    if (tracked.sinceCheckpoint + 1 >= checkpointInterval || duplicateKeys) {
+        kind = HistoryEntryKind::Checkpoint;
+        body.payload.clear();
+        body.fileData(data);
+    }
+
+    PayloadWriter payload;
+    payload.u8(static_cast<uint8_t>(kind));
+    payload.u64(static_cast<uint64_t>(DateUtils::currentTime()));
+    payload.u32(save);
+    payload.u32(added);
+    payload.u32(modified);
+    payload.u32(removed);
+    payload.payload += body.payload;
+
+    PayloadWriter entry;
+    if (tracked.end == 0) {
+        entry.payload += magic;
+        entry.u32(version);
+    }
+    entry.u32(static_cast<uint32_t>(payload.payload.size()));
+    entry.u32(Crc32c::compute(payload.payload));
+    entry.payload += payload.payload;
+
+    // Cuts off a save that was torn by a crash before appending after the last good one
+    fileSize = std::filesystem::file_size(historyPath, fileError);
+    if (tracked.end > 0 && !fileError && fileSize > tracked.end) {
+        std::filesystem::resize_file(historyPath, tracked.end, fileError);
+    } else {
+        fileError.clear();
+    }
+    std::ofstream file(historyPath, std::ios::binary | std::ios::app);
+    file.write(entry.payload.data(), static_cast<std::streamsize>(entry.payload.size()));
+    file.flush();
+    if (!file || fileError) {
+        // The hashes no longer match the file, they are rebuilt from it on the next save
+        trackedFiles.erase(found);
+        *error = "failed to write " + historyPath;
+        return false;
+    }
+
+    tracked.saves = save;
+    tracked.sinceCheckpoint = kind == HistoryEntryKind::Checkpoint ? 0 : tracked.sinceCheckpoint + 1;
+    tracked.end += entry.payload.size();
+    // The checkpoint has every record anyway, their hashes catch up with changes that were not marked
+    if (kind == HistoryEntryKind::Checkpoint && !compareAll) {
+        hashAll(data, &tracked);
+    }
+    return true;
+}
@@ -2,7 +2,6 @@
 
 #include <vector>
 #include <string>
-#include <algorithm>
 
 std::vector<Command> InputHandlers::parseConsoleInputs(int argc, char* argv[]) {
     std::vector<Command> commands;
@@ -20,6 +19,7 @@ std::vector<Command> InputHandlers::parseConsoleInputs(int argc, char* argv[]) {
                     hasArgument = true;
                     cmd.argument = argv[i];
                 }
+                cmd.arguments.push_back(argv[i]);
             }
 
             commands.push_back(cmd);
@@ -33,8 +33,10 @@ std::vector<Command> InputHandlers::filterForSupportedCommands(const std::vector
     std::vector<Command> filteredCommands;
 
     for (const auto& cmd : commands) {
-        if (std::find(supportedCommands.begin(), supportedCommands.end(), cmd.name) != supportedCommands.end()) {
+        CommandId id = CommandTable::find(cmd.name);
+        if (id != CommandId::Unknown) {
             filteredCommands.push_back(cmd);
+            filteredCommands.back().id = id;
         }
     }
 
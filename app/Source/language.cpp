@@ -0,0 +1,300 @@
+#include "../Headers/language.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char tableMagic[4] = { 'L', '4', 'D', 'L' };
+    constexpr uint32_t tableVersion = 1;
+
+    struct TableHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t textBytes;
+    };
+
+    struct TableEntry {
+        uint64_t hash;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    constexpr bool uniqueHashes() {
+        for (size_t i = 0; i < languageStringCount; i++) {
+            for (size_t j = i + 1; j < languageStringCount; j++) {
+                if (languageKeyHash(languageStrings[i].key) == languageKeyHash(languageStrings[j].key)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // The tables keep only the hashes, two keys with one hash could not be told apart
+    static_assert(uniqueHashes(), "Two language string keys have the same hash");
+    static_assert(languageStringCount < UINT16_MAX);
+
+    std::string_view trim(std::string_view text) {
+        size_t first = text.find_first_not_of(" \t");
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    const LanguageString* findString(std::string_view key) {
+        for (const auto& string : languageStrings) {
+            if (string.key == key) {
+                return &string;
+            }
+        }
+        return nullptr;
+    }
+
+    std::array<std::string, languageStringCount> defaults() {
+        std::array<std::string, languageStringCount> texts;
+        for (size_t i = 0; i < languageStringCount; i++) {
+            texts[i] = languageStrings[i].text;
+        }
+        return texts;
+    }
+
+    /**
+     * @brief Checks a compiled table and fills the texts it translates, the entries are read in place.
+     */
+    bool resolve(std::string_view table, std::array<std::string, languageStringCount> *texts, std::string *error) {
+        TableHeader header;
+        if (table.size() < sizeof(header)) {
+            *error = "the language table is truncated";
+            return false;
+        }
+        std::memcpy(&header, table.data(), sizeof(header));
+        if (std::memcmp(header.magic, tableMagic, sizeof(tableMagic)) != 0 || header.version != tableVersion) {
+            *error = "not a language table of this version, set the language again";
+            return false;
+        }
+
+        size_t entriesBytes = static_cast<size_t>(header.count) * sizeof(TableEntry);
+        if (table.size() != sizeof(header) + entriesBytes + header.textBytes) {
+            *error = "the language table is truncated";
+            return false;
+        }
+        const char *entries = table.data() + sizeof(header);
+        std::string_view strings = table.substr(sizeof(header) + entriesBytes);
+
+        auto entryAt = [entries](size_t position) {
+            TableEntry entry;
+            std::memcpy(&entry, entries + position * sizeof(TableEntry), sizeof(entry));
+            return entry;
+        };
+
+        for (size_t i = 0; i < languageStringCount; i++) {
+            uint64_t hash = languageKeyHash(languageStrings[i].key);
+
+            // Binary search over the sorted hashes
+            size_t first = 0;
+            size_t last = header.count;
+            while (first < last) {
+                size_t middle = first + (last - first) / 2;
+                if (entryAt(middle).hash < hash) {
+                    first = middle + 1;
+                } else {
+                    last = middle;
+                }
+            }
+            if (first == header.count) {
+                continue;
+            }
+            TableEntry entry = entryAt(first);
+            if (entry.hash != hash) {
+                continue;
+            }
+            if (static_cast<size_t>(entry.offset) + entry.length > strings.size()) {
+                *error = "an entry of the language table points past its end";
+                return false;
+            }
+            (*texts)[i] = strings.substr(entry.offset, entry.length);
+        }
+        return true;
+    }
+}
+
+std::array<std::string, languageStringCount> Language::table = defaults();
+
+std::string Language::format(StringId id, std::initializer_list<std::string_view> values) {
+    const std::string& pattern = text(id);
+    std::string formatted;
+    formatted.reserve(pattern.size() + 16);
+
+    for (size_t i = 0; i < pattern.size(); i++) {
+        size_t value = pattern[i] == '{' && i + 2 < pattern.size() && pattern[i + 2] == '}' ? static_cast<size_t>(pattern[i + 1] - '1') : values.size();
+        if (value < values.size()) {
+            formatted += values.begin()[value];
+            i += 2;
+        } else {
+            formatted += pattern[i];
+        }
+    }
+    return formatted;
+}
+
+bool Language::compile(std::istream& source, const std::string& outputPath, LanguagePackReport *report, std::string *error) {
+    // Hash -> text, ordered as the table stores them
+    std::map<uint64_t, std::string> texts;
+    std::map<std::string, size_t, std::less<>> seenAt;
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(source, line)) {
+        lineNumber++;
+        std::string_view content = trim(line);
+        if (content.empty() || content.front() == '#') {
+            continue;
+        }
+
+        size_t separator = content.find('=');
+        if (separator == std::string_view::npos) {
+            *error = "line " + std::to_string(lineNumber) + ": expected key = text";
+            return false;
+        }
+        std::string_view key = trim(content.substr(0, separator));
+        std::string_view text = trim(content.substr(separator + 1));
+        // Quotes keep the spaces at the ends of a text
+        if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+            text = text.substr(1, text.size() - 2);
+        }
+
+        if (!findString(key)) {
+            report->warnings.push_back("line " + std::to_string(lineNumber) + ": unknown key '" + std::string(key) + "'");
+            continue;
+        }
+        auto [seen, inserted] = seenAt.try_emplace(std::string(key), lineNumber);
+        if (!inserted) {
+            report->warnings.push_back("line " + std::to_string(lineNumber) + ": '" + std::string(key) + "' was already set on line " + std::to_string(seen->second) + ", the last one is used");
+        }
+        texts[languageKeyHash(key)] = text;
+    }
+    report->translated = texts.size();
+
+    TableHeader header;
+    std::memcpy(header.magic, tableMagic, sizeof(tableMagic));
+    header.version = tableVersion;
+    header.count = static_cast<uint32_t>(texts.size());
+    header.textBytes = 0;
+
+    std::vector<TableEntry> entries;
+    std::string blob;
+    for (const auto& [hash, text] : texts) {
+        entries.push_back({ hash, static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(text.size()) });
+        blob += text;
+    }
+    header.textBytes = static_cast<uint32_t>(blob.size());
+
+    // Written next to the old table and renamed over it, so a crash never leaves half a table
+    std::string temporary = outputPath + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TableEntry)));
+        file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        if (!file) {
+            *error = "failed to write " + temporary;
+            return false;
+        }
+    }
+
+    std::error_code renameError;
+    std::filesystem::rename(temporary, outputPath, renameError);
+    if (renameError) {
+        *error = "failed to write " + outputPath + ": " + renameError.message();
+        return false;
+    }
+    return true;
+}
+
+bool Language::load(const std::string& path, std::string *error) {
+    // FTXUI takes its texts as std::string, so they are copied out once here instead of on every frame
+    std::array<std::string, languageStringCount> texts = defaults();
+    bool resolved = false;
+
+#if defined(__unix__) || defined(__APPLE__)
+    int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        useDefault();
+        // No table means no language was set
+        if (errno == ENOENT) {
+            return true;
+        }
+        *error = "failed to open " + path;
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+        ::close(descriptor);
+        useDefault();
+        *error = path + " is empty";
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (mapped == MAP_FAILED) {
+        useDefault();
+        *error = "failed to map " + path;
+        return false;
+    }
+
+    resolved = resolve(std::string_view(static_cast<const char*>(mapped), size), &texts, error);
+    ::munmap(mapped, size);
+#else
+    // Without mmap the table is small enough to read into a buffer once
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        useDefault();
+        // No table means no language was set
+        std::error_code existsError;
+        if (!std::filesystem::exists(path, existsError)) {
+            return true;
+        }
+        *error = "failed to open " + path;
+        return false;
+    }
+
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.empty()) {
+        useDefault();
+        *error = path + " is empty";
+        return false;
+    }
+
+    resolved = resolve(bytes, &texts, error);
+#endif
+
+    if (!resolved) {
+        useDefault();
+        return false;
+    }
+    table = std::move(texts);
+    return true;
+}
+
+void Language::useDefault() {
+    table = defaults();
+}
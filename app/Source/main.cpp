@@ -1,6 +1,7 @@
 #include <thread>
 
 #include "../Headers/applicationManager.h"
+#include "../Headers/trace.h"
 #include "../Headers/uiRenderer.h"
 
 #include "../../l4dFiles/out/l4dFiles.hpp"
@@ -25,8 +26,14 @@ int main(int argc, char** argv) {
     char* argv_DEBUG[] = { p0, p, p1 };
 #endif
     
+    Trace::startFromEnvironment();
+
     ManageConfig manageConfig;
-    ConfigFolderStatus configRespond = manageConfig.prepareConfigFile();
+    ConfigFolderStatus configRespond;
+    {
+        TraceSpan span("ManageConfig::prepareConfigFile");
+        configRespond = manageConfig.prepareConfigFile();
+    }
 
     if (configRespond == ConfigFolderStatus::FOLDER_ERROR) {
         std::cerr << "Problem acured while creating config folder" << std::endl;
@@ -51,12 +58,7 @@ int main(int argc, char** argv) {
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         applicationManager.registerToday();
         uiRenderer UI(&applicationManager);
-        
-        int returnCode = 0;
-        do {
-            returnCode = UI.renderUI(returnCode);
-        } while (returnCode != 0);
-        return returnCode;
+        UI.renderUI();
     }
     return 0;
 }
@@ -0,0 +1,173 @@
+#include "../Headers/memoryReport.h"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Headers/language.h"
+
+namespace {
+    // Capacity of a string that is not on the heap
+    const size_t smallStringCapacity = std::string().capacity();
+
+    /**
+     * @brief Pads the text to the width in characters rather than bytes, so translated labels line up.
+     */
+    std::string pad(std::string_view text, size_t width, bool alignLeft) {
+        size_t characters = 0;
+        for (unsigned char byte : text) {
+            characters += (byte & 0xC0) != 0x80;
+        }
+        std::string padding(characters < width ? width - characters : 0, ' ');
+        return alignLeft ? std::string(text) + padding : padding + std::string(text);
+    }
+
+    std::string tableLine(const std::string& name, const std::string& records, const std::string& used, const std::string& strings,
+        const std::string& slack, const std::string& total) {
+        return pad(name, 18, true) + " " + pad(records, 9, false) + " " + pad(used, 11, false) + " " + pad(strings, 11, false)
+            + " " + pad(slack, 11, false) + " " + pad(total, 11, false);
+    }
+
+    std::string tableLine(const std::string& name, const MemoryUsage& usage) {
+        return tableLine(name, std::to_string(usage.records), MemoryReport::formatBytes(usage.used), MemoryReport::formatBytes(usage.strings),
+            MemoryReport::formatBytes(usage.slack), MemoryReport::formatBytes(usage.total()));
+    }
+}
+
+size_t MemoryUsage::total() const {
+    return used + strings + slack;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other) {
+    records += other.records;
+    used += other.used;
+    strings += other.strings;
+    slack += other.slack;
+    return *this;
+}
+
+MemoryUsage MemoryReport::of(const std::string& text) {
+    MemoryUsage usage;
+    if (text.capacity() > smallStringCapacity) {
+        // With its terminating null
+        usage.strings = text.size() + 1;
+        usage.slack = text.capacity() - text.size();
+    }
+    return usage;
+}
+
+MemoryUsage MemoryReport::of(const TodoData& todo) {
+    MemoryUsage usage = of(todo.todoName);
+    usage += of(todo.todoDescription);
+    return usage;
+}
+
+MemoryUsage MemoryReport::of(const MilestonesData& milestone) {
+    MemoryUsage usage = of(milestone.milestoneName);
+    usage += of(milestone.milestoneDescription);
+    return usage;
+}
+
+MemoryUsage MemoryReport::of(const DiaryData& entry) {
+    MemoryUsage usage = of(entry.diaryEntryName);
+    usage += of(entry.diaryEntry);
+    return usage;
+}
+
+std::vector<MemoryRow> MemoryReport::document(const FileData& data) {
+    MemoryUsage progressPoints;
+    for (const auto& milestone : data.milestonesData) {
+        progressPoints += of(milestone.progressPoints);
+    }
+
+    return {
+        { Language::text("memory.calendar"), of(data.calendarData) },
+        { Language::text("memory.todos"), of(data.todosData) },
+        { Language::text("memory.milestones"), of(data.milestonesData) },
+        { Language::text("memory.progressPoints"), progressPoints },
+        { Language::text("memory.diary"), of(data.diaryData) },
+    };
+}
+
+MemoryUsage MemoryReport::total(const std::vector<MemoryRow>& rows) {
+    MemoryUsage usage;
+    for (const auto& row : rows) {
+        usage += row.usage;
+    }
+    return usage;
+}
+
+size_t MemoryReport::compact(FileData *data) {
+    return compact(&data->calendarData) + compact(&data->todosData) + compact(&data->milestonesData) + compact(&data->diaryData);
+}
+
+size_t MemoryReport::compact(std::string *text) {
+    // Counted as of() counts it, a short string moves back into its small string buffer
+    size_t before = of(*text).total();
+    text->shrink_to_fit();
+    return before - of(*text).total();
+}
+
+size_t MemoryReport::compact(TodoData *todo) {
+    return compact(&todo->todoName) + compact(&todo->todoDescription);
+}
+
+size_t MemoryReport::compact(MilestonesData *milestone) {
+    return compact(&milestone->milestoneName) + compact(&milestone->milestoneDescription) + compact(&milestone->progressPoints);
+}
+
+size_t MemoryReport::compact(DiaryData *entry) {
+    return compact(&entry->diaryEntryName) + compact(&entry->diaryEntry);
+}
+
+std::string MemoryReport::formatBytes(size_t bytes) {
+    static const char* units[] = { "B", "KiB", "MiB", "GiB" };
+    if (bytes < 1024) {
+        return std::to_string(bytes) + " B";
+    }
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024 && unit < 3) {
+        value /= 1024;
+        unit++;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f %s", value, units[unit]);
+    return text;
+}
+
+std::vector<std::string> MemoryReport::describe(const std::vector<MemoryRow>& rows) {
+    std::vector<std::string> lines;
+    lines.push_back(tableLine(Language::text("memory.section"), Language::text("memory.records"), Language::text("memory.used"),
+        Language::text("memory.strings"), Language::text("memory.slack"), Language::text("memory.total")));
+
+    MemoryUsage document;
+    MemoryUsage shadows;
+    bool hasShadows = false;
+    for (const auto& row : rows) {
+        if (row.shadow) {
+            hasShadows = true;
+            shadows += row.usage;
+        } else {
+            lines.push_back(tableLine(row.name, row.usage));
+            document += row.usage;
+        }
+    }
+    lines.push_back(tableLine(Language::text("memory.document"), document));
+    if (!hasShadows) {
+        return lines;
+    }
+
+    lines.push_back("");
+    for (const auto& row : rows) {
+        if (row.shadow) {
+            lines.push_back(tableLine(row.name, row.usage));
+        }
+    }
+    lines.push_back(tableLine(Language::text("memory.copies"), shadows));
+    MemoryUsage all = document;
+    all += shadows;
+    lines.push_back(tableLine(Language::text("memory.total"), all));
+    return lines;
+}
@@ -0,0 +1,250 @@
+#include "../Headers/milestoneStats.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Headers/dateUtils.h"
+#include "../Headers/language.h"
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr uint64_t allDays = ~uint64_t(0);
+
+    // everySeventh[s] has the bits s, s + 7, s + 14, ... set, the days of one weekday in a word
+    constexpr std::array<uint64_t, 7> everySeventh = [] {
+        std::array<uint64_t, 7> masks{};
+        for (int shift = 0; shift < 7; shift++) {
+            for (int bit = shift; bit < 64; bit += 7) {
+                masks[shift] |= uint64_t(1) << bit;
+            }
+        }
+        return masks;
+    }();
+
+    int floorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // Mask of the bits [from, to] of a word, both in 0-63
+    uint64_t bitRange(int from, int to) {
+        uint64_t upper = to == 63 ? allDays : (uint64_t(1) << (to + 1)) - 1;
+        return upper & ~((uint64_t(1) << from) - 1);
+    }
+
+    constexpr StringId weekdayNames[7] = { "weekday.monday", "weekday.tuesday", "weekday.wednesday", "weekday.thursday", "weekday.friday", "weekday.saturday", "weekday.sunday" };
+
+    std::string ratio(int part, int whole) {
+        int percent = whole == 0 ? 0 : part * 100 / whole;
+        return std::to_string(part) + "/" + std::to_string(whole) + " (" + std::to_string(percent) + "%)";
+    }
+
+    int longestRunInWord(uint64_t word) {
+        int length = 0;
+        while (word) {
+            word &= word << 1;
+            length++;
+        }
+        return length;
+    }
+}
+
+void MilestoneStats::ensureDay(int day) {
+    if (recorded.empty()) {
+        firstDay = floorDiv(day, 64) * 64;
+    }
+
+    if (day < firstDay) {
+        int newFirstDay = floorDiv(day, 64) * 64;
+        size_t extraWords = static_cast<size_t>((firstDay - newFirstDay) / 64);
+        recorded.insert(recorded.begin(), extraWords, 0);
+        completed.insert(completed.begin(), extraWords, 0);
+        firstDay = newFirstDay;
+    }
+
+    size_t word = static_cast<size_t>((day - firstDay) / 64);
+    if (word >= recorded.size()) {
+        recorded.resize(word + 1, 0);
+        completed.resize(word + 1, 0);
+    }
+}
+
+bool MilestoneStats::testBit(const std::vector<uint64_t>& bits, int day) const {
+    if (day < firstDay) {
+        return false;
+    }
+    size_t offset = static_cast<size_t>(day - firstDay);
+    return offset / 64 < bits.size() && (bits[offset / 64] >> (offset % 64)) & 1;
+}
+
+void MilestoneStats::rebuild(const MilestonesData& milestone) {
+    recorded.clear();
+    completed.clear();
+
+    for (const auto& point : milestone.progressPoints) {
+        int day = DateUtils::dayNumber(point.date);
+        ensureDay(day);
+
+        size_t offset = static_cast<size_t>(day - firstDay);
+        uint64_t bit = uint64_t(1) << (offset % 64);
+        recorded[offset / 64] |= bit;
+        completed[offset / 64] = point.isCompleted ? completed[offset / 64] | bit : completed[offset / 64] & ~bit;
+    }
+
+    longestStreak = longestRun();
+    longestStreakStale = false;
+    summaryStale = true;
+}
+
+void MilestoneStats::addPoint(const MilestoneProgressPoint& point) {
+    int day = DateUtils::dayNumber(point.date);
+    ensureDay(day);
+
+    size_t offset = static_cast<size_t>(day - firstDay);
+    uint64_t bit = uint64_t(1) << (offset % 64);
+    bool wasCompleted = completed[offset / 64] & bit;
+
+    recorded[offset / 64] |= bit;
+    if (point.isCompleted) {
+        completed[offset / 64] |= bit;
+        if (!wasCompleted && !longestStreakStale) {
+            // The new day joins the runs before and after it
+            int after = 0;
+            while (testBit(completed, day + after + 1)) {
+                after++;
+            }
+            longestStreak = std::max(longestStreak, runEndingAt(day) + after);
+        }
+    }
+    else {
+        completed[offset / 64] &= ~bit;
+        if (wasCompleted) {
+            // A streak may have been broken, count again on the next read
+            longestStreakStale = true;
+        }
+    }
+    summaryStale = true;
+}
+
+int MilestoneStats::countRange(const std::vector<uint64_t>& bits, int fromDay, int toDay) const {
+    fromDay = std::max(fromDay, firstDay);
+    toDay = std::min(toDay, firstDay + static_cast<int>(bits.size()) * 64 - 1);
+    if (fromDay > toDay) {
+        return 0;
+    }
+
+    int from = fromDay - firstDay;
+    int to = toDay - firstDay;
+    size_t firstWord = static_cast<size_t>(from / 64);
+    size_t lastWord = static_cast<size_t>(to / 64);
+
+    if (firstWord == lastWord) {
+        return std::popcount(bits[firstWord] & bitRange(from % 64, to % 64));
+    }
+
+    int count = std::popcount(bits[firstWord] & bitRange(from % 64, 63));
+    for (size_t word = firstWord + 1; word < lastWord; word++) {
+        count += std::popcount(bits[word]);
+    }
+    return count + std::popcount(bits[lastWord] & bitRange(0, to % 64));
+}
+
+int MilestoneStats::runEndingAt(int day) const {
+    if (!testBit(completed, day)) {
+        return 0;
+    }
+
+    int offset = day - firstDay;
+    int word = offset / 64;
+    int bit = offset % 64;
+
+    // Completed days at and below the bit, counted from the top of the shifted word
+    uint64_t shifted = completed[word] << (63 - bit);
+    int run = std::countl_one(shifted);
+    if (run <= bit) {
+        return run;
+    }
+
+    for (word--; word >= 0; word--) {
+        if (completed[word] != allDays) {
+            return run + std::countl_one(completed[word]);
+        }
+        run += 64;
+    }
+    return run;
+}
+
+int MilestoneStats::longestRun() const {
+    int longest = 0;
+    int run = 0;
+
+    for (uint64_t word : completed) {
+        if (word == allDays) {
+            run += 64;
+            continue;
+        }
+        longest = std::max({ longest, run + std::countr_one(word), longestRunInWord(word) });
+        run = std::countl_one(word);
+    }
+    return std::max(longest, run);
+}
+
+void MilestoneStats::countWeekdays() {
+    cachedSummary.completedByWeekday.fill(0);
+    cachedSummary.recordedByWeekday.fill(0);
+
+    for (size_t word = 0; word < recorded.size(); word++) {
+        int firstWeekday = DateUtils::weekday(firstDay + static_cast<int>(word) * 64);
+        for (int weekday = 0; weekday < 7; weekday++) {
+            uint64_t mask = everySeventh[(weekday - firstWeekday + 7) % 7];
+            cachedSummary.recordedByWeekday[weekday] += std::popcount(recorded[word] & mask);
+            cachedSummary.completedByWeekday[weekday] += std::popcount(completed[word] & mask);
+        }
+    }
+}
+
+const MilestoneSummary& MilestoneStats::summary(int today) {
+    if (!summaryStale && summaryDay == today) {
+        return cachedSummary;
+    }
+
+    if (longestStreakStale) {
+        longestStreak = longestRun();
+        longestStreakStale = false;
+    }
+
+    cachedSummary.longestStreak = longestStreak;
+    // Today still counts towards the streak until the day is over
+    cachedSummary.currentStreak = testBit(recorded, today) ? runEndingAt(today) : runEndingAt(today - 1);
+    cachedSummary.recordedDays = countRange(recorded, firstDay, today);
+    cachedSummary.completedDays = countRange(completed, firstDay, today);
+    cachedSummary.completedLastWeek = countRange(completed, today - 6, today);
+    cachedSummary.completedLastMonth = countRange(completed, today - monthWindow + 1, today);
+    countWeekdays();
+
+    summaryStale = false;
+    summaryDay = today;
+    return cachedSummary;
+}
+
+std::vector<std::string> MilestoneStats::describe(const MilestoneSummary& summary) {
+    std::vector<std::string> lines;
+    lines.push_back(Language::format("milestones.statsStreak", { std::to_string(summary.currentStreak), std::to_string(summary.longestStreak) }));
+    lines.push_back(Language::format("milestones.statsRecent", {
+        ratio(summary.completedLastWeek, 7), std::to_string(monthWindow), ratio(summary.completedLastMonth, monthWindow) }));
+    lines.push_back(Language::format("milestones.statsAllTime", { ratio(summary.completedDays, summary.recordedDays) }));
+
+    std::string weekdays = Language::text("milestones.statsWeekdays");
+    for (int weekday = 0; weekday < 7; weekday++) {
+        if (weekday == 4) {
+            lines.push_back(weekdays);
+            weekdays = "  ";
+        }
+        weekdays += " " + Language::text(weekdayNames[weekday]) + " " + std::to_string(summary.completedByWeekday[weekday]) + "/" + std::to_string(summary.recordedByWeekday[weekday]);
+    }
+    lines.push_back(weekdays);
+    return lines;
+}
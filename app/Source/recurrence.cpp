@@ -0,0 +1,407 @@
+#include "../Headers/recurrence.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../Headers/batchCommands.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/fileDataOperations.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr const char* weekdayNames[7] = { "mon", "tue", "wed", "thu", "fri", "sat", "sun" };
+
+    std::vector<std::string_view> words(std::string_view text) {
+        std::vector<std::string_view> words;
+        size_t position = 0;
+        while (position < text.size()) {
+            size_t start = text.find_first_not_of(" ,\t", position);
+            if (start == std::string_view::npos) {
+                break;
+            }
+            size_t end = text.find_first_of(" ,\t", start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            words.push_back(text.substr(start, end - start));
+            position = end;
+        }
+        return words;
+    }
+
+    bool parseNumber(std::string_view text, int *number) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), *number);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    /**
+     * @brief Returns the line of the tag at the end of the description, empty if there is none.
+     */
+    std::string_view tagLine(const std::string& description, const char* tag) {
+        size_t start = description.rfind(tag);
+        if (start == std::string::npos) {
+            return std::string_view();
+        }
+        std::string_view line(description);
+        line.remove_prefix(start + std::char_traits<char>::length(tag));
+        return line.substr(0, line.find('\n'));
+    }
+
+    std::string formatDay(int day) {
+        return DateUtils::toString(DateUtils::fromDayNumber(day));
+    }
+
+    std::string formatDoneDays(const std::vector<std::pair<int, int>>& ranges) {
+        std::string text;
+        for (const auto& [first, last] : ranges) {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += formatDay(first);
+            if (last != first) {
+                text += ".." + formatDay(last);
+            }
+        }
+        return text;
+    }
+
+    /**
+     * @brief Sorts the ranges and joins the overlapping and neighbouring ones.
+     */
+    std::vector<std::pair<int, int>> joinRanges(std::vector<std::pair<int, int>> ranges) {
+        std::sort(ranges.begin(), ranges.end());
+        std::vector<std::pair<int, int>> joined;
+        for (const auto& range : ranges) {
+            if (!joined.empty() && range.first <= joined.back().second + 1) {
+                joined.back().second = std::max(joined.back().second, range.second);
+            } else {
+                joined.push_back(range);
+            }
+        }
+        return joined;
+    }
+
+    /**
+     * @brief Returns the day of the month the monthly rule falls on in that month.
+     */
+    int monthlyDay(const RecurrenceRule& rule, int year, int month) {
+        return std::min(rule.monthDay, DateUtils::daysInMonth(year, month));
+    }
+}
+
+bool Recurrence::parseRule(std::string_view text, int startDay, RecurrenceRule *rule, std::string *error) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::vector<std::string_view> parts = words(lower);
+
+    RecurrenceRule parsed;
+    if (parts.size() == 1 && parts[0] == "daily") {
+        parsed.kind = RecurrenceKind::Days;
+    }
+    else if (parts.size() == 3 && parts[0] == "every" && (parts[2] == "days" || parts[2] == "day")) {
+        parsed.kind = RecurrenceKind::Days;
+        if (!parseNumber(parts[1], &parsed.interval) || parsed.interval < 1 || parsed.interval > 3660) {
+            *error = "'" + std::string(parts[1]) + "' is not a number of days";
+            return false;
+        }
+    }
+    else if (!parts.empty() && parts[0] == "weekly") {
+        parsed.kind = RecurrenceKind::Weekly;
+        for (size_t i = 1; i < parts.size(); i++) {
+            auto name = std::find_if(std::begin(weekdayNames), std::end(weekdayNames), [&](const char* weekday) {
+                return parts[i].size() >= 3 && std::string_view(weekday) == parts[i].substr(0, 3);
+            });
+            if (name == std::end(weekdayNames)) {
+                *error = "'" + std::string(parts[i]) + "' is not a weekday";
+                return false;
+            }
+            parsed.weekdays |= 1 << (name - std::begin(weekdayNames));
+        }
+        if (parsed.weekdays == 0) {
+            parsed.weekdays = 1 << DateUtils::weekday(startDay);
+        }
+    }
+    else if (!parts.empty() && parts.size() <= 2 && parts[0] == "monthly") {
+        parsed.kind = RecurrenceKind::Monthly;
+        parsed.monthDay = DateUtils::fromDayNumber(startDay).day;
+        if (parts.size() == 2 && (!parseNumber(parts[1], &parsed.monthDay) || parsed.monthDay < 1 || parsed.monthDay > 31)) {
+            *error = "'" + std::string(parts[1]) + "' is not a day of the month";
+            return false;
+        }
+    }
+    else {
+        *error = "'" + std::string(text) + "' is not a rule (daily, every N days, weekly [mon,...], monthly [N])";
+        return false;
+    }
+
+    *rule = parsed;
+    return true;
+}
+
+std::string Recurrence::formatRule(const RecurrenceRule& rule) {
+    switch (rule.kind) {
+        case RecurrenceKind::Days:
+            return rule.interval == 1 ? "daily" : "every " + std::to_string(rule.interval) + " days";
+        case RecurrenceKind::Weekly: {
+            std::string text = "weekly";
+            char separator = ' ';
+            for (int weekday = 0; weekday < 7; weekday++) {
+                if (rule.weekdays & (1 << weekday)) {
+                    text += separator;
+                    text += weekdayNames[weekday];
+                    separator = ',';
+                }
+            }
+            return text;
+        }
+        case RecurrenceKind::Monthly:
+            return "monthly " + std::to_string(rule.monthDay);
+        default:
+            return "";
+    }
+}
+
+bool Recurrence::isRecurring(const TodoData& todo) {
+    return todo.todoDescription.find(ruleTag) != std::string::npos;
+}
+
+RecurrenceRule Recurrence::rule(const TodoData& todo) {
+    RecurrenceRule rule;
+    std::string_view line = tagLine(todo.todoDescription, ruleTag);
+    std::string error;
+    if (!line.empty()) {
+        parseRule(line, DateUtils::dayNumber(todo.dueDate), &rule, &error);
+    }
+    return rule;
+}
+
+std::string Recurrence::description(const TodoData& todo) {
+    return todo.todoDescription.substr(0, todo.todoDescription.find(ruleTag));
+}
+
+void Recurrence::setRule(TodoData *todo, const RecurrenceRule& rule) {
+    std::string done = formatDoneDays(doneDays(*todo));
+    todo->todoDescription = description(*todo);
+    if (rule.kind == RecurrenceKind::None) {
+        return;
+    }
+
+    todo->todoDescription += ruleTag + formatRule(rule);
+    if (!done.empty()) {
+        todo->todoDescription += doneTag + done;
+    }
+}
+
+std::vector<std::pair<int, int>> Recurrence::doneDays(const TodoData& todo) {
+    std::vector<std::pair<int, int>> ranges;
+    if (!isRecurring(todo)) {
+        return ranges;
+    }
+
+    for (std::string_view word : words(tagLine(todo.todoDescription, doneTag))) {
+        size_t separator = word.find("..");
+        Date first, last;
+        if (!BatchCommands::parseDate(std::string(word.substr(0, separator)), &first)) {
+            continue;
+        }
+        last = first;
+        if (separator != std::string_view::npos && !BatchCommands::parseDate(std::string(word.substr(separator + 2)), &last)) {
+            continue;
+        }
+        ranges.emplace_back(DateUtils::dayNumber(first), DateUtils::dayNumber(last));
+    }
+
+    // Written sorted, but a hand edited file is taken as it comes
+    return joinRanges(std::move(ranges));
+}
+
+bool Recurrence::isOccurrence(const RecurrenceRule& rule, int startDay, int day) {
+    if (day < startDay) {
+        return false;
+    }
+    switch (rule.kind) {
+        case RecurrenceKind::Days:
+            return (day - startDay) % rule.interval == 0;
+        case RecurrenceKind::Weekly:
+            return rule.weekdays & (1 << DateUtils::weekday(day));
+        case RecurrenceKind::Monthly: {
+            Date date = DateUtils::fromDayNumber(day);
+            return date.day == monthlyDay(rule, date.year, date.month);
+        }
+        default:
+            return false;
+    }
+}
+
+bool Recurrence::markOccurrenceDone(TodoData *todo, int day, bool done) {
+    RecurrenceRule recurrence = rule(*todo);
+    if (!isOccurrence(recurrence, DateUtils::dayNumber(todo->dueDate), day)) {
+        return false;
+    }
+
+    std::vector<std::pair<int, int>> ranges = doneDays(*todo);
+    auto range = std::lower_bound(ranges.begin(), ranges.end(), day, [](const std::pair<int, int>& range, int day) {
+        return range.second < day;
+    });
+    bool wasDone = range != ranges.end() && range->first <= day;
+    if (wasDone == done) {
+        return false;
+    }
+
+    if (done) {
+        ranges.insert(range, std::make_pair(day, day));
+    } else if (range->first == range->second) {
+        ranges.erase(range);
+    } else if (range->first == day) {
+        range->first++;
+    } else if (range->second == day) {
+        range->second--;
+    } else {
+        std::pair<int, int> after(day + 1, range->second);
+        range->second = day - 1;
+        ranges.insert(range + 1, after);
+    }
+
+    // Neighbouring days are joined into ranges, so a daily chore done every day stays one range
+    std::vector<std::pair<int, int>> merged = joinRanges(std::move(ranges));
+
+    todo->todoDescription = description(*todo) + ruleTag + formatRule(recurrence);
+    if (!merged.empty()) {
+        todo->todoDescription += doneTag + formatDoneDays(merged);
+    }
+    return true;
+}
+
+bool Recurrence::nextOpenOccurrence(const TodoData& todo, int fromDay, int *day) {
+    if (FileDataOperations::isTodoDone(todo)) {
+        return false;
+    }
+
+    RecurrenceIndex index;
+    index.rebuild({ todo });
+    std::vector<Occurrence> occurrences;
+    index.expand(fromDay, fromDay + 366, &occurrences);
+
+    auto open = std::find_if(occurrences.begin(), occurrences.end(), [](const Occurrence& occurrence) {
+        return !occurrence.done;
+    });
+    if (open == occurrences.end()) {
+        return false;
+    }
+    *day = open->day;
+    return true;
+}
+
+TodoData Recurrence::occurrence(const TodoData& todo, int day, bool done) {
+    TodoData occurrence = todo;
+    Date date = DateUtils::fromDayNumber(day);
+    date.hour = todo.dueDate.hour;
+    date.minute = todo.dueDate.minute;
+    occurrence.dueDate = date;
+
+    if (FileDataOperations::isTodoDone(todo)) {
+        occurrence.todoName.resize(occurrence.todoName.size() - std::char_traits<char>::length(FileDataOperations::doneSuffix));
+    }
+    if (done) {
+        occurrence.todoName += FileDataOperations::doneSuffix;
+    }
+    occurrence.todoDescription = description(todo);
+    return occurrence;
+}
+
+void RecurrenceIndex::rebuild(const std::vector<TodoData>& todos) {
+    series.clear();
+    seriesPositions.assign(todos.size(), false);
+
+    for (uint32_t i = 0; i < todos.size(); i++) {
+        const TodoData& todo = todos[i];
+        if (!Recurrence::isRecurring(todo)) {
+            continue;
+        }
+        seriesPositions[i] = true;
+        // An ended series has no occurrences left to expand
+        if (FileDataOperations::isTodoDone(todo)) {
+            continue;
+        }
+        Series entry({i, DateUtils::dayNumber(todo.dueDate), Recurrence::rule(todo), Recurrence::doneDays(todo)});
+        if (entry.rule.kind != RecurrenceKind::None) {
+            series.push_back(std::move(entry));
+        }
+    }
+}
+
+bool RecurrenceIndex::isSeries(uint32_t position) const {
+    return position < seriesPositions.size() && seriesPositions[position];
+}
+
+size_t RecurrenceIndex::size() const {
+    return series.size();
+}
+
+void RecurrenceIndex::expand(int firstDay, int lastDay, std::vector<Occurrence> *occurrences) const {
+    for (const auto& entry : series) {
+        int from = std::max(firstDay, entry.startDay);
+        if (from > lastDay) {
+            continue;
+        }
+
+        // Days only grow within a series, so the done ranges are walked once alongside them
+        auto done = std::lower_bound(entry.doneDays.begin(), entry.doneDays.end(), from, [](const std::pair<int, int>& range, int day) {
+            return range.second < day;
+        });
+        auto add = [&](int day) {
+            while (done != entry.doneDays.end() && done->second < day) {
+                ++done;
+            }
+            occurrences->push_back(Occurrence({entry.position, day, done != entry.doneDays.end() && done->first <= day}));
+        };
+
+        const RecurrenceRule& rule = entry.rule;
+        switch (rule.kind) {
+            case RecurrenceKind::Days: {
+                int offset = (from - entry.startDay) % rule.interval;
+                for (int day = offset == 0 ? from : from + rule.interval - offset; day <= lastDay; day += rule.interval) {
+                    add(day);
+                }
+                break;
+            }
+            case RecurrenceKind::Weekly: {
+                int weekday = DateUtils::weekday(from);
+                for (int day = from; day <= lastDay; day++) {
+                    if (rule.weekdays & (1 << weekday)) {
+                        add(day);
+                    }
+                    weekday = weekday == 6 ? 0 : weekday + 1;
+                }
+                break;
+            }
+            case RecurrenceKind::Monthly: {
+                Date date = DateUtils::fromDayNumber(from);
+                int year = date.year;
+                int month = date.month;
+                while (true) {
+                    int day = DateUtils::dayNumber(year, month, monthlyDay(rule, year, month));
+                    if (day > lastDay) {
+                        break;
+                    }
+                    if (day >= from) {
+                        add(day);
+                    }
+                    if (++month > 12) {
+                        month = 1;
+                        year++;
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
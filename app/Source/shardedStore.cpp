@@ -0,0 +1,298 @@
+#include "../Headers/shardedStore.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Headers/blockChecksums.h"
+#include "../Headers/daemonProtocol.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/trace.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr const char* manifestHeader = "log4daily shard manifest 1";
+    constexpr const char* activeShard = "active";
+
+    std::string yearShard(int year) {
+        return "year-" + std::to_string(year);
+    }
+
+    size_t fingerprint(const FileData& shard) {
+        PayloadWriter writer;
+        writer.fileData(shard);
+        return std::hash<std::string>{}(writer.payload);
+    }
+
+    /**
+     * @brief Adds the progress points of a year shard to the milestones they belong to.
+     */
+    void addProgressPoints(std::vector<MilestonesData>& milestones, const std::unordered_map<int, size_t>& positions, const std::vector<MilestonesData>& shardMilestones) {
+        for (const auto& stored : shardMilestones) {
+            auto it = positions.find(stored.id);
+            // Points of a milestone that was deleted since
+            if (it == positions.end()) {
+                continue;
+            }
+            auto& points = milestones[it->second].progressPoints;
+            points.insert(points.end(), stored.progressPoints.begin(), stored.progressPoints.end());
+        }
+    }
+
+    /**
+     * @brief Adds the records of one shard to another, calendar days only once.
+     */
+    void appendShard(FileData& target, const FileData& records) {
+        for (const auto& date : records.calendarData) {
+            if (std::find(target.calendarData.begin(), target.calendarData.end(), date) == target.calendarData.end()) {
+                target.calendarData.push_back(date);
+            }
+        }
+        target.diaryData.insert(target.diaryData.end(), records.diaryData.begin(), records.diaryData.end());
+        target.milestonesData.insert(target.milestonesData.end(), records.milestonesData.begin(), records.milestonesData.end());
+    }
+}
+
+ShardedStore::ShardedStore(std::string workingDirectory, std::string configName) {
+    this->workingDirectory = workingDirectory;
+    this->configName = configName;
+}
+
+std::string ShardedStore::directoryName(const std::string& log4FileName) {
+    return log4FileName + ".shards";
+}
+
+std::string ShardedStore::shardDirectory(const std::string& log4FileName) const {
+    return workingDirectory + directoryName(log4FileName) + "/";
+}
+
+std::string ShardedStore::manifestPath(const std::string& log4FileName) const {
+    return shardDirectory(log4FileName) + "manifest";
+}
+
+bool ShardedStore::isSharded(const std::string& log4FileName) const {
+    std::error_code error;
+    return !log4FileName.empty() && std::filesystem::is_directory(shardDirectory(log4FileName), error);
+}
+
+std::vector<int> ShardedStore::years(const std::string& log4FileName) const {
+    std::vector<int> years;
+
+    std::ifstream manifest(manifestPath(log4FileName));
+    std::string line;
+    if (!std::getline(manifest, line) || line != manifestHeader) {
+        return years;
+    }
+
+    int year;
+    while (manifest >> year) {
+        years.push_back(year);
+    }
+    return years;
+}
+
+void ShardedStore::writeManifest(const std::string& log4FileName, const std::vector<int>& years) const {
+    std::ofstream manifest(manifestPath(log4FileName), std::ios::trunc);
+    manifest << manifestHeader << '\n';
+    for (int year : years) {
+        manifest << year << '\n';
+    }
+}
+
+bool ShardedStore::create(const std::string& log4FileName) {
+    std::string directory = shardDirectory(log4FileName);
+    std::error_code error;
+    if (log4FileName.empty() || !std::filesystem::create_directory(directory, error)) {
+        return false;
+    }
+
+    // The shards are registered in a config of their own, not next to the user's log4daily files
+    std::ofstream(directory + configName, std::ios::app);
+    LocalStorage storage(directory + configName);
+    if (!storage.createLog4DailyFile(directory, activeShard, configName)) {
+        std::filesystem::remove_all(directory, error);
+        return false;
+    }
+    writeManifest(log4FileName, {});
+
+    OpenedLog& log = opened[log4FileName] = OpenedLog();
+    log.allYears = true;
+    return true;
+}
+
+bool ShardedStore::remove(const std::string& log4FileName) {
+    opened.erase(log4FileName);
+    std::error_code error;
+    return isSharded(log4FileName) && std::filesystem::remove_all(shardDirectory(log4FileName), error) > 0;
+}
+
+FileData ShardedStore::open(const std::string& log4FileName, ShardScope scope, std::vector<VerifyReport> *reports) {
+    std::string directory = shardDirectory(log4FileName);
+    LocalStorage storage(directory + configName);
+
+    auto read = [&](const std::string& shardName) {
+        if (reports == nullptr) {
+            TraceSpan span("LocalStorage::openLog4DailyFile");
+            return storage.openLog4DailyFile(directory, shardName);
+        }
+        FileData shard;
+        VerifyReport report = BlockChecksums::verifyFile(storage, directory, shardName, &shard);
+        report.file = directoryName(log4FileName) + "/" + shardName;
+        reports->push_back(report);
+        return report.readable ? BlockChecksums::salvage(shard, report) : FileData();
+    };
+
+    FileData active = read(activeShard);
+    // When checking, the year shards are still read so their records can be salvaged
+    if (active == FileData() && (reports == nullptr || !isSharded(log4FileName))) {
+        return FileData();
+    }
+
+    OpenedLog& log = opened[log4FileName] = OpenedLog();
+    log.allYears = scope == ShardScope::All;
+    log.fingerprints[activeShard] = fingerprint(active);
+
+    FileData data;
+    data.log4FileName = log4FileName;
+    data.todosData = std::move(active.todosData);
+    data.milestonesData = std::move(active.milestonesData);
+
+    if (scope == ShardScope::Active) {
+        return data;
+    }
+
+    std::unordered_map<int, size_t> positions;
+    for (size_t i = 0; i < data.milestonesData.size(); i++) {
+        positions[data.milestonesData[i].id] = i;
+    }
+
+    int currentYear = DateUtils::today().year;
+    if (scope == ShardScope::Recent) {
+        log.years = { currentYear - 1, currentYear };
+    }
+
+    for (int year : years(log4FileName)) {
+        if (scope == ShardScope::Recent && year < currentYear - 1) {
+            continue;
+        }
+        FileData shard = read(yearShard(year));
+        if (shard == FileData()) {
+            // Left as it is on save, so an unreadable shard can still be repaired
+            log.years.erase(year);
+            continue;
+        }
+        log.years.insert(year);
+        log.fingerprints[yearShard(year)] = fingerprint(shard);
+
+        data.calendarData.insert(data.calendarData.end(), shard.calendarData.begin(), shard.calendarData.end());
+        data.diaryData.insert(data.diaryData.end(), std::make_move_iterator(shard.diaryData.begin()), std::make_move_iterator(shard.diaryData.end()));
+        addProgressPoints(data.milestonesData, positions, shard.milestonesData);
+    }
+    return data;
+}
+
+size_t ShardedStore::save(const FileData& data) {
+    const std::string& log4FileName = data.log4FileName;
+    std::string directory = shardDirectory(log4FileName);
+    LocalStorage storage(directory + configName);
+
+    auto found = opened.find(log4FileName);
+    if (found == opened.end()) {
+        found = opened.emplace(log4FileName, OpenedLog()).first;
+        found->second.allYears = true;
+    }
+    OpenedLog& log = found->second;
+
+    // Split the data into its shards again
+    FileData active;
+    active.log4FileName = activeShard;
+    active.todosData = data.todosData;
+    active.milestonesData.reserve(data.milestonesData.size());
+
+    std::map<int, FileData> shards;
+    for (const auto& milestone : data.milestonesData) {
+        MilestonesData stripped = milestone;
+        stripped.progressPoints.clear();
+
+        for (const auto& point : milestone.progressPoints) {
+            FileData& shard = shards[point.date.year];
+            if (shard.milestonesData.empty() || shard.milestonesData.back().id != milestone.id) {
+                MilestonesData reference = stripped;
+                reference.milestoneDescription.clear();
+                shard.milestonesData.push_back(std::move(reference));
+            }
+            shard.milestonesData.back().progressPoints.push_back(point);
+        }
+        active.milestonesData.push_back(std::move(stripped));
+    }
+    for (const auto& date : data.calendarData) {
+        shards[date.year].calendarData.push_back(date);
+    }
+    for (const auto& entry : data.diaryData) {
+        shards[entry.date.year].diaryData.push_back(entry);
+    }
+
+    std::vector<int> manifest = years(log4FileName);
+    size_t manifestSize = manifest.size();
+
+    // A year that was read but has no records left is written empty
+    for (int year : manifest) {
+        if (log.allYears || log.years.contains(year)) {
+            shards[year];
+        }
+    }
+
+    size_t written = 0;
+    auto write = [&](const std::string& name, FileData& shard) {
+        size_t print = fingerprint(shard);
+        auto it = log.fingerprints.find(name);
+        if (it != log.fingerprints.end() && it->second == print) {
+            return;
+        }
+        BlockChecksums::save(storage, directory, name, shard);
+        log.fingerprints[name] = print;
+        written++;
+    };
+
+    write(activeShard, active);
+
+    for (auto& [year, shard] : shards) {
+        bool stored = std::find(manifest.begin(), manifest.end(), year) != manifest.end();
+        if (!stored) {
+            if (shard.calendarData.empty() && shard.diaryData.empty() && shard.milestonesData.empty()) {
+                continue;
+            }
+            storage.createLog4DailyFile(directory, yearShard(year), configName);
+            manifest.push_back(year);
+            // Everything of a new shard is in the data
+            log.years.insert(year);
+        } else if (!log.allYears && !log.years.contains(year)) {
+            // The year was not opened, so its stored records are kept and the new ones added to them
+            auto records = log.storedRecords.find(year);
+            if (records == log.storedRecords.end()) {
+                FileData storedShard = storage.openLog4DailyFile(directory, yearShard(year));
+                if (storedShard == FileData()) {
+                    continue;
+                }
+                records = log.storedRecords.emplace(year, std::move(storedShard)).first;
+            }
+            FileData merged = records->second;
+            appendShard(merged, shard);
+            shard = std::move(merged);
+        }
+
+        shard.log4FileName = yearShard(year);
+        write(yearShard(year), shard);
+    }
+
+    if (manifest.size() != manifestSize) {
+        std::sort(manifest.begin(), manifest.end());
+        writeManifest(log4FileName, manifest);
+    }
+    return written;
+}
@@ -0,0 +1,296 @@
+#include "../Headers/theme.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr size_t maxFrameColors = 8;
+
+    struct NamedColor {
+        std::string_view name;
+        ThemeColorKind kind;
+        uint8_t index;
+    };
+
+    // The 16 basic colors in FTXUI's Palette16 order, and the 256 color palette names the themes use most
+    constexpr NamedColor namedColors[] = {
+        { "Black", ThemeColorKind::Palette16, 0 },
+        { "Red", ThemeColorKind::Palette16, 1 },
+        { "Green", ThemeColorKind::Palette16, 2 },
+        { "Yellow", ThemeColorKind::Palette16, 3 },
+        { "Blue", ThemeColorKind::Palette16, 4 },
+        { "Magenta", ThemeColorKind::Palette16, 5 },
+        { "Cyan", ThemeColorKind::Palette16, 6 },
+        { "GrayLight", ThemeColorKind::Palette16, 7 },
+        { "GrayDark", ThemeColorKind::Palette16, 8 },
+        { "RedLight", ThemeColorKind::Palette16, 9 },
+        { "GreenLight", ThemeColorKind::Palette16, 10 },
+        { "YellowLight", ThemeColorKind::Palette16, 11 },
+        { "BlueLight", ThemeColorKind::Palette16, 12 },
+        { "MagentaLight", ThemeColorKind::Palette16, 13 },
+        { "CyanLight", ThemeColorKind::Palette16, 14 },
+        { "White", ThemeColorKind::Palette16, 15 },
+        { "Blue1", ThemeColorKind::Palette256, 21 },
+        { "DeepSkyBlue1", ThemeColorKind::Palette256, 39 },
+        { "Green1", ThemeColorKind::Palette256, 46 },
+        { "Cyan1", ThemeColorKind::Palette256, 51 },
+        { "SkyBlue1", ThemeColorKind::Palette256, 117 },
+        { "LightSkyBlue1", ThemeColorKind::Palette256, 153 },
+        { "Red1", ThemeColorKind::Palette256, 196 },
+        { "Magenta1", ThemeColorKind::Palette256, 201 },
+        { "DarkOrange", ThemeColorKind::Palette256, 208 },
+        { "Orange1", ThemeColorKind::Palette256, 214 },
+        { "Gold1", ThemeColorKind::Palette256, 220 },
+        { "Yellow1", ThemeColorKind::Palette256, 226 },
+        { "Grey50", ThemeColorKind::Palette256, 244 },
+    };
+
+    struct RoleKey {
+        ThemeRole role;
+        std::string_view key;
+        uint8_t palette16;
+    };
+
+    // Keys of the theme file, with the colors the UI had before themes
+    constexpr RoleKey roleKeys[] = {
+        { ThemeRole::Error, "color.error", 9 },
+        { ThemeRole::CalendarOpened, "color.calendarOpened", 12 },
+        { ThemeRole::CalendarDiary, "color.calendarDiary", 3 },
+        { ThemeRole::TodosOpen, "color.todosOpen", 9 },
+        { ThemeRole::TodosDone, "color.todosDone", 10 },
+        { ThemeRole::CalendarPoints, "color.calendarPoints", 5 },
+        { ThemeRole::PointCompleted, "color.pointCompleted", 10 },
+        { ThemeRole::PointNotCompleted, "color.pointNotCompleted", 9 },
+        { ThemeRole::PointNotAdded, "color.pointNotAdded", 4 },
+        { ThemeRole::PointUpcoming, "color.pointUpcoming", 8 },
+        { ThemeRole::Save, "color.save", 2 },
+        { ThemeRole::Discard, "color.discard", 3 },
+        { ThemeRole::Exit, "color.exit", 1 },
+    };
+    static_assert(std::size(roleKeys) == themeRoleCount);
+
+    // xterm's values of the 16 basic colors
+    constexpr uint8_t palette16Rgb[16][3] = {
+        { 0, 0, 0 }, { 128, 0, 0 }, { 0, 128, 0 }, { 128, 128, 0 }, { 0, 0, 128 }, { 128, 0, 128 }, { 0, 128, 128 }, { 192, 192, 192 },
+        { 128, 128, 128 }, { 255, 0, 0 }, { 0, 255, 0 }, { 255, 255, 0 }, { 0, 0, 255 }, { 255, 0, 255 }, { 0, 255, 255 }, { 255, 255, 255 },
+    };
+
+    ThemeColor palette16(uint8_t index) {
+        return ThemeColor({ ThemeColorKind::Palette16, index, 0, 0, 0 });
+    }
+
+    std::string_view trim(std::string_view text) {
+        size_t first = text.find_first_not_of(" \t");
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    void rgbOf(const ThemeColor& color, int rgb[3]) {
+        if (color.kind == ThemeColorKind::Rgb) {
+            rgb[0] = color.red;
+            rgb[1] = color.green;
+            rgb[2] = color.blue;
+        } else if (color.index < 16) {
+            for (int channel = 0; channel < 3; channel++) {
+                rgb[channel] = palette16Rgb[color.index][channel];
+            }
+        } else if (color.index < 232) {
+            // The 6x6x6 color cube
+            constexpr int levels[6] = { 0, 95, 135, 175, 215, 255 };
+            int cube = color.index - 16;
+            rgb[0] = levels[cube / 36];
+            rgb[1] = levels[cube / 6 % 6];
+            rgb[2] = levels[cube % 6];
+        } else {
+            // The gray ramp
+            rgb[0] = rgb[1] = rgb[2] = 8 + 10 * (color.index - 232);
+        }
+    }
+}
+
+Theme ThemeFile::defaults() {
+    Theme theme;
+    theme.frame = {
+        ThemeColor({ ThemeColorKind::Palette256, 39, 0, 0, 0 }),
+        ThemeColor({ ThemeColorKind::Palette256, 153, 0, 0, 0 }),
+        ThemeColor({ ThemeColorKind::Palette256, 153, 0, 0, 0 }),
+        ThemeColor({ ThemeColorKind::Palette256, 39, 0, 0, 0 }),
+    };
+    for (const auto& roleKey : roleKeys) {
+        theme.colors[static_cast<size_t>(roleKey.role)] = palette16(roleKey.palette16);
+    }
+    return theme;
+}
+
+bool ThemeFile::parseColor(std::string_view text, ThemeColor *color) {
+    if (text == "default") {
+        *color = ThemeColor();
+        return true;
+    }
+
+    if (text.size() == 7 && text.front() == '#') {
+        uint8_t channels[3];
+        for (int channel = 0; channel < 3; channel++) {
+            const char *first = text.data() + 1 + channel * 2;
+            auto [end, error] = std::from_chars(first, first + 2, channels[channel], 16);
+            if (error != std::errc() || end != first + 2) {
+                return false;
+            }
+        }
+        *color = ThemeColor({ ThemeColorKind::Rgb, 0, channels[0], channels[1], channels[2] });
+        return true;
+    }
+
+    unsigned int index = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), index);
+    if (error == std::errc() && end == text.data() + text.size()) {
+        if (index > 255) {
+            return false;
+        }
+        *color = ThemeColor({ index < 16 ? ThemeColorKind::Palette16 : ThemeColorKind::Palette256, static_cast<uint8_t>(index), 0, 0, 0 });
+        return true;
+    }
+
+    for (const auto& named : namedColors) {
+        if (named.name == text) {
+            *color = ThemeColor({ named.kind, named.index, 0, 0, 0 });
+            return true;
+        }
+    }
+    return false;
+}
+
+ThemeColor ThemeFile::toPalette16(const ThemeColor& color) {
+    if (color.kind == ThemeColorKind::Default || color.kind == ThemeColorKind::Palette16) {
+        return color;
+    }
+
+    int rgb[3];
+    rgbOf(color, rgb);
+    uint8_t closest = 0;
+    int closestDistance = INT32_MAX;
+    for (uint8_t index = 0; index < 16; index++) {
+        int distance = 0;
+        for (int channel = 0; channel < 3; channel++) {
+            int difference = rgb[channel] - palette16Rgb[index][channel];
+            distance += difference * difference;
+        }
+        if (distance < closestDistance) {
+            closestDistance = distance;
+            closest = index;
+        }
+    }
+    return palette16(closest);
+}
+
+bool ThemeFile::parse(std::istream& source, Theme *theme, std::vector<std::string> *warnings, std::string *error) {
+    std::string line;
+    size_t lineNumber = 0;
+    auto fail = [&](const std::string& message) {
+        *error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(source, line)) {
+        lineNumber++;
+        std::string_view content = trim(line);
+        if (content.empty() || content.front() == '#') {
+            continue;
+        }
+
+        size_t separator = content.find('=');
+        if (separator == std::string_view::npos) {
+            return fail("expected key = value");
+        }
+        std::string_view key = trim(content.substr(0, separator));
+        std::string_view value = trim(content.substr(separator + 1));
+
+        if (key == "name") {
+            theme->name = value;
+        } else if (key == "profile") {
+            if (value == "full") {
+                theme->profile = ThemeProfile::Full;
+            } else if (value == "low-cost") {
+                theme->profile = ThemeProfile::LowCost;
+            } else {
+                return fail("unknown profile '" + std::string(value) + "' (expected full or low-cost)");
+            }
+        } else if (key == "frame") {
+            theme->frame.clear();
+            if (value == "none") {
+                continue;
+            }
+            size_t position = 0;
+            while (position < value.size()) {
+                size_t next = std::min(value.find(' ', position), value.size());
+                std::string_view name = value.substr(position, next - position);
+                position = next + 1;
+                if (name.empty()) {
+                    continue;
+                }
+                ThemeColor color;
+                if (!parseColor(name, &color)) {
+                    return fail("unknown color '" + std::string(name) + "'");
+                }
+                theme->frame.push_back(color);
+            }
+            if (theme->frame.size() > maxFrameColors) {
+                return fail("the frame has more than " + std::to_string(maxFrameColors) + " colors");
+            }
+        } else if (key == "frame.angle") {
+            auto [end, angleError] = std::from_chars(value.data(), value.data() + value.size(), theme->frameAngle);
+            if (angleError != std::errc() || end != value.data() + value.size()) {
+                return fail("'" + std::string(value) + "' is not an angle in degrees");
+            }
+        } else {
+            const RoleKey *roleKey = nullptr;
+            for (const auto& candidate : roleKeys) {
+                if (candidate.key == key) {
+                    roleKey = &candidate;
+                }
+            }
+            if (!roleKey) {
+                warnings->push_back("line " + std::to_string(lineNumber) + ": unknown key '" + std::string(key) + "'");
+                continue;
+            }
+            if (!parseColor(value, &theme->colors[static_cast<size_t>(roleKey->role)])) {
+                return fail("unknown color '" + std::string(value) + "'");
+            }
+        }
+    }
+
+    // Resolved here once, so the UI never has to tell the profiles apart
+    if (theme->profile == ThemeProfile::LowCost) {
+        for (auto& color : theme->colors) {
+            color = toPalette16(color);
+        }
+        if (theme->frame.size() > 1) {
+            theme->frame.resize(1);
+        }
+        for (auto& color : theme->frame) {
+            color = toPalette16(color);
+        }
+    }
+    return true;
+}
+
+bool ThemeFile::load(const std::string& path, Theme *theme, std::string *error) {
+    *theme = defaults();
+    std::ifstream file(path);
+    if (!file) {
+        return true;
+    }
+
+    std::vector<std::string> warnings;
+    if (!parse(file, theme, &warnings, error)) {
+        *theme = defaults();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,523 @@
+#include "../Headers/todoQuery.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Headers/batchCommands.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/dueDateIndex.h"
+#include "../Headers/fileDataOperations.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr long long minDateKey = std::numeric_limits<long long>::min();
+    constexpr long long maxDateKey = std::numeric_limits<long long>::max();
+
+    enum class TokenKind {
+        Word,
+        String,
+        Operator,
+        OpenParen,
+        CloseParen,
+        End
+    };
+
+    struct Token {
+        TokenKind kind;
+        std::string text;
+    };
+
+    std::string toLower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+        return text;
+    }
+
+    bool isOperatorCharacter(char c) {
+        return c == '<' || c == '>' || c == '=' || c == '!' || c == '~';
+    }
+
+    bool tokenize(const std::string& expression, std::vector<Token> *tokens, std::string *error) {
+        size_t i = 0;
+        while (i < expression.size()) {
+            char c = expression[i];
+
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                i++;
+            }
+            else if (c == '(' || c == ')') {
+                tokens->push_back({ c == '(' ? TokenKind::OpenParen : TokenKind::CloseParen, std::string(1, c) });
+                i++;
+            }
+            else if (c == '"' || c == '\'') {
+                size_t end = expression.find(c, i + 1);
+                if (end == std::string::npos) {
+                    *error = "Missing closing quote";
+                    return false;
+                }
+                tokens->push_back({ TokenKind::String, expression.substr(i + 1, end - i - 1) });
+                i = end + 1;
+            }
+            else if (isOperatorCharacter(c)) {
+                size_t length = (i + 1 < expression.size() && expression[i + 1] == '=' && c != '~') ? 2 : 1;
+                tokens->push_back({ TokenKind::Operator, expression.substr(i, length) });
+                i += length;
+            }
+            else {
+                size_t end = i;
+                while (end < expression.size() && !std::isspace(static_cast<unsigned char>(expression[end])) &&
+                       expression[end] != '(' && expression[end] != ')' && !isOperatorCharacter(expression[end])) {
+                    end++;
+                }
+                tokens->push_back({ TokenKind::Word, expression.substr(i, end - i) });
+                i = end;
+            }
+        }
+        tokens->push_back({ TokenKind::End, "" });
+        return true;
+    }
+
+    bool containsIgnoreCase(std::string_view haystack, const std::string& lowerNeedle) {
+        if (lowerNeedle.empty()) {
+            return true;
+        }
+        if (haystack.size() < lowerNeedle.size()) {
+            return false;
+        }
+
+        // Scan for the first character in both cases, and only compare the rest on a hit
+        const char lower = lowerNeedle[0];
+        const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(lower)));
+        const size_t last = haystack.size() - lowerNeedle.size();
+
+        for (size_t i = 0; i <= last; i++) {
+            if (haystack[i] != lower && haystack[i] != upper) {
+                continue;
+            }
+            size_t j = 1;
+            while (j < lowerNeedle.size() && std::tolower(static_cast<unsigned char>(haystack[i + j])) == lowerNeedle[j]) {
+                j++;
+            }
+            if (j == lowerNeedle.size()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool equalsIgnoreCase(std::string_view text, const std::string& lowerValue) {
+        return text.size() == lowerValue.size() && std::equal(text.begin(), text.end(), lowerValue.begin(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == b;
+        });
+    }
+
+    /**
+     * @brief Escapes line breaks, tabs and backslashes as \n, \t and \\, like the fields of batch records.
+     */
+    std::string escapeField(std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char character : text) {
+            switch (character) {
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                case '\\': escaped += "\\\\"; break;
+                default: escaped += character;
+            }
+        }
+        return escaped;
+    }
+
+    std::string_view nameWithoutDoneSuffix(const TodoData& todo) {
+        std::string_view name = todo.todoName;
+        if (FileDataOperations::isTodoDone(todo)) {
+            name.remove_suffix(std::char_traits<char>::length(FileDataOperations::doneSuffix));
+        }
+        return name;
+    }
+}
+
+/**
+ * @brief Recursive descent parser producing the nodes of a TodoQuery.
+ */
+class QueryParser {
+public:
+    QueryParser(std::vector<Token> tokens, TodoQuery *query) : tokens(std::move(tokens)), query(query) {};
+
+    bool parse(std::string *error) {
+        if (tokens.front().kind == TokenKind::End) {
+            query->root = -1;
+            return true;
+        }
+        query->root = parseOr();
+        if (query->root != -1 && peek().kind != TokenKind::End) {
+            fail("Unexpected '" + peek().text + "'");
+        }
+        if (!errorText.empty()) {
+            *error = errorText;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const Token& peek() const {
+        return tokens[position];
+    }
+
+    Token next() {
+        Token token = tokens[position];
+        if (token.kind != TokenKind::End) {
+            position++;
+        }
+        return token;
+    }
+
+    bool acceptWord(const char* word) {
+        if (peek().kind == TokenKind::Word && toLower(peek().text) == word) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    int fail(const std::string& message) {
+        if (errorText.empty()) {
+            errorText = message;
+        }
+        return -1;
+    }
+
+    int addNode(QueryNode node) {
+        query->nodes.push_back(std::move(node));
+        return static_cast<int>(query->nodes.size()) - 1;
+    }
+
+    int parseOr() {
+        int left = parseAnd();
+        while (left != -1 && acceptWord("or")) {
+            int right = parseAnd();
+            if (right == -1) return -1;
+            left = addNode({ .kind = QueryNodeKind::Or, .left = left, .right = right });
+        }
+        return left;
+    }
+
+    int parseAnd() {
+        int left = parseUnary();
+        while (left != -1 && acceptWord("and")) {
+            int right = parseUnary();
+            if (right == -1) return -1;
+            left = addNode({ .kind = QueryNodeKind::And, .left = left, .right = right });
+        }
+        return left;
+    }
+
+    int parseUnary() {
+        if (acceptWord("not")) {
+            int operand = parseUnary();
+            if (operand == -1) return -1;
+            return addNode({ .kind = QueryNodeKind::Not, .left = operand });
+        }
+        return parsePrimary();
+    }
+
+    int parsePrimary() {
+        if (peek().kind == TokenKind::OpenParen) {
+            next();
+            int inner = parseOr();
+            if (inner == -1) return -1;
+            if (next().kind != TokenKind::CloseParen) {
+                return fail("Missing ')'");
+            }
+            return inner;
+        }
+
+        Token fieldToken = next();
+        if (fieldToken.kind != TokenKind::Word) {
+            return fail(fieldToken.kind == TokenKind::End ? "Unexpected end of query" : "Expected a field, got '" + fieldToken.text + "'");
+        }
+
+        std::string field = toLower(fieldToken.text);
+        if (field == "done") {
+            return parseDone();
+        }
+        if (field == "due" || field == "created") {
+            return parseDateComparison(field == "due" ? QueryField::DueDate : QueryField::CreateDate);
+        }
+        if (field == "name" || field == "description") {
+            return parseTextComparison(field == "name" ? QueryField::Name : QueryField::Description);
+        }
+        return fail("Unknown field '" + fieldToken.text + "' (use due, created, name, description or done)");
+    }
+
+    bool parseOperator(QueryOperator *op) {
+        Token token = next();
+        if (token.kind != TokenKind::Operator) {
+            fail("Expected an operator, got '" + token.text + "'");
+            return false;
+        }
+        if (token.text == "<") *op = QueryOperator::Less;
+        else if (token.text == "<=") *op = QueryOperator::LessEqual;
+        else if (token.text == ">") *op = QueryOperator::Greater;
+        else if (token.text == ">=") *op = QueryOperator::GreaterEqual;
+        else if (token.text == "=" || token.text == "==") *op = QueryOperator::Equal;
+        else if (token.text == "!=") *op = QueryOperator::NotEqual;
+        else if (token.text == "~") *op = QueryOperator::Contains;
+        else {
+            fail("Unknown operator '" + token.text + "'");
+            return false;
+        }
+        return true;
+    }
+
+    int parseDone() {
+        if (peek().kind != TokenKind::Operator) {
+            return addNode({ .kind = QueryNodeKind::IsDone });
+        }
+
+        QueryOperator op;
+        if (!parseOperator(&op)) return -1;
+        if (op != QueryOperator::Equal && op != QueryOperator::NotEqual) {
+            return fail("done can only be compared with = or !=");
+        }
+
+        std::string value = toLower(next().text);
+        if (value != "true" && value != "false") {
+            return fail("done can only be compared with true or false");
+        }
+        bool negated = (value == "false") != (op == QueryOperator::NotEqual);
+        return addNode({ .kind = QueryNodeKind::IsDone, .negated = negated });
+    }
+
+    int parseDateComparison(QueryField field) {
+        QueryOperator op;
+        if (!parseOperator(&op)) return -1;
+        if (op == QueryOperator::Contains) {
+            return fail("Dates can not be compared with ~");
+        }
+
+        Token value = next();
+        std::string dateText = value.text;
+        bool hasTime = peek().kind == TokenKind::Word && peek().text.size() == 5 && peek().text[2] == ':';
+        if (hasTime) {
+            dateText += " " + next().text;
+        }
+
+        Date date;
+        if (!BatchCommands::parseDate(dateText, &date)) {
+            return fail("'" + dateText + "' is not a valid date (YYYY-MM-DD [HH:MM])");
+        }
+
+        // A date without a time stands for the whole day
+        long long first = DateUtils::dateKey(date);
+        long long last = hasTime ? first : first + 1439;
+
+        QueryNode node = { .kind = QueryNodeKind::DateRange, .field = field, .op = op, .minKey = minDateKey, .maxKey = maxDateKey };
+        switch (op) {
+            case QueryOperator::Less: node.maxKey = first - 1; break;
+            case QueryOperator::LessEqual: node.maxKey = last; break;
+            case QueryOperator::Greater: node.minKey = last + 1; break;
+            case QueryOperator::GreaterEqual: node.minKey = first; break;
+            case QueryOperator::NotEqual: node.negated = true; [[fallthrough]];
+            default: node.minKey = first; node.maxKey = last; break;
+        }
+        return addNode(std::move(node));
+    }
+
+    int parseTextComparison(QueryField field) {
+        QueryOperator op;
+        if (!parseOperator(&op)) return -1;
+        if (op != QueryOperator::Equal && op != QueryOperator::NotEqual && op != QueryOperator::Contains) {
+            return fail("Text can only be compared with =, != or ~");
+        }
+
+        Token value = next();
+        if (value.kind != TokenKind::Word && value.kind != TokenKind::String) {
+            return fail("Expected a text value, got '" + value.text + "'");
+        }
+        return addNode({ .kind = QueryNodeKind::Text, .field = field, .op = op, .negated = op == QueryOperator::NotEqual, .text = toLower(value.text) });
+    }
+
+    std::vector<Token> tokens;
+    size_t position = 0;
+    TodoQuery *query;
+    std::string errorText;
+};
+
+bool TodoQuery::compile(const std::string& expression, TodoQuery *query, std::string *error) {
+    std::vector<Token> tokens;
+    if (!tokenize(expression, &tokens, error)) {
+        return false;
+    }
+
+    TodoQuery compiled;
+    QueryParser parser(std::move(tokens), &compiled);
+    if (!parser.parse(error)) {
+        return false;
+    }
+
+    compiled.orderByCost();
+    compiled.planDueRange();
+    *query = std::move(compiled);
+    return true;
+}
+
+bool TodoQuery::empty() const {
+    return root == -1;
+}
+
+int TodoQuery::orderByCost(int index) {
+    if (index == -1) {
+        index = root;
+        if (index == -1) return 0;
+    }
+    QueryNode& node = nodes[index];
+
+    switch (node.kind) {
+        case QueryNodeKind::And:
+        case QueryNodeKind::Or: {
+            int leftCost = orderByCost(node.left);
+            int rightCost = orderByCost(node.right);
+            // Cheap conditions go first, so they short-circuit the expensive text searches
+            if (rightCost < leftCost) {
+                std::swap(node.left, node.right);
+            }
+            return leftCost + rightCost;
+        }
+        case QueryNodeKind::Not:
+            return orderByCost(node.left);
+        case QueryNodeKind::Text:
+            return 10;
+        default:
+            return 1;
+    }
+}
+
+void TodoQuery::planDueRange() {
+    hasDueRange = false;
+    dueMinKey = minDateKey;
+    dueMaxKey = maxDateKey;
+
+    // Due date ranges that every match has to satisfy are the ones joined by "and" from the root
+    std::vector<int> pending;
+    if (root != -1) {
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        const QueryNode& node = nodes[pending.back()];
+        pending.pop_back();
+
+        if (node.kind == QueryNodeKind::And) {
+            pending.push_back(node.left);
+            pending.push_back(node.right);
+        }
+        else if (node.kind == QueryNodeKind::DateRange && node.field == QueryField::DueDate && !node.negated) {
+            hasDueRange = true;
+            dueMinKey = std::max(dueMinKey, node.minKey);
+            dueMaxKey = std::min(dueMaxKey, node.maxKey);
+        }
+    }
+}
+
+bool TodoQuery::evaluate(int index, const TodoData& todo) const {
+    const QueryNode& node = nodes[index];
+
+    switch (node.kind) {
+        case QueryNodeKind::And:
+            return evaluate(node.left, todo) && evaluate(node.right, todo);
+        case QueryNodeKind::Or:
+            return evaluate(node.left, todo) || evaluate(node.right, todo);
+        case QueryNodeKind::Not:
+            return !evaluate(node.left, todo);
+        case QueryNodeKind::IsDone:
+            return FileDataOperations::isTodoDone(todo) != node.negated;
+        case QueryNodeKind::DateRange: {
+            long long key = DateUtils::dateKey(node.field == QueryField::DueDate ? todo.dueDate : todo.createDate);
+            return (key >= node.minKey && key <= node.maxKey) != node.negated;
+        }
+        case QueryNodeKind::Text: {
+            // The done suffix is state rather than part of the name, it is matched with the done field
+            std::string_view value = node.field == QueryField::Name ? nameWithoutDoneSuffix(todo) : std::string_view(todo.todoDescription);
+            if (node.op == QueryOperator::Contains) {
+                return containsIgnoreCase(value, node.text);
+            }
+            return equalsIgnoreCase(value, node.text) != node.negated;
+        }
+    }
+    return false;
+}
+
+bool TodoQuery::matches(const TodoData& todo) const {
+    return root == -1 || evaluate(root, todo);
+}
+
+std::vector<uint32_t> TodoQuery::run(const std::vector<TodoData>& todos, const DueDateIndex *index) const {
+    std::vector<uint32_t> positions;
+
+    if (hasDueRange && index && index->size() == todos.size()) {
+        if (dueMinKey > dueMaxKey) {
+            return positions;
+        }
+        auto [first, last] = index->range(dueMinKey, dueMaxKey);
+
+        // Jumping around the todos list costs more than reading it in order once the range is wide
+        if (static_cast<size_t>(last - first) * 8 < todos.size()) {
+            for (const DueDateEntry *entry = first; entry != last; entry++) {
+                if (evaluate(root, todos[entry->position])) {
+                    positions.push_back(entry->position);
+                }
+            }
+            std::sort(positions.begin(), positions.end());
+            return positions;
+        }
+    }
+
+    for (size_t i = 0; i < todos.size(); i++) {
+        if (matches(todos[i])) {
+            positions.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return positions;
+}
+
+std::vector<TodoData> TodoQuery::runOccurrences(const std::vector<TodoData>& todos, const RecurrenceIndex& recurrences, int today) const {
+    std::vector<TodoData> found;
+    if (recurrences.size() == 0) {
+        return found;
+    }
+
+    auto toDay = [](long long key) {
+        return static_cast<int>(key >= 0 ? key / 1440 : (key - 1439) / 1440);
+    };
+    int firstDay = today;
+    int lastDay = today + 6;
+    if (hasDueRange) {
+        if (dueMinKey > dueMaxKey) {
+            return found;
+        }
+        // Without a start every occurrence since the start of its todo is looked at
+        firstDay = dueMinKey == minDateKey ? std::numeric_limits<int>::min() : toDay(dueMinKey);
+        lastDay = dueMaxKey == maxDateKey ? today + 366 : toDay(dueMaxKey);
+    }
+
+    std::vector<Occurrence> occurrences;
+    recurrences.expand(firstDay, lastDay, &occurrences);
+    for (const auto& occurrence : occurrences) {
+        TodoData todo = Recurrence::occurrence(todos[occurrence.position], occurrence.day, occurrence.done);
+        if (matches(todo)) {
+            found.push_back(std::move(todo));
+        }
+    }
+    return found;
+}
+
+std::string TodoQuery::formatMatch(const TodoData& todo) {
+    bool done = FileDataOperations::isTodoDone(todo);
+    return std::to_string(todo.id) + '\t' + DateUtils::toString(todo.dueDate, true) + '\t' + (done ? "done" : "open") + '\t'
+        + escapeField(nameWithoutDoneSuffix(todo)) + '\t' + escapeField(todo.todoDescription);
+}
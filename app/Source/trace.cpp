@@ -0,0 +1,117 @@
+#include "../Headers/trace.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+    };
+
+    struct ThreadRing {
+        uint32_t thread = 0;
+        // Spans recorded so far, the ring holds the last ringSize of them
+        uint64_t recorded = 0;
+        std::array<TraceEvent, Trace::ringSize> events;
+    };
+
+    // The rings outlive their threads, so spans of finished threads are still written
+    std::mutex ringsMutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::string tracePath;
+    int64_t origin = 0;
+
+    ThreadRing& threadRing() {
+        thread_local ThreadRing *ring = nullptr;
+        if (!ring) [[unlikely]] {
+            std::lock_guard lock(ringsMutex);
+            rings.push_back(std::make_unique<ThreadRing>());
+            ring = rings.back().get();
+            ring->thread = static_cast<uint32_t>(rings.size());
+        }
+        return *ring;
+    }
+}
+
+void Trace::startFromEnvironment() {
+    const char* path = std::getenv("LOG4DAILY_TRACE");
+    if (path == nullptr || *path == '\0') {
+        return;
+    }
+    start(path);
+    std::atexit([] {
+        std::string error;
+        if (!finish(&error)) {
+            std::cerr << "The trace could not be written: " << error << std::endl;
+        }
+    });
+}
+
+void Trace::start(const std::string& path) {
+    tracePath = path;
+    origin = now();
+    enabled = true;
+}
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* name, int64_t begin, int64_t end) {
+    ThreadRing& ring = threadRing();
+    ring.events[ring.recorded % ringSize] = TraceEvent({ name, begin, end });
+    ring.recorded++;
+}
+
+bool Trace::finish(std::string *error) {
+    if (!enabled) {
+        return true;
+    }
+    enabled = false;
+
+    std::string temporary = tracePath + ".tmp";
+    {
+        std::ofstream trace(temporary, std::ios::trunc);
+        trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        char timing[64];
+
+        std::lock_guard lock(ringsMutex);
+        for (const auto& ring : rings) {
+            uint64_t count = std::min<uint64_t>(ring->recorded, ringSize);
+            for (uint64_t i = ring->recorded - count; i < ring->recorded; i++) {
+                const TraceEvent& event = ring->events[i % ringSize];
+                // Microseconds, as Chrome traces count them
+                std::snprintf(timing, sizeof(timing), "%.3f,\"dur\":%.3f", (event.begin - origin) / 1000.0, (event.end - event.begin) / 1000.0);
+                trace << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"log4daily\",\"ph\":\"X\",\"ts\":" << timing
+                    << ",\"pid\":1,\"tid\":" << ring->thread << "}";
+                first = false;
+            }
+        }
+        trace << "\n]}\n";
+        if (!trace) {
+            *error = "failed to write " + temporary;
+            return false;
+        }
+    }
+
+    std::error_code renameError;
+    std::filesystem::rename(temporary, tracePath, renameError);
+    if (renameError) {
+        *error = "failed to write " + tracePath + ": " + renameError.message();
+        return false;
+    }
+    return true;
+}
@@ -1,12 +1,24 @@
 #include "../Headers/uiRenderer.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 #include <functional>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
 
 // Log4daily components
 #include "../Headers/applicationManager.h"
+#include "../Headers/dateUtils.h"
+#include "../Headers/upcomingIndex.h"
+#include "../Headers/calendarIndex.h"
+#include "../Headers/language.h"
+#include "../Headers/memoryReport.h"
+#include "../Headers/trace.h"
 
 #include "../../l4dFiles/out/l4dFiles.hpp"
 
@@ -19,43 +31,37 @@
 
 // UI components
 #include "../Headers/Interface/todosComponent.h"
+#include "../Headers/Interface/upcomingComponent.h"
+#include "../Headers/Interface/calendarComponent.h"
 #include "../Headers/Interface/milestonesComponent.h"
 #include "../Headers/Interface/diaryComponent.h"
+#include "../Headers/Interface/historyComponent.h"
+#include "../Headers/Interface/mergeComponent.h"
 #include "../Headers/Interface/exitComponent.h"
+#include "../Headers/Interface/palette.h"
+#include "../Headers/Interface/eventRecorder.h"
 
 using namespace ftxui;
 
-uiRenderer::uiRenderer(ApplicationManager *_applicationManager) : inUseFileData(_applicationManager->getOpenedFile()) {
+uiRenderer::uiRenderer(ApplicationManager *_applicationManager) : screen(ScreenInteractive::Fullscreen()), inUseFileData(_applicationManager->getOpenedFile()) {
     applicationManager = _applicationManager;
     inUseFileDataBeforeSave = inUseFileData;
+    inUseChanges = applicationManager->getDocumentChanges();
+    Palette::use(applicationManager->getTheme());
 }
 
-int uiRenderer::renderUI(int isReload) {
-    int minHeight = 40;
-    int minWidth = 160;
+Component uiRenderer::buildComponents() {
+    constexpr int minHeight = 40;
+    constexpr int minWidth = 160;
 
-    auto screen = ScreenInteractive::Fullscreen();
-    screen_ptr = &screen;
-
-    std::vector<std::string> tabLabels{
-        "Todos", "Milestones", "Diary", "Exit"
+    tabLabels = {
+        Language::text("tab.todos"), Language::text("tab.upcoming"), Language::text("tab.calendar"),
+        Language::text("tab.milestones"), Language::text("tab.diary"), Language::text("tab.history"), Language::text("tab.merge"), Language::text("tab.memory"), Language::text("tab.exit")
     };
 
-    int selectedTab = 0;
     auto tabToggle = Toggle(&tabLabels, &selectedTab);
 
-    std::string notificationText = "";
-
-    if (isReload == 1) {
-        selectedTab = 3;
-        notificationText = "Changes has been discarded.";
-    }
-    else if (isReload == 2) {
-        selectedTab = 3;
-        notificationText = "Changes has been saved.";
-    }
-
-    auto centeredTabToggle = Renderer(tabToggle, [&tabToggle] {
+    auto centeredTabToggle = Renderer(tabToggle, [tabToggle] {
         return hbox({
             filler(),                
             tabToggle->Render(),    
@@ -63,16 +69,34 @@ int uiRenderer::renderUI(int isReload) {
         }) | center;            
     });
 
-    TodosComponent todosComponent;
-    MilestonesComponent milestonesComponent;
-    DiaryComponent diaryComponent;
     ExitComponent exitComponent;
 
+    upcomingIndex.rebuild(inUseFileData.todosData, DateUtils::dayNumber(DateUtils::today()));
+    todosComponent.setUpcomingIndex(&upcomingIndex);
+
+    calendarIndex.rebuild(inUseFileData);
+    todosComponent.setCalendarIndex(&calendarIndex);
+    milestonesComponent.setCalendarIndex(&calendarIndex);
+    diaryComponent.setCalendarIndex(&calendarIndex);
+
+    todosComponent.setDocumentChanges(&inUseChanges);
+    milestonesComponent.setDocumentChanges(&inUseChanges);
+    diaryComponent.setDocumentChanges(&inUseChanges);
+
     auto tabContainer = Container::Tab(
         {
             todosComponent.renderTodosComponent(&inUseFileData),
+            upcomingComponent.renderUpcomingComponent(&upcomingIndex, &inUseFileData),
+            calendarComponent.renderCalendarComponent(&calendarIndex, &inUseFileData),
             milestonesComponent.renderMilestonesComponent(&inUseFileData),
             diaryComponent.diaryComponent(&inUseFileData),
+            historyComponent.renderHistoryComponent(applicationManager->getHistoryPath()),
+            mergeComponent.renderMergeComponent(applicationManager->getConflictsPath(), &inUseFileData, [this] {
+                // A conflict resolved with their version replaces records the tabs did not mark
+                inUseChanges.markWhole();
+                refreshComponents();
+            }),
+            memoryComponent.renderMemoryComponent([this] { return measureMemory(); }, [this] { return compactMemory(); }),
             exitComponent.exitComponent(*this)
         },
         &selectedTab
@@ -83,26 +107,27 @@ int uiRenderer::renderUI(int isReload) {
         tabContainer,
     });
 
-    auto notification = ftxui::Renderer([&notificationText] {
-        if (notificationText.empty()) {
+    auto notification = ftxui::Renderer([this] {
+        if (notificationText.empty() || std::chrono::steady_clock::now() >= notificationExpiry) {
             return ftxui::text("");
         }
-        std::thread([&notificationText] {
-            std::this_thread::sleep_for(std::chrono::seconds(3));
-            notificationText = "";
-        }).detach();
         return ftxui::text(notificationText);
     });
 
 
-    auto content = [&]() -> Element {
-        if (screen.dimx() < minWidth || screen.dimy() < minHeight) {
+    auto content = [centeredTabToggle, tabContainer, notification, this]() -> Element {
+        int width = replaying ? replayWidth : screen.dimx();
+        int height = replaying ? replayHeight : screen.dimy();
+        if (!replaying) {
+            recorder.resize(width, height);
+        }
+        if (width < minWidth || height < minHeight) {
             return center(vbox({
                 text("Log4Daily") | bold | hcenter,
-                text("Minimal width: " + std::to_string(screen.dimx()) + " / " + std::to_string(minWidth)),
-                text("Minimal height: " + std::to_string(screen.dimy()) + " / " + std::to_string(minHeight)),
+                text(Language::text("ui.minimalWidth") + std::to_string(width) + " / " + std::to_string(minWidth)),
+                text(Language::text("ui.minimalHeight") + std::to_string(height) + " / " + std::to_string(minHeight)),
                 separator(),
-                text("Move mouse over app or expand the window to see the content."),
+                text(Language::text("ui.tooSmall")),
             })) | border;
         }
         return vbox({
@@ -114,36 +139,184 @@ int uiRenderer::renderUI(int isReload) {
             notification->Render() | hcenter,
             filler(),
         }) | border | size(WIDTH, EQUAL, 200) | size(HEIGHT, EQUAL, 50) | center \
-            | color(LinearGradient().Angle(45).Stop(Color::DeepSkyBlue1).Stop(Color::LightSkyBlue1).Stop(Color::LightSkyBlue1).Stop(Color::DeepSkyBlue1))
+            | Palette::frame
             | bgcolor(Color::Default);;
     };
 
-    auto renderer = Renderer(container, [&content] {
+    return Renderer(container, [content] {
+        TraceSpan span("uiRenderer::frame");
         return content();
     });
+}
+
+void uiRenderer::renderUI() {
+    Component renderer = buildComponents();
 
+    std::string recordError;
+    if (!recorder.startFromEnvironment(&recordError)) {
+        notify(Language::text("ui.recordFailed") + recordError);
+    }
+    if (recorder.active()) {
+        // Recorded before the components see the event, returning false lets them handle it
+        renderer = CatchEvent(renderer, [this](Event event) {
+            recorder.record(event);
+            return false;
+        });
+    }
+
+    startDayTick();
     screen.Loop(renderer);
-    return reloadUI;
+
+    dayTick.request_stop();
+    dayTick = std::jthread();
+}
+
+std::vector<ReplayedEvent> uiRenderer::replay(const std::vector<RecordedEvent>& events, int width, int height) {
+    replaying = true;
+    replayWidth = width;
+    replayHeight = height;
+    Component renderer = buildComponents();
+
+    auto renderFrame = [&renderer, this] {
+        Screen frame(replayWidth, replayHeight);
+        Render(frame, renderer->Render());
+    };
+    // Mouse events find their component by the boxes of the last frame
+    renderFrame();
+
+    std::vector<ReplayedEvent> replayed;
+    replayed.reserve(events.size());
+    for (size_t i = 0; i < events.size() && !exitRequested; i++) {
+        const RecordedEvent& event = events[i];
+        ReplayedEvent result;
+        result.index = i;
+
+        auto start = std::chrono::steady_clock::now();
+        if (event.kind == RecordedEventKind::Resize) {
+            replayWidth = event.width;
+            replayHeight = event.height;
+        } else {
+            result.handled = renderer->OnEvent(EventRecorder::toEvent(event));
+        }
+        auto handled = std::chrono::steady_clock::now();
+        renderFrame();
+        auto rendered = std::chrono::steady_clock::now();
+
+        result.handleMs = std::chrono::duration<double, std::milli>(handled - start).count();
+        result.renderMs = std::chrono::duration<double, std::milli>(rendered - handled).count();
+        replayed.push_back(result);
+    }
+    replaying = false;
+    return replayed;
+}
+
+FileData uiRenderer::getInUseFileData() {
+    return inUseFileData;
+}
+
+void uiRenderer::startDayTick() {
+    dayTick = std::jthread([this](std::stop_token stopToken) {
+        int day = DateUtils::dayNumber(DateUtils::today());
+        // Checked every minute rather than sleeping until midnight, so clock changes and suspend are caught too
+        auto nextDayCheck = std::chrono::steady_clock::now() + std::chrono::minutes(1);
+
+        std::unique_lock lock(tickMutex);
+        while (!stopToken.stop_requested()) {
+            auto deadline = std::min(nextDayCheck, notificationWakeUp);
+            // Woken up early by notify() when a notification expires before the deadline
+            tickWakeUp.wait_until(lock, stopToken, deadline, [this, deadline] { return notificationWakeUp < deadline; });
+            if (stopToken.stop_requested()) {
+                return;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            bool redraw = false;
+            if (now >= notificationWakeUp) {
+                notificationWakeUp = std::chrono::steady_clock::time_point::max();
+                redraw = true;
+            }
+            if (now >= nextDayCheck) {
+                nextDayCheck = now + std::chrono::minutes(1);
+                int today = DateUtils::dayNumber(DateUtils::today());
+                redraw = redraw || today != day;
+                day = today;
+            }
+            if (redraw) {
+                screen.PostEvent(Event::Custom);
+            }
+        }
+    });
+}
+
+void uiRenderer::refreshComponents() {
+    upcomingIndex.rebuild(inUseFileData.todosData, DateUtils::dayNumber(DateUtils::today()));
+    calendarIndex.rebuild(inUseFileData);
+    todosComponent.refreshData(&inUseFileData);
+    milestonesComponent.refreshData(&inUseFileData);
+    diaryComponent.refreshData(&inUseFileData);
+    memoryComponent.invalidate();
+}
+
+std::vector<MemoryRow> uiRenderer::measureMemory() {
+    std::vector<MemoryRow> rows = MemoryReport::document(inUseFileData);
+    // Every section of the copy kept for discarding changes, in one row
+    rows.push_back({ Language::text("memory.savedCopy"), MemoryReport::total(MemoryReport::document(inUseFileDataBeforeSave)), true });
+    rows.push_back({ Language::text("memory.todosList"), todosComponent.memoryUsage(), true });
+    rows.push_back({ Language::text("memory.milestonesList"), milestonesComponent.memoryUsage(), true });
+    rows.push_back({ Language::text("memory.diaryEntries"), diaryComponent.memoryUsage(), true });
+    return rows;
+}
+
+size_t uiRenderer::compactMemory() {
+    return MemoryReport::compact(&inUseFileData) + MemoryReport::compact(&inUseFileDataBeforeSave)
+        + todosComponent.compact() + milestonesComponent.compact() + diaryComponent.compact();
+}
+
+void uiRenderer::notify(const std::string& message) {
+    notificationText = message;
+    notificationExpiry = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+
+    // The day tick wakes the loop up once the notification expired, so it disappears without user input
+    {
+        std::lock_guard lock(tickMutex);
+        notificationWakeUp = notificationExpiry;
+    }
+    tickWakeUp.notify_one();
 }
 
 void uiRenderer::discardFileData() {
     inUseFileData = inUseFileDataBeforeSave;
+    inUseChanges.clear();
+    refreshComponents();
 
-    screen_ptr->Clear();
-    screen_ptr->ExitLoopClosure()();
-    reloadUI = 1;
+    notify(Language::text("ui.changesDiscarded"));
 }
 
 void uiRenderer::saveFileData() {
-    applicationManager->updateFileData(inUseFileData);
+    bool replaced = false;
+    std::string error;
+    if (!applicationManager->updateFileData(&inUseFileData, inUseChanges, &replaced, &error)) {
+        notify(Language::text("ui.changesNotSaved") + error);
+        return;
+    }
+    inUseChanges.clear();
+    inUseFileDataBeforeSave = inUseFileData;
+    // The daemon sent its document back, with the changes other clients made since it was opened
+    if (replaced) {
+        refreshComponents();
+    }
+    historyComponent.refreshData(applicationManager->getHistoryPath());
+    memoryComponent.invalidate();
 
-    screen_ptr->Clear();
-    screen_ptr->ExitLoopClosure()();
-    reloadUI = 2;
+    notify(Language::text("ui.changesSaved"));
 }
 
 void uiRenderer::exit() {
-    screen_ptr->Clear();
-    screen_ptr->ExitLoopClosure()();
-    reloadUI = 0;
+    // A replay has no loop to leave, it stops at the next event
+    if (replaying) {
+        exitRequested = true;
+        return;
+    }
+    screen.Clear();
+    screen.ExitLoopClosure()();
 }
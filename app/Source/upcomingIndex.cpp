@@ -0,0 +1,103 @@
+#include "../Headers/upcomingIndex.h"
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Headers/dateUtils.h"
+#include "../Headers/fileDataOperations.h"
+#include "../Headers/recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+void UpcomingIndex::rebuild(const std::vector<TodoData>& todos, int today) {
+    entries.clear();
+    keys.clear();
+    this->today = today;
+
+    for (const auto& todo : todos) {
+        update(todo);
+    }
+    changes++;
+}
+
+void UpcomingIndex::update(const TodoData& todo) {
+    remove(todo.id);
+    if (FileDataOperations::isTodoDone(todo)) {
+        return;
+    }
+
+    UpcomingEntry entry({todo.id, todo.dueDate, todo.todoName, false});
+    if (Recurrence::isRecurring(todo)) {
+        int day;
+        if (!Recurrence::nextOpenOccurrence(todo, today, &day)) {
+            return;
+        }
+        entry.dueDate = DateUtils::fromDayNumber(day);
+        entry.dueDate.hour = todo.dueDate.hour;
+        entry.dueDate.minute = todo.dueDate.minute;
+        entry.recurring = true;
+    }
+
+    std::pair<long long, int> key(DateUtils::dateKey(entry.dueDate), todo.id);
+    entries.emplace(key, std::move(entry));
+    keys[todo.id] = key;
+    changes++;
+}
+
+void UpcomingIndex::remove(int id) {
+    auto key = keys.find(id);
+    if (key == keys.end()) {
+        return;
+    }
+    entries.erase(key->second);
+    keys.erase(key);
+    changes++;
+}
+
+bool UpcomingIndex::rollOver(const std::vector<TodoData>& todos, int today) {
+    if (today == this->today) {
+        return false;
+    }
+    this->today = today;
+
+    // Only recurring todos move, every other todo keeps its due date and just falls into another bucket
+    for (const auto& todo : todos) {
+        if (Recurrence::isRecurring(todo)) {
+            update(todo);
+        }
+    }
+    changes++;
+    return true;
+}
+
+UpcomingIndex::Range UpcomingIndex::bucket(UpcomingBucket bucket) const {
+    auto dayStart = [this](int day) {
+        return entries.lower_bound(std::make_pair(static_cast<long long>(day) * 1440, std::numeric_limits<int>::min()));
+    };
+    int endOfWeek = today + 6 - DateUtils::weekday(today);
+
+    switch (bucket) {
+        case UpcomingBucket::Overdue:
+            return { entries.begin(), dayStart(today) };
+        case UpcomingBucket::Today:
+            return { dayStart(today), dayStart(today + 1) };
+        case UpcomingBucket::ThisWeek:
+            return { dayStart(today + 1), dayStart(endOfWeek + 1) };
+        default:
+            return { dayStart(endOfWeek + 1), entries.end() };
+    }
+}
+
+size_t UpcomingIndex::size() const {
+    return entries.size();
+}
+
+int UpcomingIndex::day() const {
+    return today;
+}
+
+uint64_t UpcomingIndex::version() const {
+    return changes;
+}
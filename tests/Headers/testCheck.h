@@ -0,0 +1,31 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <iostream>
+
+/**
+ * @brief Failed checks of the running test program, main returns non-zero when there are any.
+ */
+inline int testFailures = 0;
+
+/**
+ * @brief Prints the condition with its place when it is false, and goes on with the test.
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" << #condition << ") failed" << std::endl; \
+            testFailures++; \
+        } \
+    } while (false)
+
+inline int testResult(const char* name) {
+    if (testFailures > 0) {
+        std::cerr << name << ": " << testFailures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << name << ": all checks passed" << std::endl;
+    return 0;
+}
+
+#endif // TEST_CHECK_H
@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "../Headers/testCheck.h"
+#include "../../app/Headers/daemonProtocol.h"
+#include "../../app/Headers/documentChanges.h"
+
+namespace {
+    FileData sampleData() {
+        FileData data;
+        data.log4FileName = "sample";
+        data.calendarData = { Date({ 29, 2, 2024, 0, 0 }) };
+        data.todosData = { TodoData({ 1, Date({ 1, 10, 2026, 9, 5 }), Date({ 1, 11, 2026, 23, 59 }), "Deploy\tnow", "line one\nline two" }) };
+        data.milestonesData = { MilestonesData({ 2, Date({ 3, 1, 2026, 0, 0 }), "Run", "", { MilestoneProgressPoint({ Date({ 4, 1, 2026, 7, 0 }), true }) } }) };
+        data.diaryData = { DiaryData({ 3, Date({ 5, 1, 2026, 0, 0 }), "Monday", std::string("with a \0 byte", 13) }) };
+        return data;
+    }
+
+    void testPayloadRoundTrip() {
+        FileData data = sampleData();
+        PayloadWriter writer;
+        writer.u8(7);
+        writer.u64(UINT64_MAX);
+        writer.fileData(data);
+        writer.strings({ "", "a", std::string(70000, 'x') });
+
+        PayloadReader reader(writer.payload);
+        CHECK(reader.u8() == 7);
+        CHECK(reader.u64() == UINT64_MAX);
+        CHECK(reader.fileData() == data);
+        CHECK(reader.strings() == std::vector<std::string>({ "", "a", std::string(70000, 'x') }));
+        CHECK(reader.ok);
+    }
+
+    void testShortPayload() {
+        PayloadWriter writer;
+        writer.fileData(sampleData());
+
+        // A message cut anywhere reads as not ok, with no read outside it
+        for (size_t size = 0; size < writer.payload.size(); size++) {
+            PayloadReader reader(std::string_view(writer.payload).substr(0, size));
+            reader.fileData();
+            CHECK(!reader.ok);
+        }
+
+        // A string claiming more bytes than there are
+        PayloadWriter lying;
+        lying.u32(1000);
+        lying.payload += "abc";
+        PayloadReader reader(lying.payload);
+        CHECK(reader.string().empty());
+        CHECK(!reader.ok);
+        // Once not ok, later fields read as defaults
+        CHECK(reader.u32() == 0);
+    }
+
+    void testChanges() {
+        FileData data = sampleData();
+        DocumentChanges changes;
+        PayloadWriter whole;
+        whole.changes(data, changes);
+        PayloadReader wholeReader(whole.payload);
+        CHECK(wholeReader.u8() == 1);
+        CHECK(wholeReader.fileData() == data);
+
+        changes.clear();
+        data.todosData.push_back(TodoData({ 4, Date(), Date(), "new", "" }));
+        changes.added(DocumentSection::Todos, 4, data.todosData.size() - 1);
+        changes.changed(DocumentSection::Todos, 1, 0);
+        changes.removed(DocumentSection::Diary, 3);
+        // Added and removed before the save, so no other client ever sees it
+        changes.added(DocumentSection::Milestones, 9, 5);
+        changes.removed(DocumentSection::Milestones, 9);
+
+        PayloadWriter writer;
+        writer.changes(data, changes);
+        PayloadReader reader(writer.payload);
+        CHECK(reader.u8() == 0);
+        // Calendar
+        CHECK(reader.u32() == 0);
+        CHECK(reader.u32() == 0);
+        // Todos, in the order of the document
+        CHECK(reader.u32() == 2);
+        CHECK(reader.u8() == 0);
+        CHECK(reader.todo() == data.todosData[0]);
+        CHECK(reader.u8() == 1);
+        CHECK(reader.todo() == data.todosData[1]);
+        CHECK(reader.u32() == 0);
+        // Milestones
+        CHECK(reader.u32() == 0);
+        CHECK(reader.u32() == 0);
+        // Diary
+        CHECK(reader.u32() == 0);
+        CHECK(reader.u32() == 1);
+        CHECK(reader.u64() == 3);
+        CHECK(reader.ok);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    void testFrames() {
+        int sockets[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+
+        // Both sizes of frame: small ones go out in one send, large ones in two
+        for (const std::string& payload : { std::string(), std::string("ping"), std::string(100000, 'z') }) {
+            // A large frame may not fit the socket buffer, so it is written while this end reads
+            bool written = false;
+            std::thread writer([&] {
+                written = DaemonProtocol::writeFrame(sockets[0], 4, payload);
+            });
+            DaemonFrame frame;
+            bool read = DaemonProtocol::readFrame(sockets[1], &frame);
+            writer.join();
+            CHECK(written);
+            CHECK(read);
+            CHECK(frame.opcode == 4);
+            CHECK(frame.payload == payload);
+        }
+        close(sockets[0]);
+        close(sockets[1]);
+    }
+
+    // Writes raw bytes and closes the writing end, then reads one frame from the other
+    bool readRaw(const std::string& bytes, DaemonFrame *frame) {
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            return false;
+        }
+        bool sent = send(sockets[0], bytes.data(), bytes.size(), 0) == static_cast<ssize_t>(bytes.size());
+        close(sockets[0]);
+        bool read = DaemonProtocol::readFrame(sockets[1], frame);
+        close(sockets[1]);
+        return sent && read;
+    }
+
+    void testBrokenFrames() {
+        DaemonFrame frame;
+        // Nothing, and a header cut short
+        CHECK(!readRaw("", &frame));
+        CHECK(!readRaw(std::string("\x04\x00\x00", 3), &frame));
+        // A payload shorter than its header says
+        CHECK(!readRaw(std::string("\x0a\x00\x00\x00\x01" "abcd", 9), &frame));
+
+        // Larger than maxPayloadSize, refused from the header alone without allocating it
+        PayloadWriter oversized;
+        oversized.u32(DaemonProtocol::maxPayloadSize + 1);
+        oversized.u8(1);
+        CHECK(!readRaw(oversized.payload, &frame));
+        PayloadWriter largest;
+        largest.u32(UINT32_MAX);
+        largest.u8(1);
+        CHECK(!readRaw(largest.payload, &frame));
+
+        // Exactly one frame is read, the bytes after it are left for the next
+        CHECK(readRaw(std::string("\x02\x00\x00\x00\x05" "ok" "junk", 11), &frame));
+        CHECK(frame.opcode == 5);
+        CHECK(frame.payload == "ok");
+    }
+#endif
+}
+
+int main() {
+    testPayloadRoundTrip();
+    testShortPayload();
+    testChanges();
+#if defined(__unix__) || defined(__APPLE__)
+    testFrames();
+    testBrokenFrames();
+#endif
+    return testResult("daemonProtocol");
+}
@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Headers/testCheck.h"
+#include "../../app/Headers/diaryCodec.h"
+
+namespace {
+    // Deterministic bytes, so a failure is the same on every run
+    std::string noise(size_t size, uint32_t seed) {
+        std::string text(size, '\0');
+        for (auto& byte : text) {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<char>(seed >> 24);
+        }
+        return text;
+    }
+
+    std::string diaryText(size_t size) {
+        const std::string sentence = "Went for a walk by the river, then wrote the report and called home. ";
+        std::string text;
+        while (text.size() < size) {
+            text += sentence;
+            text += std::to_string(text.size() % 97);
+        }
+        text.resize(size);
+        return text;
+    }
+
+    void testRoundTrip() {
+        std::vector<std::string> texts = {
+            "",
+            "short entry",
+            diaryText(DiaryCodec::minCompressSize),
+            diaryText(5000),
+            std::string(DiaryCodec::blockSize * 2 + 17, 'a'),
+            diaryText(DiaryCodec::blockSize * 3 + 1),
+            noise(4000, 7),
+            diaryText(3000) + noise(2000, 11) + diaryText(3000)
+        };
+
+        for (const auto& text : texts) {
+            std::string stored = DiaryCodec::compress(text);
+            std::string decoded;
+            CHECK(DiaryCodec::decompress(stored, &decoded));
+            CHECK(decoded == text);
+            CHECK(DiaryCodec::text(stored) == text);
+            // Compressing only happens when it saves space
+            CHECK(stored.size() <= text.size());
+            // A body is never compressed twice
+            CHECK(DiaryCodec::compress(stored) == stored);
+        }
+
+        CHECK(!DiaryCodec::isCompressed(DiaryCodec::compress("short entry")));
+        CHECK(DiaryCodec::isCompressed(DiaryCodec::compress(diaryText(5000))));
+        // Random bytes do not get smaller and stay plain
+        CHECK(!DiaryCodec::isCompressed(DiaryCodec::compress(noise(4000, 3))));
+    }
+
+    void testBlockRoundTrip() {
+        for (const auto& block : { std::string("abcd"), std::string(1000, 'x'), diaryText(DiaryCodec::blockSize), noise(300, 5) }) {
+            std::string compressed = DiaryCodec::compressBlock(block);
+            std::string output = "kept";
+            CHECK(DiaryCodec::decompressBlock(compressed, block.size(), &output));
+            CHECK(output == "kept" + block);
+        }
+    }
+
+    void testTruncated() {
+        std::string text = diaryText(DiaryCodec::blockSize + 5000);
+        std::string stored = DiaryCodec::compress(text);
+        CHECK(DiaryCodec::isCompressed(stored));
+
+        // Every cut of the body after the marker is damaged, none of them may decode
+        for (size_t size = DiaryCodec::marker.size(); size < stored.size(); size++) {
+            std::string decoded;
+            CHECK(!DiaryCodec::decompress(std::string_view(stored).substr(0, size), &decoded));
+        }
+        // A damaged body is shown as it is stored instead of as text that is not the entry
+        CHECK(DiaryCodec::text(stored.substr(0, stored.size() - 4)) == stored.substr(0, stored.size() - 4));
+
+        std::string block = diaryText(2000);
+        std::string compressed = DiaryCodec::compressBlock(block);
+        for (size_t size = 0; size < compressed.size(); size++) {
+            // Only the empty literal run that ends a block ending in a match can go without losing bytes
+            std::string output;
+            if (DiaryCodec::decompressBlock(std::string_view(compressed).substr(0, size), block.size(), &output)) {
+                CHECK(size + 1 == compressed.size() && output == block);
+            }
+        }
+        std::string output;
+        CHECK(!DiaryCodec::decompressBlock(compressed, block.size() - 1, &output));
+        CHECK(!DiaryCodec::decompressBlock(compressed, block.size() + 1, &output));
+    }
+
+    void testCorrupted() {
+        std::string text = diaryText(6000);
+        std::string stored = DiaryCodec::compress(text);
+        std::string body = stored.substr(DiaryCodec::marker.size());
+
+        // Anything but base64 after the marker
+        std::string decoded;
+        CHECK(!DiaryCodec::decompress(std::string(DiaryCodec::marker) + "not base64!", &decoded));
+        CHECK(!DiaryCodec::decompress(std::string(DiaryCodec::marker) + "QUJD=A==", &decoded));
+
+        // Each character changed: the codec has no checksum, so this only asks that damage never decodes
+        // into text of another length or reads outside its input
+        for (size_t i = 0; i < body.size(); i++) {
+            std::string damaged = stored;
+            size_t position = DiaryCodec::marker.size() + i;
+            damaged[position] = damaged[position] == 'A' ? 'B' : 'A';
+            if (DiaryCodec::decompress(damaged, &decoded)) {
+                CHECK(decoded.size() == text.size());
+            }
+        }
+
+        // Back references before the start of the block, and of offset 0
+        std::string output;
+        CHECK(!DiaryCodec::decompressBlock(std::string("\x10" "a" "\x05\x00", 4), 5, &output));
+        CHECK(!DiaryCodec::decompressBlock(std::string("\x10" "a" "\x00\x00", 4), 5, &output));
+        // More literals than the block has
+        CHECK(!DiaryCodec::decompressBlock(std::string("\x50" "ab", 3), 5, &output));
+        // A literal length that runs past the input
+        CHECK(!DiaryCodec::decompressBlock(std::string("\xf0\xff", 2), 300, &output));
+        // A match that writes past the block size
+        CHECK(!DiaryCodec::decompressBlock(std::string("\x1f" "a" "\x01\x00" "\x10", 5), 10, &output));
+    }
+}
+
+int main() {
+    testRoundTrip();
+    testBlockRoundTrip();
+    testTruncated();
+    testCorrupted();
+    return testResult("diaryCodec");
+}
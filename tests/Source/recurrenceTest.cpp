@@ -0,0 +1,165 @@
+#include <string>
+#include <vector>
+
+#include "../Headers/testCheck.h"
+#include "../../app/Headers/dateUtils.h"
+#include "../../app/Headers/recurrence.h"
+
+namespace {
+    RecurrenceRule parsed(const std::string& text, int startDay) {
+        RecurrenceRule rule;
+        std::string error;
+        if (!Recurrence::parseRule(text, startDay, &rule, &error)) {
+            std::cerr << text << ": " << error << std::endl;
+        }
+        return rule;
+    }
+
+    // The occurrences on the days [firstDay, lastDay], as day numbers
+    std::vector<int> occurrenceDays(const RecurrenceRule& rule, int startDay, int firstDay, int lastDay) {
+        std::vector<int> days;
+        for (int day = firstDay; day <= lastDay; day++) {
+            if (Recurrence::isOccurrence(rule, startDay, day)) {
+                days.push_back(day);
+            }
+        }
+        return days;
+    }
+
+    TodoData recurringTodo(int id, Date due, const std::string& rule) {
+        TodoData todo({ id, Date({ 1, 1, 2024, 0, 0 }), due, "series " + std::to_string(id), "notes" });
+        Recurrence::setRule(&todo, parsed(rule, DateUtils::dayNumber(due)));
+        return todo;
+    }
+
+    void testMonthEnds() {
+        int start = DateUtils::dayNumber(2024, 1, 31);
+        RecurrenceRule rule = parsed("monthly", start);
+        CHECK(rule.kind == RecurrenceKind::Monthly);
+        CHECK(rule.monthDay == 31);
+
+        // The 31st moves to the last day of shorter months, once per month
+        CHECK(occurrenceDays(rule, start, DateUtils::dayNumber(2024, 2, 1), DateUtils::dayNumber(2024, 5, 31)) == std::vector<int>({
+            DateUtils::dayNumber(2024, 2, 29), DateUtils::dayNumber(2024, 3, 31),
+            DateUtils::dayNumber(2024, 4, 30), DateUtils::dayNumber(2024, 5, 31)
+        }));
+        CHECK(!Recurrence::isOccurrence(rule, start, DateUtils::dayNumber(2024, 3, 30)));
+        CHECK(Recurrence::isOccurrence(rule, start, DateUtils::dayNumber(2025, 2, 28)));
+        CHECK(Recurrence::isOccurrence(rule, start, DateUtils::dayNumber(2024, 12, 31)));
+
+        // A day of the month every month has is never moved
+        RecurrenceRule fifteenth = parsed("monthly 15", start);
+        CHECK(occurrenceDays(fifteenth, start, DateUtils::dayNumber(2024, 2, 1), DateUtils::dayNumber(2024, 3, 31)) == std::vector<int>({
+            DateUtils::dayNumber(2024, 2, 15), DateUtils::dayNumber(2024, 3, 15)
+        }));
+
+        // The 30th lands on February's last day, then on the 30th again
+        RecurrenceRule thirtieth = parsed("monthly 30", start);
+        CHECK(Recurrence::isOccurrence(thirtieth, start, DateUtils::dayNumber(2024, 2, 29)));
+        CHECK(Recurrence::isOccurrence(thirtieth, start, DateUtils::dayNumber(2025, 2, 28)));
+        CHECK(Recurrence::isOccurrence(thirtieth, start, DateUtils::dayNumber(2025, 3, 30)));
+        CHECK(!Recurrence::isOccurrence(thirtieth, start, DateUtils::dayNumber(2025, 3, 31)));
+    }
+
+    void testLeapDays() {
+        // Intervals count days, so they run through February 29th only in leap years
+        int leapStart = DateUtils::dayNumber(2024, 2, 27);
+        RecurrenceRule everyTwo = parsed("every 2 days", leapStart);
+        CHECK(occurrenceDays(everyTwo, leapStart, leapStart, DateUtils::dayNumber(2024, 3, 3)) == std::vector<int>({
+            leapStart, DateUtils::dayNumber(2024, 2, 29), DateUtils::dayNumber(2024, 3, 2)
+        }));
+        int plainStart = DateUtils::dayNumber(2023, 2, 27);
+        CHECK(occurrenceDays(everyTwo, plainStart, plainStart, DateUtils::dayNumber(2023, 3, 3)) == std::vector<int>({
+            plainStart, DateUtils::dayNumber(2023, 3, 1), DateUtils::dayNumber(2023, 3, 3)
+        }));
+
+        // A weekly series keeps its weekday across February 29th
+        int monday = DateUtils::dayNumber(2024, 2, 26);
+        CHECK(DateUtils::weekday(monday) == 0);
+        RecurrenceRule weekly = parsed("weekly", monday);
+        CHECK(occurrenceDays(weekly, monday, monday, DateUtils::dayNumber(2024, 3, 11)) == std::vector<int>({
+            monday, DateUtils::dayNumber(2024, 3, 4), DateUtils::dayNumber(2024, 3, 11)
+        }));
+        RecurrenceRule weekdays = parsed("weekly thu,fri", monday);
+        CHECK(occurrenceDays(weekdays, monday, monday, DateUtils::dayNumber(2024, 3, 3)) == std::vector<int>({
+            DateUtils::dayNumber(2024, 2, 29), DateUtils::dayNumber(2024, 3, 1)
+        }));
+
+        // A monthly series started on February 29th comes back on the 29th, and on the 28th in other years' Februaries
+        int leapDay = DateUtils::dayNumber(2024, 2, 29);
+        RecurrenceRule monthly = parsed("monthly", leapDay);
+        CHECK(monthly.monthDay == 29);
+        CHECK(Recurrence::isOccurrence(monthly, leapDay, DateUtils::dayNumber(2024, 3, 29)));
+        CHECK(Recurrence::isOccurrence(monthly, leapDay, DateUtils::dayNumber(2025, 2, 28)));
+        CHECK(Recurrence::isOccurrence(monthly, leapDay, DateUtils::dayNumber(2028, 2, 29)));
+        CHECK(!Recurrence::isOccurrence(monthly, leapDay, DateUtils::dayNumber(2028, 2, 28)));
+
+        // Nothing before the first occurrence
+        CHECK(!Recurrence::isOccurrence(monthly, leapDay, DateUtils::dayNumber(2024, 1, 29)));
+        CHECK(!Recurrence::isOccurrence(parsed("daily", leapDay), leapDay, leapDay - 1));
+    }
+
+    void testExpand() {
+        std::vector<TodoData> todos = {
+            TodoData({ 1, Date({ 1, 1, 2024, 0, 0 }), Date({ 1, 3, 2024, 0, 0 }), "plain", "" }),
+            recurringTodo(2, Date({ 27, 2, 2024, 9, 0 }), "daily"),
+            recurringTodo(3, Date({ 31, 1, 2024, 9, 0 }), "monthly")
+        };
+        int leapDay = DateUtils::dayNumber(2024, 2, 29);
+        CHECK(Recurrence::markOccurrenceDone(&todos[1], leapDay, true));
+        CHECK(!Recurrence::markOccurrenceDone(&todos[1], leapDay, true));
+        // Not an occurrence of the series
+        CHECK(!Recurrence::markOccurrenceDone(&todos[2], DateUtils::dayNumber(2024, 2, 28), true));
+        CHECK(Recurrence::description(todos[1]) == "notes");
+
+        RecurrenceIndex index;
+        index.rebuild(todos);
+        CHECK(index.size() == 2);
+        CHECK(!index.isSeries(0));
+        CHECK(index.isSeries(1));
+
+        std::vector<Occurrence> occurrences;
+        index.expand(DateUtils::dayNumber(2024, 2, 27), DateUtils::dayNumber(2024, 3, 1), &occurrences);
+        CHECK(occurrences.size() == 5);
+        if (occurrences.size() == 5) {
+            for (int i = 0; i < 4; i++) {
+                CHECK(occurrences[i].position == 1);
+                CHECK(occurrences[i].day == DateUtils::dayNumber(2024, 2, 27) + i);
+                CHECK(occurrences[i].done == (occurrences[i].day == leapDay));
+            }
+            CHECK(occurrences[4].position == 2);
+            CHECK(occurrences[4].day == leapDay);
+            CHECK(!occurrences[4].done);
+        }
+
+        int next = 0;
+        CHECK(Recurrence::nextOpenOccurrence(todos[1], leapDay, &next));
+        CHECK(next == DateUtils::dayNumber(2024, 3, 1));
+
+        TodoData occurrence = Recurrence::occurrence(todos[2], DateUtils::dayNumber(2024, 4, 30), false);
+        CHECK(occurrence.dueDate.day == 30);
+        CHECK(occurrence.dueDate.month == 4);
+        CHECK(occurrence.dueDate.hour == 9);
+    }
+
+    void testRules() {
+        int start = DateUtils::dayNumber(2024, 1, 31);
+        CHECK(Recurrence::formatRule(parsed("every 3 days", start)) == "every 3 days");
+        CHECK(parsed(Recurrence::formatRule(parsed("weekly mon,wed", start)), start) == parsed("weekly mon,wed", start));
+
+        for (const char* text : { "", "every 0 days", "every 3661 days", "every days", "monthly 0", "monthly 32", "weekly funday", "yearly" }) {
+            RecurrenceRule rule;
+            std::string error;
+            CHECK(!Recurrence::parseRule(text, start, &rule, &error));
+            CHECK(!error.empty());
+        }
+    }
+}
+
+int main() {
+    testMonthEnds();
+    testLeapDays();
+    testExpand();
+    testRules();
+    return testResult("recurrence");
+}
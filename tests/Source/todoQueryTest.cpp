@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Headers/testCheck.h"
+#include "../../app/Headers/dueDateIndex.h"
+#include "../../app/Headers/todoQuery.h"
+
+namespace {
+    TodoData todo(int id, const std::string& name, Date due) {
+        return TodoData({ id, Date({ 1, 1, 2026, 0, 0 }), due, name, "" });
+    }
+
+    // The ids of the todos the expression matches, checked to be the same with and without the due date index
+    std::vector<int> matching(const std::string& expression, const std::vector<TodoData>& todos) {
+        TodoQuery query;
+        std::string error;
+        if (!TodoQuery::compile(expression, &query, &error)) {
+            std::cerr << expression << ": " << error << std::endl;
+            return { -1 };
+        }
+
+        DueDateIndex index;
+        index.rebuild(todos);
+        std::vector<uint32_t> scanned = query.run(todos);
+        std::vector<uint32_t> indexed = query.run(todos, &index);
+        CHECK(scanned == indexed);
+
+        std::vector<int> ids;
+        for (uint32_t position : scanned) {
+            CHECK(query.matches(todos[position]));
+            ids.push_back(todos[position].id);
+        }
+        return ids;
+    }
+
+    void testPrecedence() {
+        std::vector<TodoData> todos = {
+            todo(1, "alpha (done)", Date({ 1, 11, 2026, 0, 0 })),
+            todo(2, "beta", Date({ 1, 11, 2026, 0, 0 })),
+            todo(3, "gamma", Date({ 1, 11, 2026, 0, 0 }))
+        };
+
+        // "and" binds tighter than "or"
+        CHECK(matching("name ~ gamma or name ~ beta and done", todos) == std::vector<int>({ 3 }));
+        CHECK(matching("name ~ beta and done or name ~ gamma", todos) == std::vector<int>({ 3 }));
+        CHECK(matching("(name ~ gamma or name ~ beta) and done", todos).empty());
+        CHECK(matching("(name ~ gamma or name ~ beta) and not done", todos) == std::vector<int>({ 2, 3 }));
+        // "not" binds tighter than "and"
+        CHECK(matching("not done and name ~ a", todos) == std::vector<int>({ 2, 3 }));
+        CHECK(matching("not (done and name ~ a)", todos) == std::vector<int>({ 2, 3 }));
+        CHECK(matching("not not done", todos) == std::vector<int>({ 1 }));
+        // Keywords are case insensitive, the done suffix is not part of the name
+        CHECK(matching("NAME ~ ALPHA AND DONE = true", todos) == std::vector<int>({ 1 }));
+        CHECK(matching("name ~ done", todos).empty());
+        CHECK(matching("name = alpha", todos) == std::vector<int>({ 1 }));
+        CHECK(matching("", todos) == std::vector<int>({ 1, 2, 3 }));
+    }
+
+    void testDateBoundaries() {
+        std::vector<TodoData> todos = {
+            todo(1, "last minute before", Date({ 31, 10, 2026, 23, 59 })),
+            todo(2, "first minute", Date({ 1, 11, 2026, 0, 0 })),
+            todo(3, "noon", Date({ 1, 11, 2026, 12, 30 })),
+            todo(4, "last minute", Date({ 1, 11, 2026, 23, 59 })),
+            todo(5, "first minute after", Date({ 2, 11, 2026, 0, 0 }))
+        };
+
+        // A date without a time is the whole day
+        CHECK(matching("due = 2026-11-01", todos) == std::vector<int>({ 2, 3, 4 }));
+        CHECK(matching("due != 2026-11-01", todos) == std::vector<int>({ 1, 5 }));
+        CHECK(matching("due < 2026-11-01", todos) == std::vector<int>({ 1 }));
+        CHECK(matching("due <= 2026-11-01", todos) == std::vector<int>({ 1, 2, 3, 4 }));
+        CHECK(matching("due > 2026-11-01", todos) == std::vector<int>({ 5 }));
+        CHECK(matching("due >= 2026-11-01", todos) == std::vector<int>({ 2, 3, 4, 5 }));
+        // With a time, only that minute
+        CHECK(matching("due = 2026-11-01 12:30", todos) == std::vector<int>({ 3 }));
+        CHECK(matching("due < 2026-11-01 12:30", todos) == std::vector<int>({ 1, 2 }));
+        CHECK(matching("due > 2026-11-01 12:30", todos) == std::vector<int>({ 4, 5 }));
+        CHECK(matching("due >= 2026-11-01 and due < 2026-11-02", todos) == std::vector<int>({ 2, 3, 4 }));
+        // Across a month and a year end
+        CHECK(matching("due > 2026-10-31 and due < 2026-11-02", todos) == std::vector<int>({ 2, 3, 4 }));
+        CHECK(matching("due >= 2026-12-31", todos).empty());
+        CHECK(matching("created = 2026-01-01", todos) == std::vector<int>({ 1, 2, 3, 4, 5 }));
+    }
+
+    void testInvalid() {
+        for (const char* expression : { "due <", "due ~ 2026-11-01", "due = 2026-13-01", "due = 2026-02-30", "due = 2026-11-01 24:00",
+                                        "name ~", "name < a", "(done", "done)", "done = maybe", "size > 3", "done and", "not" }) {
+            TodoQuery query;
+            std::string error;
+            CHECK(!TodoQuery::compile(expression, &query, &error));
+            CHECK(!error.empty());
+        }
+
+        // A leap day only exists in leap years
+        TodoQuery query;
+        std::string error;
+        CHECK(TodoQuery::compile("due = 2028-02-29", &query, &error));
+        CHECK(!TodoQuery::compile("due = 2027-02-29", &query, &error));
+    }
+
+    void testFormatMatch() {
+        TodoData escaped = todo(7, "tab\there (done)", Date({ 1, 11, 2026, 9, 0 }));
+        escaped.todoDescription = "line one\nline two \\ end";
+        std::string line = TodoQuery::formatMatch(escaped);
+        CHECK(line.find('\n') == std::string::npos);
+        CHECK(line.find("tab\\there") != std::string::npos);
+        CHECK(line.find("line one\\nline two \\\\ end") != std::string::npos);
+        CHECK(line.find("\tdone\t") != std::string::npos);
+    }
+}
+
+int main() {
+    testPrecedence();
+    testDateBoundaries();
+    testInvalid();
+    testFormatMatch();
+    return testResult("todoQuery");
+}
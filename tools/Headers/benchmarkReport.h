@@ -0,0 +1,74 @@
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Latency percentiles of a benchmark, in milliseconds.
+ */
+struct LatencySummary {
+    double min = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+    double mean = 0;
+};
+
+/**
+ * @brief Samples and context of one benchmark case.
+ */
+struct BenchmarkResult {
+    std::string name;
+    // "tmpfs", "disk" or "memory"
+    std::string storage;
+    // The size the data was generated for, and the size it took on storage
+    uint64_t nominalBytes = 0;
+    uint64_t fileBytes = 0;
+    // Bytes read or written by one iteration, used for the throughput
+    uint64_t bytesPerIteration = 0;
+    std::vector<double> samplesMs;
+    long peakRssKb = 0;
+};
+
+/**
+ * @class BenchmarkReport
+ * @brief Collects benchmark results and writes them as JSON, so runs can be compared by scripts.
+ */
+class BenchmarkReport {
+    public:
+        /**
+         * @brief Adds a string value to the top level "environment" object of the report.
+         */
+        void setEnvironment(const std::string& key, const std::string& value);
+        void add(BenchmarkResult result);
+        /**
+         * @brief Adds a top level member to the report, its value written as the already formatted JSON.
+         */
+        void addSection(const std::string& key, std::string json);
+        void writeJson(std::ostream& output) const;
+        /**
+         * @brief Writes the text as a JSON string, quoted and escaped.
+         */
+        static void writeString(std::ostream& output, const std::string& text);
+
+        static LatencySummary summarize(std::vector<double> samplesMs);
+        /**
+         * @brief Resets the peak resident set size of the process, where the system allows it.
+         *
+         * On Linux this clears VmHWM, so peakResidentKilobytes() reports the peak of one benchmark
+         * instead of the whole run.
+         */
+        static void resetPeakResident();
+        static long peakResidentKilobytes();
+    private:
+        std::vector<std::pair<std::string, std::string>> environment;
+        std::vector<BenchmarkResult> results;
+        std::vector<std::pair<std::string, std::string>> sections;
+};
+
+#endif // BENCHMARK_REPORT_H
@@ -0,0 +1,170 @@
+#ifndef WORKLOAD_GENERATOR_H
+#define WORKLOAD_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../app/Headers/applicationManager.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+/**
+ * @brief Small, fast pseudo random generator (SplitMix64) with a fixed output for a given seed.
+ */
+class SplitMix64 {
+    public:
+        explicit constexpr SplitMix64(uint64_t seed) : state(seed) {}
+
+        constexpr uint64_t next() {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+        /**
+         * @brief Returns a number in [0, bound).
+         */
+        constexpr uint64_t below(uint64_t bound) {
+            return bound == 0 ? 0 : next() % bound;
+        }
+        /**
+         * @brief Returns a number in [min, max].
+         */
+        constexpr int between(int min, int max) {
+            return min + static_cast<int>(below(static_cast<uint64_t>(max - min) + 1));
+        }
+        /**
+         * @brief Returns a number in [0, 1).
+         */
+        constexpr double unit() {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+        constexpr bool chance(double probability) {
+            return unit() < probability;
+        }
+    private:
+        uint64_t state;
+};
+
+/**
+ * @brief How the due dates of the generated todos are spread around the base day.
+ */
+enum class DueDistribution {
+    // Mostly the next two weeks, with some overdue and some far away todos
+    Mixed,
+    // Evenly over a year before and after the base day
+    Uniform,
+    // Piled on the last day of each month, like sprint or billing deadlines
+    Clustered
+};
+
+/**
+ * @brief Sizes and shape of a generated log4daily file.
+ */
+struct WorkloadOptions {
+    uint64_t seed = 1;
+    int todos = 1000;
+    DueDistribution dueDistribution = DueDistribution::Mixed;
+    int milestones = 10;
+    int progressYears = 2;
+    int diaryEntries = 365;
+    // Average number of words in a diary entry
+    int diaryWords = 250;
+    int calendarDays = 365;
+    // The day the generated data is relative to ("today" of the generated file)
+    Date baseDay = Date({1, 1, 2025, 0, 0});
+    unsigned threads = 1;
+};
+
+enum class TraceOperationKind {
+    AddTodo,
+    RemoveTodo,
+    MarkTodoDone,
+    AddProgressPoint,
+    AddDiaryEntry,
+    Save
+};
+
+/**
+ * @brief One step of a replayed operation trace.
+ *
+ * The target of an operation is picked from the data at replay time using pick,
+ * so the same trace applied to the same file always touches the same records.
+ */
+struct TraceOperation {
+    TraceOperationKind kind;
+    uint64_t pick;
+};
+
+/**
+ * @brief Time spent on one kind of operation during a replay.
+ */
+struct ReplayTiming {
+    size_t count = 0;
+    // Operations that had no effect, e.g. removing from an empty list
+    size_t rejected = 0;
+    double seconds = 0;
+};
+
+/**
+ * @class WorkloadGenerator
+ * @brief Generates production sized log4daily data for load testing.
+ *
+ * Every record list is generated in fixed size chunks, each with its own generator seeded from
+ * the seed and the chunk index. Chunks are spread over the worker threads, so the output only
+ * depends on the options and never on the number of threads or their timing.
+ */
+class WorkloadGenerator {
+    public:
+        explicit WorkloadGenerator(WorkloadOptions options);
+
+        /**
+         * @brief Generates the data of a log4daily file.
+         */
+        FileData generate(const std::string& log4FileName) const;
+        /**
+         * @brief Generates a mixed trace of operations, with a save after every saveEvery operations and at the end.
+         */
+        std::vector<TraceOperation> generateTrace(int operations, int saveEvery) const;
+        /**
+         * @brief Applies the trace to the file opened by the application manager, timing each kind of operation.
+         *
+         * Saves go through ApplicationManager::updateFileData, the same path the UI uses.
+         */
+        std::vector<ReplayTiming> replay(ApplicationManager *applicationManager, const std::vector<TraceOperation>& trace) const;
+
+        static const char* operationName(TraceOperationKind kind);
+        /**
+         * @brief Parses the name of a due date distribution ("mixed", "uniform" or "clustered").
+         */
+        static bool parseDueDistribution(const std::string& text, DueDistribution *distribution);
+    private:
+        enum class Stream : uint64_t {
+            Todos = 1,
+            Milestones,
+            Diary,
+            Calendar,
+            Trace,
+            Replay
+        };
+
+        SplitMix64 streamGenerator(Stream stream, uint64_t index) const;
+        /**
+         * @brief Calls generateChunk(begin, end, chunkIndex) for every chunk of count items on the worker threads.
+         */
+        template <typename Function>
+        void forEachChunk(size_t count, size_t chunkSize, Function generateChunk) const;
+
+        std::string sentence(SplitMix64& random, int words) const;
+        std::string diaryText(SplitMix64& random) const;
+        Date dueDate(SplitMix64& random) const;
+        TodoData todo(SplitMix64& random, int id) const;
+        MilestonesData milestone(SplitMix64& random, int id) const;
+        DiaryData diaryEntry(SplitMix64& random, int id) const;
+
+        WorkloadOptions options;
+        int baseDayNumber;
+};
+
+#endif // WORKLOAD_GENERATOR_H
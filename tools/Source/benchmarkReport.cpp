@@ -0,0 +1,144 @@
+#include "../Headers/benchmarkReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+void BenchmarkReport::setEnvironment(const std::string& key, const std::string& value) {
+    environment.emplace_back(key, value);
+}
+
+void BenchmarkReport::add(BenchmarkResult result) {
+    results.push_back(std::move(result));
+}
+
+void BenchmarkReport::addSection(const std::string& key, std::string json) {
+    sections.emplace_back(key, std::move(json));
+}
+
+LatencySummary BenchmarkReport::summarize(std::vector<double> samplesMs) {
+    LatencySummary summary;
+    if (samplesMs.empty()) {
+        return summary;
+    }
+
+    std::sort(samplesMs.begin(), samplesMs.end());
+
+    // Nearest rank percentile
+    auto percentile = [&samplesMs](double rank) {
+        size_t index = static_cast<size_t>(std::ceil(rank / 100 * samplesMs.size()));
+        return samplesMs[std::clamp<size_t>(index, 1, samplesMs.size()) - 1];
+    };
+
+    summary.min = samplesMs.front();
+    summary.p50 = percentile(50);
+    summary.p90 = percentile(90);
+    summary.p99 = percentile(99);
+    summary.max = samplesMs.back();
+    summary.mean = std::accumulate(samplesMs.begin(), samplesMs.end(), 0.0) / samplesMs.size();
+    return summary;
+}
+
+void BenchmarkReport::resetPeakResident() {
+#if defined(__linux__)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+long BenchmarkReport::peakResidentKilobytes() {
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmHWM:")) {
+            return std::stol(line.substr(6));
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+void BenchmarkReport::writeString(std::ostream& output, const std::string& text) {
+    output << '"';
+    for (char character : text) {
+        switch (character) {
+            case '"':
+                output << "\\\"";
+                break;
+            case '\\':
+                output << "\\\\";
+                break;
+            case '\n':
+                output << "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+                    output << escaped;
+                } else {
+                    output << character;
+                }
+        }
+    }
+    output << '"';
+}
+
+void BenchmarkReport::writeJson(std::ostream& output) const {
+    output << "{\n  \"environment\": {";
+    for (size_t i = 0; i < environment.size(); i++) {
+        output << (i > 0 ? ",\n    " : "\n    ");
+        writeString(output, environment[i].first);
+        output << ": ";
+        writeString(output, environment[i].second);
+    }
+    output << "\n  },\n  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& result = results[i];
+        LatencySummary latency = summarize(result.samplesMs);
+        double meanSeconds = latency.mean / 1000;
+
+        output << (i > 0 ? ",\n    {" : "\n    {");
+        output << "\"name\": ";
+        writeString(output, result.name);
+        output << ", \"storage\": ";
+        writeString(output, result.storage);
+        output << ", \"nominal_bytes\": " << result.nominalBytes;
+        output << ", \"file_bytes\": " << result.fileBytes;
+        output << ", \"iterations\": " << result.samplesMs.size();
+        output << ",\n     \"latency_ms\": {\"min\": " << latency.min << ", \"p50\": " << latency.p50 << ", \"p90\": " << latency.p90
+               << ", \"p99\": " << latency.p99 << ", \"max\": " << latency.max << ", \"mean\": " << latency.mean << "}";
+        output << ",\n     \"throughput_mib_s\": " << (meanSeconds > 0 ? result.bytesPerIteration / meanSeconds / (1024 * 1024) : 0);
+        output << ", \"ops_per_s\": " << (meanSeconds > 0 ? 1 / meanSeconds : 0);
+        output << ", \"peak_rss_kb\": " << result.peakRssKb << "}";
+    }
+    output << "\n  ]";
+
+    for (const auto& [key, json] : sections) {
+        output << ",\n  ";
+        writeString(output, key);
+        output << ": " << json;
+    }
+    output << "\n}\n";
+}
@@ -0,0 +1,550 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Headers/benchmarkReport.h"
+#include "../Headers/workloadGenerator.h"
+
+#include "../../app/Headers/applicationManager.h"
+#include "../../app/Headers/dateUtils.h"
+#include "../../app/Headers/diaryCodec.h"
+#include "../../app/Headers/inputHandlers.h"
+#include "../../app/Headers/language.h"
+#include "../../app/Headers/recurrence.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    struct Storage {
+        std::string name;
+        std::filesystem::path directory;
+    };
+
+    struct BenchOptions {
+        std::vector<uint64_t> sizes = { 1ULL << 10, 64ULL << 10, 1ULL << 20, 16ULL << 20, 128ULL << 20, 500ULL << 20 };
+        // 0 picks the number of iterations from the file size
+        int iterations = 0;
+        uint64_t seed = 1;
+        std::string tmpfsDirectory = "/dev/shm";
+        std::string diskDirectory = ".";
+        std::string output;
+        // Also time the file cases with compressed diary entries
+        bool diaryCodec = false;
+    };
+
+    void showHelp() {
+        std::cout << "Usage: l4d-bench [options]" << std::endl;
+        std::cout << "Times the log4daily storage path and console parsing, and prints the results as JSON." << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  --sizes                 [list]              File sizes, e.g. 1K,64K,1M,16M (default 1K,64K,1M,16M,128M,500M)" << std::endl;
+        std::cout << "  --iterations            [count]             Iterations of every case (default: fewer for larger files)" << std::endl;
+        std::cout << "  --seed                  [number]            Seed of the generated data (default 1)" << std::endl;
+        std::cout << "  --tmpfs-dir             [path]              Directory on tmpfs, empty to skip (default /dev/shm)" << std::endl;
+        std::cout << "  --disk-dir              [path]              Directory on disk, empty to skip (default .)" << std::endl;
+        std::cout << "  --output                [path]              Write the JSON report to a file instead of stdout" << std::endl;
+        std::cout << "  --diary-codec                               Also time the file cases with compressed diary entries" << std::endl;
+        std::cout << "  --help                                      Show this help message" << std::endl;
+    }
+
+    bool parseSize(std::string text, uint64_t *bytes) {
+        uint64_t multiplier = 1;
+        if (!text.empty()) {
+            switch (std::toupper(static_cast<unsigned char>(text.back()))) {
+                case 'K': multiplier = 1ULL << 10; break;
+                case 'M': multiplier = 1ULL << 20; break;
+                case 'G': multiplier = 1ULL << 30; break;
+                default: break;
+            }
+            if (multiplier != 1) {
+                text.pop_back();
+            }
+        }
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), *bytes);
+        *bytes *= multiplier;
+        return !text.empty() && error == std::errc() && end == text.data() + text.size() && *bytes > 0;
+    }
+
+    /**
+     * @brief Picks generator sizes so the stored file lands close to the requested size.
+     *
+     * Roughly 40% of the bytes go to diary text, 35% to todos and 25% to progress points,
+     * which is the mix of a file that has been used daily for a few years.
+     */
+    WorkloadOptions optionsForSize(uint64_t bytes, uint64_t seed) {
+        constexpr uint64_t diaryEntryBytes = 1700;
+        constexpr uint64_t todoBytes = 120;
+        constexpr uint64_t progressPointBytes = 20;
+        constexpr int progressYears = 2;
+
+        WorkloadOptions options;
+        options.seed = seed;
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        // The data ends yesterday, so registerToday always has a day to add
+        options.baseDay = DateUtils::fromDayNumber(DateUtils::dayNumber(DateUtils::today()) - 1);
+        options.todos = static_cast<int>(bytes * 35 / 100 / todoBytes);
+        options.diaryEntries = static_cast<int>(bytes * 40 / 100 / diaryEntryBytes);
+        options.progressYears = progressYears;
+        options.milestones = static_cast<int>(bytes * 25 / 100 / progressPointBytes / (progressYears * 365));
+        options.calendarDays = static_cast<int>(std::clamp<uint64_t>(bytes / 4096, 1, 3650));
+        return options;
+    }
+
+    int iterationsForSize(const BenchOptions& options, uint64_t bytes) {
+        if (options.iterations > 0) {
+            return options.iterations;
+        }
+        return static_cast<int>(std::clamp<uint64_t>((512ULL << 20) / bytes, 3, 50));
+    }
+
+    /**
+     * @brief Returns the size of every file the storage keeps for the log4daily file.
+     */
+    uint64_t storedBytes(const std::filesystem::path& directory, const std::string& name) {
+        uint64_t bytes = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().filename().string().starts_with(name)) {
+                bytes += entry.file_size();
+            }
+        }
+        return bytes;
+    }
+
+    template <typename Function>
+    double timeMs(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    BenchmarkResult newResult(const std::string& name, const Storage& storage, uint64_t nominalBytes) {
+        BenchmarkResult result;
+        result.name = name;
+        result.storage = storage.name;
+        result.nominalBytes = nominalBytes;
+        BenchmarkReport::resetPeakResident();
+        return result;
+    }
+
+    void finishResult(BenchmarkReport *report, BenchmarkResult result) {
+        result.peakRssKb = BenchmarkReport::peakResidentKilobytes();
+        LatencySummary latency = BenchmarkReport::summarize(result.samplesMs);
+        std::cerr << "  " << result.name << " [" << result.storage << "] p50 " << latency.p50 << " ms, p99 " << latency.p99 << " ms" << std::endl;
+        report->add(std::move(result));
+    }
+
+    /**
+     * @brief Times the file cases, the suffix tells variants of the same data apart in the report.
+     */
+    void benchmarkFile(BenchmarkReport *report, const Storage& storage, const std::string& configName, uint64_t nominalBytes, const FileData& data, int iterations, const std::string& suffix) {
+        std::string workingDirectory = storage.directory.string() + "/";
+        LocalStorage localStorage(workingDirectory + configName);
+        std::string name = data.log4FileName;
+
+        localStorage.createLog4DailyFile(workingDirectory, name, configName);
+        localStorage.updateDataToFile(workingDirectory, name, data);
+        uint64_t fileBytes = storedBytes(storage.directory, name);
+
+        BenchmarkResult save = newResult("updateDataToFile" + suffix, storage, nominalBytes);
+        for (int i = 0; i < iterations; i++) {
+            save.samplesMs.push_back(timeMs([&] { localStorage.updateDataToFile(workingDirectory, name, data); }));
+        }
+        save.fileBytes = save.bytesPerIteration = fileBytes;
+        finishResult(report, std::move(save));
+
+        BenchmarkResult open = newResult("openLog4DailyFile" + suffix, storage, nominalBytes);
+        for (int i = 0; i < iterations; i++) {
+            FileData opened;
+            open.samplesMs.push_back(timeMs([&] { opened = localStorage.openLog4DailyFile(workingDirectory, name); }));
+            if (i == 0 && opened.todosData.size() != data.todosData.size()) {
+                std::cerr << "  warning: opened " << opened.todosData.size() << " todo(s), saved " << data.todosData.size() << std::endl;
+            }
+        }
+        open.fileBytes = open.bytesPerIteration = fileBytes;
+        finishResult(report, std::move(open));
+
+        // Every iteration opens the file as it was generated, so registerToday always adds the day and saves
+        ApplicationManager applicationManager(workingDirectory, configName);
+        std::string openArgument = "--open";
+        std::string program = "l4d-bench";
+        char* openArgv[] = { program.data(), openArgument.data(), name.data() };
+
+        BenchmarkResult registerToday = newResult("registerToday" + suffix, storage, nominalBytes);
+        for (int i = 0; i < iterations; i++) {
+            if (applicationManager.run(3, openArgv) != CommandType::Open) {
+                std::cerr << "  warning: " << applicationManager.getRespondMessage() << std::endl;
+                break;
+            }
+            registerToday.samplesMs.push_back(timeMs([&] { applicationManager.registerToday(); }));
+            localStorage.updateDataToFile(workingDirectory, name, data);
+        }
+        registerToday.fileBytes = registerToday.bytesPerIteration = fileBytes;
+        finishResult(report, std::move(registerToday));
+
+        localStorage.deleteLog4DailyFile(workingDirectory, name, configName);
+    }
+
+    void benchmarkCreateDelete(BenchmarkReport *report, const Storage& storage, const std::string& configName) {
+        constexpr int iterations = 200;
+        std::string workingDirectory = storage.directory.string() + "/";
+        LocalStorage localStorage(workingDirectory + configName);
+
+        BenchmarkResult create = newResult("createLog4DailyFile", storage, 0);
+        BenchmarkResult remove = newResult("deleteLog4DailyFile", storage, 0);
+        for (int i = 0; i < iterations; i++) {
+            create.samplesMs.push_back(timeMs([&] { localStorage.createLog4DailyFile(workingDirectory, "bench-empty", configName); }));
+            remove.samplesMs.push_back(timeMs([&] { localStorage.deleteLog4DailyFile(workingDirectory, "bench-empty", configName); }));
+        }
+        finishResult(report, std::move(create));
+        finishResult(report, std::move(remove));
+    }
+
+    /**
+     * @brief Times the diary codec on the generated diary text, one block per call, in memory.
+     */
+    void benchmarkDiaryCodec(BenchmarkReport *report, const FileData& data, uint64_t nominalBytes) {
+        constexpr int samples = 20;
+        Storage memory({"memory", ""});
+
+        std::string text;
+        for (const auto& entry : data.diaryData) {
+            text += entry.diaryEntry;
+            text += '\n';
+            if (text.size() >= DiaryCodec::blockSize) {
+                break;
+            }
+        }
+        text.resize(std::min(text.size(), DiaryCodec::blockSize));
+        if (text.empty()) {
+            return;
+        }
+
+        std::string compressed = DiaryCodec::compressBlock(text);
+
+        BenchmarkResult compress = newResult("DiaryCodec::compressBlock", memory, nominalBytes);
+        for (int i = 0; i < samples; i++) {
+            compress.samplesMs.push_back(timeMs([&] { compressed = DiaryCodec::compressBlock(text); }));
+        }
+        compress.bytesPerIteration = text.size();
+        compress.fileBytes = compressed.size();
+        finishResult(report, std::move(compress));
+
+        BenchmarkResult decompress = newResult("DiaryCodec::decompressBlock", memory, nominalBytes);
+        std::string output;
+        for (int i = 0; i < samples; i++) {
+            output.clear();
+            decompress.samplesMs.push_back(timeMs([&] { DiaryCodec::decompressBlock(compressed, text.size(), &output); }));
+        }
+        if (output != text) {
+            std::cerr << "  warning: the decompressed block differs from the input" << std::endl;
+        }
+        decompress.bytesPerIteration = text.size();
+        decompress.fileBytes = compressed.size();
+        finishResult(report, std::move(decompress));
+    }
+
+    /**
+     * @brief Times expanding a year of occurrences of 500 recurring todos, each with a month of done occurrences.
+     */
+    void benchmarkRecurrence(BenchmarkReport *report) {
+        constexpr int series = 500;
+        constexpr int samples = 200;
+        constexpr const char* rules[] = { "daily", "every 3 days", "weekly mon,wed,fri", "weekly", "monthly 31" };
+        Storage memory({"memory", ""});
+
+        int firstDay = DateUtils::dayNumber(DateUtils::today().year, 1, 1);
+        int lastDay = DateUtils::dayNumber(DateUtils::today().year, 12, 31);
+
+        std::vector<TodoData> todos(series);
+        for (int i = 0; i < series; i++) {
+            TodoData& todo = todos[static_cast<size_t>(i)];
+            int startDay = firstDay + i % 28;
+            todo.id = i;
+            todo.dueDate = DateUtils::fromDayNumber(startDay);
+            todo.todoName = "Chore " + std::to_string(i);
+
+            RecurrenceRule rule;
+            std::string error;
+            Recurrence::parseRule(rules[i % std::size(rules)], startDay, &rule, &error);
+            Recurrence::setRule(&todo, rule);
+            for (int day = startDay; day < startDay + 30; day++) {
+                Recurrence::markOccurrenceDone(&todo, day, true);
+            }
+        }
+
+        RecurrenceIndex index;
+        BenchmarkResult rebuild = newResult("RecurrenceIndex::rebuild/500", memory, 0);
+        for (int i = 0; i < samples; i++) {
+            rebuild.samplesMs.push_back(timeMs([&] { index.rebuild(todos); }));
+        }
+        finishResult(report, std::move(rebuild));
+
+        std::vector<Occurrence> occurrences;
+        BenchmarkResult expand = newResult("RecurrenceIndex::expand/500-year", memory, 0);
+        for (int i = 0; i < samples; i++) {
+            occurrences.clear();
+            expand.samplesMs.push_back(timeMs([&] { index.expand(firstDay, lastDay, &occurrences); }));
+        }
+        expand.bytesPerIteration = occurrences.size() * sizeof(Occurrence);
+        finishResult(report, std::move(expand));
+    }
+
+    /**
+     * @brief Times loading a compiled language table, and the texts of the Todos tab built as literals and from the table.
+     */
+    void benchmarkLanguage(BenchmarkReport *report, const Storage& storage) {
+        constexpr int samples = 1000;
+        constexpr int framesPerSample = 100;
+        Storage memory({"memory", ""});
+
+        // Every key translated, longer than the English text like most translations
+        std::stringstream pack;
+        for (const auto& string : languageStrings) {
+            pack << string.key << " = \"" << string.text << " (translated)\"\n";
+        }
+        std::string tablePath = (storage.directory / Language::compiledFileName).string();
+        LanguagePackReport packReport;
+        std::string error;
+        if (!Language::compile(pack, tablePath, &packReport, &error)) {
+            std::cerr << "  warning: the language pack did not compile: " << error << std::endl;
+            return;
+        }
+
+        BenchmarkResult load = newResult("Language::load/" + std::to_string(languageStringCount), storage, 0);
+        load.fileBytes = std::filesystem::file_size(tablePath);
+        load.bytesPerIteration = load.fileBytes;
+        for (int i = 0; i < samples; i++) {
+            load.samplesMs.push_back(timeMs([&] { Language::load(tablePath, &error); }));
+        }
+        finishResult(report, std::move(load));
+
+        // The static texts of the Todos tab, FTXUI copies each into a std::string when it is rendered
+        constexpr const char* literals[] = {
+            "Todos list:", "Add Todo:", "Todo Title:", "Description:", "Due Date:", "Repeat:", "Add Todo",
+            "Remove Todo", "Mark Done", "Selected Todo: ", "Description: ", "Due Date: ", "Year", "Month", "Day",
+        };
+        constexpr StringId ids[] = {
+            "todos.list", "todos.addHeader", "todos.title", "todos.description", "todos.dueDate", "todos.repeat", "todos.add",
+            "todos.remove", "todos.markDone", "todos.selected", "todos.descriptionLabel", "todos.dueDateLabel", "date.year", "date.month", "date.day",
+        };
+        static_assert(std::size(literals) == std::size(ids));
+
+        size_t characters = 0;
+        auto benchmarkFrames = [&](const std::string& name, auto text) {
+            BenchmarkResult frames = newResult(name, memory, 0);
+            for (int i = 0; i < samples; i++) {
+                frames.samplesMs.push_back(timeMs([&] {
+                    for (int frame = 0; frame < framesPerSample; frame++) {
+                        for (size_t string = 0; string < std::size(ids); string++) {
+                            characters += text(string).size();
+                        }
+                    }
+                }) / framesPerSample);
+            }
+            finishResult(report, std::move(frames));
+        };
+        benchmarkFrames("todos-texts/literals", [&](size_t string) { return std::string(literals[string]); });
+        benchmarkFrames("todos-texts/language", [&](size_t string) { return std::string(Language::text(ids[string])); });
+
+        Language::useDefault();
+        if (characters == 0) {
+            std::cerr << "  warning: no texts built" << std::endl;
+        }
+    }
+
+    void benchmarkParsing(BenchmarkReport *report) {
+        // Single calls are too short for the clock, so every sample times a batch of calls and keeps the average
+        constexpr int samples = 1000;
+        constexpr int callsPerSample = 100;
+        Storage memory({"memory", ""});
+
+        auto benchmarkArguments = [&](const std::string& name, std::vector<std::string> arguments) {
+            std::vector<char*> argv;
+            for (auto& argument : arguments) {
+                argv.push_back(argument.data());
+            }
+            int argc = static_cast<int>(argv.size());
+
+            BenchmarkResult parse = newResult("parseConsoleInputs/" + name, memory, 0);
+            size_t commands = 0;
+            for (int i = 0; i < samples; i++) {
+                parse.samplesMs.push_back(timeMs([&] {
+                    for (int call = 0; call < callsPerSample; call++) {
+                        commands += InputHandlers::parseConsoleInputs(argc, argv.data()).size();
+                    }
+                }) / callsPerSample);
+            }
+            finishResult(report, std::move(parse));
+
+            std::vector<Command> parsed = InputHandlers::parseConsoleInputs(argc, argv.data());
+            BenchmarkResult filter = newResult("filterForSupportedCommands/" + name, memory, 0);
+            for (int i = 0; i < samples; i++) {
+                filter.samplesMs.push_back(timeMs([&] {
+                    for (int call = 0; call < callsPerSample; call++) {
+                        commands += InputHandlers::filterForSupportedCommands(parsed).size();
+                    }
+                }) / callsPerSample);
+            }
+            finishResult(report, std::move(filter));
+
+            if (commands == 0) {
+                std::cerr << "  warning: no commands parsed for " << name << std::endl;
+            }
+        };
+
+        benchmarkArguments("open", { "log4daily", "--open", "daily" });
+
+        std::vector<std::string> records = { "log4daily", "--add-todo", "daily" };
+        for (int i = 0; i < 1000; i++) {
+            records.push_back("Todo " + std::to_string(i) + "\tdescription\t2025-01-01 12:00");
+        }
+        benchmarkArguments("add-todo-1000", records);
+
+        std::vector<std::string> mixed = { "log4daily" };
+        for (int i = 0; i < 16; i++) {
+            mixed.push_back(i % 2 == 0 ? "--unknown-" + std::to_string(i) : std::string(supportedCommands[static_cast<size_t>(i) % supportedCommands.size()]));
+            mixed.push_back("argument");
+        }
+        benchmarkArguments("mixed-16", mixed);
+    }
+}
+
+/**
+ * @brief Benchmarks the storage path on tmpfs and disk and writes the results as JSON.
+ */
+int main(int argc, char** argv) {
+    BenchOptions options;
+
+    for (const auto& command : InputHandlers::parseConsoleInputs(argc, argv)) {
+        bool valid = true;
+
+        if (command.name == "--sizes") {
+            options.sizes.clear();
+            std::string list = command.argument;
+            for (size_t start = 0; valid && start <= list.size();) {
+                size_t end = std::min(list.find(',', start), list.size());
+                uint64_t bytes = 0;
+                valid = parseSize(list.substr(start, end - start), &bytes);
+                options.sizes.push_back(bytes);
+                start = end + 1;
+            }
+        } else if (command.name == "--iterations") {
+            auto [end, error] = std::from_chars(command.argument.data(), command.argument.data() + command.argument.size(), options.iterations);
+            valid = error == std::errc() && end == command.argument.data() + command.argument.size() && options.iterations > 0;
+        } else if (command.name == "--seed") {
+            auto [end, error] = std::from_chars(command.argument.data(), command.argument.data() + command.argument.size(), options.seed);
+            valid = error == std::errc() && end == command.argument.data() + command.argument.size();
+        } else if (command.name == "--tmpfs-dir") {
+            options.tmpfsDirectory = command.argument;
+        } else if (command.name == "--disk-dir") {
+            options.diskDirectory = command.argument;
+        } else if (command.name == "--output") {
+            options.output = command.argument;
+        } else if (command.name == "--diary-codec") {
+            options.diaryCodec = true;
+        } else if (command.name == "--help") {
+            showHelp();
+            return 0;
+        } else {
+            std::cerr << "Unsupported option: " << command.name << std::endl;
+            return 1;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value for " << command.name << ": \"" << command.argument << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    // Every storage gets its own scratch directory with its own config file, removed at the end
+    ManageConfig manageConfig;
+    std::string configName = manageConfig.configFileName.empty() ? "config" : manageConfig.configFileName;
+    std::string scratchName = "l4d-bench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    std::vector<Storage> storages;
+    for (const auto& [storageName, directory] : { std::pair{"tmpfs", options.tmpfsDirectory}, std::pair{"disk", options.diskDirectory} }) {
+        std::error_code error;
+        if (directory.empty() || !std::filesystem::is_directory(directory, error)) {
+            std::cerr << "Skipping " << storageName << " (no directory)" << std::endl;
+            continue;
+        }
+        std::filesystem::path scratch = std::filesystem::path(directory) / scratchName;
+        if (!std::filesystem::create_directory(scratch, error)) {
+            std::cerr << "Skipping " << storageName << " (cannot create " << scratch << ")" << std::endl;
+            continue;
+        }
+        std::ofstream(scratch / configName, std::ios::app);
+        storages.push_back(Storage({storageName, scratch}));
+    }
+
+    BenchmarkReport report;
+    report.setEnvironment("tool", "l4d-bench");
+    report.setEnvironment("date", DateUtils::toString(DateUtils::now(), true));
+    report.setEnvironment("seed", std::to_string(options.seed));
+    report.setEnvironment("hardware_threads", std::to_string(std::thread::hardware_concurrency()));
+    for (const auto& storage : storages) {
+        report.setEnvironment(storage.name + "_directory", storage.directory.string());
+    }
+
+    std::cerr << "Console parsing" << std::endl;
+    benchmarkParsing(&report);
+
+    std::cerr << "Recurring todos" << std::endl;
+    benchmarkRecurrence(&report);
+
+    if (!storages.empty()) {
+        std::cerr << "Language table" << std::endl;
+        benchmarkLanguage(&report, storages.front());
+    }
+
+    for (const auto& storage : storages) {
+        std::cerr << "Create and delete on " << storage.name << std::endl;
+        benchmarkCreateDelete(&report, storage, configName);
+    }
+
+    for (uint64_t size : options.sizes) {
+        FileData data = WorkloadGenerator(optionsForSize(size, options.seed)).generate("bench-" + std::to_string(size));
+        int iterations = iterationsForSize(options, size);
+
+        std::cerr << "Diary codec on the text of the " << size << " byte file" << std::endl;
+        benchmarkDiaryCodec(&report, data, size);
+
+        for (const auto& storage : storages) {
+            std::cerr << "File of " << size << " bytes on " << storage.name << ", " << iterations << " iteration(s)" << std::endl;
+            benchmarkFile(&report, storage, configName, size, data, iterations, "");
+        }
+
+        if (options.diaryCodec) {
+            FileData compressed = data;
+            DiaryCodec::compressEntries(&compressed);
+            for (const auto& storage : storages) {
+                std::cerr << "File of " << size << " bytes with compressed diary entries on " << storage.name << std::endl;
+                benchmarkFile(&report, storage, configName, size, compressed, iterations, "/compressed-diary");
+            }
+        }
+    }
+
+    for (const auto& storage : storages) {
+        std::error_code error;
+        std::filesystem::remove_all(storage.directory, error);
+    }
+
+    if (options.output.empty()) {
+        report.writeJson(std::cout);
+    } else {
+        std::ofstream output(options.output);
+        report.writeJson(output);
+        if (!output) {
+            std::cerr << "Failed to write " << options.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
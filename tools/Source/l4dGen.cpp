@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Headers/workloadGenerator.h"
+
+#include "../../app/Headers/applicationManager.h"
+#include "../../app/Headers/batchCommands.h"
+#include "../../app/Headers/dateUtils.h"
+#include "../../app/Headers/inputHandlers.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    void showHelp() {
+        std::cout << "Usage: l4d-gen [log4_file_name] [options]" << std::endl;
+        std::cout << "Writes a synthetic log4daily file through the same storage as log4daily, for load testing." << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  --seed                  [number]            Seed of the generated data (default 1)" << std::endl;
+        std::cout << "  --todos                 [count]             Number of todos (default 1000)" << std::endl;
+        std::cout << "  --due-distribution      [name]              mixed, uniform or clustered (default mixed)" << std::endl;
+        std::cout << "  --milestones            [count]             Number of milestones (default 10)" << std::endl;
+        std::cout << "  --progress-years        [years]             Years of daily progress points per milestone (default 2)" << std::endl;
+        std::cout << "  --diary                 [count]             Number of diary entries, one a day (default 365)" << std::endl;
+        std::cout << "  --diary-words           [count]             Average words in a diary entry (default 250)" << std::endl;
+        std::cout << "  --calendar-days         [count]             Number of registered calendar days (default 365)" << std::endl;
+        std::cout << "  --today                 [YYYY-MM-DD]        Day the data is generated around (default today)" << std::endl;
+        std::cout << "  --threads               [count]             Generator threads (default: all cores)" << std::endl;
+        std::cout << "  --trace                 [count]             Replay a mixed trace of this many operations after writing" << std::endl;
+        std::cout << "  --save-every            [count]             Operations between saves in the trace (default 100)" << std::endl;
+        std::cout << "  --force                                     Overwrite the file if it already exists" << std::endl;
+        std::cout << "  --help                                      Show this help message" << std::endl;
+        std::cout << "Note: the same options and seed always produce the same file, whatever the number of threads." << std::endl;
+    }
+
+    bool parseNumber(const Command& command, int minimum, int *value) {
+        const std::string& text = command.argument;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), *value);
+        if (text.empty() || error != std::errc() || end != text.data() + text.size() || *value < minimum) {
+            std::cerr << "Invalid value for " << command.name << ": \"" << text << "\"" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+/**
+ * @brief Generates a synthetic log4daily file and optionally replays an operation trace on it.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        showHelp();
+        return argc < 2 ? 1 : 0;
+    }
+    std::string fileName = argv[1];
+
+    WorkloadOptions options;
+    options.baseDay = DateUtils::today();
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    int traceOperations = 0;
+    int saveEvery = 100;
+    bool force = false;
+
+    for (const auto& command : InputHandlers::parseConsoleInputs(argc, argv)) {
+        int value = 0;
+        bool valid = true;
+
+        if (command.name == "--seed") {
+            auto [end, error] = std::from_chars(command.argument.data(), command.argument.data() + command.argument.size(), options.seed);
+            valid = !command.argument.empty() && error == std::errc() && end == command.argument.data() + command.argument.size();
+            if (!valid) {
+                std::cerr << "Invalid value for --seed: \"" << command.argument << "\"" << std::endl;
+            }
+        } else if (command.name == "--todos") {
+            valid = parseNumber(command, 0, &options.todos);
+        } else if (command.name == "--due-distribution") {
+            valid = WorkloadGenerator::parseDueDistribution(command.argument, &options.dueDistribution);
+            if (!valid) {
+                std::cerr << "Unknown due date distribution: \"" << command.argument << "\"" << std::endl;
+            }
+        } else if (command.name == "--milestones") {
+            valid = parseNumber(command, 0, &options.milestones);
+        } else if (command.name == "--progress-years") {
+            valid = parseNumber(command, 0, &options.progressYears);
+        } else if (command.name == "--diary") {
+            valid = parseNumber(command, 0, &options.diaryEntries);
+        } else if (command.name == "--diary-words") {
+            valid = parseNumber(command, 1, &options.diaryWords);
+        } else if (command.name == "--calendar-days") {
+            valid = parseNumber(command, 0, &options.calendarDays);
+        } else if (command.name == "--today") {
+            valid = BatchCommands::parseDate(command.argument, &options.baseDay);
+            if (!valid) {
+                std::cerr << "Invalid value for --today: \"" << command.argument << "\"" << std::endl;
+            }
+        } else if (command.name == "--threads") {
+            valid = parseNumber(command, 1, &value);
+            options.threads = static_cast<unsigned>(value);
+        } else if (command.name == "--trace") {
+            valid = parseNumber(command, 0, &traceOperations);
+        } else if (command.name == "--save-every") {
+            valid = parseNumber(command, 0, &saveEvery);
+        } else if (command.name == "--force") {
+            force = true;
+        } else if (command.name == "--help") {
+            showHelp();
+            return 0;
+        } else {
+            std::cerr << "Unsupported option: " << command.name << std::endl;
+            valid = false;
+        }
+
+        if (!valid) {
+            return 1;
+        }
+    }
+
+    ManageConfig manageConfig;
+    if (manageConfig.prepareConfigFile() == ConfigFolderStatus::FOLDER_ERROR) {
+        std::cerr << "Problem acured while creating config folder" << std::endl;
+        return 1;
+    }
+    std::string workingDirectory = manageConfig.getSystemConfiguration().configPath + "/";
+    LocalStorage localStorage(workingDirectory + manageConfig.configFileName);
+
+    if (!localStorage.createLog4DailyFile(workingDirectory, fileName, manageConfig.configFileName) && !force) {
+        std::cerr << "Failed to create log4daily file. (maybe it already exists? use --force to overwrite it)" << std::endl;
+        return 1;
+    }
+
+    WorkloadGenerator generator(options);
+
+    auto start = std::chrono::steady_clock::now();
+    FileData data = generator.generate(fileName);
+    double generateSeconds = secondsSince(start);
+
+    size_t progressPoints = 0;
+    for (const auto& milestone : data.milestonesData) {
+        progressPoints += milestone.progressPoints.size();
+    }
+    size_t diaryBytes = 0;
+    for (const auto& entry : data.diaryData) {
+        diaryBytes += entry.diaryEntry.size();
+    }
+
+    std::cout << "Generated " << data.todosData.size() << " todo(s), " << data.milestonesData.size() << " milestone(s) with "
+              << progressPoints << " progress point(s), " << data.diaryData.size() << " diary entr(ies) with "
+              << diaryBytes / 1024 << " KiB of text and " << data.calendarData.size() << " calendar day(s) around "
+              << DateUtils::toString(options.baseDay) << " (seed " << options.seed << ") in " << generateSeconds << " s on "
+              << options.threads << " thread(s)." << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    localStorage.updateDataToFile(workingDirectory, fileName, data);
+    std::cout << "Saved in " << secondsSince(start) << " s." << std::endl;
+
+    if (traceOperations == 0) {
+        return 0;
+    }
+
+    // The trace goes through the application manager, like the UI and the headless commands
+    ApplicationManager applicationManager(workingDirectory, manageConfig.configFileName);
+    std::string openArgument = "--open";
+    char* openArgv[] = { argv[0], openArgument.data(), fileName.data() };
+    if (applicationManager.run(3, openArgv) != CommandType::Open) {
+        std::cerr << applicationManager.getRespondMessage() << std::endl;
+        return 1;
+    }
+
+    std::vector<TraceOperation> trace = generator.generateTrace(traceOperations, saveEvery);
+    std::vector<ReplayTiming> timings = generator.replay(&applicationManager, trace);
+
+    std::cout << "Replayed " << trace.size() << " operation(s):" << std::endl;
+    for (size_t kind = 0; kind < timings.size(); kind++) {
+        const ReplayTiming& timing = timings[kind];
+        if (timing.count == 0) {
+            continue;
+        }
+        std::cout << "  " << WorkloadGenerator::operationName(static_cast<TraceOperationKind>(kind)) << '\t' << timing.count << " op(s), "
+                  << timing.rejected << " without effect, " << timing.seconds * 1000 << " ms total, "
+                  << timing.seconds * 1e6 / timing.count << " us per op" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Headers/benchmarkReport.h"
+
+#include "../../app/Headers/applicationManager.h"
+#include "../../app/Headers/batchCommands.h"
+#include "../../app/Headers/dateUtils.h"
+#include "../../app/Headers/documentExchange.h"
+#include "../../app/Headers/documentMerge.h"
+#include "../../app/Headers/inputHandlers.h"
+#include "../../app/Headers/uiRenderer.h"
+#include "../../app/Headers/Interface/eventRecorder.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    struct ReplayOptions {
+        std::string events;
+        std::string file;
+        // 0 fixes the clock at the start of the recording
+        std::time_t clock = 0;
+        int width = 200;
+        int height = 50;
+        std::string output;
+        std::string document;
+    };
+
+    void showHelp() {
+        std::cout << "Usage: l4d-replay --events [path] --file [path_to_file] [options]" << std::endl;
+        std::cout << "Replays a UI session recorded with LOG4DAILY_RECORD=path on a copy of a log4daily file, without a terminal," << std::endl;
+        std::cout << "and prints the latency of every event and the final document as JSON." << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "  --events                [path]              The recorded events" << std::endl;
+        std::cout << "  --file                  [path_to_file]      The .l4d file to replay them on, it is copied and not changed" << std::endl;
+        std::cout << "  --clock                 [date]              Fix the clock at \"YYYY-MM-DD HH:MM\" (default: when the events were recorded)" << std::endl;
+        std::cout << "  --size                  [WxH]               Size of the frames until the events resize them (default 200x50)" << std::endl;
+        std::cout << "  --output                [path]              Write the JSON report to a file instead of stdout" << std::endl;
+        std::cout << "  --document              [path]              Also write the final document as JSON, as --export does" << std::endl;
+        std::cout << "  --help                                      Show this help message" << std::endl;
+    }
+
+    bool parseNumber(const std::string& text, int *value) {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), *value);
+        return error == std::errc() && end == text.data() + text.size() && *value > 0;
+    }
+
+    bool parseClock(const std::string& text, std::time_t *time) {
+        Date date;
+        if (!BatchCommands::parseDate(text, &date)) {
+            return false;
+        }
+        std::tm tm{};
+        tm.tm_year = date.year - 1900;
+        tm.tm_mon = date.month - 1;
+        tm.tm_mday = date.day;
+        tm.tm_hour = date.hour;
+        tm.tm_min = date.minute;
+        tm.tm_isdst = -1;
+        *time = std::mktime(&tm);
+        return *time > 0;
+    }
+
+    std::string hex(uint64_t value) {
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+        return text;
+    }
+
+    /**
+     * @brief The record counts of the document and a hash of every section, equal hashes mean equal sections.
+     */
+    std::string documentJson(const FileData& data) {
+        size_t progressPoints = 0;
+        for (const auto& milestone : data.milestonesData) {
+            progressPoints += milestone.progressPoints.size();
+        }
+        MerkleTree tree = MerkleTree::build(data);
+
+        std::stringstream json;
+        json << "{\"calendar_days\": " << data.calendarData.size() << ", \"todos\": " << data.todosData.size()
+             << ", \"milestones\": " << data.milestonesData.size() << ", \"progress_points\": " << progressPoints
+             << ", \"diary_entries\": " << data.diaryData.size() << ",\n    \"hashes\": {";
+        const char* names[MerkleTree::sectionCount] = { "calendar", "todos", "milestones", "diary" };
+        for (size_t section = 0; section < MerkleTree::sectionCount; section++) {
+            json << (section > 0 ? ", \"" : "\"") << names[section] << "\": \"" << hex(tree.sections[section].root) << "\"";
+        }
+        json << "}}";
+        return json.str();
+    }
+
+    std::string eventsJson(const std::vector<RecordedEvent>& events, const std::vector<ReplayedEvent>& replayed) {
+        std::stringstream json;
+        json << "[";
+        for (size_t i = 0; i < replayed.size(); i++) {
+            const ReplayedEvent& result = replayed[i];
+            const RecordedEvent& event = events[result.index];
+            json << (i > 0 ? ",\n    {" : "\n    {") << "\"index\": " << result.index << ", \"time_ms\": " << event.time << ", \"event\": ";
+            BenchmarkReport::writeString(json, EventRecorder::describe(event));
+            json << ", \"handled\": " << (result.handled ? "true" : "false") << ", \"handle_ms\": " << result.handleMs
+                 << ", \"render_ms\": " << result.renderMs << ", \"total_ms\": " << result.handleMs + result.renderMs << "}";
+        }
+        json << "\n  ]";
+        return json.str();
+    }
+}
+
+/**
+ * @brief Replays recorded UI events on a copy of a log4daily file and writes their latency as JSON.
+ */
+int main(int argc, char** argv) {
+    ReplayOptions options;
+
+    for (const auto& command : InputHandlers::parseConsoleInputs(argc, argv)) {
+        bool valid = true;
+
+        if (command.name == "--events") {
+            options.events = command.argument;
+        } else if (command.name == "--file") {
+            options.file = command.argument;
+        } else if (command.name == "--clock") {
+            // The date and the time are two arguments unless they were quoted together
+            std::string clock;
+            for (const auto& argument : command.arguments) {
+                clock += (clock.empty() ? "" : " ") + argument;
+            }
+            valid = parseClock(clock, &options.clock);
+        } else if (command.name == "--size") {
+            size_t separator = command.argument.find('x');
+            valid = separator != std::string::npos && parseNumber(command.argument.substr(0, separator), &options.width)
+                && parseNumber(command.argument.substr(separator + 1), &options.height);
+        } else if (command.name == "--output") {
+            options.output = command.argument;
+        } else if (command.name == "--document") {
+            options.document = command.argument;
+        } else if (command.name == "--help") {
+            showHelp();
+            return 0;
+        } else {
+            std::cerr << "Unsupported option: " << command.name << std::endl;
+            return 1;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value for " << command.name << ": \"" << command.argument << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.events.empty() || options.file.empty()) {
+        showHelp();
+        return 1;
+    }
+
+    EventLog log;
+    std::string error;
+    if (!EventRecorder::load(options.events, &log, &error)) {
+        std::cerr << "Failed to read the events: " << error << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path file(options.file);
+    std::error_code fileError;
+    if (file.extension() != ".l4d" || !std::filesystem::is_regular_file(file, fileError)) {
+        std::cerr << options.file << " is not a log4daily file (.l4d)." << std::endl;
+        return 1;
+    }
+
+    // The replay saves when the session did, so it runs on a copy in a scratch directory with its own config file
+    ManageConfig manageConfig;
+    std::string configName = manageConfig.configFileName.empty() ? "config" : manageConfig.configFileName;
+    std::filesystem::path scratch = std::filesystem::temp_directory_path(fileError)
+        / ("l4d-replay-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    if (fileError || !std::filesystem::create_directory(scratch, fileError)
+        || !std::filesystem::copy_file(file, scratch / file.filename(), fileError)) {
+        std::cerr << "Failed to copy " << options.file << " to a scratch directory: " << fileError.message() << std::endl;
+        return 1;
+    }
+    std::ofstream(scratch / configName, std::ios::app);
+
+    std::time_t clock = options.clock != 0 ? options.clock : log.start;
+    DateUtils::fixClock(clock);
+
+    std::string name = file.stem().string();
+    std::string program = "l4d-replay";
+    std::string openArgument = "--open";
+    char* openArgv[] = { program.data(), openArgument.data(), name.data() };
+
+    ApplicationManager applicationManager(scratch.string() + "/", configName);
+    CommandType opened = applicationManager.run(3, openArgv);
+    if (opened != CommandType::Open) {
+        std::cerr << "Failed to open " << options.file << ": " << applicationManager.getRespondMessage() << std::endl;
+        std::filesystem::remove_all(scratch, fileError);
+        return 1;
+    }
+    applicationManager.registerToday();
+
+    uiRenderer UI(&applicationManager);
+    std::cerr << "Replaying " << log.events.size() << " event(s) on " << name << std::endl;
+    std::vector<ReplayedEvent> replayed = UI.replay(log.events, options.width, options.height);
+    FileData document = UI.getInUseFileData();
+
+    BenchmarkReport report;
+    report.setEnvironment("tool", "l4d-replay");
+    report.setEnvironment("events", options.events);
+    report.setEnvironment("file", options.file);
+    report.setEnvironment("clock", DateUtils::toString(DateUtils::now(), true));
+    report.setEnvironment("size", std::to_string(options.width) + "x" + std::to_string(options.height));
+    report.setEnvironment("replayed", std::to_string(replayed.size()) + " of " + std::to_string(log.events.size()));
+
+    // One result per kind of event, and one for all of them
+    const std::pair<const char*, RecordedEventKind> kinds[] = {
+        { "replay/key", RecordedEventKind::Key }, { "replay/char", RecordedEventKind::Character },
+        { "replay/mouse", RecordedEventKind::Mouse }, { "replay/resize", RecordedEventKind::Resize },
+    };
+    BenchmarkResult all;
+    all.name = "replay/all";
+    all.storage = "memory";
+    for (const auto& [kindName, kind] : kinds) {
+        BenchmarkResult result;
+        result.name = kindName;
+        result.storage = "memory";
+        for (const auto& event : replayed) {
+            if (log.events[event.index].kind == kind) {
+                result.samplesMs.push_back(event.handleMs + event.renderMs);
+            }
+        }
+        if (!result.samplesMs.empty()) {
+            all.samplesMs.insert(all.samplesMs.end(), result.samplesMs.begin(), result.samplesMs.end());
+            report.add(std::move(result));
+        }
+    }
+    all.peakRssKb = BenchmarkReport::peakResidentKilobytes();
+    LatencySummary latency = BenchmarkReport::summarize(all.samplesMs);
+    std::cerr << "  p50 " << latency.p50 << " ms, p99 " << latency.p99 << " ms, max " << latency.max << " ms" << std::endl;
+    report.add(std::move(all));
+
+    report.addSection("events", eventsJson(log.events, replayed));
+    report.addSection("document", documentJson(document));
+
+    bool written = true;
+    if (!options.document.empty()) {
+        std::ofstream output(options.document);
+        DocumentExchange::exportJson(document, output);
+        if (!output) {
+            std::cerr << "Failed to write " << options.document << std::endl;
+            written = false;
+        }
+    }
+
+    std::filesystem::remove_all(scratch, fileError);
+
+    if (options.output.empty()) {
+        report.writeJson(std::cout);
+    } else {
+        std::ofstream output(options.output);
+        report.writeJson(output);
+        if (!output) {
+            std::cerr << "Failed to write " << options.output << std::endl;
+            return 1;
+        }
+    }
+    return written ? 0 : 1;
+}
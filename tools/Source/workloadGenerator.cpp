@@ -0,0 +1,370 @@
+#include "../Headers/workloadGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../app/Headers/applicationManager.h"
+#include "../../app/Headers/dateUtils.h"
+#include "../../app/Headers/fileDataOperations.h"
+
+#include "../../l4dFiles/out/l4dFiles.hpp"
+
+namespace {
+    constexpr const char* words[] = {
+        "the", "a", "to", "and", "of", "in", "for", "on", "with", "after", "before", "today",
+        "meeting", "project", "review", "code", "release", "report", "email", "call", "plan", "budget",
+        "team", "client", "draft", "notes", "design", "test", "build", "deploy", "server", "update",
+        "morning", "evening", "walk", "run", "gym", "book", "coffee", "lunch", "dinner", "family",
+        "friends", "weekend", "trip", "train", "garden", "kitchen", "music", "movie", "idea", "problem",
+        "finished", "started", "missed", "wrote", "read", "fixed", "cleaned", "called", "planned", "learned",
+        "quiet", "busy", "long", "short", "good", "bad", "late", "early", "new", "old",
+        "really", "almost", "again", "finally", "still", "maybe", "probably", "never", "always", "together"
+    };
+    constexpr size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    constexpr const char* verbs[] = {
+        "Write", "Review", "Send", "Call", "Fix", "Plan", "Buy", "Prepare", "Update", "Clean",
+        "Book", "Pay", "Test", "Deploy", "Read", "Finish", "Check", "Order", "Schedule", "Renew"
+    };
+    constexpr const char* nouns[] = {
+        "report", "invoice", "slides", "release notes", "dentist", "groceries", "tickets", "budget",
+        "pull request", "backup", "car service", "insurance", "newsletter", "interview", "roadmap",
+        "taxes", "garden", "presentation", "contract", "gift"
+    };
+
+    constexpr size_t todoChunkSize = 4096;
+    constexpr size_t diaryChunkSize = 256;
+    constexpr size_t calendarChunkSize = 4096;
+
+    Date withTime(int dayNumber, int hour, int minute) {
+        Date date = DateUtils::fromDayNumber(dayNumber);
+        date.hour = static_cast<short>(hour);
+        date.minute = static_cast<short>(minute);
+        return date;
+    }
+}
+
+WorkloadGenerator::WorkloadGenerator(WorkloadOptions options) : options(options) {
+    this->options.threads = std::max(1u, options.threads);
+    baseDayNumber = DateUtils::dayNumber(options.baseDay);
+}
+
+SplitMix64 WorkloadGenerator::streamGenerator(Stream stream, uint64_t index) const {
+    SplitMix64 mixer(options.seed ^ (static_cast<uint64_t>(stream) << 56) ^ index);
+    return SplitMix64(mixer.next());
+}
+
+template <typename Function>
+void WorkloadGenerator::forEachChunk(size_t count, size_t chunkSize, Function generateChunk) const {
+    size_t chunks = (count + chunkSize - 1) / chunkSize;
+    std::atomic<size_t> nextChunk = 0;
+
+    auto worker = [&] {
+        for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+            generateChunk(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize), chunk);
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(options.threads, chunks);
+    if (threadCount <= 1) {
+        worker();
+        return;
+    }
+
+    std::vector<std::jthread> workers;
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(worker);
+    }
+}
+
+std::string WorkloadGenerator::sentence(SplitMix64& random, int wordsInSentence) const {
+    std::string text;
+    for (int i = 0; i < wordsInSentence; i++) {
+        if (i > 0) {
+            text += ' ';
+        }
+        text += words[random.below(wordCount)];
+    }
+    if (!text.empty()) {
+        text[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(text[0])));
+    }
+    return text;
+}
+
+std::string WorkloadGenerator::diaryText(SplitMix64& random) const {
+    // Log-normal like spread: most entries are close to the average, a few are several times longer
+    double normal = -6;
+    for (int i = 0; i < 12; i++) {
+        normal += random.unit();
+    }
+    constexpr double sigma = 0.6;
+    int wordsLeft = std::max(5, static_cast<int>(options.diaryWords * std::exp(sigma * normal - sigma * sigma / 2)));
+
+    std::string text;
+    text.reserve(static_cast<size_t>(wordsLeft) * 7);
+
+    int sentencesInParagraph = random.between(3, 7);
+    while (wordsLeft > 0) {
+        int wordsInSentence = std::min(wordsLeft, random.between(6, 18));
+        text += sentence(random, wordsInSentence);
+        text += random.chance(0.1) ? "!" : ".";
+        wordsLeft -= wordsInSentence;
+
+        if (wordsLeft > 0) {
+            if (--sentencesInParagraph == 0) {
+                text += "\n\n";
+                sentencesInParagraph = random.between(3, 7);
+            }
+            else {
+                text += ' ';
+            }
+        }
+    }
+    return text;
+}
+
+Date WorkloadGenerator::dueDate(SplitMix64& random) const {
+    int day = baseDayNumber;
+
+    switch (options.dueDistribution) {
+        case DueDistribution::Mixed: {
+            double bucket = random.unit();
+            if (bucket < 0.2) {
+                day -= random.between(1, 90);
+            }
+            else if (bucket < 0.7) {
+                day += random.between(0, 14);
+            }
+            else if (bucket < 0.9) {
+                day += random.between(15, 90);
+            }
+            else {
+                day += random.between(91, 730);
+            }
+            return withTime(day, random.between(7, 22), static_cast<int>(random.below(4)) * 15);
+        }
+        case DueDistribution::Uniform:
+            day += random.between(-365, 365);
+            return withTime(day, random.between(0, 23), random.between(0, 59));
+        case DueDistribution::Clustered: {
+            Date month = DateUtils::fromDayNumber(day + random.between(-365, 365));
+            return Date({static_cast<short>(DateUtils::daysInMonth(month.year, month.month)), month.month, month.year, 17, 0});
+        }
+    }
+    return withTime(day, 12, 0);
+}
+
+TodoData WorkloadGenerator::todo(SplitMix64& random, int id) const {
+    TodoData todo;
+
+    todo.id = id;
+    todo.dueDate = dueDate(random);
+
+    int dueDay = DateUtils::dayNumber(todo.dueDate);
+    todo.createDate = withTime(std::min(dueDay, baseDayNumber) - random.between(0, 60), random.between(7, 22), random.between(0, 59));
+
+    todo.todoName = std::string(verbs[random.below(std::size(verbs))]) + " " + nouns[random.below(std::size(nouns))];
+    todo.todoDescription = random.chance(0.3) ? "" : sentence(random, random.between(5, 25)) + ".";
+
+    // Old todos are mostly done, upcoming ones rarely
+    if (random.chance(dueDay < baseDayNumber ? 0.7 : 0.05)) {
+        todo.todoName += FileDataOperations::doneSuffix;
+    }
+    return todo;
+}
+
+MilestonesData WorkloadGenerator::milestone(SplitMix64& random, int id) const {
+    MilestonesData milestone;
+
+    int startDay = baseDayNumber - options.progressYears * 365 - random.between(0, 30);
+
+    milestone.id = id;
+    milestone.startDate = withTime(startDay, random.between(7, 22), random.between(0, 59));
+    milestone.milestoneName = std::string(verbs[random.below(std::size(verbs))]) + " every day";
+    milestone.milestoneDescription = sentence(random, random.between(5, 15)) + ".";
+
+    if (options.progressYears <= 0) {
+        return milestone;
+    }
+
+    double completionRate = 0.5 + random.unit() * 0.45;
+    milestone.progressPoints.reserve(static_cast<size_t>(baseDayNumber - startDay));
+    for (int day = startDay; day < baseDayNumber; day++) {
+        if (random.chance(0.1)) {
+            continue;
+        }
+        milestone.progressPoints.push_back(MilestoneProgressPoint({withTime(day, random.between(18, 23), random.between(0, 59)), random.chance(completionRate)}));
+    }
+    return milestone;
+}
+
+DiaryData WorkloadGenerator::diaryEntry(SplitMix64& random, int id) const {
+    DiaryData entry;
+
+    // One entry a day, the last one on the day before the base day
+    entry.id = id;
+    entry.date = withTime(baseDayNumber - (options.diaryEntries - id) - 1, random.between(19, 23), random.between(0, 59));
+    entry.diaryEntryName = sentence(random, random.between(2, 5));
+    entry.diaryEntry = diaryText(random);
+    return entry;
+}
+
+FileData WorkloadGenerator::generate(const std::string& log4FileName) const {
+    FileData data;
+    data.log4FileName = log4FileName;
+
+    data.todosData.resize(static_cast<size_t>(std::max(0, options.todos)));
+    forEachChunk(data.todosData.size(), todoChunkSize, [&](size_t begin, size_t end, size_t chunk) {
+        SplitMix64 random = streamGenerator(Stream::Todos, chunk);
+        for (size_t i = begin; i < end; i++) {
+            data.todosData[i] = todo(random, static_cast<int>(i) + 1);
+        }
+    });
+
+    // Milestones are few but each has years of progress points, so every milestone is its own chunk
+    data.milestonesData.resize(static_cast<size_t>(std::max(0, options.milestones)));
+    forEachChunk(data.milestonesData.size(), 1, [&](size_t begin, size_t, size_t chunk) {
+        SplitMix64 random = streamGenerator(Stream::Milestones, chunk);
+        data.milestonesData[begin] = milestone(random, static_cast<int>(begin) + 1);
+    });
+
+    data.diaryData.resize(static_cast<size_t>(std::max(0, options.diaryEntries)));
+    forEachChunk(data.diaryData.size(), diaryChunkSize, [&](size_t begin, size_t end, size_t chunk) {
+        SplitMix64 random = streamGenerator(Stream::Diary, chunk);
+        for (size_t i = begin; i < end; i++) {
+            data.diaryData[i] = diaryEntry(random, static_cast<int>(i) + 1);
+        }
+    });
+
+    // Calendar days are registered once per day the file was opened, oldest first
+    int calendarDays = std::max(0, options.calendarDays);
+    data.calendarData.resize(static_cast<size_t>(calendarDays));
+    forEachChunk(data.calendarData.size(), calendarChunkSize, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            data.calendarData[i] = DateUtils::fromDayNumber(baseDayNumber - calendarDays + 1 + static_cast<int>(i));
+        }
+    });
+
+    return data;
+}
+
+std::vector<TraceOperation> WorkloadGenerator::generateTrace(int operations, int saveEvery) const {
+    SplitMix64 random = streamGenerator(Stream::Trace, 0);
+    std::vector<TraceOperation> trace;
+    trace.reserve(static_cast<size_t>(std::max(0, operations)) + 1);
+
+    for (int i = 1; i <= operations; i++) {
+        double bucket = random.unit();
+        TraceOperationKind kind = TraceOperationKind::AddDiaryEntry;
+        if (bucket < 0.35) {
+            kind = TraceOperationKind::AddTodo;
+        }
+        else if (bucket < 0.5) {
+            kind = TraceOperationKind::RemoveTodo;
+        }
+        else if (bucket < 0.8) {
+            kind = TraceOperationKind::MarkTodoDone;
+        }
+        else if (bucket < 0.9) {
+            kind = TraceOperationKind::AddProgressPoint;
+        }
+        trace.push_back(TraceOperation({kind, random.next()}));
+
+        if (saveEvery > 0 && i % saveEvery == 0) {
+            trace.push_back(TraceOperation({TraceOperationKind::Save, 0}));
+        }
+    }
+    if (trace.empty() || trace.back().kind != TraceOperationKind::Save) {
+        trace.push_back(TraceOperation({TraceOperationKind::Save, 0}));
+    }
+    return trace;
+}
+
+std::vector<ReplayTiming> WorkloadGenerator::replay(ApplicationManager *applicationManager, const std::vector<TraceOperation>& trace) const {
+    std::vector<ReplayTiming> timings(static_cast<size_t>(TraceOperationKind::Save) + 1);
+    FileData data = applicationManager->getOpenedFile();
+    DocumentChanges changes;
+
+    for (const auto& operation : trace) {
+        SplitMix64 random = streamGenerator(Stream::Replay, operation.pick);
+        ReplayTiming& timing = timings[static_cast<size_t>(operation.kind)];
+        bool applied = true;
+
+        auto start = std::chrono::steady_clock::now();
+        switch (operation.kind) {
+            case TraceOperationKind::AddTodo: {
+                TodoData generated = todo(random, 0);
+                FileDataOperations::addTodo(&data, generated.todoName, generated.todoDescription, generated.dueDate, &changes);
+                break;
+            }
+            case TraceOperationKind::RemoveTodo:
+                applied = !data.todosData.empty();
+                if (applied) {
+                    FileDataOperations::removeTodo(&data, data.todosData[operation.pick % data.todosData.size()].id, &changes);
+                }
+                break;
+            case TraceOperationKind::MarkTodoDone:
+                applied = !data.todosData.empty() && FileDataOperations::markTodoDone(&data, data.todosData[operation.pick % data.todosData.size()].id, true, &changes);
+                break;
+            case TraceOperationKind::AddProgressPoint:
+                applied = !data.milestonesData.empty() && FileDataOperations::addMilestoneProgressPoint(&data, data.milestonesData[operation.pick % data.milestonesData.size()].id, random.chance(0.7), &changes);
+                break;
+            case TraceOperationKind::AddDiaryEntry:
+                FileDataOperations::addDiaryEntry(&data, sentence(random, random.between(2, 5)), diaryText(random), &changes);
+                break;
+            case TraceOperationKind::Save: {
+                bool replaced = false;
+                std::string error;
+                applied = applicationManager->updateFileData(&data, changes, &replaced, &error);
+                if (applied) {
+                    changes.clear();
+                }
+                break;
+            }
+        }
+        timing.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        timing.count++;
+        timing.rejected += applied ? 0 : 1;
+    }
+    return timings;
+}
+
+const char* WorkloadGenerator::operationName(TraceOperationKind kind) {
+    switch (kind) {
+        case TraceOperationKind::AddTodo:
+            return "add-todo";
+        case TraceOperationKind::RemoveTodo:
+            return "remove-todo";
+        case TraceOperationKind::MarkTodoDone:
+            return "mark-done";
+        case TraceOperationKind::AddProgressPoint:
+            return "progress";
+        case TraceOperationKind::AddDiaryEntry:
+            return "add-diary";
+        case TraceOperationKind::Save:
+            return "save";
+    }
+    return "unknown";
+}
+
+bool WorkloadGenerator::parseDueDistribution(const std::string& text, DueDistribution *distribution) {
+    if (text == "mixed") {
+        *distribution = DueDistribution::Mixed;
+    }
+    else if (text == "uniform") {
+        *distribution = DueDistribution::Uniform;
+    }
+    else if (text == "clustered") {
+        *distribution = DueDistribution::Clustered;
+    }
+    else {
+        return false;
+    }
+    return true;
+}